@@ -0,0 +1,464 @@
+#ifndef UNIX_G4TCPP_BASIC_SOCKET_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-basic-socket_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Constructs a socket without descriptor.
+ */
+template <typename Policy>
+TcpInitializer::BasicSocket<Policy>::BasicSocket(void) noexcept
+    : _socket(-1), _error(0), _bytes_sent(0), _bytes_received(0), _read_mtx(), _send_mtx() {};
+
+/**
+ * @brief Takes ownership of an open descriptor, e.g. one accepted elsewhere.
+ *
+ * @param _sock The descriptor, closed with the socket.
+ */
+template <typename Policy>
+TcpInitializer::BasicSocket<Policy>::BasicSocket(const t_sock _sock) noexcept
+    : _socket(_sock), _error(0), _bytes_sent(0), _bytes_received(0), _read_mtx(), _send_mtx() {};
+
+/**
+ * @brief Moves the descriptor and counters out of another socket, which is left without descriptor.
+ *
+ * @param _other The socket to move from, not in use by another thread.
+ */
+template <typename Policy>
+TcpInitializer::BasicSocket<Policy>::BasicSocket(BasicSocket &&_other) noexcept
+    : _socket(std::exchange(_other._socket, -1)), _error(_other._error.exchange(0, std::memory_order_relaxed)), _bytes_sent(std::exchange(_other._bytes_sent, 0)),
+      _bytes_received(std::exchange(_other._bytes_received, 0)), _read_mtx(), _send_mtx() {};
+
+/**
+ * @brief Closes the held descriptor and moves in the one of another socket.
+ *
+ * @param _other The socket to move from, not in use by another thread.
+ * @returns This socket.
+ */
+template <typename Policy>
+TcpInitializer::BasicSocket<Policy> &TcpInitializer::BasicSocket<Policy>::operator=(BasicSocket &&_other) noexcept {
+    if (this != &_other) {
+        this->Close();
+        this->_socket = std::exchange(_other._socket, -1);
+        this->_error.store(_other._error.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        this->_bytes_sent = std::exchange(_other._bytes_sent, 0);
+        this->_bytes_received = std::exchange(_other._bytes_received, 0);
+    }
+    return *this;
+};
+
+/**
+ * @brief Closes the descriptor.
+ */
+template <typename Policy>
+TcpInitializer::BasicSocket<Policy>::~BasicSocket() {
+    this->Close();
+};
+
+/**
+ * @brief Connects to a server, trying every address of a host name in order. ClientRole only.
+ *
+ * @param _address Numeric IPv4 or IPv6 address, or a host name resolved through Resolver::Global.
+ * @param _port The port number to connect to.
+ * @returns true if connected, false otherwise (errno from the last connect, EINVAL for a bad address).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Connect(const t_strw _address, const t_u16 _port) {
+    static_assert(is_client, "Connect needs a ClientRole socket");
+    std::vector<IpAddress> addresses;
+    if (!TcpInitializer::BasicSocket<Policy>::_Resolve(_address, _port, addresses))
+        return false;
+    std::lock_guard<mutex_type> read_lock(this->_read_mtx);
+    std::lock_guard<mutex_type> send_lock(this->_send_mtx);
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = -1;
+    for (const IpAddress &address : addresses) {
+        PeerAddress sock_address;
+        socklen_t address_size(0);
+        if (!TcpInitializer::AddressParser::ToSockAddr(address, sock_address, address_size))
+            continue;
+        const t_sock sock(socket(address.family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP));
+        if (sock < 0)
+            return false;
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        TcpInitializer::Metrics::connects.Add();
+        if (connect(sock, &sock_address.addr, address_size) == 0) {
+            TcpInitializer::Metrics::connect_latency.Record(TcpInitializer::Metrics::Now() - started);
+            this->_socket = sock;
+            this->_error.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        const int saved_errno(errno);
+        TcpInitializer::Metrics::connect_failures.Add();
+        close(sock);
+        errno = saved_errno;
+    }
+    return false;
+};
+
+/**
+ * @brief Binds and listens; an IPv6 address listens dual-stack ("::" takes IPv4 clients too). ServerRole only.
+ *
+ * @param _address Numeric IPv4 or IPv6 address, or a host name.
+ * @param _port The port number to listen on.
+ * @param _backlog The listen backlog.
+ * @returns true if listening, false otherwise (errno from the failed call).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Listen(const t_strw _address, const t_u16 _port, const int _backlog) {
+    static_assert(is_server, "Listen needs a ServerRole socket");
+    std::vector<IpAddress> addresses;
+    if (!TcpInitializer::BasicSocket<Policy>::_Resolve(_address, _port, addresses))
+        return false;
+    PeerAddress sock_address;
+    socklen_t address_size(0);
+    if (!TcpInitializer::AddressParser::ToSockAddr(addresses.front(), sock_address, address_size)) {
+        errno = EAFNOSUPPORT;
+        return false;
+    }
+    std::lock_guard<mutex_type> read_lock(this->_read_mtx);
+    std::lock_guard<mutex_type> send_lock(this->_send_mtx);
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = socket(addresses.front().family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (this->_socket < 0)
+        return false;
+    const int enable(1), disable(0);
+    setsockopt(this->_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (addresses.front().family == AF_INET6)
+        setsockopt(this->_socket, IPPROTO_IPV6, IPV6_V6ONLY, &disable, sizeof(disable));
+    if (bind(this->_socket, &sock_address.addr, address_size) < 0 || listen(this->_socket, _backlog) < 0) {
+        const int saved_errno(errno);
+        close(this->_socket);
+        this->_socket = -1;
+        errno = saved_errno;
+        return false;
+    }
+    this->_error.store(0, std::memory_order_relaxed);
+    return true;
+};
+
+/**
+ * @brief Accepts a connection. ServerRole only.
+ *
+ * Transient failures (EAGAIN, EINTR, ECONNABORTED, descriptor or memory exhaustion) leave the
+ * listener usable; any other failure is kept in GetError.
+ *
+ * @returns The connection, not open (IsOpen false, errno set) if accept failed.
+ */
+template <typename Policy>
+typename TcpInitializer::BasicSocket<Policy>::accepted_type TcpInitializer::BasicSocket<Policy>::Accept(void) noexcept {
+    static_assert(is_server, "Accept needs a ServerRole socket");
+    std::lock_guard<mutex_type> lock(this->_read_mtx);
+    if constexpr (checked) {
+        if (!this->_Usable())
+            return accepted_type();
+    }
+    const t_sock sock(accept4(this->_socket, nullptr, nullptr, SOCK_CLOEXEC));
+    if (sock < 0) {
+        const int error(errno);
+        if (error != EAGAIN && error != EWOULDBLOCK && error != EINTR && error != ECONNABORTED && error != EMFILE && error != ENFILE && error != ENOBUFS && error != ENOMEM)
+            this->_Fail(error);
+        errno = error;
+        return accepted_type();
+    }
+    TcpInitializer::Metrics::accepted.Add();
+    return accepted_type(sock);
+};
+
+/**
+ * @brief Sends a whole buffer. ClientRole only.
+ *
+ * @param _buffer The bytes to send.
+ * @returns true if every byte was sent, false otherwise (errno from send, or ENOTCONN on a failed socket when Checked).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Send(const t_strw _buffer) noexcept {
+    static_assert(is_client, "Send needs a ClientRole socket");
+    struct iovec tcp_iov;
+    tcp_iov.iov_base = const_cast<char *>(_buffer.data());
+    tcp_iov.iov_len = _buffer.length();
+    std::lock_guard<mutex_type> lock(this->_send_mtx);
+    return this->_SendAll(&tcp_iov, 1);
+};
+
+/**
+ * @brief Sends several buffers with vectored writes, in order and in full. ClientRole only.
+ *
+ * @param _buffers The buffers to send.
+ * @param _count The number of buffers.
+ * @returns true if every byte was sent, false otherwise.
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Send(const t_strw *_buffers, const std::size_t _count) noexcept {
+    static_assert(is_client, "Send needs a ClientRole socket");
+    if constexpr (checked) {
+        if (_buffers == nullptr && _count > 0) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+    std::lock_guard<mutex_type> lock(this->_send_mtx);
+    struct iovec tcp_iov[DEFAULT_SEND_IOV_MAX];
+    for (std::size_t sent = 0; sent < _count;) {
+        const std::size_t batch(std::min<std::size_t>(_count - sent, DEFAULT_SEND_IOV_MAX));
+        for (std::size_t i = 0; i < batch; ++i) {
+            tcp_iov[i].iov_base = const_cast<char *>(_buffers[sent + i].data());
+            tcp_iov[i].iov_len = _buffers[sent + i].length();
+        }
+        if (!this->_SendAll(tcp_iov, batch))
+            return false;
+        sent += batch;
+    }
+    return true;
+};
+
+/**
+ * @brief Performs one read. ClientRole only.
+ *
+ * @param _buffer Destination of the bytes.
+ * @param _size Capacity of the destination.
+ * @returns The byte count, 0 at end of stream (GetError becomes ENOTCONN), -1 on error (errno set, EAGAIN leaves the socket usable).
+ */
+template <typename Policy>
+ssize_t TcpInitializer::BasicSocket<Policy>::Read(char *_buffer, const std::size_t _size) noexcept {
+    static_assert(is_client, "Read needs a ClientRole socket");
+    std::lock_guard<mutex_type> lock(this->_read_mtx);
+    if constexpr (checked) {
+        if (_buffer == nullptr && _size > 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (!this->_Usable())
+            return -1;
+    }
+    for (;;) {
+        const ssize_t tcp_read(recv(this->_socket, _buffer, _size, 0));
+        if (tcp_read > 0) {
+            this->_bytes_received += static_cast<t_u64>(tcp_read);
+            TcpInitializer::Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+            TcpInitializer::ConnectionTable::AccountOwner(this->_socket, static_cast<t_u64>(tcp_read), 0);
+        } else if (tcp_read == 0 && _size > 0) {
+            this->_Fail(ENOTCONN);
+        } else if (tcp_read < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                this->_Fail(errno);
+        }
+        return tcp_read;
+    }
+};
+
+/**
+ * @brief Reads up to buffer_size bytes into a string, replacing its content. ClientRole only.
+ *
+ * @param _sink Receives the bytes, empty at end of stream or on error.
+ * @returns true if at least one byte was read, false otherwise.
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Read(t_str &_sink) {
+    _sink.resize(buffer_size);
+    const ssize_t tcp_read(this->Read(_sink.data(), buffer_size));
+    _sink.resize(tcp_read > 0 ? static_cast<std::size_t>(tcp_read) : 0);
+    return tcp_read > 0;
+};
+
+/**
+ * @brief Reads up to buffer_size bytes into a block of the calling thread's BufferPool, without copying. ClientRole only.
+ *
+ * @param _dest_view Receives the block and the byte count.
+ * @returns true if at least one byte was read, false otherwise.
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::Read(TcpInterceptView &_dest_view) {
+    _dest_view.buffer = TcpInitializer::BufferPool::Local().Acquire();
+    const ssize_t tcp_read(this->Read(_dest_view.buffer.Data(), std::min<std::size_t>(buffer_size, _dest_view.buffer.Capacity())));
+    _dest_view.block_size = tcp_read > 0 ? static_cast<t_u64>(tcp_read) : 0;
+    return tcp_read > 0;
+};
+
+/**
+ * @brief Checks whether the socket holds a descriptor that has not failed.
+ *
+ * No syscall is made: a broken connection is noticed by the next read or send.
+ *
+ * @returns true if open and no I/O call has failed, false otherwise.
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::IsOpen(void) const noexcept {
+    return this->_socket >= 0 && this->_error.load(std::memory_order_relaxed) == 0;
+};
+
+/**
+ * @brief Gets the error of the I/O call that broke the socket.
+ *
+ * @returns The errno value (ENOTCONN after end of stream), 0 while the socket is healthy.
+ */
+template <typename Policy>
+int TcpInitializer::BasicSocket<Policy>::GetError(void) const noexcept {
+    return this->_error.load(std::memory_order_relaxed);
+};
+
+/**
+ * @brief Gets the number of bytes sent.
+ *
+ * @returns The sent byte count.
+ */
+template <typename Policy>
+TcpInitializer::t_u64 TcpInitializer::BasicSocket<Policy>::GetBytesSent(void) const noexcept {
+    std::lock_guard<mutex_type> lock(this->_send_mtx);
+    return this->_bytes_sent;
+};
+
+/**
+ * @brief Gets the number of bytes received.
+ *
+ * @returns The received byte count.
+ */
+template <typename Policy>
+TcpInitializer::t_u64 TcpInitializer::BasicSocket<Policy>::GetBytesReceived(void) const noexcept {
+    std::lock_guard<mutex_type> lock(this->_read_mtx);
+    return this->_bytes_received;
+};
+
+/**
+ * @brief Gets the descriptor, e.g. to register it with an EventLoop.
+ *
+ * @returns The descriptor, -1 if none.
+ */
+template <typename Policy>
+t_sock TcpInitializer::BasicSocket<Policy>::GetSocket(void) const noexcept {
+    return this->_socket;
+};
+
+/**
+ * @brief Gives up the descriptor without closing it.
+ *
+ * @returns The descriptor, -1 if none.
+ */
+template <typename Policy>
+t_sock TcpInitializer::BasicSocket<Policy>::Release(void) noexcept {
+    std::lock_guard<mutex_type> read_lock(this->_read_mtx);
+    std::lock_guard<mutex_type> send_lock(this->_send_mtx);
+    this->_error.store(0, std::memory_order_relaxed);
+    return std::exchange(this->_socket, -1);
+};
+
+/**
+ * @brief Closes the descriptor.
+ */
+template <typename Policy>
+void TcpInitializer::BasicSocket<Policy>::Close(void) noexcept {
+    const t_sock sock(this->Release());
+    if (sock >= 0)
+        close(sock);
+};
+
+/**
+ * @brief Writes iovecs in full, resuming short writes; the send lock must be held.
+ *
+ * @param _iov The buffers, advanced in place.
+ * @param _count The number of buffers.
+ * @returns true if every byte was sent, false otherwise (EAGAIN on a non-blocking socket or an expired SO_SNDTIMEO leaves the socket usable).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::_SendAll(struct iovec *_iov, std::size_t _count) noexcept {
+    if constexpr (checked) {
+        if (!this->_Usable())
+            return false;
+    }
+    while (_count > 0 && _iov->iov_len == 0) {
+        ++_iov;
+        --_count;
+    }
+    while (_count > 0) {
+        struct msghdr tcp_msg;
+        memset(&tcp_msg, 0, sizeof(tcp_msg));
+        tcp_msg.msg_iov = _iov;
+        tcp_msg.msg_iovlen = _count;
+        const ssize_t tcp_sent(sendmsg(this->_socket, &tcp_msg, MSG_NOSIGNAL));
+        if (tcp_sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                this->_Fail(errno);
+            return false;
+        }
+        this->_bytes_sent += static_cast<t_u64>(tcp_sent);
+        TcpInitializer::Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+        TcpInitializer::ConnectionTable::AccountOwner(this->_socket, 0, static_cast<t_u64>(tcp_sent));
+        std::size_t written(static_cast<std::size_t>(tcp_sent));
+        while (_count > 0 && written >= _iov->iov_len) {
+            written -= _iov->iov_len;
+            ++_iov;
+            --_count;
+        }
+        if (_count > 0) {
+            _iov->iov_base = static_cast<char *>(_iov->iov_base) + written;
+            _iov->iov_len -= written;
+        }
+    }
+    return true;
+};
+
+/**
+ * @brief Records the error that broke the socket, the first one is kept.
+ *
+ * @param _error The errno value.
+ */
+template <typename Policy>
+void TcpInitializer::BasicSocket<Policy>::_Fail(const int _error) noexcept {
+    // the reader and the sender may fail at the same time under different locks
+    int expected(0);
+    this->_error.compare_exchange_strong(expected, _error, std::memory_order_relaxed);
+    errno = _error;
+};
+
+/**
+ * @brief Checked policy guard: the socket is open and no I/O call has failed.
+ *
+ * @returns true if the socket can be used, false otherwise (errno EBADF or ENOTCONN).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::_Usable(void) const noexcept {
+    if (this->_socket < 0) {
+        errno = EBADF;
+        return false;
+    }
+    if (this->_error.load(std::memory_order_relaxed) != 0) {
+        errno = ENOTCONN;
+        return false;
+    }
+    return true;
+};
+
+/**
+ * @brief Turns an address into the socket addresses to try.
+ *
+ * @param _address Numeric IPv4 or IPv6 address, or a host name.
+ * @param _port The port.
+ * @param _addresses Receives the addresses with the port set.
+ * @returns true if there is at least one address, false otherwise (errno EINVAL or set by the resolver).
+ */
+template <typename Policy>
+bool TcpInitializer::BasicSocket<Policy>::_Resolve(const t_strw _address, const t_u16 _port, std::vector<IpAddress> &_addresses) {
+    IpAddress numeric;
+    if (TcpInitializer::AddressParser::ParseAddress(_address, numeric)) {
+        _addresses.assign(1, numeric);
+    } else if (!TcpInitializer::AddressParser::IsHostname(_address)) {
+        errno = EINVAL;
+        return false;
+    } else if (!TcpInitializer::Resolver::Global().Resolve(_address, _addresses)) {
+        return false;
+    }
+    for (IpAddress &address : _addresses) {
+        address.port = _port;
+    }
+    return true;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_BASIC_SOCKET_V0_0_1_HPP
+#define UNIX_G4TCPP_BASIC_SOCKET_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+#include <utility>
+
+namespace TcpInitializer
+{
+
+// role policies: what the socket is for, the other role's operations do not compile
+struct ClientRole {};
+struct ServerRole {};
+
+/**
+ * Mutex stand-in for single-threaded sockets, lock and unlock compile to nothing.
+ */
+class NullMutex
+{
+  public:
+    void lock(void) noexcept {};
+    void unlock(void) noexcept {};
+    bool try_lock(void) noexcept { return true; };
+};
+
+// threading policies: SingleThreaded sockets are owned by one thread, Locked sockets serialise
+// senders and readers separately so one thread can block in Read while another sends
+struct SingleThreaded
+{
+    using mutex_type = NullMutex;
+};
+
+struct Locked
+{
+    using mutex_type = std::mutex;
+};
+
+// validation policies: Checked rejects a closed or failed socket and bad arguments before the
+// syscall, Unchecked trusts the caller and goes straight to the syscall
+struct Checked
+{
+    static constexpr bool check_args = true;
+};
+
+struct Unchecked
+{
+    static constexpr bool check_args = false;
+};
+
+/**
+ * Compile-time configuration of a BasicSocket.
+ *
+ * @tparam Role ClientRole or ServerRole.
+ * @tparam Threading SingleThreaded or Locked.
+ * @tparam BufferSize Bytes read per Read into a string or pooled view.
+ * @tparam Validation Checked or Unchecked.
+ */
+template <typename Role, typename Threading = SingleThreaded, t_u32 BufferSize = DEFAULT_BUFFER_MAX_SIZE, typename Validation = Checked>
+struct SocketPolicy
+{
+    using role       = Role;
+    using threading  = Threading;
+    using validation = Validation;
+    static constexpr t_u32 buffer_size = BufferSize;
+};
+
+/**
+ * TCP socket whose role, locking, read size and argument checks are fixed at compile time.
+ *
+ * The hot paths make exactly one syscall and test no connection state: a failure is learned from
+ * the return code of the read, send or accept that hit it, and kept in GetError. With the Checked
+ * policy later calls on a failed socket return at once (errno ENOTCONN) instead of repeating the
+ * syscall; with Unchecked the only branch left is the syscall's own result. Unlike Socket,
+ * TcpListener and TcpConnection, a BasicSocket keeps no session table and no connection state
+ * beyond its descriptor and last error, so it suits code that owns its connections end to end.
+ * Sends use MSG_NOSIGNAL, a closed peer is reported as EPIPE rather than a signal.
+ */
+template <typename Policy>
+class BasicSocket
+{
+  public:
+    using policy_type   = Policy;
+    using mutex_type    = typename Policy::threading::mutex_type;
+    using accepted_type = BasicSocket<SocketPolicy<ClientRole, typename Policy::threading, Policy::buffer_size, typename Policy::validation>>;
+
+    static constexpr bool  is_client   = std::is_same_v<typename Policy::role, ClientRole>;
+    static constexpr bool  is_server   = std::is_same_v<typename Policy::role, ServerRole>;
+    static constexpr bool  checked     = Policy::validation::check_args;
+    static constexpr t_u32 buffer_size = Policy::buffer_size;
+
+    static_assert(is_client || is_server, "SocketPolicy role must be ClientRole or ServerRole");
+    static_assert(buffer_size > 0, "SocketPolicy buffer size must not be 0");
+
+  protected:
+    t_sock                                                _socket;
+    std::atomic<int>                                      _error;
+    t_u64                                                 _bytes_sent;
+    t_u64                                                 _bytes_received;
+    mutable mutex_type                                    _read_mtx;
+    mutable mutex_type                                    _send_mtx;
+
+  public:
+    __attribute__((cold                                            ))                          BasicSocket             (void) noexcept;
+    __attribute__((cold                                            ))  explicit                BasicSocket             (const t_sock _sock) noexcept;
+    __attribute__((cold                                            ))                          BasicSocket             (BasicSocket &&_other) noexcept;
+    __attribute__((cold                                            ))  inline               BasicSocket &operator=  (BasicSocket &&_other) noexcept;
+    BasicSocket(const BasicSocket &)            = delete;
+    BasicSocket &operator=(const BasicSocket &) = delete;
+    __attribute__((cold                                            ))                          ~BasicSocket            ();
+
+    __attribute__((cold                                            ))  inline               bool    Connect                 (const t_strw _address, const t_u16 _port);
+    __attribute__((cold                                            ))  inline               bool    Listen                  (const t_strw _address, const t_u16 _port, const int _backlog = DEFAULT_ACCEPT_MAX);
+    __attribute__((hot, warn_unused_result                         ))  inline               accepted_type Accept            (void) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_strw _buffer) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_strw *_buffers, const std::size_t _count) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               ssize_t Read                    (char *_buffer, const std::size_t _size) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Read                    (t_str &_sink);
+    __attribute__((hot                                             ))  inline               bool    Read                    (TcpInterceptView &_dest_view);
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               bool    IsOpen                  (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               int     GetError                (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetBytesSent            (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetBytesReceived        (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               t_sock  GetSocket               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Release                 (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Close                   (void) noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               bool    _SendAll                (struct iovec *_iov, std::size_t _count) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Fail                   (const int _error) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _Usable                 (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    _Resolve                (const t_strw _address, const t_u16 _port, std::vector<IpAddress> &_addresses);
+};
+
+using ClientSocket       = BasicSocket<SocketPolicy<ClientRole>>;
+using ServerSocket       = BasicSocket<SocketPolicy<ServerRole>>;
+using SharedClientSocket = BasicSocket<SocketPolicy<ClientRole, Locked>>;
+
+}; // namespace TcpInitializer
+
+#endif
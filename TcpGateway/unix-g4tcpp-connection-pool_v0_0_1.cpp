@@ -0,0 +1,388 @@
+#ifndef UNIX_G4TCPP_CONNECTION_POOL_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-connection-pool_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Constructs an empty lease.
+ */
+TcpInitializer::ConnectionPool::Lease::Lease(void) noexcept : _pool(nullptr), _key(0), _socket(-1), _reusable(false) {};
+
+/**
+ * @brief Constructs a lease on a pooled connection.
+ *
+ * @param _pool The pool the connection returns to.
+ * @param _key The upstream key.
+ * @param _sock The connected socket.
+ */
+TcpInitializer::ConnectionPool::Lease::Lease(ConnectionPool *_pool, const t_u64 _key, const t_sock _sock) noexcept : _pool(_pool), _key(_key), _socket(_sock), _reusable(true) {};
+
+/**
+ * @brief Takes over the connection of another lease.
+ *
+ * @param _other The lease to move from, left empty.
+ */
+TcpInitializer::ConnectionPool::Lease::Lease(Lease &&_other) noexcept : _pool(_other._pool), _key(_other._key), _socket(_other._socket), _reusable(_other._reusable) {
+    _other._socket = -1;
+};
+
+/**
+ * @brief Returns the current connection and takes over the one of another lease.
+ *
+ * @param _other The lease to move from, left empty.
+ * @returns A reference to this lease.
+ */
+TcpInitializer::ConnectionPool::Lease &TcpInitializer::ConnectionPool::Lease::operator=(Lease &&_other) noexcept {
+    if (this != &_other) {
+        this->Release();
+        this->_pool = _other._pool;
+        this->_key = _other._key;
+        this->_socket = _other._socket;
+        this->_reusable = _other._reusable;
+        _other._socket = -1;
+    }
+    return *this;
+};
+
+/**
+ * @brief Returns the connection to the pool.
+ */
+TcpInitializer::ConnectionPool::Lease::~Lease() {
+    this->Release();
+};
+
+/**
+ * @brief Checks whether the lease holds a connection.
+ *
+ * @returns true if Acquire succeeded, false otherwise.
+ */
+bool TcpInitializer::ConnectionPool::Lease::IsValid(void) const noexcept {
+    return this->_socket >= 0;
+};
+
+/**
+ * @brief Gets the leased socket, usable with the static Socket API.
+ *
+ * @returns A pointer to the socket, -1 for an empty lease.
+ */
+t_sock *TcpInitializer::ConnectionPool::Lease::GetSocket(void) noexcept {
+    return &this->_socket;
+};
+
+/**
+ * @brief Closes the connection on release instead of pooling it, e.g. after an I/O error or a half-read response.
+ */
+void TcpInitializer::ConnectionPool::Lease::MarkBroken(void) noexcept {
+    this->_reusable = false;
+};
+
+/**
+ * @brief Returns the connection to the pool early, the lease is empty afterwards.
+ */
+void TcpInitializer::ConnectionPool::Lease::Release(void) noexcept {
+    if (this->_socket < 0)
+        return;
+    this->_pool->_Return(this->_key, this->_socket, this->_reusable);
+    this->_socket = -1;
+};
+
+/**
+ * @brief Creates an empty pool.
+ *
+ * @param _max_per_upstream Maximum number of connections in use per upstream.
+ * @param _max_idle Maximum number of idle connections kept per upstream.
+ * @param _idle_timeout_ms Idle connections older than this are closed instead of reused.
+ */
+TcpInitializer::ConnectionPool::ConnectionPool(const t_u32 _max_per_upstream, const t_u32 _max_idle, const t_u32 _idle_timeout_ms) noexcept
+    : _max_per_upstream(_max_per_upstream > 0 ? _max_per_upstream : DEFAULT_POOL_MAX_PER_UPSTREAM), _max_idle(_max_idle), _idle_timeout_ms(_idle_timeout_ms), _keepalive_idle_s(DEFAULT_KEEPALIVE_IDLE_S), _keepalive_interval_s(DEFAULT_KEEPALIVE_INTERVAL_S), _keepalive_count(DEFAULT_KEEPALIVE_COUNT), _upstreams(), _keys(), _mtx(), _returned() {};
+
+/**
+ * @brief Closes every idle connection, leases must not outlive the pool.
+ */
+TcpInitializer::ConnectionPool::~ConnectionPool() {
+    this->Clear();
+};
+
+/**
+ * @brief Borrows a connection to an upstream, reusing an idle one when possible.
+ *
+ * @param _address The upstream address, numeric IPv4 or IPv6.
+ * @param _port The upstream port.
+ * @param _timeout_ms Deadline covering the wait for a free slot and the connect, negative waits without limit.
+ * @returns A lease, empty if the address is invalid, the deadline passed (errno ETIMEDOUT) or the connect failed.
+ */
+TcpInitializer::ConnectionPool::Lease TcpInitializer::ConnectionPool::Acquire(const t_strw _address, const t_u16 _port, const int _timeout_ms) {
+    t_str name;
+    PeerAddress address;
+    socklen_t address_size(0);
+    if (!TcpInitializer::ConnectionPool::_KeyOf(_address, _port, name, address, address_size))
+        return Lease();
+    const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+    const std::chrono::steady_clock::time_point deadline(now + std::chrono::milliseconds(std::max(0, _timeout_ms)));
+    const std::chrono::milliseconds idle_timeout(this->_idle_timeout_ms);
+
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    // upstreams are never erased, so the key handed to leases stays valid for the pool lifetime
+    const t_u64 key(this->_keys.emplace(std::move(name), this->_keys.size() + 1).first->second);
+    Upstream &upstream(this->_upstreams[key]);
+    upstream.address = address;
+    upstream.address_size = address_size;
+    for (;;) {
+        // newest first: the most recently used connection is the least likely to have been dropped
+        while (!upstream.idle.empty()) {
+            const IdleSocket idle(upstream.idle.back());
+            upstream.idle.pop_back();
+            if (std::chrono::steady_clock::now() - idle.since > idle_timeout || !TcpInitializer::ConnectionPool::_IsAlive(idle.sock)) {
+                close(idle.sock);
+                continue;
+            }
+            ++upstream.active;
+            ++upstream.reused;
+            return Lease(this, key, idle.sock);
+        }
+        if (upstream.active < this->_max_per_upstream)
+            break;
+        if (_timeout_ms < 0) {
+            this->_returned.wait(lock);
+        } else if (this->_returned.wait_until(lock, deadline) == std::cv_status::timeout && upstream.active >= this->_max_per_upstream && upstream.idle.empty()) {
+            errno = ETIMEDOUT;
+            return Lease();
+        }
+    }
+    ++upstream.active;
+    ++upstream.dialed;
+    lock.unlock();
+
+    int remaining_ms(-1);
+    if (_timeout_ms >= 0)
+        remaining_ms = static_cast<int>(std::max<long long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count()));
+    const t_sock sock(this->_Dial(address, address_size, remaining_ms));
+    if (sock < 0) {
+        const int saved_errno(errno);
+        this->_Return(key, -1, false);
+        errno = saved_errno;
+        return Lease();
+    }
+    return Lease(this, key, sock);
+};
+
+/**
+ * @brief Tunes the keepalive probes of connections dialed from now on.
+ *
+ * Idle pooled connections are probed so NAT and firewall state stays warm and a dead upstream is
+ * noticed before the connection is handed out; an idle time below the idle timeout makes the
+ * probes run while connections sit in the pool.
+ *
+ * @param _idle_s Idle seconds before the first probe.
+ * @param _interval_s Seconds between probes.
+ * @param _count Unanswered probes before the connection is dropped.
+ */
+void TcpInitializer::ConnectionPool::SetKeepAlive(const t_u32 _idle_s, const t_u32 _interval_s, const t_u32 _count) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_keepalive_idle_s = _idle_s;
+    this->_keepalive_interval_s = _interval_s;
+    this->_keepalive_count = _count;
+};
+
+/**
+ * @brief Closes idle connections older than the idle timeout.
+ *
+ * @returns The number of connections closed.
+ */
+t_u64 TcpInitializer::ConnectionPool::Prune(void) noexcept {
+    const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+    const std::chrono::milliseconds idle_timeout(this->_idle_timeout_ms);
+    t_u64 closed(0);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    for (std::pair<const t_u64, Upstream> &entry : this->_upstreams) {
+        std::vector<IdleSocket> &idle(entry.second.idle);
+        std::vector<IdleSocket>::iterator kept(std::remove_if(idle.begin(), idle.end(), [&](const IdleSocket &_idle) -> bool {
+            if (now - _idle.since <= idle_timeout)
+                return false;
+            close(_idle.sock);
+            ++closed;
+            return true;
+        }));
+        idle.erase(kept, idle.end());
+    }
+    return closed;
+};
+
+/**
+ * @brief Closes every idle connection, connections in use are closed when their lease ends.
+ */
+void TcpInitializer::ConnectionPool::Clear(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    for (std::pair<const t_u64, Upstream> &entry : this->_upstreams) {
+        for (const IdleSocket &idle : entry.second.idle) {
+            close(idle.sock);
+        }
+        entry.second.idle.clear();
+    }
+};
+
+/**
+ * @brief Gets the number of idle connections to an upstream.
+ *
+ * @param _address The upstream address.
+ * @param _port The upstream port.
+ * @returns The idle connection count.
+ */
+t_u64 TcpInitializer::ConnectionPool::GetIdleCount(const t_strw _address, const t_u16 _port) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const Upstream *upstream(this->_Find(_address, _port));
+    return upstream != nullptr ? upstream->idle.size() : 0;
+};
+
+/**
+ * @brief Gets the number of connections to an upstream currently leased or being dialed.
+ *
+ * @param _address The upstream address.
+ * @param _port The upstream port.
+ * @returns The active connection count.
+ */
+t_u64 TcpInitializer::ConnectionPool::GetActiveCount(const t_strw _address, const t_u16 _port) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const Upstream *upstream(this->_Find(_address, _port));
+    return upstream != nullptr ? upstream->active : 0;
+};
+
+/**
+ * @brief Gets the number of connects issued to an upstream.
+ *
+ * @param _address The upstream address.
+ * @param _port The upstream port.
+ * @returns The dial count.
+ */
+t_u64 TcpInitializer::ConnectionPool::GetDialCount(const t_strw _address, const t_u16 _port) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const Upstream *upstream(this->_Find(_address, _port));
+    return upstream != nullptr ? upstream->dialed : 0;
+};
+
+/**
+ * @brief Gets the number of leases served from idle connections of an upstream.
+ *
+ * @param _address The upstream address.
+ * @param _port The upstream port.
+ * @returns The reuse count.
+ */
+t_u64 TcpInitializer::ConnectionPool::GetReuseCount(const t_strw _address, const t_u16 _port) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const Upstream *upstream(this->_Find(_address, _port));
+    return upstream != nullptr ? upstream->reused : 0;
+};
+
+/**
+ * @brief Takes a connection back from a lease and wakes one waiter.
+ *
+ * @param _key The upstream key.
+ * @param _sock The socket, -1 when only the reserved slot is released.
+ * @param _reusable false to close the socket instead of pooling it.
+ */
+void TcpInitializer::ConnectionPool::_Return(const t_u64 _key, const t_sock _sock, const bool _reusable) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        std::unordered_map<t_u64, Upstream>::iterator entry(this->_upstreams.find(_key));
+        if (entry != this->_upstreams.end()) {
+            Upstream &upstream(entry->second);
+            --upstream.active;
+            if (_sock >= 0 && _reusable && upstream.idle.size() < this->_max_idle) {
+                upstream.idle.push_back(IdleSocket{_sock, std::chrono::steady_clock::now()});
+            } else if (_sock >= 0) {
+                close(_sock);
+            }
+        } else if (_sock >= 0) {
+            close(_sock);
+        }
+    }
+    this->_returned.notify_one();
+};
+
+/**
+ * @brief Opens a new connection within a deadline and prepares it for pooling.
+ *
+ * @param _address The upstream address.
+ * @param _address_size The size of _address.
+ * @param _timeout_ms Connect deadline, negative waits without limit.
+ * @returns The connected socket, or -1 on failure.
+ */
+t_sock TcpInitializer::ConnectionPool::_Dial(const PeerAddress &_address, const socklen_t _address_size, const int _timeout_ms) noexcept {
+    const t_sock sock(socket(_address.addr.sa_family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP));
+    if (sock < 0)
+        return -1;
+    if (!TcpInitializer::Socket::ConnectWithin(sock, &_address.addr, _address_size, _timeout_ms)) {
+        const int saved_errno(errno);
+        close(sock);
+        errno = saved_errno;
+        return -1;
+    }
+    const int enable(1);
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    // keepalive probes keep NAT and firewall state warm while the connection sits idle
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    const t_u32 idle_s(this->_keepalive_idle_s), interval_s(this->_keepalive_interval_s), count(this->_keepalive_count);
+    lock.unlock();
+    TcpInitializer::Socket::SetKeepAlive(sock, idle_s, interval_s, count);
+    return sock;
+};
+
+/**
+ * @brief Looks an upstream up, the pool lock must be held.
+ *
+ * @param _address The upstream address.
+ * @param _port The upstream port.
+ * @returns A pointer to the upstream, or nullptr if unknown.
+ */
+const TcpInitializer::ConnectionPool::Upstream *TcpInitializer::ConnectionPool::_Find(const t_strw _address, const t_u16 _port) const {
+    t_str name;
+    PeerAddress address;
+    socklen_t address_size(0);
+    if (!TcpInitializer::ConnectionPool::_KeyOf(_address, _port, name, address, address_size))
+        return nullptr;
+    std::unordered_map<t_str, t_u64>::const_iterator key(this->_keys.find(name));
+    if (key == this->_keys.end())
+        return nullptr;
+    std::unordered_map<t_u64, Upstream>::const_iterator entry(this->_upstreams.find(key->second));
+    return entry != this->_upstreams.end() ? &entry->second : nullptr;
+};
+
+/**
+ * @brief Parses an upstream into its pool key and socket address.
+ *
+ * @param _address The address, numeric IPv4 or IPv6.
+ * @param _port The port.
+ * @param _key Set to the bytes of the socket address, which name the upstream in the pool.
+ * @param _sock_address Set to the socket address.
+ * @param _size Set to the size of the socket address.
+ * @returns true if the address and port are valid, false otherwise.
+ */
+bool TcpInitializer::ConnectionPool::_KeyOf(const t_strw _address, const t_u16 _port, t_str &_key, PeerAddress &_sock_address, socklen_t &_size) {
+    TcpInitializer::IpAddress address;
+    if (_port == 0 || !TcpInitializer::AddressParser::ParseAddress(_address, address))
+        return false;
+    address.port = _port;
+    if (!TcpInitializer::AddressParser::ToSockAddr(address, _sock_address, _size))
+        return false;
+    _key.assign(reinterpret_cast<const char *>(&_sock_address), _size);
+    return true;
+};
+
+/**
+ * @brief Checks an idle connection without a round trip.
+ *
+ * A healthy idle connection has nothing to read: a zero-byte read means the peer closed it, and
+ * unsolicited bytes mean a stale response that would corrupt the next exchange.
+ *
+ * @param _sock The idle socket.
+ * @returns true if the connection can be reused, false otherwise.
+ */
+bool TcpInitializer::ConnectionPool::_IsAlive(const t_sock _sock) noexcept {
+    char probe;
+    const ssize_t peeked(recv(_sock, &probe, 1, MSG_PEEK | MSG_DONTWAIT));
+    return peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+};
+
+#endif
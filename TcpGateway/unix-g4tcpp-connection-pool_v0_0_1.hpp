@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_CONNECTION_POOL_V0_0_1_HPP
+#define UNIX_G4TCPP_CONNECTION_POOL_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+
+#include <condition_variable>
+#include <netinet/tcp.h>
+#include <unordered_map>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_POOL_MAX_PER_UPSTREAM  32u
+#define DEFAULT_POOL_MAX_IDLE          8u
+#define DEFAULT_POOL_IDLE_TIMEOUT_MS   30000u
+#define DEFAULT_CONNECT_TIMEOUT_MS     1000
+
+/**
+ * Pool of outbound connections keyed by (address, port).
+ *
+ * Acquire hands out the most recently returned idle connection of an upstream, so reuse skips the
+ * connect handshake entirely, and only dials a new one (non-blocking connect bounded by a
+ * deadline) when none is idle. Idle connections are validated with a single non-blocking
+ * MSG_PEEK read, which detects a peer that closed or sent unsolicited bytes without a round trip,
+ * and are kept warm with TCP keepalive until they sit idle longer than the idle timeout. Each
+ * upstream is capped at a number of connections in use; callers beyond the cap wait for a
+ * connection to come back, up to their deadline. The pool is thread-safe.
+ */
+class ConnectionPool
+{
+  public:
+    /**
+     * Connection borrowed from the pool, returned to it when the lease goes out of scope.
+     */
+    class Lease
+    {
+        friend class ConnectionPool;
+      protected:
+        ConnectionPool                                   *_pool;
+        t_u64                                             _key;
+        t_sock                                            _socket;
+        bool                                              _reusable;
+
+        __attribute__((hot                                             ))                          Lease                   (ConnectionPool *_pool, const t_u64 _key, const t_sock _sock) noexcept;
+
+      public:
+        __attribute__((hot                                             ))                          Lease                   (void) noexcept;
+        __attribute__((hot                                             ))                          Lease                   (Lease &&_other) noexcept;
+        __attribute__((hot                                             ))  inline               Lease  &operator=       (Lease &&_other) noexcept;
+        Lease(const Lease &)            = delete;
+        Lease &operator=(const Lease &) = delete;
+        __attribute__((hot                                             ))                          ~Lease                  ();
+
+        __attribute__((hot, pure, warn_unused_result                   ))  inline               bool    IsValid                 (void) const noexcept;
+        __attribute__((hot, warn_unused_result                         ))  inline               t_sock* GetSocket               (void) noexcept;
+        __attribute__((hot                                             ))  inline               void    MarkBroken              (void) noexcept;
+        __attribute__((hot                                             ))  inline               void    Release                 (void) noexcept;
+    };
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_sock             sock        { -1                                                 };
+        std::chrono::steady_clock::time_point since {                                       };
+    } IdleSocket;
+
+    typedef struct alignas(void *)
+    {
+        PeerAddress        address     {                                                    };
+        socklen_t          address_size {                                                   };
+        std::vector<IdleSocket> idle   {                                                    };
+        t_u32              active      {                                                    };
+        t_u64              dialed      {                                                    };
+        t_u64              reused      {                                                    };
+    } Upstream;
+
+    t_u32                                                 _max_per_upstream;
+    t_u32                                                 _max_idle;
+    t_u32                                                 _idle_timeout_ms;
+    t_u32                                                 _keepalive_idle_s;
+    t_u32                                                 _keepalive_interval_s;
+    t_u32                                                 _keepalive_count;
+    std::unordered_map<t_u64, Upstream>                   _upstreams;
+    std::unordered_map<t_str, t_u64>                      _keys;
+    mutable std::mutex                                    _mtx;
+    std::condition_variable                               _returned;
+
+  public:
+    __attribute__((cold                                            ))  explicit                ConnectionPool          (const t_u32 _max_per_upstream = DEFAULT_POOL_MAX_PER_UPSTREAM, const t_u32 _max_idle = DEFAULT_POOL_MAX_IDLE, const t_u32 _idle_timeout_ms = DEFAULT_POOL_IDLE_TIMEOUT_MS) noexcept;
+    ConnectionPool(const ConnectionPool &)            = delete;
+    ConnectionPool &operator=(const ConnectionPool &) = delete;
+    __attribute__((cold                                            ))                          ~ConnectionPool         ();
+
+    __attribute__((hot, warn_unused_result                         ))  inline               Lease   Acquire                 (const t_strw _address, const t_u16 _port, const int _timeout_ms = DEFAULT_CONNECT_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               void    SetKeepAlive            (const t_u32 _idle_s, const t_u32 _interval_s, const t_u32 _count) noexcept;
+    __attribute__((cold                                            ))  inline               t_u64   Prune                   (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Clear                   (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetIdleCount            (const t_strw _address, const t_u16 _port) const;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetActiveCount          (const t_strw _address, const t_u16 _port) const;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetDialCount            (const t_strw _address, const t_u16 _port) const;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetReuseCount           (const t_strw _address, const t_u16 _port) const;
+
+  protected:
+    __attribute__((hot                                             ))  inline               void    _Return                 (const t_u64 _key, const t_sock _sock, const bool _reusable) noexcept;
+    __attribute__((hot                                             ))  inline               t_sock  _Dial                   (const PeerAddress &_address, const socklen_t _address_size, const int _timeout_ms) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               const Upstream *_Find           (const t_strw _address, const t_u16 _port) const;
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool    _KeyOf                  (const t_strw _address, const t_u16 _port, t_str &_key, PeerAddress &_sock_address, socklen_t &_size);
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool    _IsAlive                (const t_sock _sock) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,844 @@
+#ifndef UNIX_G4TCPP_CORO_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-coro_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Allocates a coroutine frame, from the free list of its size class when one is cached.
+ *
+ * @param _size The frame size requested by the compiler.
+ * @returns The frame memory.
+ * @throws std::bad_alloc If the global allocator fails.
+ */
+void *TcpInitializer::FramePool::Allocate(const std::size_t _size) {
+    const std::size_t size_class((_size + CORO_FRAME_SIZE_STEP - 1) / CORO_FRAME_SIZE_STEP);
+    if (size_class >= CORO_FRAME_SIZE_CLASSES)
+        return ::operator new(_size);
+    FreeList &list(TcpInitializer::FramePool::_Lists()[size_class]);
+    if (list.head != nullptr) {
+        FreeFrame *frame(list.head);
+        list.head = frame->next;
+        --list.count;
+        return frame;
+    }
+    return ::operator new(size_class * CORO_FRAME_SIZE_STEP);
+};
+
+/**
+ * @brief Returns a coroutine frame to the free list of the calling thread.
+ *
+ * @param _frame The frame memory.
+ * @param _size The size the frame was allocated with.
+ */
+void TcpInitializer::FramePool::Release(void *_frame, const std::size_t _size) noexcept {
+    const std::size_t size_class((_size + CORO_FRAME_SIZE_STEP - 1) / CORO_FRAME_SIZE_STEP);
+    if (size_class >= CORO_FRAME_SIZE_CLASSES)
+        return ::operator delete(_frame);
+    FreeList &list(TcpInitializer::FramePool::_Lists()[size_class]);
+    if (list.count >= DEFAULT_CORO_FRAME_CACHE)
+        return ::operator delete(_frame);
+    FreeFrame *frame(static_cast<FreeFrame *>(_frame));
+    frame->next = list.head;
+    list.head = frame;
+    ++list.count;
+};
+
+/**
+ * @brief Gets the number of frames cached by the calling thread.
+ *
+ * @returns The number of cached frames over every size class.
+ */
+TcpInitializer::t_u64 TcpInitializer::FramePool::GetCachedCount(void) noexcept {
+    t_u64 cached(0);
+    const FreeList *lists(TcpInitializer::FramePool::_Lists());
+    for (t_u32 i = 0; i < CORO_FRAME_SIZE_CLASSES; ++i)
+        cached += lists[i].count;
+    return cached;
+};
+
+/**
+ * @brief Gets the free lists of the calling thread, freed when the thread exits.
+ *
+ * @returns The CORO_FRAME_SIZE_CLASSES free lists.
+ */
+TcpInitializer::FramePool::FreeList *TcpInitializer::FramePool::_Lists(void) noexcept {
+    thread_local struct LocalLists
+    {
+        FreeList lists[CORO_FRAME_SIZE_CLASSES]{};
+        ~LocalLists()
+        {
+            for (FreeList &list : lists) {
+                while (list.head != nullptr) {
+                    FreeFrame *frame(list.head);
+                    list.head = frame->next;
+                    ::operator delete(frame);
+                }
+            }
+        };
+    } local_lists;
+    return local_lists.lists;
+};
+
+/**
+ * @brief Creates a scheduler running its coroutines on an event loop.
+ *
+ * @param _loop The loop, which must outlive the scheduler.
+ */
+TcpInitializer::Scheduler::Scheduler(EventLoop &_loop) : _loop(&_loop), _states(), _spawned(), _token(std::make_shared<Scheduler *>(this)), _closing(false) {};
+
+/**
+ * @brief Destroys every spawned task that is still suspended, closing the sockets it owns, and
+ * stops watching the remaining sockets.
+ */
+TcpInitializer::Scheduler::~Scheduler() {
+    this->_closing = true;
+    // deferred resumptions check the token, reset it before frames go away
+    this->_token.reset();
+    while (!this->_spawned.empty()) {
+        void *frame(*this->_spawned.begin());
+        this->_spawned.erase(this->_spawned.begin());
+        std::coroutine_handle<>::from_address(frame).destroy();
+    }
+    for (std::size_t sock = 0; sock < this->_states.size(); ++sock) {
+        IoState &state(this->_states[sock]);
+        if (!state.watched)
+            continue;
+        for (const t_sock pending : state.backlog)
+            close(pending);
+        this->_loop->Remove(static_cast<t_sock>(sock));
+        if (!state.listener)
+            close(static_cast<t_sock>(sock));
+    }
+};
+
+/**
+ * @brief Starts a task that runs on its own; its frame is released when it finishes.
+ *
+ * The task runs on the calling thread until its first suspension, then on the loop thread.
+ * An exception escaping the task is logged.
+ *
+ * @param _task The task to run.
+ */
+void TcpInitializer::Scheduler::Spawn(Task<void> &&_task) {
+    Task<void>::handle_type handle(_task.Release());
+    if (!handle)
+        return;
+    handle.promise().scheduler = this;
+    this->_spawned.insert(handle.address());
+    handle.resume();
+};
+
+/**
+ * @brief Awaits the next connection accepted on a listening socket.
+ *
+ * The listener is registered with the loop on first use; connections accepted while no coroutine
+ * waits are queued. The result is an invalid AsyncSocket once the listener was closed.
+ *
+ * @param _listen_sock The listening socket.
+ * @returns The awaiter.
+ */
+TcpInitializer::Scheduler::AcceptAwaiter TcpInitializer::Scheduler::Accept(const t_sock _listen_sock) noexcept {
+    return AcceptAwaiter(this, _listen_sock);
+};
+
+/**
+ * @brief Awaits a non-blocking connect to an IPv4 or IPv6 address.
+ *
+ * @param _address The numeric IPv4 or IPv6 address.
+ * @param _port The port.
+ * @returns The awaiter, resuming with an invalid AsyncSocket if the connect failed (errno is set).
+ */
+TcpInitializer::Scheduler::ConnectAwaiter TcpInitializer::Scheduler::Connect(const t_strw _address, const t_u16 _port) noexcept {
+    return ConnectAwaiter(this, _address, _port);
+};
+
+/**
+ * @brief Suspends the calling coroutine until the end of the current loop tick, letting other sessions run.
+ *
+ * @returns The awaiter.
+ */
+TcpInitializer::Scheduler::YieldAwaiter TcpInitializer::Scheduler::Yield(void) noexcept {
+    return YieldAwaiter{this};
+};
+
+/**
+ * @brief Wraps an already connected socket, e.g. one obtained from a blocking API.
+ *
+ * @param _sock The connected socket, switched to non-blocking mode.
+ * @returns The socket handle, invalid if the socket could not be watched.
+ */
+TcpInitializer::AsyncSocket TcpInitializer::Scheduler::Adopt(const t_sock _sock) {
+    if (!this->_Watch(_sock))
+        return AsyncSocket();
+    return AsyncSocket(this, _sock, this->_StateOf(_sock).generation);
+};
+
+/**
+ * @brief Stops accepting on a listener: the pending Accept resumes with an invalid socket and
+ * queued connections are closed. The listening socket itself stays open.
+ *
+ * @param _listen_sock The listening socket.
+ */
+void TcpInitializer::Scheduler::CloseListener(const t_sock _listen_sock) noexcept {
+    if (_listen_sock < 0 || static_cast<std::size_t>(_listen_sock) >= this->_states.size())
+        return;
+    IoState &state(this->_states[_listen_sock]);
+    if (!state.watched || !state.listener)
+        return;
+    for (const t_sock pending : state.backlog)
+        close(pending);
+    state.backlog.clear();
+    this->_loop->Remove(_listen_sock);
+    state.watched = false;
+    state.listener = false;
+    ++state.generation;
+    this->_Cancel(state, EBADF);
+};
+
+/**
+ * @brief Runs the loop until Stop() is called.
+ */
+void TcpInitializer::Scheduler::Run(void) {
+    this->_loop->Run();
+};
+
+/**
+ * @brief Requests Run() to return, safe to call from any thread.
+ */
+void TcpInitializer::Scheduler::Stop(void) noexcept {
+    this->_loop->Stop();
+};
+
+/**
+ * @brief Gets the number of spawned tasks that have not finished.
+ *
+ * @returns The number of live spawned tasks.
+ */
+TcpInitializer::t_u64 TcpInitializer::Scheduler::GetTaskCount(void) const noexcept {
+    return this->_spawned.size();
+};
+
+/**
+ * @brief Gets the loop the scheduler runs on.
+ *
+ * @returns A reference to the loop.
+ */
+TcpInitializer::EventLoop &TcpInitializer::Scheduler::GetLoop(void) noexcept {
+    return *this->_loop;
+};
+
+/**
+ * @brief Gets the state of a socket, growing the table as needed.
+ *
+ * @param _sock The socket.
+ * @returns A reference to its state.
+ */
+TcpInitializer::Scheduler::IoState &TcpInitializer::Scheduler::_StateOf(const t_sock _sock) {
+    if (static_cast<std::size_t>(_sock) >= this->_states.size())
+        this->_states.resize(std::max<std::size_t>(static_cast<std::size_t>(_sock) + 1, this->_states.size() * 2));
+    return this->_states[_sock];
+};
+
+/**
+ * @brief Registers a connected socket with the loop, its readiness resumes the parked operations.
+ *
+ * @param _sock The connected socket.
+ * @returns true if the socket is watched, false otherwise.
+ */
+bool TcpInitializer::Scheduler::_Watch(const t_sock _sock) {
+    if (_sock < 0)
+        return false;
+    IoState &state(this->_StateOf(_sock));
+    if (state.watched)
+        return true;
+    EventLoop::IoHandlers handlers;
+    handlers.on_readable = [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnReady(_conn.sock, true); };
+    handlers.on_writable = [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnReady(_conn.sock, false); };
+    handlers.on_close = [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnClosed(_conn.sock); };
+    if (!this->_loop->AddConnection(ClientTcpConnection{_sock, true}, std::move(handlers)))
+        return false;
+    state.reader = nullptr;
+    state.writer = nullptr;
+    state.watched = true;
+    state.listener = false;
+    ++state.generation;
+    return true;
+};
+
+/**
+ * @brief Checks that a socket handle still refers to the connection it was created for.
+ *
+ * @param _sock The socket.
+ * @param _generation The generation recorded by the handle.
+ * @returns true if the socket is watched with that generation, false otherwise.
+ */
+bool TcpInitializer::Scheduler::_IsCurrent(const t_sock _sock, const t_u32 _generation) const noexcept {
+    return _sock >= 0 && static_cast<std::size_t>(_sock) < this->_states.size() && this->_states[_sock].watched && this->_states[_sock].generation == _generation;
+};
+
+/**
+ * @brief Parks an operation until its socket is ready.
+ *
+ * @param _sock The socket.
+ * @param _operation The operation, retried on readiness.
+ * @param _read true to wait for read readiness, false for write readiness.
+ */
+void TcpInitializer::Scheduler::_Park(const t_sock _sock, Operation *_operation, const bool _read) noexcept {
+    IoState &state(this->_states[_sock]);
+    if (_read) {
+        state.reader = _operation;
+    } else {
+        state.writer = _operation;
+        this->_loop->WantWrite(_sock, true);
+    }
+};
+
+/**
+ * @brief Retries the operation parked on a ready socket and resumes its coroutine once it completed.
+ *
+ * @param _sock The ready socket.
+ * @param _read true for read readiness, false for write readiness.
+ */
+void TcpInitializer::Scheduler::_OnReady(const t_sock _sock, const bool _read) noexcept {
+    IoState &state(this->_states[_sock]);
+    Operation *&slot(_read ? state.reader : state.writer);
+    if (slot == nullptr || !slot->Attempt())
+        return;
+    Operation *operation(slot);
+    slot = nullptr;
+    if (!_read)
+        this->_loop->WantWrite(_sock, false);
+    // the state may move once the coroutine runs, nothing of it is touched afterwards
+    operation->handle.resume();
+};
+
+/**
+ * @brief Queues a connection accepted by the loop and hands it to the waiting Accept, if any.
+ *
+ * @param _listen_sock The listening socket.
+ * @param _sock The accepted socket.
+ */
+void TcpInitializer::Scheduler::_OnAccepted(const t_sock _listen_sock, const t_sock _sock) {
+    this->_states[_listen_sock].backlog.push_back(_sock);
+    this->_OnReady(_listen_sock, true);
+};
+
+/**
+ * @brief Handles a socket the loop closed after a hang-up or error: parked operations fail.
+ *
+ * @param _sock The closed socket.
+ */
+void TcpInitializer::Scheduler::_OnClosed(const t_sock _sock) noexcept {
+    IoState &state(this->_states[_sock]);
+    state.watched = false;
+    ++state.generation;
+    this->_Cancel(state, ECONNRESET);
+};
+
+/**
+ * @brief Fails the operations parked on a socket; their coroutines resume at the end of the tick.
+ *
+ * @param _state The socket state.
+ * @param _error The errno reported to the operations.
+ */
+void TcpInitializer::Scheduler::_Cancel(IoState &_state, const int _error) noexcept {
+    for (Operation **slot : {&_state.reader, &_state.writer}) {
+        if (*slot == nullptr)
+            continue;
+        Operation *operation(*slot);
+        *slot = nullptr;
+        // while the scheduler is destroyed the frame owning the operation may be gone already
+        if (this->_closing)
+            continue;
+        operation->error = _error;
+        try {
+            this->_ResumeLater(operation->handle);
+        } catch (const t_except &e) {
+            TcpInitializer::Socket::Log("coroutine resume failure: ", e.what(), '\n');
+        }
+    }
+};
+
+/**
+ * @brief Resumes a coroutine at the end of the current tick, unless the scheduler is gone by then.
+ *
+ * @param _handle The suspended coroutine.
+ */
+void TcpInitializer::Scheduler::_ResumeLater(std::coroutine_handle<> _handle) {
+    std::weak_ptr<Scheduler *> token(this->_token);
+    this->_loop->Defer([token, _handle](EventLoop &) -> void {
+        if (!token.expired())
+            _handle.resume();
+    });
+};
+
+/**
+ * @brief Drops a finished spawned task from the live set.
+ *
+ * @param _frame The frame address of the task.
+ */
+void TcpInitializer::Scheduler::_Forget(void *_frame) noexcept {
+    this->_spawned.erase(_frame);
+};
+
+/**
+ * @brief Defers the coroutine to the end of the tick.
+ *
+ * @param _handle The yielding coroutine.
+ */
+void TcpInitializer::Scheduler::YieldAwaiter::await_suspend(std::coroutine_handle<> _handle) {
+    this->scheduler->_ResumeLater(_handle);
+};
+
+/**
+ * @brief Creates an accept awaiter.
+ *
+ * @param _scheduler The scheduler.
+ * @param _listen_sock The listening socket.
+ */
+TcpInitializer::Scheduler::AcceptAwaiter::AcceptAwaiter(Scheduler *_scheduler, const t_sock _listen_sock) noexcept : scheduler(_scheduler), listener(_listen_sock) {};
+
+/**
+ * @brief Completes once a connection is queued.
+ *
+ * @returns true if a connection is queued, false otherwise.
+ */
+bool TcpInitializer::Scheduler::AcceptAwaiter::Attempt(void) noexcept {
+    return !this->scheduler->_states[this->listener].backlog.empty();
+};
+
+/**
+ * @brief Registers the listener on first use and completes at once if a connection is queued.
+ *
+ * @returns true if the awaiter does not need to suspend, false otherwise.
+ */
+bool TcpInitializer::Scheduler::AcceptAwaiter::await_ready() noexcept {
+    if (this->listener < 0) {
+        this->error = EBADF;
+        return true;
+    }
+    try {
+        IoState &state(this->scheduler->_StateOf(this->listener));
+        if (!state.watched) {
+            Scheduler *owner(this->scheduler);
+            const t_sock listen_sock(this->listener);
+            if (!this->scheduler->_loop->AddListener(listen_sock, [owner, listen_sock](EventLoop &, ClientTcpConnection &_conn) -> void { owner->_OnAccepted(listen_sock, _conn.sock); })) {
+                this->error = errno != 0 ? errno : EBADF;
+                return true;
+            }
+            state.watched = true;
+            state.listener = true;
+            state.reader = nullptr;
+            ++state.generation;
+        }
+    } catch (const t_except &) {
+        this->error = ENOMEM;
+        return true;
+    }
+    return this->Attempt();
+};
+
+/**
+ * @brief Parks the awaiting coroutine on the listener.
+ *
+ * @param _handle The awaiting coroutine.
+ */
+void TcpInitializer::Scheduler::AcceptAwaiter::await_suspend(std::coroutine_handle<> _handle) noexcept {
+    this->handle = _handle;
+    this->scheduler->_Park(this->listener, this, true);
+};
+
+/**
+ * @brief Takes the next queued connection and starts watching it.
+ *
+ * @returns The accepted socket, invalid if the listener failed or was closed.
+ */
+TcpInitializer::AsyncSocket TcpInitializer::Scheduler::AcceptAwaiter::await_resume() noexcept {
+    if (this->error != 0) {
+        errno = this->error;
+        return AsyncSocket();
+    }
+    IoState &state(this->scheduler->_states[this->listener]);
+    const t_sock sock(state.backlog.front());
+    state.backlog.pop_front();
+    try {
+        AsyncSocket accepted(this->scheduler->Adopt(sock));
+        if (!accepted.IsValid())
+            close(sock);
+        return accepted;
+    } catch (const t_except &) {
+        close(sock);
+        errno = ENOMEM;
+        return AsyncSocket();
+    }
+};
+
+/**
+ * @brief Creates a connect awaiter.
+ *
+ * @param _scheduler The scheduler.
+ * @param _address The numeric IPv4 or IPv6 address.
+ * @param _port The port.
+ */
+TcpInitializer::Scheduler::ConnectAwaiter::ConnectAwaiter(Scheduler *_scheduler, const t_strw _address, const t_u16 _port) noexcept
+    : scheduler(_scheduler), address(), address_size(0), sock(-1), started(0), generation(0), parked(false), done(false) {
+    TcpInitializer::IpAddress target;
+    if (!TcpInitializer::AddressParser::ParseAddress(_address, target)) {
+        this->error = EINVAL;
+        return;
+    }
+    target.port = _port;
+    if (!TcpInitializer::AddressParser::ToSockAddr(target, this->address, this->address_size))
+        this->error = EINVAL;
+};
+
+/**
+ * @brief Completes once the pending connect reports its outcome.
+ *
+ * @returns true once the connect succeeded or failed, false while it is still in progress.
+ */
+bool TcpInitializer::Scheduler::ConnectAwaiter::Attempt(void) noexcept {
+    int error(0);
+    socklen_t error_size(sizeof(error));
+    if (getsockopt(this->sock, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0)
+        error = errno;
+    this->error = error;
+    this->done = error == 0;
+    return true;
+};
+
+/**
+ * @brief Starts the connect and completes at once when it does not go in progress.
+ *
+ * @returns true if the awaiter does not need to suspend, false otherwise.
+ */
+bool TcpInitializer::Scheduler::ConnectAwaiter::await_ready() noexcept {
+    if (this->error != 0)
+        return true;
+    TcpInitializer::Metrics::connects.Add();
+    this->started = TcpInitializer::Metrics::Now();
+    this->sock = socket(this->address.addr.sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (this->sock < 0) {
+        this->error = errno;
+        return true;
+    }
+    if (connect(this->sock, &this->address.addr, this->address_size) == 0) {
+        this->done = true;
+        return true;
+    }
+    if (errno != EINPROGRESS) {
+        this->error = errno;
+        return true;
+    }
+    try {
+        this->parked = this->scheduler->_Watch(this->sock);
+        if (!this->parked)
+            this->error = errno != 0 ? errno : EBADF;
+        else
+            this->generation = this->scheduler->_states[this->sock].generation;
+    } catch (const t_except &) {
+        this->error = ENOMEM;
+    }
+    return this->error != 0;
+};
+
+/**
+ * @brief Parks the awaiting coroutine until the socket turns writable.
+ *
+ * @param _handle The awaiting coroutine.
+ */
+void TcpInitializer::Scheduler::ConnectAwaiter::await_suspend(std::coroutine_handle<> _handle) noexcept {
+    this->handle = _handle;
+    this->scheduler->_Park(this->sock, this, false);
+};
+
+/**
+ * @brief Hands out the connected socket.
+ *
+ * @returns The connected socket, invalid if the connect failed (errno is set).
+ */
+TcpInitializer::AsyncSocket TcpInitializer::Scheduler::ConnectAwaiter::await_resume() noexcept {
+    if (this->error != 0) {
+        TcpInitializer::Metrics::connect_failures.Add();
+        // a socket the loop already closed after a hang-up may have been reused meanwhile
+        if (!this->parked && this->sock >= 0)
+            close(this->sock);
+        else if (this->parked && this->scheduler->_IsCurrent(this->sock, this->generation))
+            this->scheduler->_loop->CloseConnection(this->sock);
+        errno = this->error;
+        return AsyncSocket();
+    }
+    TcpInitializer::Metrics::connect_latency.Record(TcpInitializer::Metrics::Now() - this->started);
+    try {
+        AsyncSocket connected(this->scheduler->Adopt(this->sock));
+        if (!connected.IsValid())
+            close(this->sock);
+        return connected;
+    } catch (const t_except &) {
+        close(this->sock);
+        errno = ENOMEM;
+        return AsyncSocket();
+    }
+};
+
+/**
+ * @brief Creates an invalid socket handle.
+ */
+TcpInitializer::AsyncSocket::AsyncSocket(void) noexcept : _scheduler(nullptr), _socket(-1), _generation(0) {};
+
+/**
+ * @brief Creates a handle for a socket watched by a scheduler.
+ *
+ * @param _scheduler The scheduler watching the socket.
+ * @param _sock The socket.
+ * @param _generation The generation of the socket state.
+ */
+TcpInitializer::AsyncSocket::AsyncSocket(Scheduler *_scheduler, const t_sock _sock, const t_u32 _generation) noexcept : _scheduler(_scheduler), _socket(_sock), _generation(_generation) {};
+
+/**
+ * @brief Takes over the socket of another handle.
+ *
+ * @param _other The handle to move from, left invalid.
+ */
+TcpInitializer::AsyncSocket::AsyncSocket(AsyncSocket &&_other) noexcept
+    : _scheduler(std::exchange(_other._scheduler, nullptr)), _socket(std::exchange(_other._socket, -1)), _generation(_other._generation) {};
+
+/**
+ * @brief Closes the current socket and takes over the socket of another handle.
+ *
+ * @param _other The handle to move from, left invalid.
+ * @returns A reference to this handle.
+ */
+TcpInitializer::AsyncSocket &TcpInitializer::AsyncSocket::operator=(AsyncSocket &&_other) noexcept {
+    if (this != &_other) {
+        this->Close();
+        this->_scheduler = std::exchange(_other._scheduler, nullptr);
+        this->_socket = std::exchange(_other._socket, -1);
+        this->_generation = _other._generation;
+    }
+    return *this;
+};
+
+/**
+ * @brief Closes the socket.
+ */
+TcpInitializer::AsyncSocket::~AsyncSocket() {
+    this->Close();
+};
+
+/**
+ * @brief Awaits at least one byte.
+ *
+ * @param _buffer The destination.
+ * @param _size The destination capacity.
+ * @returns The awaiter, resuming with the number of bytes read, 0 at end of stream or -1 on error (errno is set).
+ */
+TcpInitializer::AsyncSocket::ReadAwaiter TcpInitializer::AsyncSocket::Read(char *_buffer, const std::size_t _size) noexcept {
+    ReadAwaiter awaiter;
+    awaiter.scheduler = this->_scheduler;
+    awaiter.sock = this->_socket;
+    awaiter.generation = this->_generation;
+    awaiter.buffer = _buffer;
+    awaiter.size = _size;
+    awaiter.result = -1;
+    return awaiter;
+};
+
+/**
+ * @brief Awaits until every byte of a buffer was written.
+ *
+ * @param _buffer The bytes to send, which must stay valid until the awaiter resumes.
+ * @returns The awaiter, resuming with true if everything was written, false on error (errno is set).
+ */
+TcpInitializer::AsyncSocket::SendAwaiter TcpInitializer::AsyncSocket::Send(const t_strw _buffer) noexcept {
+    SendAwaiter awaiter;
+    awaiter.scheduler = this->_scheduler;
+    awaiter.sock = this->_socket;
+    awaiter.generation = this->_generation;
+    awaiter.buffer = _buffer;
+    awaiter.done = false;
+    return awaiter;
+};
+
+/**
+ * @brief Checks that the handle refers to a socket that is still open.
+ *
+ * @returns true if the socket is open, false otherwise.
+ */
+bool TcpInitializer::AsyncSocket::IsValid(void) const noexcept {
+    return this->_scheduler != nullptr && this->_scheduler->_IsCurrent(this->_socket, this->_generation);
+};
+
+/**
+ * @brief Gets the socket descriptor.
+ *
+ * @returns The socket, or -1 for an invalid handle.
+ */
+t_sock TcpInitializer::AsyncSocket::GetSocket(void) const noexcept {
+    return this->_socket;
+};
+
+/**
+ * @brief Stops watching the socket and hands it over without closing it.
+ *
+ * @returns The socket, or -1 if the handle was invalid.
+ */
+t_sock TcpInitializer::AsyncSocket::Release(void) noexcept {
+    if (!this->IsValid()) {
+        this->_scheduler = nullptr;
+        this->_socket = -1;
+        return -1;
+    }
+    Scheduler::IoState &state(this->_scheduler->_states[this->_socket]);
+    this->_scheduler->_loop->Remove(this->_socket);
+    state.watched = false;
+    ++state.generation;
+    this->_scheduler->_Cancel(state, EBADF);
+    this->_scheduler = nullptr;
+    return std::exchange(this->_socket, -1);
+};
+
+/**
+ * @brief Closes the socket, operations still parked on it resume with EBADF.
+ */
+void TcpInitializer::AsyncSocket::Close(void) noexcept {
+    const t_sock sock(this->Release());
+    if (sock >= 0)
+        close(sock);
+};
+
+/**
+ * @brief Reads once, until data, end of stream or an error other than EAGAIN.
+ *
+ * @returns true once the read completed, false if the socket has no data yet.
+ */
+bool TcpInitializer::AsyncSocket::ReadAwaiter::Attempt(void) noexcept {
+    for (;;) {
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        const ssize_t tcp_read(recv(this->sock, this->buffer, this->size, MSG_DONTWAIT));
+        TcpInitializer::Metrics::read_latency.Record(TcpInitializer::Metrics::Now() - started);
+        if (tcp_read >= 0) {
+            TcpInitializer::Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+            TcpInitializer::ConnectionTable::AccountOwner(this->sock, static_cast<t_u64>(tcp_read), 0);
+            this->result = tcp_read;
+            return true;
+        }
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return false;
+        this->error = errno;
+        return true;
+    }
+};
+
+/**
+ * @brief Reads at once and only suspends when no data is available.
+ *
+ * @returns true if the read completed without suspending, false otherwise.
+ */
+bool TcpInitializer::AsyncSocket::ReadAwaiter::await_ready() noexcept {
+    if (this->scheduler == nullptr || !this->scheduler->_IsCurrent(this->sock, this->generation)) {
+        this->error = EBADF;
+        return true;
+    }
+    if (this->scheduler->_states[this->sock].reader != nullptr) {
+        this->error = EBUSY;
+        return true;
+    }
+    return this->Attempt();
+};
+
+/**
+ * @brief Parks the awaiting coroutine until the socket is readable.
+ *
+ * @param _handle The awaiting coroutine.
+ */
+void TcpInitializer::AsyncSocket::ReadAwaiter::await_suspend(std::coroutine_handle<> _handle) noexcept {
+    this->handle = _handle;
+    this->scheduler->_Park(this->sock, this, true);
+};
+
+/**
+ * @brief Reports the read.
+ *
+ * @returns The number of bytes read, 0 at end of stream or -1 on error (errno is set).
+ */
+ssize_t TcpInitializer::AsyncSocket::ReadAwaiter::await_resume() noexcept {
+    if (this->error != 0) {
+        errno = this->error;
+        return -1;
+    }
+    return this->result;
+};
+
+/**
+ * @brief Writes as much as the socket accepts.
+ *
+ * @returns true once everything was written or the write failed, false while the socket is full.
+ */
+bool TcpInitializer::AsyncSocket::SendAwaiter::Attempt(void) noexcept {
+    while (!this->buffer.empty()) {
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        const ssize_t tcp_sent(send(this->sock, this->buffer.data(), this->buffer.size(), MSG_NOSIGNAL | MSG_DONTWAIT));
+        TcpInitializer::Metrics::send_latency.Record(TcpInitializer::Metrics::Now() - started);
+        if (tcp_sent > 0) {
+            TcpInitializer::Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+            TcpInitializer::ConnectionTable::AccountOwner(this->sock, 0, static_cast<t_u64>(tcp_sent));
+            this->buffer.remove_prefix(static_cast<std::size_t>(tcp_sent));
+            continue;
+        }
+        if (tcp_sent < 0 && errno == EINTR)
+            continue;
+        if (tcp_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return false;
+        this->error = tcp_sent < 0 ? errno : EPIPE;
+        return true;
+    }
+    this->done = true;
+    return true;
+};
+
+/**
+ * @brief Writes at once and only suspends when the socket buffer is full.
+ *
+ * @returns true if the send completed without suspending, false otherwise.
+ */
+bool TcpInitializer::AsyncSocket::SendAwaiter::await_ready() noexcept {
+    if (this->scheduler == nullptr || !this->scheduler->_IsCurrent(this->sock, this->generation)) {
+        this->error = EBADF;
+        return true;
+    }
+    if (this->scheduler->_states[this->sock].writer != nullptr) {
+        this->error = EBUSY;
+        return true;
+    }
+    return this->Attempt();
+};
+
+/**
+ * @brief Parks the awaiting coroutine until the socket is writable.
+ *
+ * @param _handle The awaiting coroutine.
+ */
+void TcpInitializer::AsyncSocket::SendAwaiter::await_suspend(std::coroutine_handle<> _handle) noexcept {
+    this->handle = _handle;
+    this->scheduler->_Park(this->sock, this, false);
+};
+
+/**
+ * @brief Reports the send.
+ *
+ * @returns true if every byte was written, false on error (errno is set).
+ */
+bool TcpInitializer::AsyncSocket::SendAwaiter::await_resume() noexcept {
+    if (this->error != 0) {
+        errno = this->error;
+        return false;
+    }
+    return this->done;
+};
+
+#endif
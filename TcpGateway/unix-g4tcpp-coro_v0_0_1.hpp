@@ -0,0 +1,391 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_CORO_V0_0_1_HPP
+#define UNIX_G4TCPP_CORO_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "unix-g4tcpp-coro requires C++20 coroutines, compile with -std=c++20"
+#endif
+
+#include <coroutine>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+
+namespace TcpInitializer
+{
+
+#define CORO_FRAME_SIZE_STEP           64u
+#define CORO_FRAME_SIZE_CLASSES        128u
+#define DEFAULT_CORO_FRAME_CACHE       4096u
+
+/**
+ * Per-thread free lists for coroutine frames.
+ *
+ * Frames are rounded up to CORO_FRAME_SIZE_STEP bytes and recycled by size class, so spawning a
+ * coroutine per connection reuses the frame of a finished one instead of calling malloc. Frames
+ * larger than CORO_FRAME_SIZE_CLASSES steps go to the global allocator. Each class keeps at most
+ * DEFAULT_CORO_FRAME_CACHE frames per thread; the rest is freed.
+ */
+class FramePool
+{
+  public:
+    __attribute__((hot, malloc, warn_unused_result                 ))  inline static        void   *Allocate                (const std::size_t _size);
+    __attribute__((hot                                             ))  inline static        void    Release                 (void *_frame, const std::size_t _size) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_u64   GetCachedCount          (void) noexcept;
+
+  protected:
+    typedef struct FreeFrame
+    {
+        FreeFrame         *next       {                                                    };
+    } FreeFrame;
+
+    typedef struct alignas(void *)
+    {
+        FreeFrame         *head       {                                                    };
+        t_u32              count      {                                                    };
+    } FreeList;
+
+    __attribute__((hot, warn_unused_result                         ))  inline static        FreeList *_Lists                (void) noexcept;
+};
+
+class Scheduler;
+
+/**
+ * State shared by every task promise: the awaiting coroutine, a captured exception, and for
+ * tasks handed to Scheduler::Spawn the scheduler that owns the frame.
+ */
+class TaskPromiseBase
+{
+  public:
+    std::coroutine_handle<>                               continuation;
+    std::exception_ptr                                    exception;
+    Scheduler                                            *scheduler { nullptr };
+
+    /**
+     * Resumes the awaiting coroutine, or releases the frame of a spawned task.
+     */
+    class FinalAwaiter
+    {
+      public:
+        bool await_ready() const noexcept { return false; };
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> _handle) noexcept;
+        void await_resume() const noexcept {};
+    };
+
+    static void *operator new(const std::size_t _size) { return FramePool::Allocate(_size); };
+    static void  operator delete(void *_frame, const std::size_t _size) noexcept { FramePool::Release(_frame, _size); };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; };
+    FinalAwaiter        final_suspend() const noexcept { return {}; };
+    void                unhandled_exception() noexcept { this->exception = std::current_exception(); };
+};
+
+template <typename T> class Task;
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+  public:
+    std::optional<T>                                      value;
+
+    Task<T> get_return_object() noexcept;
+    template <typename U>
+    void return_value(U &&_value) { this->value.emplace(std::forward<U>(_value)); };
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+  public:
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {};
+};
+
+/**
+ * Lazily started coroutine producing a T.
+ *
+ * The body runs when the task is awaited, control returns to the awaiting coroutine by symmetric
+ * transfer when it finishes, and exceptions are rethrown at the co_await. A task that is never
+ * awaited is destroyed with its Task object. Scheduler::Spawn runs a Task<void> on its own.
+ */
+template <typename T = void>
+class Task
+{
+  public:
+    using promise_type = TaskPromise<T>;
+    using handle_type  = std::coroutine_handle<promise_type>;
+
+  protected:
+    handle_type                                           _handle;
+
+  public:
+    Task(void) noexcept : _handle() {};
+    explicit Task(const handle_type _handle) noexcept : _handle(_handle) {};
+    Task(Task &&_other) noexcept : _handle(std::exchange(_other._handle, nullptr)) {};
+    Task &operator=(Task &&_other) noexcept
+    {
+        if (this != &_other) {
+            if (this->_handle)
+                this->_handle.destroy();
+            this->_handle = std::exchange(_other._handle, nullptr);
+        }
+        return *this;
+    };
+    Task(const Task &)            = delete;
+    Task &operator=(const Task &) = delete;
+    ~Task()
+    {
+        if (this->_handle)
+            this->_handle.destroy();
+    };
+
+    bool IsValid(void) const noexcept { return static_cast<bool>(this->_handle); };
+    bool IsDone(void) const noexcept { return !this->_handle || this->_handle.done(); };
+    handle_type Release(void) noexcept { return std::exchange(this->_handle, nullptr); };
+
+    auto operator co_await() && noexcept
+    {
+        typedef struct
+        {
+            handle_type handle;
+            bool await_ready() const noexcept { return !handle || handle.done(); };
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> _awaiting) noexcept
+            {
+                handle.promise().continuation = _awaiting;
+                return handle;
+            };
+            T await_resume()
+            {
+                if (handle.promise().exception)
+                    std::rethrow_exception(handle.promise().exception);
+                if constexpr (!std::is_void_v<T>)
+                    return std::move(*handle.promise().value);
+            };
+        } Awaiter;
+        return Awaiter{this->_handle};
+    };
+};
+
+class AsyncSocket;
+
+/**
+ * Runs coroutines on an EventLoop: sockets are awaited for readiness instead of blocking a thread.
+ *
+ * Every operation first tries its syscall and only suspends on EAGAIN; the loop resumes the
+ * coroutine once the socket is ready and the retried syscall completed, so a single loop thread
+ * serves any number of sessions written as straight-line code. One read and one write may be
+ * pending per socket at a time, and one Accept per listener. Tasks still suspended when the
+ * scheduler is destroyed are destroyed with it.
+ */
+class Scheduler
+{
+  friend class AsyncSocket;
+  friend class TaskPromiseBase;
+  public:
+    /**
+     * Pending operation parked on a socket, retried by the readiness callbacks until it completes.
+     */
+    class Operation
+    {
+      public:
+        std::coroutine_handle<>                           handle;
+        int                                               error { 0 };
+
+        virtual ~Operation() = default;
+        virtual bool Attempt(void) noexcept = 0;
+    };
+
+    class AcceptAwaiter final : public Operation
+    {
+      public:
+        Scheduler                                        *scheduler;
+        t_sock                                            listener;
+
+        AcceptAwaiter(Scheduler *_scheduler, const t_sock _listen_sock) noexcept;
+        bool Attempt(void) noexcept override;
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> _handle) noexcept;
+        AsyncSocket await_resume() noexcept;
+    };
+
+    class ConnectAwaiter final : public Operation
+    {
+      public:
+        Scheduler                                        *scheduler;
+        PeerAddress                                       address;
+        socklen_t                                         address_size;
+        t_sock                                            sock;
+        t_u64                                             started;
+        t_u32                                             generation;
+        bool                                              parked;
+        bool                                              done;
+
+        ConnectAwaiter(Scheduler *_scheduler, const t_strw _address, const t_u16 _port) noexcept;
+        bool Attempt(void) noexcept override;
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> _handle) noexcept;
+        AsyncSocket await_resume() noexcept;
+    };
+
+    class YieldAwaiter
+    {
+      public:
+        Scheduler                                        *scheduler;
+
+        bool await_ready() const noexcept { return false; };
+        void await_suspend(std::coroutine_handle<> _handle);
+        void await_resume() const noexcept {};
+    };
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        Operation         *reader      {                                                    };
+        Operation         *writer      {                                                    };
+        std::deque<t_sock> backlog     {                                                    };
+        t_u32              generation  {                                                    };
+        bool               watched     {                                                    };
+        bool               listener    {                                                    };
+    } IoState;
+
+    EventLoop                                            *_loop;
+    std::deque<IoState>                                   _states;
+    std::unordered_set<void *>                            _spawned;
+    std::shared_ptr<Scheduler *>                          _token;
+    bool                                                  _closing;
+
+  public:
+    __attribute__((cold                                            ))  explicit                Scheduler               (EventLoop &_loop);
+    Scheduler(const Scheduler &)            = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    __attribute__((cold                                            ))                          ~Scheduler              ();
+
+    __attribute__((hot                                             ))  inline               void    Spawn                   (Task<void> &&_task);
+    __attribute__((hot, warn_unused_result                         ))  inline               AcceptAwaiter  Accept           (const t_sock _listen_sock) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               ConnectAwaiter Connect          (const t_strw _address, const t_u16 _port) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               YieldAwaiter   Yield            (void) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               AsyncSocket    Adopt            (const t_sock _sock);
+    __attribute__((cold                                            ))  inline               void    CloseListener           (const t_sock _listen_sock) noexcept;
+    __attribute__((cold                                            ))  inline               void    Run                     (void);
+    __attribute__((cold                                            ))  inline               void    Stop                    (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetTaskCount            (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               EventLoop &GetLoop              (void) noexcept;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               IoState &_StateOf               (const t_sock _sock);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _Watch                  (const t_sock _sock);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _IsCurrent              (const t_sock _sock, const t_u32 _generation) const noexcept;
+    __attribute__((hot                                             ))  inline               void    _Park                   (const t_sock _sock, Operation *_operation, const bool _read) noexcept;
+    __attribute__((hot                                             ))  inline               void    _OnReady                (const t_sock _sock, const bool _read) noexcept;
+    __attribute__((hot                                             ))  inline               void    _OnAccepted             (const t_sock _listen_sock, const t_sock _sock);
+    __attribute__((cold                                            ))  inline               void    _OnClosed               (const t_sock _sock) noexcept;
+    __attribute__((cold                                            ))  inline               void    _Cancel                 (IoState &_state, const int _error) noexcept;
+    __attribute__((hot                                             ))  inline               void    _ResumeLater            (std::coroutine_handle<> _handle);
+    __attribute__((cold                                            ))  inline               void    _Forget                 (void *_frame) noexcept;
+};
+
+/**
+ * Connected socket owned by a coroutine, closed when it goes out of scope.
+ *
+ * The handle remembers the generation of the socket it was created for, so once the socket was
+ * closed (by the peer hanging up or by Close) and its descriptor reused, stale handles fail with
+ * EBADF instead of touching the new connection.
+ */
+class AsyncSocket
+{
+  public:
+    class ReadAwaiter final : public Scheduler::Operation
+    {
+      public:
+        Scheduler                                        *scheduler;
+        t_sock                                            sock;
+        t_u32                                             generation;
+        char                                             *buffer;
+        std::size_t                                       size;
+        ssize_t                                           result;
+
+        bool Attempt(void) noexcept override;
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> _handle) noexcept;
+        ssize_t await_resume() noexcept;
+    };
+
+    class SendAwaiter final : public Scheduler::Operation
+    {
+      public:
+        Scheduler                                        *scheduler;
+        t_sock                                            sock;
+        t_u32                                             generation;
+        t_strw                                            buffer;
+        bool                                              done;
+
+        bool Attempt(void) noexcept override;
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> _handle) noexcept;
+        bool await_resume() noexcept;
+    };
+
+  protected:
+    Scheduler                                            *_scheduler;
+    t_sock                                                _socket;
+    t_u32                                                 _generation;
+
+  public:
+    __attribute__((hot                                             ))                          AsyncSocket             (void) noexcept;
+    __attribute__((hot                                             ))                          AsyncSocket             (Scheduler *_scheduler, const t_sock _sock, const t_u32 _generation) noexcept;
+    __attribute__((hot                                             ))                          AsyncSocket             (AsyncSocket &&_other) noexcept;
+    __attribute__((hot                                             ))  inline               AsyncSocket &operator=  (AsyncSocket &&_other) noexcept;
+    AsyncSocket(const AsyncSocket &)            = delete;
+    AsyncSocket &operator=(const AsyncSocket &) = delete;
+    __attribute__((hot                                             ))                          ~AsyncSocket            ();
+
+    __attribute__((hot, warn_unused_result                         ))  inline               ReadAwaiter Read            (char *_buffer, const std::size_t _size) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               SendAwaiter Send            (const t_strw _buffer) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsValid                 (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               t_sock  GetSocket               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Release                 (void) noexcept;
+    __attribute__((hot                                             ))  inline               void    Close                   (void) noexcept;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+};
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+};
+
+template <typename Promise>
+std::coroutine_handle<> TaskPromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<Promise> _handle) noexcept
+{
+    TaskPromiseBase &promise(_handle.promise());
+    if (promise.scheduler != nullptr) {
+        // spawned task: nobody awaits it, the frame is released here
+        if (promise.exception) {
+            try {
+                std::rethrow_exception(promise.exception);
+            } catch (const t_except &e) {
+                TcpInitializer::Socket::Log("coroutine failure: ", e.what(), '\n');
+            } catch (...) {
+                TcpInitializer::Socket::Log("coroutine failure\n");
+            }
+        }
+        promise.scheduler->_Forget(_handle.address());
+        _handle.destroy();
+        return std::noop_coroutine();
+    }
+    if (promise.continuation)
+        return promise.continuation;
+    return std::noop_coroutine();
+};
+
+}; // namespace TcpInitializer
+
+#endif
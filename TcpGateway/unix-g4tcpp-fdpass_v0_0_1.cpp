@@ -0,0 +1,242 @@
+#ifndef UNIX_G4TCPP_FDPASS_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-fdpass_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Constructs a channel without socket.
+ */
+TcpInitializer::FdChannel::FdChannel(void) noexcept : _socket(-1), _sent(0), _received(0) {};
+
+/**
+ * @brief Adopts a connected Unix domain socket as channel.
+ *
+ * @param _sock The socket, closed with the channel.
+ */
+TcpInitializer::FdChannel::FdChannel(const t_sock _sock) noexcept : _socket(_sock), _sent(0), _received(0) {};
+
+/**
+ * @brief Closes the channel socket.
+ */
+TcpInitializer::FdChannel::~FdChannel() {
+    this->Close();
+};
+
+/**
+ * @brief Connects two channels with a seqpacket socketpair, to be split across a fork.
+ *
+ * @param _first Receives one end, any socket it held is closed.
+ * @param _second Receives the other end, any socket it held is closed.
+ * @returns true if the pair was created, false otherwise (errno set by socketpair).
+ */
+bool TcpInitializer::FdChannel::Pair(FdChannel &_first, FdChannel &_second) noexcept {
+    int ends[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, ends) < 0)
+        return false;
+    _first.Close();
+    _second.Close();
+    _first._socket = ends[0];
+    _second._socket = ends[1];
+    return true;
+};
+
+/**
+ * @brief Sends descriptors and a payload as one message; the sender keeps its own copies open.
+ *
+ * @param _fds The descriptors to pass.
+ * @param _count The number of descriptors, at most DEFAULT_FDPASS_MAX_FDS.
+ * @param _payload Bytes delivered with the descriptors, at most DEFAULT_FDPASS_PAYLOAD_MAX.
+ * @returns true if the message was sent, false otherwise (errno EINVAL or EMSGSIZE for bad arguments, else from sendmsg).
+ */
+bool TcpInitializer::FdChannel::SendFds(const t_sock *_fds, const std::size_t _count, const t_strw _payload) noexcept {
+    if (this->_socket < 0) {
+        errno = EBADF;
+        return false;
+    }
+    if ((_fds == nullptr && _count > 0) || _count > DEFAULT_FDPASS_MAX_FDS || _payload.size() > DEFAULT_FDPASS_PAYLOAD_MAX) {
+        errno = _count > DEFAULT_FDPASS_MAX_FDS || _payload.size() > DEFAULT_FDPASS_PAYLOAD_MAX ? EMSGSIZE : EINVAL;
+        return false;
+    }
+    // the leading count byte makes every message non-empty, SCM_RIGHTS needs at least one data byte
+    t_u8 header(static_cast<t_u8>(_count));
+    struct iovec fd_iov[2];
+    fd_iov[0].iov_base = &header;
+    fd_iov[0].iov_len = 1;
+    fd_iov[1].iov_base = const_cast<char *>(_payload.data());
+    fd_iov[1].iov_len = _payload.size();
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * DEFAULT_FDPASS_MAX_FDS)];
+    struct msghdr fd_msg;
+    memset(&fd_msg, 0, sizeof(fd_msg));
+    fd_msg.msg_iov = fd_iov;
+    fd_msg.msg_iovlen = _payload.empty() ? 1 : 2;
+    if (_count > 0) {
+        memset(control, 0, sizeof(control));
+        fd_msg.msg_control = control;
+        fd_msg.msg_controllen = CMSG_SPACE(sizeof(int) * _count);
+        struct cmsghdr *fd_cmsg(CMSG_FIRSTHDR(&fd_msg));
+        fd_cmsg->cmsg_level = SOL_SOCKET;
+        fd_cmsg->cmsg_type = SCM_RIGHTS;
+        fd_cmsg->cmsg_len = CMSG_LEN(sizeof(int) * _count);
+        memcpy(CMSG_DATA(fd_cmsg), _fds, sizeof(int) * _count);
+    }
+    ssize_t fd_sent(-1);
+    do {
+        fd_sent = sendmsg(this->_socket, &fd_msg, MSG_NOSIGNAL);
+    } while (fd_sent < 0 && errno == EINTR);
+    if (fd_sent < 0)
+        return false;
+    // a stream channel may take part of the payload, the descriptors travelled with the first byte
+    if (static_cast<std::size_t>(fd_sent) < 1 + _payload.size() && !TcpInitializer::Socket::Send(&this->_socket, _payload.substr(static_cast<std::size_t>(fd_sent) - 1)))
+        return false;
+    this->_sent += _count;
+    return true;
+};
+
+/**
+ * @brief Hands one descriptor over and closes the local copy, so the receiver owns the connection alone.
+ *
+ * @param _fd The descriptor, set to -1 once transferred.
+ * @param _payload Bytes delivered with the descriptor, e.g. what was already read from the client.
+ * @param _listener The listener that accepted the descriptor; its session is closed so the connection limit is kept exact.
+ * @returns true if the descriptor was transferred, false otherwise (the descriptor stays open).
+ */
+bool TcpInitializer::FdChannel::Transfer(t_sock &_fd, const t_strw _payload, TcpListener *_listener) noexcept {
+    if (!this->SendFds(&_fd, 1, _payload))
+        return false;
+    if (_listener != nullptr)
+        _listener->CloseSession(_fd);
+    else
+        close(_fd);
+    _fd = -1;
+    return true;
+};
+
+/**
+ * @brief Receives one message and the descriptors it carries.
+ *
+ * @param _fds Receives the descriptors, owned by the caller.
+ * @param _max Capacity of _fds; a message carrying more is rejected and its descriptors closed.
+ * @param _count Set to the number of descriptors received.
+ * @param _payload If not null, set to the bytes sent with the descriptors.
+ * @returns true if a message was received, false otherwise (errno ENOTCONN once the peer closed, EMSGSIZE for a rejected message).
+ */
+bool TcpInitializer::FdChannel::ReceiveFds(t_sock *_fds, const std::size_t _max, std::size_t &_count, t_str *_payload) {
+    _count = 0;
+    if (this->_socket < 0 || (_fds == nullptr && _max > 0)) {
+        errno = this->_socket < 0 ? EBADF : EINVAL;
+        return false;
+    }
+    const std::size_t room(std::min<std::size_t>(_max, DEFAULT_FDPASS_MAX_FDS));
+    t_u8 header(0);
+    char data[DEFAULT_FDPASS_PAYLOAD_MAX];
+    struct iovec fd_iov[2];
+    fd_iov[0].iov_base = &header;
+    fd_iov[0].iov_len = 1;
+    fd_iov[1].iov_base = data;
+    fd_iov[1].iov_len = sizeof(data);
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * DEFAULT_FDPASS_MAX_FDS)];
+    struct msghdr fd_msg;
+    memset(&fd_msg, 0, sizeof(fd_msg));
+    fd_msg.msg_iov = fd_iov;
+    fd_msg.msg_iovlen = 2;
+    fd_msg.msg_control = control;
+    fd_msg.msg_controllen = room > 0 ? CMSG_SPACE(sizeof(int) * room) : 0;
+    ssize_t fd_read(-1);
+    do {
+        fd_read = recvmsg(this->_socket, &fd_msg, MSG_CMSG_CLOEXEC);
+    } while (fd_read < 0 && errno == EINTR);
+    if (fd_read <= 0) {
+        if (fd_read == 0)
+            errno = ENOTCONN;
+        return false;
+    }
+    std::size_t received(0);
+    for (struct cmsghdr *fd_cmsg = CMSG_FIRSTHDR(&fd_msg); fd_cmsg != nullptr; fd_cmsg = CMSG_NXTHDR(&fd_msg, fd_cmsg)) {
+        if (fd_cmsg->cmsg_level != SOL_SOCKET || fd_cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+        const std::size_t carried((fd_cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        const std::size_t kept(std::min(carried, room - received));
+        memcpy(_fds + received, CMSG_DATA(fd_cmsg), sizeof(int) * kept);
+        received += kept;
+    }
+    if ((fd_msg.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) != 0) {
+        // the kernel already dropped the descriptors that did not fit, the ones that did go too
+        for (std::size_t i = 0; i < received; ++i) {
+            close(_fds[i]);
+        }
+        errno = EMSGSIZE;
+        return false;
+    }
+    if (_payload != nullptr)
+        _payload->assign(data, static_cast<std::size_t>(fd_read) - 1);
+    _count = received;
+    this->_received += received;
+    return true;
+};
+
+/**
+ * @brief Receives a message carrying one descriptor, as sent by Transfer.
+ *
+ * @param _payload If not null, set to the bytes sent with the descriptor.
+ * @returns The descriptor, -1 on error (errno ENOMSG for a message without descriptor).
+ */
+TcpInitializer::t_sock TcpInitializer::FdChannel::Receive(t_str *_payload) {
+    t_sock fd(-1);
+    std::size_t count(0);
+    if (!this->ReceiveFds(&fd, 1, count, _payload))
+        return -1;
+    if (count == 0) {
+        errno = ENOMSG;
+        return -1;
+    }
+    return fd;
+};
+
+/**
+ * @brief Gets the number of descriptors sent.
+ *
+ * @returns The sent descriptor count.
+ */
+TcpInitializer::t_u64 TcpInitializer::FdChannel::GetSentCount(void) const noexcept {
+    return this->_sent;
+};
+
+/**
+ * @brief Gets the number of descriptors received.
+ *
+ * @returns The received descriptor count.
+ */
+TcpInitializer::t_u64 TcpInitializer::FdChannel::GetReceivedCount(void) const noexcept {
+    return this->_received;
+};
+
+/**
+ * @brief Gets the channel socket, e.g. to wait for messages with an EventLoop.
+ *
+ * @returns The socket, -1 if none.
+ */
+t_sock TcpInitializer::FdChannel::GetSocket(void) const noexcept {
+    return this->_socket;
+};
+
+/**
+ * @brief Gives up the channel socket without closing it.
+ *
+ * @returns The socket, -1 if none.
+ */
+t_sock TcpInitializer::FdChannel::Release(void) noexcept {
+    return std::exchange(this->_socket, -1);
+};
+
+/**
+ * @brief Closes the channel socket; the peer's next receive reports ENOTCONN.
+ */
+void TcpInitializer::FdChannel::Close(void) noexcept {
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = -1;
+};
+
+#endif
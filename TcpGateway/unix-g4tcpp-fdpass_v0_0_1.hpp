@@ -0,0 +1,55 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_FDPASS_V0_0_1_HPP
+#define UNIX_G4TCPP_FDPASS_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+#include <utility>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_FDPASS_MAX_FDS         64u
+#define DEFAULT_FDPASS_PAYLOAD_MAX     4096u
+
+/**
+ * Unix domain channel carrying open descriptors between processes with SCM_RIGHTS.
+ *
+ * Lets one acceptor process hand accepted client connections to worker processes: the worker
+ * receives its own descriptor for the same connection and serves it directly, nothing is proxied.
+ * A channel is made with Pair before fork, or by adopting either end of a "unixpacket:" connection
+ * (TcpListener::Accept on the acceptor, TcpConnection::Release on the worker). Each message holds
+ * up to DEFAULT_FDPASS_MAX_FDS descriptors and an optional payload, e.g. bytes the acceptor already
+ * read from the client; on a seqpacket channel every receive returns exactly one message, on a
+ * stream channel payloads may be split or merged. Received descriptors are close-on-exec. A
+ * channel has one owner thread per direction.
+ */
+class FdChannel
+{
+  protected:
+    t_sock                                                _socket;
+    t_u64                                                 _sent;
+    t_u64                                                 _received;
+
+  public:
+    __attribute__((cold                                            ))                          FdChannel               (void) noexcept;
+    __attribute__((cold                                            ))  explicit                FdChannel               (const t_sock _sock) noexcept;
+    FdChannel(const FdChannel &)            = delete;
+    FdChannel &operator=(const FdChannel &) = delete;
+    __attribute__((cold                                            ))                          ~FdChannel              ();
+
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    Pair                    (FdChannel &_first, FdChannel &_second) noexcept;
+    __attribute__((hot                                             ))  inline               bool    SendFds                 (const t_sock *_fds, const std::size_t _count, const t_strw _payload = t_strw()) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Transfer                (t_sock &_fd, const t_strw _payload = t_strw(), TcpListener *_listener = nullptr) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    ReceiveFds              (t_sock *_fds, const std::size_t _max, std::size_t &_count, t_str *_payload = nullptr);
+    __attribute__((hot, warn_unused_result                         ))  inline               t_sock  Receive                 (t_str *_payload = nullptr);
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetSentCount            (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetReceivedCount        (void) const noexcept;
+    __attribute__((pure, warn_unused_result                        ))  inline               t_sock  GetSocket               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Release                 (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Close                   (void) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef UNIX_G4TCPP_FRAMING_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-framing_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates a length-prefixed codec.
+ *
+ * @param _prefix Encoding of the length field.
+ * @param _max_frame Largest accepted payload, longer frames are reported as malformed.
+ */
+TcpInitializer::LengthPrefixCodec::LengthPrefixCodec(const LengthPrefix _prefix, const t_u64 _max_frame) noexcept : _prefix(_prefix), _max_frame(_max_frame) {};
+
+/**
+ * @brief Decodes the length field and checks whether the whole payload is buffered.
+ *
+ * @param _data Start of the next frame.
+ * @param _size Number of buffered bytes from _data.
+ * @param _consumed Set to the wire size of the frame when READY.
+ * @param _payload Set to the payload when READY.
+ * @returns The decoding status.
+ */
+TcpInitializer::FrameStatus TcpInitializer::LengthPrefixCodec::Decode(const char *_data, const t_u64 _size, t_u64 &_consumed, t_strw &_payload) {
+    t_u64 length(0), header(0);
+    if (this->_prefix == LengthPrefix::U32_BE) {
+        if (_size < sizeof(t_u32))
+            return FrameStatus::INCOMPLETE;
+        t_u32 wire;
+        memcpy(&wire, _data, sizeof(wire));
+        length = ntohl(wire);
+        header = sizeof(t_u32);
+    } else {
+        for (t_u32 shift = 0;; shift += 7) {
+            if (header == _size)
+                return FrameStatus::INCOMPLETE;
+            if (header == FRAME_VARINT_MAX_BYTES)
+                return FrameStatus::MALFORMED;
+            const unsigned char byte(static_cast<unsigned char>(_data[header++]));
+            length |= static_cast<t_u64>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+    }
+    if (length > this->_max_frame)
+        return FrameStatus::MALFORMED;
+    if (_size - header < length)
+        return FrameStatus::INCOMPLETE;
+    _consumed = header + length;
+    _payload = t_strw(_data + header, length);
+    return FrameStatus::READY;
+};
+
+/**
+ * @brief Appends the length field followed by the payload.
+ *
+ * @param _payload The payload to frame.
+ * @param _dest The string receiving the encoded frame.
+ */
+void TcpInitializer::LengthPrefixCodec::Encode(const t_strw _payload, t_str &_dest) const {
+    if (this->_prefix == LengthPrefix::U32_BE) {
+        const t_u32 wire(htonl(static_cast<t_u32>(_payload.size())));
+        _dest.append(reinterpret_cast<const char *>(&wire), sizeof(wire));
+    } else {
+        t_u64 length(_payload.size());
+        do {
+            const unsigned char byte(static_cast<unsigned char>(length & 0x7f));
+            length >>= 7;
+            _dest.push_back(static_cast<char>(length > 0 ? (byte | 0x80) : byte));
+        } while (length > 0);
+    }
+    _dest.append(_payload.data(), _payload.size());
+};
+
+/**
+ * @brief Creates a delimiter codec.
+ *
+ * @param _delimiter The frame terminator, must not be empty.
+ * @param _max_frame Largest accepted payload, longer frames are reported as malformed.
+ * @throws std::invalid_argument If the delimiter is empty.
+ */
+TcpInitializer::DelimiterCodec::DelimiterCodec(const t_strw _delimiter, const t_u64 _max_frame) : _delimiter(_delimiter), _max_frame(_max_frame), _scanned(0) {
+    if (this->_delimiter.empty())
+        throw std::invalid_argument("empty frame delimiter");
+};
+
+/**
+ * @brief Searches the buffered bytes for the delimiter, resuming where the previous call stopped.
+ *
+ * @param _data Start of the next frame.
+ * @param _size Number of buffered bytes from _data.
+ * @param _consumed Set to the wire size of the frame when READY.
+ * @param _payload Set to the payload when READY.
+ * @returns The decoding status.
+ */
+TcpInitializer::FrameStatus TcpInitializer::DelimiterCodec::Decode(const char *_data, const t_u64 _size, t_u64 &_consumed, t_strw &_payload) {
+    const t_u64 delimiter_size(this->_delimiter.size());
+    // a delimiter may straddle the previous end of data, step back so it is not missed
+    const t_u64 from(this->_scanned >= delimiter_size ? this->_scanned - (delimiter_size - 1) : 0);
+    if (from < _size) {
+        const void *found(memmem(_data + from, _size - from, this->_delimiter.data(), delimiter_size));
+        if (found != nullptr) {
+            const t_u64 length(static_cast<const char *>(found) - _data);
+            this->_scanned = 0;
+            if (length > this->_max_frame)
+                return FrameStatus::MALFORMED;
+            _consumed = length + delimiter_size;
+            _payload = t_strw(_data, length);
+            return FrameStatus::READY;
+        }
+    }
+    this->_scanned = _size;
+    return _size > this->_max_frame + delimiter_size ? FrameStatus::MALFORMED : FrameStatus::INCOMPLETE;
+};
+
+/**
+ * @brief Appends the payload followed by the delimiter.
+ *
+ * @param _payload The payload to frame, must not contain the delimiter.
+ * @param _dest The string receiving the encoded frame.
+ */
+void TcpInitializer::DelimiterCodec::Encode(const t_strw _payload, t_str &_dest) const {
+    _dest.append(_payload.data(), _payload.size());
+    _dest.append(this->_delimiter);
+};
+
+/**
+ * @brief Forgets how far the current incomplete frame was scanned.
+ */
+void TcpInitializer::DelimiterCodec::Reset(void) noexcept {
+    this->_scanned = 0;
+};
+
+/**
+ * @brief Maps a memfd twice in a row so the ring contents are always contiguous.
+ *
+ * @param _capacity Requested capacity, rounded up to the page size.
+ * @throws std::runtime_error If the memfd or one of the mappings cannot be created.
+ */
+TcpInitializer::RingBuffer::RingBuffer(const t_u64 _capacity) : _base(nullptr), _capacity(0), _head(0), _tail(0) {
+    const t_u64 page(static_cast<t_u64>(sysconf(_SC_PAGESIZE)));
+    this->_capacity = (std::max<t_u64>(_capacity, 1) + page - 1) / page * page;
+    const t_sock memory_fd(memfd_create("tcpgateway-ring", MFD_CLOEXEC));
+    if (memory_fd < 0)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("ring memfd failure: "));
+    if (ftruncate(memory_fd, static_cast<off_t>(this->_capacity)) < 0) {
+        close(memory_fd);
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("ring resize failure: "));
+    }
+    void *reserved(mmap(nullptr, this->_capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (reserved == MAP_FAILED) {
+        close(memory_fd);
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("ring reserve failure: "));
+    }
+    char *base(static_cast<char *>(reserved));
+    if (mmap(base, this->_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memory_fd, 0) == MAP_FAILED ||
+        mmap(base + this->_capacity, this->_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memory_fd, 0) == MAP_FAILED) {
+        munmap(base, this->_capacity * 2);
+        close(memory_fd);
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("ring mirror failure: "));
+    }
+    // the mappings keep the memory alive
+    close(memory_fd);
+    this->_base = base;
+};
+
+/**
+ * @brief Unmaps both views of the ring.
+ */
+TcpInitializer::RingBuffer::~RingBuffer() {
+    if (this->_base != nullptr)
+        munmap(this->_base, this->_capacity * 2);
+};
+
+/**
+ * @brief Gets the first unconsumed byte.
+ *
+ * @returns A pointer followed by Readable() contiguous bytes.
+ */
+char *TcpInitializer::RingBuffer::ReadPtr(void) const noexcept {
+    return this->_base + (this->_head % this->_capacity);
+};
+
+/**
+ * @brief Gets the first free byte.
+ *
+ * @returns A pointer followed by Writable() contiguous bytes.
+ */
+char *TcpInitializer::RingBuffer::WritePtr(void) const noexcept {
+    return this->_base + (this->_tail % this->_capacity);
+};
+
+/**
+ * @brief Gets the number of buffered bytes.
+ *
+ * @returns The readable byte count.
+ */
+t_u64 TcpInitializer::RingBuffer::Readable(void) const noexcept {
+    return this->_tail - this->_head;
+};
+
+/**
+ * @brief Gets the free space.
+ *
+ * @returns The writable byte count.
+ */
+t_u64 TcpInitializer::RingBuffer::Writable(void) const noexcept {
+    return this->_capacity - (this->_tail - this->_head);
+};
+
+/**
+ * @brief Publishes bytes written at WritePtr().
+ *
+ * @param _bytes Number of bytes written, at most Writable().
+ */
+void TcpInitializer::RingBuffer::Commit(const t_u64 _bytes) noexcept {
+    this->_tail += _bytes;
+};
+
+/**
+ * @brief Releases bytes at ReadPtr().
+ *
+ * @param _bytes Number of bytes consumed, at most Readable().
+ */
+void TcpInitializer::RingBuffer::Consume(const t_u64 _bytes) noexcept {
+    this->_head += _bytes;
+    if (this->_head == this->_tail)
+        this->_head = this->_tail = 0;
+};
+
+/**
+ * @brief Gets the ring capacity.
+ *
+ * @returns The capacity in bytes.
+ */
+t_u64 TcpInitializer::RingBuffer::GetCapacity(void) const noexcept {
+    return this->_capacity;
+};
+
+/**
+ * @brief Drops every buffered byte.
+ */
+void TcpInitializer::RingBuffer::Clear(void) noexcept {
+    this->_head = this->_tail = 0;
+};
+
+/**
+ * @brief Creates a decoder for one connection.
+ *
+ * @param _codec The codec cutting frames out of the stream.
+ * @param _on_frames Callback receiving batches of complete frames.
+ * @param _ring_size Ring buffer capacity, bounds the largest frame that can be decoded.
+ * @param _batch_size Maximum number of frames per callback.
+ * @throws std::invalid_argument If no codec is given.
+ * @throws std::runtime_error If the ring buffer cannot be mapped.
+ */
+TcpInitializer::FrameDecoder::FrameDecoder(std::unique_ptr<FrameCodec> _codec, frame_cb _on_frames, const t_u64 _ring_size, const t_u32 _batch_size)
+    : _codec(std::move(_codec)), _ring(_ring_size), _on_frames(std::move(_on_frames)), _batch(), _frame_count(0), _malformed(false) {
+    if (!this->_codec)
+        throw std::invalid_argument("missing frame codec");
+    this->_batch.reserve(_batch_size > 0 ? _batch_size : DEFAULT_FRAME_BATCH_SIZE);
+};
+
+/**
+ * @brief Reads everything the socket holds without blocking and delivers the complete frames.
+ *
+ * @param _sock The connected socket, blocking or not.
+ * @returns true if the socket is drained and still open, false on end of stream, error or malformed data.
+ */
+bool TcpInitializer::FrameDecoder::Feed(const t_sock _sock) {
+    for (;;) {
+        if (this->_ring.Writable() == 0) {
+            if (!this->_Drain())
+                return false;
+            if (this->_ring.Writable() == 0) {
+                // a single frame larger than the ring can never complete
+                this->_malformed = true;
+                return false;
+            }
+        }
+        const t_u64 started(Metrics::Now());
+        const ssize_t tcp_read(recv(_sock, this->_ring.WritePtr(), this->_ring.Writable(), MSG_DONTWAIT));
+        Metrics::read_latency.Record(Metrics::Now() - started);
+        if (tcp_read > 0) {
+            Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+            ConnectionTable::AccountOwner(_sock, static_cast<t_u64>(tcp_read), 0);
+            this->_ring.Commit(static_cast<t_u64>(tcp_read));
+            continue;
+        }
+        if (tcp_read < 0 && errno == EINTR)
+            continue;
+        const bool drained(tcp_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+        return this->_Drain() && drained;
+    }
+};
+
+/**
+ * @brief Appends bytes received elsewhere (e.g. from an IoBackend read callback) and delivers the complete frames.
+ *
+ * @param _bytes The received bytes, copied into the ring.
+ * @returns true if the stream is still well formed, false otherwise.
+ */
+bool TcpInitializer::FrameDecoder::Feed(const t_strw _bytes) {
+    t_u64 offset(0);
+    while (offset < _bytes.size()) {
+        if (this->_ring.Writable() == 0) {
+            if (!this->_Drain())
+                return false;
+            if (this->_ring.Writable() == 0) {
+                this->_malformed = true;
+                return false;
+            }
+        }
+        const t_u64 chunk(std::min<t_u64>(this->_ring.Writable(), _bytes.size() - offset));
+        memcpy(this->_ring.WritePtr(), _bytes.data() + offset, chunk);
+        this->_ring.Commit(chunk);
+        offset += chunk;
+    }
+    return this->_Drain();
+};
+
+/**
+ * @brief Drops the buffered bytes and codec state, e.g. before reusing the decoder for another connection.
+ *
+ * Must not be called from the frame callback.
+ */
+void TcpInitializer::FrameDecoder::Reset(void) noexcept {
+    this->_ring.Clear();
+    this->_codec->Reset();
+    this->_batch.clear();
+    this->_frame_count = 0;
+    this->_malformed = false;
+};
+
+/**
+ * @brief Checks whether the codec rejected the stream.
+ *
+ * @returns true if malformed data was received, false otherwise.
+ */
+bool TcpInitializer::FrameDecoder::IsMalformed(void) const noexcept {
+    return this->_malformed;
+};
+
+/**
+ * @brief Gets the number of frames delivered so far.
+ *
+ * @returns The frame count.
+ */
+t_u64 TcpInitializer::FrameDecoder::GetFrameCount(void) const noexcept {
+    return this->_frame_count;
+};
+
+/**
+ * @brief Gets the number of bytes waiting for the rest of their frame.
+ *
+ * @returns The buffered byte count.
+ */
+t_u64 TcpInitializer::FrameDecoder::GetBuffered(void) const noexcept {
+    return this->_ring.Readable();
+};
+
+/**
+ * @brief Gets the codec, e.g. to encode replies with the same framing.
+ *
+ * @returns A reference to the codec.
+ */
+TcpInitializer::FrameCodec &TcpInitializer::FrameDecoder::GetCodec(void) noexcept {
+    return *this->_codec;
+};
+
+/**
+ * @brief Cuts every complete frame out of the ring and hands them to the callback batch by batch.
+ *
+ * Frames are only consumed after the callback returned, so their views stay valid during the call.
+ *
+ * @returns true if the stream is well formed, false otherwise.
+ */
+bool TcpInitializer::FrameDecoder::_Drain(void) {
+    if (this->_malformed)
+        return false;
+    for (;;) {
+        const char *data(this->_ring.ReadPtr());
+        const t_u64 readable(this->_ring.Readable());
+        t_u64 offset(0);
+        FrameStatus status(FrameStatus::INCOMPLETE);
+        this->_batch.clear();
+        while (this->_batch.size() < this->_batch.capacity() && offset < readable) {
+            t_u64 consumed(0);
+            t_strw payload;
+            status = this->_codec->Decode(data + offset, readable - offset, consumed, payload);
+            if (status != FrameStatus::READY)
+                break;
+            this->_batch.push_back(payload);
+            offset += consumed;
+        }
+        if (!this->_batch.empty()) {
+            this->_frame_count += this->_batch.size();
+            if (this->_on_frames)
+                this->_on_frames(*this, this->_batch.data(), this->_batch.size());
+        }
+        this->_ring.Consume(offset);
+        if (status == FrameStatus::MALFORMED) {
+            this->_malformed = true;
+            return false;
+        }
+        if (status != FrameStatus::READY || offset == readable)
+            return true;
+    }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_FRAMING_V0_0_1_HPP
+#define UNIX_G4TCPP_FRAMING_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+
+#include <sys/mman.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_FRAME_RING_SIZE        65536u
+#define DEFAULT_FRAME_BATCH_SIZE       64u
+#define DEFAULT_FRAME_MAX_SIZE         (DEFAULT_FRAME_RING_SIZE - 16u)
+#define FRAME_VARINT_MAX_BYTES         10u
+
+enum class FrameStatus
+{
+    INCOMPLETE,
+    READY,
+    MALFORMED
+};
+
+enum class LengthPrefix
+{
+    U32_BE,
+    VARINT
+};
+
+/**
+ * Incremental frame decoder/encoder plugged into a FrameDecoder.
+ *
+ * Decode inspects the unconsumed bytes starting at the beginning of the next frame and either asks
+ * for more data, reports a malformed stream, or reports one complete frame: the number of bytes the
+ * frame occupies on the wire and a view of its payload inside the given bytes. Codecs may keep scan
+ * state between INCOMPLETE calls, Reset drops it.
+ */
+class FrameCodec
+{
+  public:
+    virtual ~FrameCodec() = default;
+
+    virtual                 FrameStatus Decode              (const char *_data, const t_u64 _size, t_u64 &_consumed, t_strw &_payload) = 0;
+    virtual                 void    Encode                  (const t_strw _payload, t_str &_dest) const = 0;
+    virtual                 void    Reset                   (void) noexcept {};
+};
+
+/**
+ * Frames carrying their payload length in front, as a big-endian u32 or a LEB128 varint.
+ */
+class LengthPrefixCodec final : public FrameCodec
+{
+  protected:
+    LengthPrefix                                          _prefix;
+    t_u64                                                 _max_frame;
+
+  public:
+    __attribute__((cold                                            ))  explicit                LengthPrefixCodec       (const LengthPrefix _prefix = LengthPrefix::U32_BE, const t_u64 _max_frame = DEFAULT_FRAME_MAX_SIZE) noexcept;
+
+    FrameStatus   Decode   (const char *_data, const t_u64 _size, t_u64 &_consumed, t_strw &_payload) override;
+    void          Encode   (const t_strw _payload, t_str &_dest) const override;
+};
+
+/**
+ * Frames terminated by a delimiter such as "\r\n", the delimiter is not part of the payload.
+ *
+ * The codec remembers how far it already scanned an incomplete frame, so a long frame arriving in
+ * many small reads is searched once rather than from its start on every read.
+ */
+class DelimiterCodec final : public FrameCodec
+{
+  protected:
+    t_str                                                 _delimiter;
+    t_u64                                                 _max_frame;
+    t_u64                                                 _scanned;
+
+  public:
+    __attribute__((cold                                            ))  explicit                DelimiterCodec          (const t_strw _delimiter = "\r\n", const t_u64 _max_frame = DEFAULT_FRAME_MAX_SIZE);
+
+    FrameStatus   Decode   (const char *_data, const t_u64 _size, t_u64 &_consumed, t_strw &_payload) override;
+    void          Encode   (const t_strw _payload, t_str &_dest) const override;
+    void          Reset    (void) noexcept override;
+};
+
+/**
+ * Byte ring whose storage is mapped twice back to back from one memfd.
+ *
+ * Because the second mapping mirrors the first, the readable bytes and the writable space are
+ * always contiguous in memory however the ring wrapped, so a frame can be decoded and handed out
+ * in place without ever being copied to straighten it.
+ */
+class RingBuffer
+{
+  protected:
+    char                                                 *_base;
+    t_u64                                                 _capacity;
+    t_u64                                                 _head;
+    t_u64                                                 _tail;
+
+  public:
+    __attribute__((cold                                            ))  explicit                RingBuffer              (const t_u64 _capacity = DEFAULT_FRAME_RING_SIZE);
+    RingBuffer(const RingBuffer &)            = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+    __attribute__((cold                                            ))                          ~RingBuffer             ();
+
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               char*   ReadPtr                 (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               char*   WritePtr                (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               t_u64   Readable                (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               t_u64   Writable                (void) const noexcept;
+    __attribute__((hot                                             ))  inline               void    Commit                  (const t_u64 _bytes) noexcept;
+    __attribute__((hot                                             ))  inline               void    Consume                 (const t_u64 _bytes) noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetCapacity             (void) const noexcept;
+    __attribute__((cold                                            ))  inline               void    Clear                   (void) noexcept;
+};
+
+/**
+ * Per-connection decoding stage between a socket and the application.
+ *
+ * Feed pulls everything the socket has into the ring buffer, lets the codec cut complete frames out
+ * of it in place and hands them to the frame callback in batches of up to DEFAULT_FRAME_BATCH_SIZE.
+ * The payload views passed to the callback point into the ring and are only valid for the duration
+ * of the call. Partial frames stay buffered until the rest arrives.
+ */
+class FrameDecoder
+{
+  public:
+    using frame_cb   = std::function<void(FrameDecoder &, const t_strw *, const std::size_t)>;
+
+  protected:
+    std::unique_ptr<FrameCodec>                           _codec;
+    RingBuffer                                            _ring;
+    frame_cb                                              _on_frames;
+    std::vector<t_strw>                                   _batch;
+    t_u64                                                 _frame_count;
+    bool                                                  _malformed;
+
+  public:
+    __attribute__((cold                                            ))  explicit                FrameDecoder            (std::unique_ptr<FrameCodec> _codec, frame_cb _on_frames, const t_u64 _ring_size = DEFAULT_FRAME_RING_SIZE, const t_u32 _batch_size = DEFAULT_FRAME_BATCH_SIZE);
+    FrameDecoder(const FrameDecoder &)            = delete;
+    FrameDecoder &operator=(const FrameDecoder &) = delete;
+
+    __attribute__((hot                                             ))  inline               bool    Feed                    (const t_sock _sock);
+    __attribute__((hot                                             ))  inline               bool    Feed                    (const t_strw _bytes);
+    __attribute__((cold                                            ))  inline               void    Reset                   (void) noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               bool    IsMalformed             (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetFrameCount           (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetBuffered             (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               FrameCodec &GetCodec            (void) noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               bool    _Drain                  (void);
+};
+
+}; // namespace TcpInitializer
+
+#endif
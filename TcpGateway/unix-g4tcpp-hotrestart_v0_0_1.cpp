@@ -0,0 +1,355 @@
+#ifndef UNIX_G4TCPP_HOTRESTART_V0_0_1_HPP
+
+#include "unix-g4tcpp-fdpass_v0_0_1.cpp"
+#include "unix-g4tcpp-hotrestart_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Constructs a restart coordinator without listeners.
+ */
+TcpInitializer::HotRestart::HotRestart(void)
+    : _bindings(), _control(), _control_address(), _on_release(), _session_filter(), _adopted_sessions(0) {};
+
+/**
+ * @brief Registers a listener to be handed over, or taken over, under its address and port.
+ *
+ * @param _listener The listener, it must outlive the coordinator.
+ * @param _address The address the listener serves, as given to Listen.
+ * @param _port The port the listener serves.
+ */
+void TcpInitializer::HotRestart::Register(TcpListener &_listener, const t_strw _address, const t_u16 _port) {
+    Binding binding;
+    binding.listener = &_listener;
+    binding.address = _address;
+    binding.port = _port;
+    this->_bindings.push_back(std::move(binding));
+};
+
+/**
+ * @brief Sets the callback run for every descriptor the old process gives up, just before it is closed.
+ *
+ * @param _on_release Receives the descriptor, e.g. to remove it from an EventLoop.
+ */
+void TcpInitializer::HotRestart::SetReleaseCallback(release_cb _on_release) {
+    this->_on_release = std::move(_on_release);
+};
+
+/**
+ * @brief Sets which live sessions move to the successor instead of being drained.
+ *
+ * @param _filter Returns true for a session to hand over; without a filter every session is drained.
+ */
+void TcpInitializer::HotRestart::SetSessionFilter(session_cb _filter) {
+    this->_session_filter = std::move(_filter);
+};
+
+/**
+ * @brief Takes the listeners over from a running predecessor, binds the others and serves the control socket.
+ *
+ * @param _control The control address, "unixpacket:PATH" or "unixpacket:@name" for an abstract one.
+ * @param _timeout_ms Limit for each step of the takeover.
+ * @returns true if every registered listener listens and the control socket is served, false otherwise.
+ * @throws std::runtime_error If a listener or control address is invalid.
+ */
+bool TcpInitializer::HotRestart::Start(const t_strw _control, const int _timeout_ms) {
+    if (!this->Takeover(_control, _timeout_ms))
+        TcpInitializer::Socket::Log("Hot restart: no predecessor on ", _control, ", listening\n");
+    bool listening(true);
+    for (Binding &binding : this->_bindings) {
+        if (!binding.adopted)
+            listening = binding.listener->Listen(binding.address, binding.port) && listening;
+    }
+    return this->Serve(_control) && listening;
+};
+
+/**
+ * @brief Receives listening sockets and handed-over sessions from the process serving the control address.
+ *
+ * A received listener is adopted by the registered listener with the same address and port, and
+ * closed if there is none. Sessions are inserted into their listener's ConnectionTable with their
+ * buffered bytes, where they can be found with Snapshot. If the handoff breaks off before the
+ * predecessor gave up its sockets, everything received is released again and the predecessor
+ * keeps serving.
+ *
+ * @param _control The control address, a "unixpacket:" one.
+ * @param _timeout_ms Limit for the connect and for each message.
+ * @returns true if the predecessor handed over and released its control socket, false otherwise
+ *          (errno EINVAL if the address is not a seqpacket one).
+ */
+bool TcpInitializer::HotRestart::Takeover(const t_strw _control, const int _timeout_ms) {
+    TcpConnection predecessor;
+    predecessor.SetConnectTimeout(_timeout_ms);
+    if (!TcpInitializer::HotRestart::_IsControl(_control)) {
+        errno = EINVAL;
+        return false;
+    }
+    if (!predecessor.Connect(_control, 0))
+        return false;
+    TcpInitializer::FdChannel channel(predecessor.Release());
+    TcpInitializer::Socket::SetTimeouts(channel.GetSocket(), _timeout_ms, _timeout_ms);
+    std::vector<std::pair<Binding *, t_sock>> sessions;
+    Binding *current(nullptr);
+    t_u64 current_id(0);
+    for (;;) {
+        t_sock fd(-1);
+        std::size_t count(0);
+        t_str payload;
+        if (!channel.ReceiveFds(&fd, 1, count, &payload) || payload.empty()) {
+            if (count > 0)
+                close(fd);
+            this->_Rollback(sessions);
+            return false;
+        }
+        const char type(payload[0]);
+        Binding *binding(type == 'L' || type == 'S' ? this->_Find(t_strw(payload).substr(1)) : nullptr);
+        if (type == 'L' && count > 0 && binding != nullptr && !binding->adopted && binding->listener->Adopt(fd, binding->address, binding->port)) {
+            binding->adopted = true;
+        } else if (type == 'S' && count > 0 && binding != nullptr && binding->adopted) {
+            PeerAddress peer;
+            socklen_t peer_size(sizeof(peer));
+            if (getpeername(fd, &peer.addr, &peer_size) < 0)
+                peer_size = 0;
+            current = binding;
+            current_id = binding->listener->GetSessions().Insert(fd, peer_size > 0 ? &peer.addr : nullptr, peer_size);
+            sessions.emplace_back(binding, fd);
+        } else if (type == 'B' && current != nullptr) {
+            current->listener->GetSessions().WithBuffer(current_id, [&payload](t_str &_buffer) -> void { _buffer.append(payload, 1, t_str::npos); });
+        } else if (type == 'E') {
+            break;
+        } else if (count > 0) {
+            // a socket this process does not serve, the predecessor keeps its own copy
+            close(fd);
+        }
+    }
+    if (!channel.SendFds(nullptr, 0, "R") || !HotRestart::_Expect(channel, 'C')) {
+        this->_Rollback(sessions);
+        return false;
+    }
+    this->_adopted_sessions += sessions.size();
+    TcpInitializer::Socket::Log("Hot restart: took over ", this->GetAdoptedListeners(), " listeners and ", sessions.size(), " sessions\n");
+    return true;
+};
+
+/**
+ * @brief Binds the control socket a successor connects to.
+ *
+ * @param _control The control address, a "unixpacket:" one.
+ * @returns true if the control socket listens, false otherwise (errno EINVAL if the address is not a seqpacket one).
+ */
+bool TcpInitializer::HotRestart::Serve(const t_strw _control) {
+    if (!TcpInitializer::HotRestart::_IsControl(_control)) {
+        errno = EINVAL;
+        return false;
+    }
+    this->_control_address = _control;
+    if (!this->_control.Listen(_control, 0))
+        return false;
+    // a successor started with fork and exec must not inherit the control socket it is about to bind
+    fcntl(*this->_control.GetSocket(), F_SETFD, FD_CLOEXEC);
+    return true;
+};
+
+/**
+ * @brief Hands the listeners, and the sessions picked by the filter, to a successor connecting to the control socket.
+ *
+ * Once the successor confirmed that it serves them, the local copies are released and closed and
+ * the control socket is closed for the successor to bind. Sessions not handed over stay open;
+ * call Drain to let them finish. If the successor fails half way, nothing is released.
+ *
+ * @param _timeout_ms How long to wait for a successor to connect, 0 only checks, -1 waits forever.
+ * @returns true if a successor took over, false otherwise (errno ETIMEDOUT if none connected).
+ */
+bool TcpInitializer::HotRestart::HandOff(const int _timeout_ms) {
+    if (!this->_control.IsListening()) {
+        errno = ENOTCONN;
+        return false;
+    }
+    struct pollfd restart_poll = {*this->_control.GetSocket(), POLLIN, 0};
+    int ready(-1);
+    do {
+        ready = poll(&restart_poll, 1, _timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0) {
+        if (ready == 0)
+            errno = ETIMEDOUT;
+        return false;
+    }
+    const t_sock successor(accept4(*this->_control.GetSocket(), nullptr, nullptr, SOCK_CLOEXEC));
+    if (successor < 0)
+        return false;
+    TcpInitializer::FdChannel channel(successor);
+    TcpInitializer::Socket::SetTimeouts(successor, DEFAULT_RESTART_TIMEOUT_MS, DEFAULT_RESTART_TIMEOUT_MS);
+    std::vector<std::pair<TcpListener *, t_sock>> handed;
+    for (const Binding &binding : this->_bindings) {
+        if (!binding.listener->IsListening())
+            continue;
+        const t_sock listen_sock(*binding.listener->GetSocket());
+        if (!channel.SendFds(&listen_sock, 1, HotRestart::_Message('L', binding)))
+            return false;
+        if (!this->_session_filter)
+            continue;
+        for (const ConnectionTable::Session &session : binding.listener->GetSessions().Snapshot()) {
+            if (!this->_session_filter(session))
+                continue;
+            if (!channel.SendFds(&session.sock, 1, HotRestart::_Message('S', binding)))
+                return false;
+            // copied, not moved: the session stays intact here until the successor confirmed
+            t_str buffered;
+            binding.listener->GetSessions().WithBuffer(session.id, [&buffered](t_str &_buffer) -> void { buffered = _buffer; });
+            for (std::size_t offset = 0; offset < buffered.size(); offset += DEFAULT_FDPASS_PAYLOAD_MAX - 1) {
+                if (!channel.SendFds(nullptr, 0, t_str(1, 'B').append(buffered, offset, DEFAULT_FDPASS_PAYLOAD_MAX - 1)))
+                    return false;
+            }
+            handed.emplace_back(binding.listener, session.sock);
+        }
+    }
+    if (!channel.SendFds(nullptr, 0, "E") || !HotRestart::_Expect(channel, 'R'))
+        return false;
+    // the successor serves everything it received, the local copies go
+    for (const std::pair<TcpListener *, t_sock> &session : handed) {
+        if (this->_on_release)
+            this->_on_release(session.second);
+        session.first->CloseSession(session.second);
+    }
+    for (Binding &binding : this->_bindings) {
+        const t_sock listen_sock(binding.listener->Release());
+        if (listen_sock < 0)
+            continue;
+        if (this->_on_release)
+            this->_on_release(listen_sock);
+        close(listen_sock);
+    }
+    this->_control.Close();
+    if (!channel.SendFds(nullptr, 0, "C"))
+        TcpInitializer::Socket::Log("Hot restart: successor left before the control socket was released\n");
+    TcpInitializer::Socket::Log("Hot restart: handed over ", handed.size(), " sessions\n");
+    return true;
+};
+
+/**
+ * @brief Waits for the sessions left with this process to be closed, after HandOff.
+ *
+ * Sessions count as closed once removed with TcpListener::CloseSession or Socket::Close.
+ *
+ * @param _timeout_ms Longest wait, -1 waits until every session is closed.
+ * @returns true if no session is left, false if the timeout expired first.
+ */
+bool TcpInitializer::HotRestart::Drain(const int _timeout_ms) {
+    const std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(_timeout_ms, 0)));
+    for (;;) {
+        t_u64 live(0);
+        for (const Binding &binding : this->_bindings) {
+            live += binding.listener->GetSessionCount();
+        }
+        if (live == 0)
+            return true;
+        if (_timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_RESTART_DRAIN_POLL_MS));
+    }
+};
+
+/**
+ * @brief Gets the control socket, e.g. to call HandOff when a successor connects.
+ *
+ * @returns The control socket, -1 if not served.
+ */
+t_sock TcpInitializer::HotRestart::GetSocket(void) noexcept {
+    return *this->_control.GetSocket();
+};
+
+/**
+ * @brief Gets the number of listeners taken over from the predecessor.
+ *
+ * @returns The adopted listener count.
+ */
+TcpInitializer::t_u64 TcpInitializer::HotRestart::GetAdoptedListeners(void) const noexcept {
+    return static_cast<t_u64>(std::count_if(this->_bindings.begin(), this->_bindings.end(), [](const Binding &_binding) -> bool { return _binding.adopted; }));
+};
+
+/**
+ * @brief Gets the number of sessions taken over from the predecessor.
+ *
+ * @returns The adopted session count.
+ */
+TcpInitializer::t_u64 TcpInitializer::HotRestart::GetAdoptedSessions(void) const noexcept {
+    return this->_adopted_sessions;
+};
+
+/**
+ * @brief Finds the binding a control message names.
+ *
+ * @param _key "PORT ADDRESS" as written by _Message.
+ * @returns The binding, nullptr if no registered listener serves that address and port.
+ */
+TcpInitializer::HotRestart::Binding *TcpInitializer::HotRestart::_Find(const t_strw _key) {
+    for (Binding &binding : this->_bindings) {
+        if (t_strw(HotRestart::_Message(' ', binding)).substr(1) == _key)
+            return &binding;
+    }
+    return nullptr;
+};
+
+/**
+ * @brief Gives back what a broken takeover received: the predecessor still owns and serves it.
+ *
+ * Listeners are released without Close, which would unlink a socket file the predecessor still uses.
+ *
+ * @param _sessions The sessions inserted so far with their bindings.
+ */
+void TcpInitializer::HotRestart::_Rollback(const std::vector<std::pair<Binding *, t_sock>> &_sessions) noexcept {
+    for (const std::pair<Binding *, t_sock> &session : _sessions) {
+        session.first->listener->CloseSession(session.second);
+    }
+    for (Binding &binding : this->_bindings) {
+        if (!binding.adopted)
+            continue;
+        const t_sock listen_sock(binding.listener->Release());
+        if (listen_sock >= 0)
+            close(listen_sock);
+        binding.adopted = false;
+    }
+};
+
+/**
+ * @brief Checks that a control address names a seqpacket socket.
+ *
+ * A stream socket would merge control messages sent without a descriptor, e.g. a buffered-bytes
+ * message with the end of handoff that follows it, so only "unixpacket:" addresses are accepted.
+ *
+ * @param _control The control address.
+ * @returns true if the address is a valid "unixpacket:" one, false otherwise.
+ */
+bool TcpInitializer::HotRestart::_IsControl(const t_strw _control) noexcept {
+    PeerAddress address;
+    socklen_t size(0);
+    int type(SOCK_STREAM);
+    return TcpInitializer::AddressParser::ParseUnix(_control, address, size, type) && type == SOCK_SEQPACKET;
+};
+
+/**
+ * @brief Waits for a control message of the given type.
+ *
+ * @param _channel The control channel.
+ * @param _type The expected type byte.
+ * @returns true if the next message has that type, false otherwise.
+ */
+bool TcpInitializer::HotRestart::_Expect(FdChannel &_channel, const char _type) {
+    std::size_t count(0);
+    t_str payload;
+    return _channel.ReceiveFds(nullptr, 0, count, &payload) && !payload.empty() && payload[0] == _type;
+};
+
+/**
+ * @brief Formats a listener or session message.
+ *
+ * @param _type The type byte.
+ * @param _binding The listener the message is about.
+ * @returns The type byte followed by "PORT ADDRESS".
+ */
+TcpInitializer::t_str TcpInitializer::HotRestart::_Message(const char _type, const Binding &_binding) {
+    return t_str(1, _type).append(std::to_string(_binding.port)).append(" ").append(_binding.address);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_HOTRESTART_V0_0_1_HPP
+#define UNIX_G4TCPP_HOTRESTART_V0_0_1_HPP
+
+#include "unix-g4tcpp-fdpass_v0_0_1.hpp"
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_RESTART_TIMEOUT_MS     5000u
+#define DEFAULT_RESTART_DRAIN_POLL_MS  10u
+
+/**
+ * Zero-downtime restart by handing listening sockets from the running process to its successor.
+ *
+ * Every process registers its listeners with the address and port they serve and calls Start
+ * with a "unixpacket:" control address. A new binary connects to the control socket
+ * of the running one, receives its listening descriptors over an FdChannel and adopts the ones
+ * registered with the same address and port; the kernel accept queue goes with them, so no
+ * queued connection is lost and clients never see a refused connect. Listeners nobody handed
+ * over are bound normally, so the first start and a start after a crash take the same path.
+ *
+ * The running process serves the handoff with HandOff, from the thread that owns the listeners
+ * (the release callback runs there, e.g. to take descriptors out of an EventLoop before they are
+ * closed). Sessions picked by the session filter move along with their buffered bytes; the others
+ * stay and are finished by the old process, which waits for them with Drain before it exits.
+ *
+ * Control messages are one seqpacket each: a type byte, then "PORT ADDRESS" for a listener ('L')
+ * or a session of that listener ('S'), buffered bytes ('B'), end of handoff ('E'), successor
+ * ready ('R') and control socket released ('C'). A stream socket would merge messages sent
+ * without a descriptor, so "unix:" control addresses are rejected with EINVAL.
+ */
+class HotRestart
+{
+  public:
+    using release_cb = std::function<void(const t_sock)>;
+    using session_cb = std::function<bool(const ConnectionTable::Session &)>;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        TcpListener       *listener    {                                                    };
+        t_str              address     {                                                    };
+        t_u16              port        {                                                    };
+        bool               adopted     {                                                    };
+    } Binding;
+
+    std::vector<Binding>                                  _bindings;
+    TcpListener                                           _control;
+    t_str                                                 _control_address;
+    release_cb                                            _on_release;
+    session_cb                                            _session_filter;
+    t_u64                                                 _adopted_sessions;
+
+  public:
+    __attribute__((cold                                            ))                          HotRestart              (void);
+    HotRestart(const HotRestart &)            = delete;
+    HotRestart &operator=(const HotRestart &) = delete;
+
+    __attribute__((cold                                            ))  inline               void    Register                (TcpListener &_listener, const t_strw _address, const t_u16 _port);
+    __attribute__((cold                                            ))  inline               void    SetReleaseCallback      (release_cb _on_release);
+    __attribute__((cold                                            ))  inline               void    SetSessionFilter        (session_cb _filter);
+    __attribute__((cold                                            ))  inline               bool    Start                   (const t_strw _control, const int _timeout_ms = DEFAULT_RESTART_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               bool    Takeover                (const t_strw _control, const int _timeout_ms = DEFAULT_RESTART_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               bool    Serve                   (const t_strw _control);
+    __attribute__((cold                                            ))  inline               bool    HandOff                 (const int _timeout_ms = 0);
+    __attribute__((cold                                            ))  inline               bool    Drain                   (const int _timeout_ms = -1);
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  GetSocket               (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetAdoptedListeners     (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetAdoptedSessions      (void) const noexcept;
+
+  protected:
+    __attribute__((cold, warn_unused_result                        ))  inline               Binding* _Find                  (const t_strw _key);
+    __attribute__((cold                                            ))  inline               void    _Rollback               (const std::vector<std::pair<Binding *, t_sock>> &_sessions) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    _IsControl              (const t_strw _control) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    _Expect                 (FdChannel &_channel, const char _type);
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_str   _Message                (const char _type, const Binding &_binding);
+};
+
+}; // namespace TcpInitializer
+
+#endif
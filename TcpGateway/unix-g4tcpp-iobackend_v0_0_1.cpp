@@ -0,0 +1,918 @@
+#ifndef UNIX_G4TCPP_IOBACKEND_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-iobackend_v0_0_1.hpp"
+
+#include <poll.h>
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Sends a single buffer, see the vectored overload.
+ *
+ * @param _sock The socket to send on.
+ * @param _buffer The payload, copied before the call returns.
+ * @param _on_sent Optional callback invoked once the payload is fully written or failed.
+ * @returns true if the send was queued, false otherwise.
+ */
+bool TcpInitializer::IoBackend::Send(const t_sock _sock, const t_strw _buffer, send_cb _on_sent) {
+    return this->Send(_sock, &_buffer, 1, std::move(_on_sent));
+};
+
+/**
+ * @brief Dispatches completions until Stop() is called.
+ */
+void TcpInitializer::IoBackend::Run(void) {
+    this->_running.store(true, std::memory_order_release);
+    while (this->_running.load(std::memory_order_acquire)) {
+        this->RunOnce(DEFAULT_LOOP_TIMEOUT_MS);
+    }
+};
+
+/**
+ * @brief Creates an epoll backed backend.
+ */
+TcpInitializer::EpollIoBackend::EpollIoBackend(void) : _loop(), _fds(), _buffer(DEFAULT_BUFFER_MAX_SIZE) {};
+
+/**
+ * @brief Keeps accepting on a listening socket.
+ *
+ * @param _listen_sock The listening socket.
+ * @param _on_accept Callback receiving every accepted socket.
+ * @returns true if the listener was registered, false otherwise.
+ */
+bool TcpInitializer::EpollIoBackend::Accept(const t_sock _listen_sock, accept_cb _on_accept) {
+    return this->_loop.AddListener(_listen_sock, [this, on_accept = std::move(_on_accept)](EventLoop &, ClientTcpConnection &_conn) -> void { on_accept(*this, _conn.sock); });
+};
+
+/**
+ * @brief Keeps reading from a connected socket.
+ *
+ * @param _sock The connected socket.
+ * @param _on_read Callback receiving every block read, or an empty view on end of stream.
+ * @returns true if the socket is being read, false otherwise.
+ */
+bool TcpInitializer::EpollIoBackend::Read(const t_sock _sock, read_cb _on_read) {
+    if (!this->_Watch(_sock))
+        return false;
+    this->_StateOf(_sock).on_read = std::move(_on_read);
+    this->_loop.WantRead(_sock, true);
+    // data may already be queued on the socket, edge triggering would not report it again
+    this->_OnReadable(_sock);
+    return true;
+};
+
+/**
+ * @brief Writes buffers with writev, queueing whatever the socket does not take immediately.
+ *
+ * @param _sock The connected socket.
+ * @param _buffers Array of buffers written back to back.
+ * @param _count Number of buffers.
+ * @param _on_sent Optional callback invoked once every buffer is fully written or failed.
+ * @returns true if the payload was written or queued, false otherwise.
+ */
+bool TcpInitializer::EpollIoBackend::Send(const t_sock _sock, const t_strw *_buffers, const std::size_t _count, send_cb _on_sent) {
+    if (!this->_Watch(_sock))
+        return false;
+    FdState &state(this->_StateOf(_sock));
+    t_u64 total(0), written(0);
+    for (std::size_t i = 0; i < _count; ++i)
+        total += _buffers[i].length();
+    if (state.sends.empty() && total > 0) {
+        std::vector<struct iovec> iov(_count);
+        for (std::size_t i = 0; i < _count; ++i)
+            iov[i] = {const_cast<char *>(_buffers[i].data()), _buffers[i].length()};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = iov.size();
+        const t_u64 started(Metrics::Now());
+        const ssize_t sent(sendmsg(_sock, &msg, MSG_NOSIGNAL));
+        Metrics::send_latency.Record(Metrics::Now() - started);
+        if (sent > 0) {
+            Metrics::bytes_out.Add(static_cast<t_u64>(sent));
+            ConnectionTable::AccountOwner(_sock, 0, static_cast<t_u64>(sent));
+        }
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            if (_on_sent)
+                _on_sent(*this, _sock, false);
+            return false;
+        }
+        written = sent > 0 ? static_cast<t_u64>(sent) : 0;
+    }
+    if (written == total) {
+        if (_on_sent)
+            _on_sent(*this, _sock, true);
+        return true;
+    }
+    PendingSend pending;
+    pending.data.reserve(total - written);
+    for (std::size_t i = 0; i < _count; ++i) {
+        const t_u64 length(_buffers[i].length());
+        if (written >= length) {
+            written -= length;
+            continue;
+        }
+        pending.data.append(_buffers[i].data() + written, length - written);
+        written = 0;
+    }
+    pending.on_sent = std::move(_on_sent);
+    state.sends.emplace_back(std::move(pending));
+    return this->_loop.WantWrite(_sock, true);
+};
+
+/**
+ * @brief Closes a socket, pending sends are reported as failed.
+ *
+ * @param _sock The socket to close.
+ */
+void TcpInitializer::EpollIoBackend::Close(const t_sock _sock) noexcept {
+    if (this->_loop.IsWatched(_sock)) {
+        this->_loop.CloseConnection(_sock);
+    } else if (_sock >= 0) {
+        this->_OnClosed(_sock);
+        close(_sock);
+    }
+};
+
+/**
+ * @brief Runs one reactor iteration.
+ *
+ * @param _timeout_ms Wait timeout in milliseconds, -1 blocks until an event arrives.
+ * @returns The number of readiness events dispatched.
+ */
+TcpInitializer::t_u32 TcpInitializer::EpollIoBackend::RunOnce(const int _timeout_ms) {
+    return this->_loop.RunOnce(_timeout_ms);
+};
+
+/**
+ * @brief Requests Run() to return, safe to call from any thread.
+ */
+void TcpInitializer::EpollIoBackend::Stop(void) noexcept {
+    this->_running.store(false, std::memory_order_release);
+    this->_loop.Stop();
+};
+
+/**
+ * @brief Gets the backend type.
+ *
+ * @returns IoBackendType::EPOLL.
+ */
+TcpInitializer::IoBackendType TcpInitializer::EpollIoBackend::GetType(void) const noexcept {
+    return IoBackendType::EPOLL;
+};
+
+/**
+ * @brief Gets the per-socket state, growing the table as needed.
+ *
+ * @param _sock The socket.
+ * @returns A reference to the socket state.
+ */
+TcpInitializer::EpollIoBackend::FdState &TcpInitializer::EpollIoBackend::_StateOf(const t_sock _sock) {
+    if (static_cast<std::size_t>(_sock) >= this->_fds.size())
+        this->_fds.resize(std::max<std::size_t>(static_cast<std::size_t>(_sock) + 1, this->_fds.size() * 2));
+    return this->_fds[_sock];
+};
+
+/**
+ * @brief Registers a socket with the reactor once, with read interest paused until Read is called.
+ *
+ * @param _sock The socket.
+ * @returns true if the socket is watched, false otherwise.
+ */
+bool TcpInitializer::EpollIoBackend::_Watch(const t_sock _sock) {
+    if (_sock < 0)
+        return false;
+    FdState &state(this->_StateOf(_sock));
+    if (state.watched && this->_loop.IsWatched(_sock))
+        return true;
+    EventLoop::IoHandlers handlers{
+        [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnReadable(_conn.sock); },
+        [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnWritable(_conn.sock); },
+        [this](EventLoop &, ClientTcpConnection &_conn) -> void { this->_OnClosed(_conn.sock); },
+    };
+    if (!this->_loop.AddConnection(ClientTcpConnection{_sock, true}, std::move(handlers)))
+        return false;
+    this->_loop.WantRead(_sock, false);
+    const t_u32 generation(state.generation + 1);
+    state = FdState{};
+    state.watched = true;
+    state.generation = generation;
+    return true;
+};
+
+/**
+ * @brief Drains a readable socket into the read callback.
+ *
+ * @param _sock The socket.
+ */
+void TcpInitializer::EpollIoBackend::_OnReadable(const t_sock _sock) {
+    for (;;) {
+        FdState &state(this->_StateOf(_sock));
+        if (!state.on_read)
+            return;
+        const t_u64 started(Metrics::Now());
+        const ssize_t tcp_read(read(_sock, this->_buffer.data(), this->_buffer.size()));
+        Metrics::read_latency.Record(Metrics::Now() - started);
+        if (tcp_read > 0) {
+            Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+            ConnectionTable::AccountOwner(_sock, static_cast<t_u64>(tcp_read), 0);
+            // the callback may close the socket and reset its state, run it from a local
+            const t_u32 generation(state.generation);
+            read_cb on_read(std::move(state.on_read));
+            on_read(*this, _sock, t_strw(this->_buffer.data(), static_cast<std::size_t>(tcp_read)));
+            FdState &current(this->_StateOf(_sock));
+            if (!this->_loop.IsWatched(_sock) || current.generation != generation)
+                return;
+            if (!current.on_read)
+                current.on_read = std::move(on_read);
+            continue;
+        }
+        if (tcp_read < 0 && errno == EINTR)
+            continue;
+        if (tcp_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        // end of stream or receive error, report it once and stop reading
+        read_cb on_read(std::move(state.on_read));
+        this->_loop.WantRead(_sock, false);
+        on_read(*this, _sock, t_strw());
+        return;
+    }
+};
+
+/**
+ * @brief Flushes queued sends on a writable socket.
+ *
+ * @param _sock The socket.
+ */
+void TcpInitializer::EpollIoBackend::_OnWritable(const t_sock _sock) {
+    FdState &state(this->_StateOf(_sock));
+    while (!state.sends.empty()) {
+        PendingSend &front(state.sends.front());
+        const t_u64 started(Metrics::Now());
+        const ssize_t sent(send(_sock, front.data.data() + front.offset, front.data.length() - front.offset, MSG_NOSIGNAL));
+        Metrics::send_latency.Record(Metrics::Now() - started);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            this->Close(_sock);
+            return;
+        }
+        Metrics::bytes_out.Add(static_cast<t_u64>(sent));
+        ConnectionTable::AccountOwner(_sock, 0, static_cast<t_u64>(sent));
+        front.offset += static_cast<t_u64>(sent);
+        if (front.offset < front.data.length())
+            return;
+        send_cb on_sent(std::move(front.on_sent));
+        state.sends.pop_front();
+        if (on_sent) {
+            on_sent(*this, _sock, true);
+            if (!this->_loop.IsWatched(_sock))
+                return;
+        }
+    }
+    this->_loop.WantWrite(_sock, false);
+};
+
+/**
+ * @brief Resets the socket state and fails every pending send.
+ *
+ * @param _sock The closed socket.
+ */
+void TcpInitializer::EpollIoBackend::_OnClosed(const t_sock _sock) noexcept {
+    if (_sock < 0 || static_cast<std::size_t>(_sock) >= this->_fds.size())
+        return;
+    FdState state(std::move(this->_fds[_sock]));
+    this->_fds[_sock] = FdState{};
+    this->_fds[_sock].generation = state.generation;
+    for (PendingSend &pending : state.sends) {
+        if (pending.on_sent)
+            pending.on_sent(*this, _sock, false);
+    }
+};
+
+/**
+ * @brief Creates the ring, maps its queues, registers the receive buffer ring and arms the wake-up poll.
+ *
+ * @param _entries Submission queue size, the completion queue is four times larger.
+ * @param _buffer_count Number of provided receive buffers, rounded up to a power of two.
+ * @param _buffer_size Size of each provided receive buffer.
+ * @throws std::runtime_error If the kernel lacks io_uring or one of the required features.
+ */
+TcpInitializer::UringIoBackend::UringIoBackend(const t_u32 _entries, const t_u32 _buffer_count, const t_u32 _buffer_size)
+    : _ring_fd(-1), _wake_fd(-1), _wake_value(0), _params(), _sq_ptr(MAP_FAILED), _cq_ptr(MAP_FAILED), _sq_size(0), _cq_size(0), _sqes(static_cast<struct io_uring_sqe *>(MAP_FAILED)), _sq_head(nullptr),
+      _sq_tail(nullptr), _sq_array(nullptr), _sq_mask(0), _cq_head(nullptr), _cq_tail(nullptr), _cqes(nullptr), _cq_mask(0), _sq_pending(0), _buf_ring(static_cast<struct io_uring_buf_ring *>(MAP_FAILED)),
+      _buf_base(nullptr), _buf_count(1), _buf_size(_buffer_size > 0 ? _buffer_size : DEFAULT_URING_BUFFER_SIZE), _multishot_recv(true), _fds(), _closing() {
+    while (this->_buf_count < _buffer_count && this->_buf_count < 32768u)
+        this->_buf_count <<= 1;
+    memset(&this->_params, 0, sizeof(this->_params));
+    this->_params.flags = IORING_SETUP_CQSIZE;
+    this->_params.cq_entries = std::max(1u, _entries) * 4;
+    this->_ring_fd = static_cast<t_sock>(syscall(__NR_io_uring_setup, std::max(1u, _entries), &this->_params));
+    if (this->_ring_fd < 0)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring setup failure: "));
+    const t_u32 required(IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG);
+    try {
+        if ((this->_params.features & required) != required) {
+            errno = ENOTSUP;
+            throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring feature failure: "));
+        }
+        this->_MapRings();
+        this->_SetupBufferRing();
+        this->_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (this->_wake_fd < 0)
+            throw std::runtime_error(TcpInitializer::ErrorMsgCombine("eventfd create failure: "));
+        this->_ArmWake();
+    } catch (...) {
+        this->_Release();
+        throw;
+    }
+};
+
+/**
+ * @brief Unmaps the rings and closes the ring; sockets are left open and owned by the caller.
+ */
+TcpInitializer::UringIoBackend::~UringIoBackend() {
+    this->_Release();
+};
+
+/**
+ * @brief Arms a multishot accept on a listening socket.
+ *
+ * @param _listen_sock The listening socket.
+ * @param _on_accept Callback receiving every accepted socket.
+ * @returns true if the accept was queued, false otherwise.
+ */
+bool TcpInitializer::UringIoBackend::Accept(const t_sock _listen_sock, accept_cb _on_accept) {
+    FdState *state(this->_StateOf(_listen_sock));
+    if (state == nullptr || state->on_accept || !_on_accept)
+        return false;
+    state->on_accept = std::move(_on_accept);
+    this->_ArmAccept(state);
+    return true;
+};
+
+/**
+ * @brief Arms a multishot receive drawing from the provided buffer ring.
+ *
+ * @param _sock The connected socket.
+ * @param _on_read Callback receiving every block read, or an empty view on end of stream.
+ * @returns true if the receive was queued, false otherwise.
+ */
+bool TcpInitializer::UringIoBackend::Read(const t_sock _sock, read_cb _on_read) {
+    FdState *state(this->_StateOf(_sock));
+    if (state == nullptr || state->on_read || !_on_read)
+        return false;
+    state->on_read = std::move(_on_read);
+    this->_ArmRecv(state);
+    return true;
+};
+
+/**
+ * @brief Queues a payload, chaining it behind the sends already in flight on the socket.
+ *
+ * @param _sock The connected socket.
+ * @param _buffers Array of buffers written back to back.
+ * @param _count Number of buffers.
+ * @param _on_sent Optional callback invoked once every buffer is fully written or failed.
+ * @returns true if the payload was queued, false otherwise.
+ */
+bool TcpInitializer::UringIoBackend::Send(const t_sock _sock, const t_strw *_buffers, const std::size_t _count, send_cb _on_sent) {
+    FdState *state(this->_StateOf(_sock));
+    if (state == nullptr)
+        return false;
+    PendingSend pending;
+    t_u64 total(0);
+    for (std::size_t i = 0; i < _count; ++i)
+        total += _buffers[i].length();
+    pending.data.reserve(total);
+    for (std::size_t i = 0; i < _count; ++i)
+        pending.data.append(_buffers[i].data(), _buffers[i].length());
+    if (pending.data.empty()) {
+        if (_on_sent)
+            _on_sent(*this, _sock, true);
+        return true;
+    }
+    pending.on_sent = std::move(_on_sent);
+    pending.state = state;
+    state->sends.emplace_back(std::move(pending));
+    if (state->chain == 0)
+        this->_SubmitSendChain(state);
+    return true;
+};
+
+/**
+ * @brief Cancels every operation of a socket and closes it.
+ *
+ * The state is kept alive until the last cancelled completion arrives, since the kernel may
+ * still reference queued send buffers.
+ *
+ * @param _sock The socket to close.
+ */
+void TcpInitializer::UringIoBackend::Close(const t_sock _sock) noexcept {
+    if (_sock < 0)
+        return;
+    if (static_cast<std::size_t>(_sock) >= this->_fds.size() || !this->_fds[_sock]) {
+        close(_sock);
+        return;
+    }
+    std::unique_ptr<FdState> state(std::move(this->_fds[_sock]));
+    state->closed = true;
+    shutdown(_sock, SHUT_RDWR);
+    try {
+        struct io_uring_sqe *sqe(this->_GetSqe());
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = _sock;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = OP_CANCEL;
+        // the cancel resolves the descriptor at submission, it must reach the kernel before close()
+        this->_Submit(0, 0);
+    } catch (...) {
+    }
+    close(_sock);
+    for (PendingSend &pending : state->sends) {
+        send_cb on_sent(std::move(pending.on_sent));
+        if (on_sent)
+            on_sent(*this, _sock, false);
+    }
+    // callers may be inside a callback of this very socket, the state is swept after the batch
+    this->_closing.emplace_back(std::move(state));
+};
+
+/**
+ * @brief Submits queued operations, waits for at least one completion and dispatches all of them.
+ *
+ * @param _timeout_ms Wait timeout in milliseconds, -1 blocks until a completion arrives.
+ * @returns The number of completions dispatched.
+ */
+TcpInitializer::t_u32 TcpInitializer::UringIoBackend::RunOnce(const int _timeout_ms) {
+    const bool ready(__atomic_load_n(this->_cq_tail, __ATOMIC_ACQUIRE) != *this->_cq_head);
+    if (!ready || this->_sq_pending > 0)
+        this->_Submit(ready ? 0 : 1, _timeout_ms);
+    t_u32 completed(0);
+    for (;;) {
+        t_u32 head(*this->_cq_head);
+        if (head == __atomic_load_n(this->_cq_tail, __ATOMIC_ACQUIRE))
+            break;
+        const struct io_uring_cqe cqe(this->_cqes[head & this->_cq_mask]);
+        __atomic_store_n(this->_cq_head, head + 1, __ATOMIC_RELEASE);
+        this->_Complete(cqe);
+        ++completed;
+    }
+    this->_Settle();
+    return completed;
+};
+
+/**
+ * @brief Requests Run() to return, safe to call from any thread.
+ */
+void TcpInitializer::UringIoBackend::Stop(void) noexcept {
+    this->_running.store(false, std::memory_order_release);
+    const t_u64 signal(1);
+    [[maybe_unused]] const ssize_t w(write(this->_wake_fd, &signal, sizeof(signal)));
+};
+
+/**
+ * @brief Gets the backend type.
+ *
+ * @returns IoBackendType::IO_URING.
+ */
+TcpInitializer::IoBackendType TcpInitializer::UringIoBackend::GetType(void) const noexcept {
+    return IoBackendType::IO_URING;
+};
+
+/**
+ * @brief Checks whether the running kernel provides every io_uring feature the backend needs.
+ *
+ * @returns true if a UringIoBackend can be created, false otherwise.
+ */
+bool TcpInitializer::UringIoBackend::IsSupported(void) noexcept {
+    try {
+        UringIoBackend probe(8, 1, 64);
+        return true;
+    } catch (...) {
+        return false;
+    }
+};
+
+/**
+ * @brief Maps the shared submission/completion ring and the SQE array.
+ *
+ * @throws std::runtime_error If a mapping fails.
+ */
+void TcpInitializer::UringIoBackend::_MapRings(void) {
+    this->_sq_size = this->_params.sq_off.array + this->_params.sq_entries * sizeof(t_u32);
+    this->_cq_size = this->_params.cq_off.cqes + this->_params.cq_entries * sizeof(struct io_uring_cqe);
+    this->_sq_size = this->_cq_size = std::max(this->_sq_size, this->_cq_size);
+    this->_sq_ptr = mmap(nullptr, this->_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_ring_fd, IORING_OFF_SQ_RING);
+    if (this->_sq_ptr == MAP_FAILED)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring ring map failure: "));
+    this->_cq_ptr = this->_sq_ptr;
+    void *sqes(mmap(nullptr, this->_params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->_ring_fd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring sqe map failure: "));
+    this->_sqes = static_cast<struct io_uring_sqe *>(sqes);
+    char *sq(static_cast<char *>(this->_sq_ptr));
+    this->_sq_head = reinterpret_cast<t_u32 *>(sq + this->_params.sq_off.head);
+    this->_sq_tail = reinterpret_cast<t_u32 *>(sq + this->_params.sq_off.tail);
+    this->_sq_array = reinterpret_cast<t_u32 *>(sq + this->_params.sq_off.array);
+    this->_sq_mask = *reinterpret_cast<t_u32 *>(sq + this->_params.sq_off.ring_mask);
+    this->_cq_head = reinterpret_cast<t_u32 *>(sq + this->_params.cq_off.head);
+    this->_cq_tail = reinterpret_cast<t_u32 *>(sq + this->_params.cq_off.tail);
+    this->_cqes = reinterpret_cast<struct io_uring_cqe *>(sq + this->_params.cq_off.cqes);
+    this->_cq_mask = *reinterpret_cast<t_u32 *>(sq + this->_params.cq_off.ring_mask);
+};
+
+/**
+ * @brief Allocates the receive buffers and registers them as provided buffer group 0.
+ *
+ * @throws std::runtime_error If the kernel does not support buffer rings.
+ */
+void TcpInitializer::UringIoBackend::_SetupBufferRing(void) {
+    const std::size_t ring_bytes(this->_buf_count * sizeof(struct io_uring_buf));
+    void *ring(mmap(nullptr, ring_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (ring == MAP_FAILED)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring buffer ring map failure: "));
+    this->_buf_ring = static_cast<struct io_uring_buf_ring *>(ring);
+    this->_buf_base = static_cast<char *>(std::aligned_alloc(64, static_cast<std::size_t>(this->_buf_count) * this->_buf_size));
+    if (this->_buf_base == nullptr)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring buffer alloc failure: "));
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<t_u64>(ring);
+    reg.ring_entries = this->_buf_count;
+    reg.bgid = 0;
+    if (syscall(__NR_io_uring_register, this->_ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring buffer ring register failure: "));
+    for (t_u32 bid = 0; bid < this->_buf_count; ++bid)
+        this->_RecycleBuffer(bid);
+};
+
+/**
+ * @brief Releases every resource acquired by the constructor.
+ */
+void TcpInitializer::UringIoBackend::_Release(void) noexcept {
+    if (this->_buf_ring != MAP_FAILED)
+        munmap(this->_buf_ring, this->_buf_count * sizeof(struct io_uring_buf));
+    this->_buf_ring = static_cast<struct io_uring_buf_ring *>(MAP_FAILED);
+    std::free(this->_buf_base);
+    this->_buf_base = nullptr;
+    if (this->_sqes != MAP_FAILED)
+        munmap(this->_sqes, this->_params.sq_entries * sizeof(struct io_uring_sqe));
+    this->_sqes = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    if (this->_sq_ptr != MAP_FAILED)
+        munmap(this->_sq_ptr, this->_sq_size);
+    this->_sq_ptr = this->_cq_ptr = MAP_FAILED;
+    if (this->_wake_fd >= 0)
+        close(this->_wake_fd);
+    this->_wake_fd = -1;
+    if (this->_ring_fd >= 0)
+        close(this->_ring_fd);
+    this->_ring_fd = -1;
+};
+
+/**
+ * @brief Gets the state of a socket, creating it on first use.
+ *
+ * @param _sock The socket.
+ * @returns A pointer to the state, or nullptr for an invalid socket.
+ */
+TcpInitializer::UringIoBackend::FdState *TcpInitializer::UringIoBackend::_StateOf(const t_sock _sock) {
+    if (_sock < 0)
+        return nullptr;
+    if (static_cast<std::size_t>(_sock) >= this->_fds.size())
+        this->_fds.resize(std::max<std::size_t>(static_cast<std::size_t>(_sock) + 1, this->_fds.size() * 2));
+    std::unique_ptr<FdState> &state(this->_fds[_sock]);
+    if (!state) {
+        state = std::make_unique<FdState>();
+        state->sock = _sock;
+    }
+    return state.get();
+};
+
+/**
+ * @brief Gets a zeroed submission entry, flushing the queue to the kernel when it is full.
+ *
+ * Without SQPOLL the kernel only reads entries during io_uring_enter, so publishing the tail
+ * before the caller fills the entry is safe.
+ *
+ * @returns A pointer to the submission entry.
+ */
+struct io_uring_sqe *TcpInitializer::UringIoBackend::_GetSqe(void) {
+    t_u32 tail(*this->_sq_tail);
+    if (tail - __atomic_load_n(this->_sq_head, __ATOMIC_ACQUIRE) >= this->_params.sq_entries) {
+        this->_Submit(0, 0);
+        tail = *this->_sq_tail;
+    }
+    const t_u32 index(tail & this->_sq_mask);
+    struct io_uring_sqe *sqe(&this->_sqes[index]);
+    memset(sqe, 0, sizeof(*sqe));
+    this->_sq_array[index] = index;
+    __atomic_store_n(this->_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++this->_sq_pending;
+    return sqe;
+};
+
+/**
+ * @brief Submits pending entries and optionally waits for completions in the same syscall.
+ *
+ * @param _wait_nr Minimum number of completions to wait for.
+ * @param _timeout_ms Wait timeout in milliseconds, -1 waits without limit.
+ * @returns The number of entries submitted.
+ * @throws std::runtime_error If io_uring_enter fails.
+ */
+int TcpInitializer::UringIoBackend::_Submit(const t_u32 _wait_nr, const int _timeout_ms) {
+    t_u32 flags(_wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    struct __kernel_timespec timeout;
+    struct io_uring_getevents_arg arg;
+    const void *arg_ptr(nullptr);
+    std::size_t arg_size(URING_KERNEL_SIGSET_SIZE);
+    if (_wait_nr > 0 && _timeout_ms >= 0) {
+        timeout.tv_sec = _timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long long>(_timeout_ms % 1000) * 1000000;
+        memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = URING_KERNEL_SIGSET_SIZE;
+        arg.ts = reinterpret_cast<t_u64>(&timeout);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg_ptr = &arg;
+        arg_size = sizeof(arg);
+    }
+    const long submitted(syscall(__NR_io_uring_enter, this->_ring_fd, this->_sq_pending, _wait_nr, flags, arg_ptr, arg_size));
+    if (submitted < 0) {
+        if (errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            return 0;
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("io_uring enter failure: "));
+    }
+    this->_sq_pending -= std::min<t_u32>(this->_sq_pending, static_cast<t_u32>(submitted));
+    return static_cast<int>(submitted);
+};
+
+/**
+ * @brief Queues a multishot accept for a listener.
+ *
+ * @param _state The listener state.
+ */
+void TcpInitializer::UringIoBackend::_ArmAccept(FdState *_state) {
+    struct io_uring_sqe *sqe(this->_GetSqe());
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _state->sock;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = reinterpret_cast<t_u64>(_state) | OP_ACCEPT;
+    ++_state->inflight;
+};
+
+/**
+ * @brief Queues a receive selecting its buffer from group 0, multishot when the kernel allows it.
+ *
+ * @param _state The connection state.
+ */
+void TcpInitializer::UringIoBackend::_ArmRecv(FdState *_state) {
+    struct io_uring_sqe *sqe(this->_GetSqe());
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = _state->sock;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->ioprio = this->_multishot_recv ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = reinterpret_cast<t_u64>(_state) | OP_RECV;
+    ++_state->inflight;
+};
+
+/**
+ * @brief Queues a multishot poll on the wake-up eventfd used by Stop().
+ */
+void TcpInitializer::UringIoBackend::_ArmWake(void) {
+    struct io_uring_sqe *sqe(this->_GetSqe());
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = this->_wake_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = OP_WAKE;
+};
+
+/**
+ * @brief Queues the unwritten head of the send queue as one chain of linked send entries.
+ *
+ * Every entry carries MSG_WAITALL, so a send that stops short fails and cancels the rest of the
+ * chain instead of letting the next payload go out behind a gap; the remainder is resubmitted
+ * from the completion handler once the chain has drained. Each entry is tagged with its payload.
+ * The chain is cut to the free submission slots, the rest follows with the next chain.
+ *
+ * @param _state The connection state.
+ */
+void TcpInitializer::UringIoBackend::_SubmitSendChain(FdState *_state) {
+    PendingSend *chain[DEFAULT_SEND_CHAIN_MAX];
+    std::size_t length(0);
+    for (std::deque<PendingSend>::iterator pending = _state->sends.begin(); pending != _state->sends.end() && length < DEFAULT_SEND_CHAIN_MAX; ++pending) {
+        if (pending->offset < pending->data.length())
+            chain[length++] = &*pending;
+    }
+    // a chain must reach the kernel in one submission, split across two it would run as two concurrent chains
+    t_u32 space(this->_params.sq_entries - (*this->_sq_tail - __atomic_load_n(this->_sq_head, __ATOMIC_ACQUIRE)));
+    if (space < length) {
+        this->_Submit(0, 0);
+        space = this->_params.sq_entries - (*this->_sq_tail - __atomic_load_n(this->_sq_head, __ATOMIC_ACQUIRE));
+        length = std::min<std::size_t>(length, std::max<t_u32>(space, 1u));
+    }
+    for (std::size_t i = 0; i < length; ++i) {
+        PendingSend &pending(*chain[i]);
+        struct io_uring_sqe *sqe(this->_GetSqe());
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = _state->sock;
+        sqe->addr = reinterpret_cast<t_u64>(pending.data.data() + pending.offset);
+        sqe->len = static_cast<t_u32>(pending.data.length() - pending.offset);
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+        sqe->flags = i + 1 < length ? IOSQE_IO_LINK : 0;
+        sqe->user_data = reinterpret_cast<t_u64>(&pending) | OP_SEND;
+        ++pending.inflight;
+        ++_state->inflight;
+        ++_state->chain;
+    }
+};
+
+/**
+ * @brief Hands a receive buffer back to the kernel.
+ *
+ * @param _bid The buffer id.
+ */
+void TcpInitializer::UringIoBackend::_RecycleBuffer(const t_u32 _bid) noexcept {
+    struct io_uring_buf *bufs(reinterpret_cast<struct io_uring_buf *>(this->_buf_ring));
+    const t_u16 tail(this->_buf_ring->tail);
+    struct io_uring_buf &buf(bufs[tail & (this->_buf_count - 1)]);
+    buf.addr = reinterpret_cast<t_u64>(this->_buf_base + static_cast<std::size_t>(_bid) * this->_buf_size);
+    buf.len = this->_buf_size;
+    buf.bid = static_cast<t_u16>(_bid);
+    __atomic_store_n(&this->_buf_ring->tail, static_cast<t_u16>(tail + 1), __ATOMIC_RELEASE);
+};
+
+/**
+ * @brief Routes one completion to its operation handler.
+ *
+ * @param _cqe The completion entry.
+ */
+void TcpInitializer::UringIoBackend::_Complete(const struct io_uring_cqe &_cqe) {
+    const t_u64 op(_cqe.user_data & 7u);
+    FdState *state(reinterpret_cast<FdState *>(_cqe.user_data & ~static_cast<t_u64>(7u)));
+    const bool more((_cqe.flags & IORING_CQE_F_MORE) != 0);
+    switch (op) {
+    case OP_WAKE: {
+        t_u64 signal(0);
+        while (read(this->_wake_fd, &signal, sizeof(signal)) > 0) {
+        }
+        if (!more)
+            this->_ArmWake();
+        return;
+    }
+    case OP_ACCEPT:
+        if (!more)
+            --state->inflight;
+        if (state->closed) {
+            if (_cqe.res >= 0)
+                close(_cqe.res);
+            return;
+        }
+        if (_cqe.res >= 0) {
+            state->on_accept(*this, _cqe.res);
+        } else if (_cqe.res != -EAGAIN && _cqe.res != -EINTR && _cqe.res != -ECONNABORTED) {
+            TcpInitializer::Socket::Log("accept failure: ", strerror(-_cqe.res), '\n');
+        }
+        if (!more && !state->closed && _cqe.res != -EINVAL && _cqe.res != -EBADF)
+            this->_ArmAccept(state);
+        return;
+    case OP_RECV:
+        this->_CompleteRecv(state, _cqe);
+        return;
+    case OP_SEND:
+        this->_CompleteSend(reinterpret_cast<PendingSend *>(state), _cqe.res);
+        return;
+    default:
+        return;
+    }
+};
+
+/**
+ * @brief Delivers a received block and recycles its buffer, re-arming the receive when it ended.
+ *
+ * @param _state The connection state.
+ * @param _cqe The completion entry.
+ */
+void TcpInitializer::UringIoBackend::_CompleteRecv(FdState *_state, const struct io_uring_cqe &_cqe) {
+    const bool more((_cqe.flags & IORING_CQE_F_MORE) != 0);
+    const bool has_buffer((_cqe.flags & IORING_CQE_F_BUFFER) != 0);
+    const t_u32 bid(_cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+    if (!more)
+        --_state->inflight;
+    if (_state->closed) {
+        if (has_buffer)
+            this->_RecycleBuffer(bid);
+        return;
+    }
+    if (_cqe.res > 0 && has_buffer) {
+        Metrics::bytes_in.Add(static_cast<t_u64>(_cqe.res));
+        ConnectionTable::AccountOwner(_state->sock, static_cast<t_u64>(_cqe.res), 0);
+        _state->on_read(*this, _state->sock, t_strw(this->_buf_base + static_cast<std::size_t>(bid) * this->_buf_size, static_cast<std::size_t>(_cqe.res)));
+        this->_RecycleBuffer(bid);
+        if (!more && !_state->closed)
+            this->_ArmRecv(_state);
+        return;
+    }
+    if (has_buffer)
+        this->_RecycleBuffer(bid);
+    if (_cqe.res == -ENOBUFS || _cqe.res == -EINTR || _cqe.res == -EAGAIN) {
+        if (!more)
+            this->_ArmRecv(_state);
+        return;
+    }
+    if (_cqe.res == -EINVAL && this->_multishot_recv) {
+        // kernels before 6.0 reject multishot receive, fall back to re-arming single shots
+        this->_multishot_recv = false;
+        this->_ArmRecv(_state);
+        return;
+    }
+    if (!more) {
+        read_cb on_read(std::move(_state->on_read));
+        on_read(*this, _state->sock, t_strw());
+    }
+};
+
+/**
+ * @brief Accounts one send completion to its payload and resubmits the queue once the chain has drained.
+ *
+ * Payloads leave the queue in order once they are written (or failed) and no entry refers to
+ * them anymore, since the kernel may still read the buffer of a cancelled link.
+ *
+ * @param _pending The payload the completed entry was writing.
+ * @param _res The completion result.
+ */
+void TcpInitializer::UringIoBackend::_CompleteSend(PendingSend *_pending, const int _res) {
+    FdState *state(_pending->state);
+    --_pending->inflight;
+    --state->inflight;
+    --state->chain;
+    if (state->closed)
+        return;
+    if (_res >= 0) {
+        Metrics::bytes_out.Add(static_cast<t_u64>(_res));
+        ConnectionTable::AccountOwner(state->sock, 0, static_cast<t_u64>(_res));
+        _pending->offset += static_cast<t_u64>(_res);
+    } else if (_res != -ECANCELED && _res != -EAGAIN && _res != -EINTR) {
+        // the peer is gone, every queued payload fails with it; callbacks may queue more behind them
+        const std::size_t queued(state->sends.size());
+        for (std::size_t i = 0; i < queued; ++i) {
+            PendingSend &pending(state->sends[i]);
+            pending.offset = pending.data.length();
+            send_cb on_sent(std::move(pending.on_sent));
+            pending.on_sent = nullptr;
+            if (on_sent)
+                on_sent(*this, state->sock, false);
+            if (state->closed)
+                return;
+        }
+    }
+    while (!state->sends.empty() && state->sends.front().inflight == 0 && state->sends.front().offset == state->sends.front().data.length()) {
+        send_cb on_sent(std::move(state->sends.front().on_sent));
+        state->sends.pop_front();
+        if (on_sent)
+            on_sent(*this, state->sock, true);
+        if (state->closed)
+            return;
+    }
+    if (state->chain > 0 || state->sends.empty())
+        return;
+    this->_SubmitSendChain(state);
+};
+
+/**
+ * @brief Frees the state of closed sockets whose last completion has arrived.
+ */
+void TcpInitializer::UringIoBackend::_Settle(void) noexcept {
+    for (std::size_t i = 0; i < this->_closing.size();) {
+        if (this->_closing[i]->inflight > 0) {
+            ++i;
+            continue;
+        }
+        std::swap(this->_closing[i], this->_closing.back());
+        this->_closing.pop_back();
+    }
+};
+
+/**
+ * @brief Creates the preferred backend, falling back to epoll when io_uring is unavailable.
+ *
+ * @param _type IoBackendType::AUTO and IO_URING try io_uring first, EPOLL forces the reactor.
+ * @returns The created backend.
+ */
+std::unique_ptr<TcpInitializer::IoBackend> TcpInitializer::MakeIoBackend(const IoBackendType _type) {
+    if (_type != IoBackendType::EPOLL) {
+        try {
+            return std::make_unique<UringIoBackend>();
+        } catch (const t_except &e) {
+            TcpInitializer::Socket::Log("io_uring unavailable, using epoll: ", e.what(), '\n');
+        }
+    }
+    return std::make_unique<EpollIoBackend>();
+};
+
+#endif
@@ -0,0 +1,215 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_IOBACKEND_V0_0_1_HPP
+#define UNIX_G4TCPP_IOBACKEND_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_URING_ENTRIES          1024u
+#define DEFAULT_URING_BUFFER_COUNT     1024u
+#define DEFAULT_URING_BUFFER_SIZE      DEFAULT_BUFFER_MAX_SIZE
+#define DEFAULT_SEND_CHAIN_MAX         16u
+#define URING_KERNEL_SIGSET_SIZE       8u
+
+enum class IoBackendType
+{
+    AUTO,
+    EPOLL,
+    IO_URING
+};
+
+/**
+ * Completion-style I/O surface shared by the epoll and io_uring backends.
+ *
+ * Accept and Read stay armed until the socket is closed: every accepted socket and every received
+ * block is reported through the callback. The data view passed to a read callback is only valid
+ * for the duration of the call, an empty view reports end of stream or a receive error, after
+ * which the socket should be closed with Close. Send copies the payload, so the caller buffers
+ * can be reused immediately; sends on one socket are written in submission order.
+ */
+class IoBackend
+{
+  public:
+    using accept_cb  = std::function<void(IoBackend &, const t_sock)>;
+    using read_cb    = std::function<void(IoBackend &, const t_sock, const t_strw)>;
+    using send_cb    = std::function<void(IoBackend &, const t_sock, const bool)>;
+
+    virtual ~IoBackend() = default;
+
+    virtual                 bool    Accept                  (const t_sock _listen_sock, accept_cb _on_accept) = 0;
+    virtual                 bool    Read                    (const t_sock _sock, read_cb _on_read) = 0;
+    virtual                 bool    Send                    (const t_sock _sock, const t_strw *_buffers, const std::size_t _count, send_cb _on_sent = nullptr) = 0;
+    virtual                 void    Close                   (const t_sock _sock) noexcept = 0;
+    virtual                 t_u32   RunOnce                 (const int _timeout_ms = DEFAULT_LOOP_TIMEOUT_MS) = 0;
+    virtual                 void    Stop                    (void) noexcept = 0;
+    virtual                 IoBackendType GetType           (void) const noexcept = 0;
+
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_sock _sock, const t_strw _buffer, send_cb _on_sent = nullptr);
+    __attribute__((cold                                            ))  inline               void    Run                     (void);
+
+  protected:
+    std::atomic<bool>                                     _running { false };
+};
+
+/**
+ * IoBackend driven by the EventLoop reactor, used everywhere io_uring is unavailable.
+ */
+class EpollIoBackend final : public IoBackend
+{
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_str              data        {                                                    };
+        t_u64              offset      {                                                    };
+        send_cb            on_sent     {                                                    };
+    } PendingSend;
+
+    typedef struct alignas(void *)
+    {
+        read_cb            on_read     {                                                    };
+        std::deque<PendingSend> sends  {                                                    };
+        t_u32              generation  {                                                    };
+        bool               watched     {                                                    };
+    } FdState;
+
+    EventLoop                                             _loop;
+    std::deque<FdState>                                   _fds;
+    std::vector<char>                                     _buffer;
+
+  public:
+    __attribute__((cold                                            ))                          EpollIoBackend          (void);
+
+    bool          Accept   (const t_sock _listen_sock, accept_cb _on_accept) override;
+    bool          Read     (const t_sock _sock, read_cb _on_read) override;
+    bool          Send     (const t_sock _sock, const t_strw *_buffers, const std::size_t _count, send_cb _on_sent = nullptr) override;
+    void          Close    (const t_sock _sock) noexcept override;
+    t_u32         RunOnce  (const int _timeout_ms = DEFAULT_LOOP_TIMEOUT_MS) override;
+    void          Stop     (void) noexcept override;
+    IoBackendType GetType  (void) const noexcept override;
+    using IoBackend::Send;
+
+  protected:
+    __attribute__((hot                                             ))  inline               FdState &_StateOf               (const t_sock _sock);
+    __attribute__((hot                                             ))  inline               bool    _Watch                  (const t_sock _sock);
+    __attribute__((hot                                             ))  inline               void    _OnReadable             (const t_sock _sock);
+    __attribute__((hot                                             ))  inline               void    _OnWritable             (const t_sock _sock);
+    __attribute__((cold                                            ))  inline               void    _OnClosed               (const t_sock _sock) noexcept;
+};
+
+/**
+ * IoBackend on top of a raw io_uring instance (no liburing dependency).
+ *
+ * Listeners use one multishot accept, connections use one multishot recv that picks buffers from
+ * a registered buffer ring, and queued sends of a socket are submitted as a chain of linked send
+ * SQEs, each tagged with the payload it writes. Pending submissions are flushed together with the
+ * wait for completions, so a loop tick costs a single io_uring_enter call however many operations
+ * it carries.
+ */
+class UringIoBackend final : public IoBackend
+{
+  protected:
+    enum UringOp : t_u64
+    {
+        OP_ACCEPT = 1,
+        OP_RECV   = 2,
+        OP_SEND   = 3,
+        OP_CANCEL = 4,
+        OP_WAKE   = 5
+    };
+
+    struct FdState;
+
+    typedef struct alignas(void *)
+    {
+        t_str              data        {                                                    };
+        t_u64              offset      {                                                    };
+        send_cb            on_sent     {                                                    };
+        FdState           *state       {                                                    };
+        t_u32              inflight    {                                                    };
+    } PendingSend;
+
+    typedef struct alignas(8) FdState
+    {
+        t_sock             sock        { -1                                                 };
+        accept_cb          on_accept   {                                                    };
+        read_cb            on_read     {                                                    };
+        std::deque<PendingSend> sends  {                                                    };
+        t_u32              inflight    {                                                    };
+        t_u32              chain       {                                                    };
+        bool               closed      {                                                    };
+    } FdState;
+
+    t_sock                                                _ring_fd;
+    t_sock                                                _wake_fd;
+    t_u64                                                 _wake_value;
+    struct io_uring_params                                _params;
+    void                                                 *_sq_ptr;
+    void                                                 *_cq_ptr;
+    std::size_t                                           _sq_size;
+    std::size_t                                           _cq_size;
+    struct io_uring_sqe                                  *_sqes;
+    t_u32                                                *_sq_head;
+    t_u32                                                *_sq_tail;
+    t_u32                                                *_sq_array;
+    t_u32                                                 _sq_mask;
+    t_u32                                                *_cq_head;
+    t_u32                                                *_cq_tail;
+    struct io_uring_cqe                                  *_cqes;
+    t_u32                                                 _cq_mask;
+    t_u32                                                 _sq_pending;
+    struct io_uring_buf_ring                             *_buf_ring;
+    char                                                 *_buf_base;
+    t_u32                                                 _buf_count;
+    t_u32                                                 _buf_size;
+    bool                                                  _multishot_recv;
+    std::vector<std::unique_ptr<FdState>>                 _fds;
+    std::vector<std::unique_ptr<FdState>>                 _closing;
+
+  public:
+    __attribute__((cold                                            ))  explicit                UringIoBackend          (const t_u32 _entries = DEFAULT_URING_ENTRIES, const t_u32 _buffer_count = DEFAULT_URING_BUFFER_COUNT, const t_u32 _buffer_size = DEFAULT_URING_BUFFER_SIZE);
+    UringIoBackend(const UringIoBackend &)            = delete;
+    UringIoBackend &operator=(const UringIoBackend &) = delete;
+    __attribute__((cold                                            ))                          ~UringIoBackend         () override;
+
+    bool          Accept   (const t_sock _listen_sock, accept_cb _on_accept) override;
+    bool          Read     (const t_sock _sock, read_cb _on_read) override;
+    bool          Send     (const t_sock _sock, const t_strw *_buffers, const std::size_t _count, send_cb _on_sent = nullptr) override;
+    void          Close    (const t_sock _sock) noexcept override;
+    t_u32         RunOnce  (const int _timeout_ms = DEFAULT_LOOP_TIMEOUT_MS) override;
+    void          Stop     (void) noexcept override;
+    IoBackendType GetType  (void) const noexcept override;
+    using IoBackend::Send;
+
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    IsSupported             (void) noexcept;
+
+  protected:
+    __attribute__((cold                                            ))  inline               void    _MapRings               (void);
+    __attribute__((cold                                            ))  inline               void    _SetupBufferRing        (void);
+    __attribute__((cold                                            ))  inline               void    _Release                (void) noexcept;
+    __attribute__((hot                                             ))  inline               FdState *_StateOf               (const t_sock _sock);
+    __attribute__((hot, warn_unused_result                         ))  inline               struct io_uring_sqe *_GetSqe    (void);
+    __attribute__((hot                                             ))  inline               int     _Submit                 (const t_u32 _wait_nr, const int _timeout_ms);
+    __attribute__((hot                                             ))  inline               void    _ArmAccept              (FdState *_state);
+    __attribute__((hot                                             ))  inline               void    _ArmRecv                (FdState *_state);
+    __attribute__((hot                                             ))  inline               void    _ArmWake                (void);
+    __attribute__((hot                                             ))  inline               void    _SubmitSendChain        (FdState *_state);
+    __attribute__((hot                                             ))  inline               void    _RecycleBuffer          (const t_u32 _bid) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Complete               (const struct io_uring_cqe &_cqe);
+    __attribute__((hot                                             ))  inline               void    _CompleteRecv           (FdState *_state, const struct io_uring_cqe &_cqe);
+    __attribute__((hot                                             ))  inline               void    _CompleteSend           (PendingSend *_pending, const int _res);
+    __attribute__((hot                                             ))  inline               void    _Settle                 (void) noexcept;
+};
+
+__attribute__((cold, warn_unused_result                        ))  inline std::unique_ptr<IoBackend> MakeIoBackend(const IoBackendType _type = IoBackendType::AUTO);
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef UNIX_G4TCPP_PIPELINE_V0_0_1_HPP
+
+#include "unix-g4tcpp-framing_v0_0_1.cpp"
+#include "unix-g4tcpp-pipeline_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates an unconnected client.
+ *
+ * @param _max_in_flight Most requests waiting for an answer at once, at least one.
+ */
+TcpInitializer::PipelineClient::PipelineClient(const t_u32 _max_in_flight)
+    : _connection(), _decoder(), _pending(), _deadlines(), _ready(), _next_id(1), _max_in_flight(_max_in_flight > 0 ? _max_in_flight : 1), _open(false), _timeouts(0),
+      _late_replies(0), _reader(), _mtx(), _slot_cv() {
+    this->_decoder = std::make_unique<TcpInitializer::FrameDecoder>(std::make_unique<TcpInitializer::LengthPrefixCodec>(LengthPrefix::U32_BE),
+                                                                    [this](FrameDecoder &, const t_strw *_frames, const std::size_t _count) -> void { this->_OnFrames(_frames, _count); });
+    this->_pending.reserve(this->_max_in_flight);
+};
+
+/**
+ * @brief Closes the connection, waiting requests complete with CLOSED.
+ */
+TcpInitializer::PipelineClient::~PipelineClient() {
+    this->Close();
+};
+
+/**
+ * @brief Connects and starts the reader thread.
+ *
+ * @param _address Any address TcpConnection::Connect takes, including "unix:" paths.
+ * @param _port The port number to connect to.
+ * @returns true if connected, false otherwise (errno EISCONN if already open).
+ */
+bool TcpInitializer::PipelineClient::Connect(const t_strw _address, const t_u16 _port) {
+    if (this->IsOpen()) {
+        errno = EISCONN;
+        return false;
+    }
+    if (this->_reader.joinable())
+        this->_reader.join();
+    // the socket of a lost connection is still connected in the kernel, connecting it again fails with EISCONN
+    this->_connection.Close();
+    if (!this->_connection.Connect(_address, _port))
+        return false;
+    // requests are small and many, waiting for Nagle to fill a segment only adds latency
+    const int enable(1);
+    setsockopt(*this->_connection.GetSocket(), IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    this->_decoder->Reset();
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_open = true;
+    }
+    this->_reader = std::thread(&TcpInitializer::PipelineClient::_Run, this);
+    return true;
+};
+
+/**
+ * @brief Sends a request and completes the callback with its answer, a timeout or the connection loss.
+ *
+ * Blocks while max_in_flight requests are waiting, at most until the request's own deadline.
+ *
+ * @param _body The request payload.
+ * @param _on_reply Receives the result, on the reader thread (or inline if the request never went out).
+ * @param _timeout_ms Deadline of the request, counted from the call.
+ * @returns The correlation id of the request.
+ */
+TcpInitializer::t_u64 TcpInitializer::PipelineClient::Call(const t_strw _body, reply_cb _on_reply, const t_u32 _timeout_ms) {
+    const t_u64 id(this->_next_id.fetch_add(1, std::memory_order_relaxed));
+    const t_u64 started(TcpInitializer::Metrics::Now());
+    const std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(_timeout_ms));
+    CallResult result;
+    result.id = id;
+    bool rejected(false);
+    {
+        std::unique_lock<std::mutex> lock(this->_mtx);
+        const bool admitted(this->_slot_cv.wait_until(lock, deadline, [this]() -> bool { return !this->_open || this->_pending.size() < this->_max_in_flight; }));
+        if (this->_open && admitted) {
+            Pending pending;
+            pending.on_reply = std::move(_on_reply);
+            pending.started_ns = started;
+            pending.deadline = this->_deadlines.emplace(started + static_cast<t_u64>(_timeout_ms) * 1000000ull, id);
+            this->_pending.emplace(id, std::move(pending));
+        } else {
+            rejected = true;
+            result.status = this->_open ? CallStatus::TIMEOUT : CallStatus::CLOSED;
+            if (result.status == CallStatus::TIMEOUT)
+                ++this->_timeouts;
+        }
+    }
+    if (rejected) {
+        // never sent, completed on the calling thread
+        if (_on_reply)
+            _on_reply(std::move(result));
+        return id;
+    }
+    t_str frame;
+    frame.reserve(sizeof(t_u32) + PIPELINE_ID_SIZE + _body.size());
+    TcpInitializer::PipelineClient::EncodeFrame(id, _body, frame);
+    if (!this->_connection.Send(frame)) {
+        // part of the frame may be on the wire, the stream cannot be trusted any more
+        std::vector<completion> done;
+        {
+            std::lock_guard<std::mutex> lock(this->_mtx);
+            this->_Complete(id, CallStatus::CLOSED, t_strw(), TcpInitializer::Metrics::Now(), done);
+            if (this->_open)
+                shutdown(*this->_connection.GetSocket(), SHUT_RDWR);
+        }
+        this->_slot_cv.notify_one();
+        TcpInitializer::PipelineClient::_Deliver(done);
+    }
+    return id;
+};
+
+/**
+ * @brief Sends a request and returns a future of its result.
+ *
+ * @param _body The request payload.
+ * @param _timeout_ms Deadline of the request, counted from the call.
+ * @returns The future, ready once the answer arrived, the deadline passed or the connection broke.
+ */
+std::future<TcpInitializer::PipelineClient::CallResult> TcpInitializer::PipelineClient::Call(const t_strw _body, const t_u32 _timeout_ms) {
+    std::shared_ptr<std::promise<CallResult>> promise(std::make_shared<std::promise<CallResult>>());
+    std::future<CallResult> result(promise->get_future());
+    this->Call(_body, [promise](CallResult &&_result) -> void { promise->set_value(std::move(_result)); }, _timeout_ms);
+    return result;
+};
+
+/**
+ * @brief Closes the connection and stops the reader; waiting requests complete with CLOSED.
+ *
+ * From a callback, on the reader thread, the connection is shut down and the reader stops on its own.
+ */
+void TcpInitializer::PipelineClient::Close(void) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->_open)
+            shutdown(*this->_connection.GetSocket(), SHUT_RDWR);
+    }
+    if (this->_reader.joinable() && this->_reader.get_id() == std::this_thread::get_id())
+        return;
+    if (this->_reader.joinable())
+        this->_reader.join();
+    this->_connection.Close();
+};
+
+/**
+ * @brief Checks whether requests can be sent.
+ *
+ * @returns true while the connection is open, false otherwise.
+ */
+bool TcpInitializer::PipelineClient::IsOpen(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_open;
+};
+
+/**
+ * @brief Gets the number of requests waiting for an answer.
+ *
+ * @returns The in-flight count.
+ */
+TcpInitializer::t_u64 TcpInitializer::PipelineClient::GetInFlight(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_pending.size();
+};
+
+/**
+ * @brief Gets the number of requests completed with TIMEOUT.
+ *
+ * @returns The timeout count.
+ */
+TcpInitializer::t_u64 TcpInitializer::PipelineClient::GetTimeoutCount(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_timeouts;
+};
+
+/**
+ * @brief Gets the number of answers dropped because their request had already timed out, or unknown ids.
+ *
+ * @returns The late reply count.
+ */
+TcpInitializer::t_u64 TcpInitializer::PipelineClient::GetLateReplyCount(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_late_replies;
+};
+
+/**
+ * @brief Appends a request or response frame: u32 big-endian length, 8-byte big-endian id, body.
+ *
+ * @param _id The correlation id, a server echoes the id of the request it answers.
+ * @param _body The payload.
+ * @param _dest Receives the frame.
+ */
+void TcpInitializer::PipelineClient::EncodeFrame(const t_u64 _id, const t_strw _body, t_str &_dest) {
+    const t_u32 wire_size(htonl(static_cast<t_u32>(PIPELINE_ID_SIZE + _body.size())));
+    char wire_id[PIPELINE_ID_SIZE];
+    for (t_u32 i = 0; i < PIPELINE_ID_SIZE; ++i) {
+        wire_id[i] = static_cast<char>((_id >> (8 * (PIPELINE_ID_SIZE - 1 - i))) & 0xff);
+    }
+    _dest.append(reinterpret_cast<const char *>(&wire_size), sizeof(wire_size));
+    _dest.append(wire_id, PIPELINE_ID_SIZE);
+    _dest.append(_body.data(), _body.size());
+};
+
+/**
+ * @brief Splits a frame payload, as delivered by a FrameDecoder with a LengthPrefixCodec, into id and body.
+ *
+ * @param _payload The frame payload.
+ * @param _id Set to the correlation id.
+ * @param _body Set to the body, a view into _payload.
+ * @returns true if the payload holds an id, false otherwise.
+ */
+bool TcpInitializer::PipelineClient::ParseFrame(const t_strw _payload, t_u64 &_id, t_strw &_body) noexcept {
+    if (_payload.size() < PIPELINE_ID_SIZE)
+        return false;
+    _id = 0;
+    for (t_u32 i = 0; i < PIPELINE_ID_SIZE; ++i) {
+        _id = (_id << 8) | static_cast<unsigned char>(_payload[i]);
+    }
+    _body = _payload.substr(PIPELINE_ID_SIZE);
+    return true;
+};
+
+/**
+ * @brief Reader thread: waits for answers or the next deadline until the connection ends.
+ */
+void TcpInitializer::PipelineClient::_Run(void) {
+    const t_sock sock(*this->_connection.GetSocket());
+    for (;;) {
+        t_u64 wait_ns(static_cast<t_u64>(DEFAULT_PIPELINE_TICK_MS) * 1000000ull);
+        {
+            std::lock_guard<std::mutex> lock(this->_mtx);
+            const t_u64 now(TcpInitializer::Metrics::Now());
+            if (!this->_deadlines.empty())
+                wait_ns = std::min(wait_ns, this->_deadlines.begin()->first > now ? this->_deadlines.begin()->first - now : 0);
+        }
+        struct pollfd pipeline_poll = {sock, POLLIN, 0};
+        // rounded up, a deadline is never reported before it passed
+        const int ready(poll(&pipeline_poll, 1, static_cast<int>((wait_ns + 999999ull) / 1000000ull)));
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (ready > 0 && !this->_decoder->Feed(sock))
+            break;
+        this->_Expire(TcpInitializer::Metrics::Now());
+    }
+    this->_FailAll();
+};
+
+/**
+ * @brief Matches a batch of answers to their requests.
+ *
+ * @param _frames The frame payloads, views into the decoder ring.
+ * @param _count The number of frames.
+ */
+void TcpInitializer::PipelineClient::_OnFrames(const t_strw *_frames, const std::size_t _count) {
+    const t_u64 now(TcpInitializer::Metrics::Now());
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        for (std::size_t i = 0; i < _count; ++i) {
+            t_u64 id(0);
+            t_strw body;
+            if (!TcpInitializer::PipelineClient::ParseFrame(_frames[i], id, body) || !this->_Complete(id, CallStatus::OK, body, now, this->_ready))
+                ++this->_late_replies;
+        }
+    }
+    this->_slot_cv.notify_all();
+    TcpInitializer::PipelineClient::_Deliver(this->_ready);
+};
+
+/**
+ * @brief Completes the requests whose deadline passed with TIMEOUT.
+ *
+ * @param _now_ns The current Metrics::Now time.
+ */
+void TcpInitializer::PipelineClient::_Expire(const t_u64 _now_ns) {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        while (!this->_deadlines.empty() && this->_deadlines.begin()->first <= _now_ns) {
+            this->_Complete(this->_deadlines.begin()->second, CallStatus::TIMEOUT, t_strw(), _now_ns, this->_ready);
+            ++this->_timeouts;
+        }
+    }
+    if (this->_ready.empty())
+        return;
+    this->_slot_cv.notify_all();
+    TcpInitializer::PipelineClient::_Deliver(this->_ready);
+};
+
+/**
+ * @brief Marks the connection closed and completes every waiting request with CLOSED.
+ */
+void TcpInitializer::PipelineClient::_FailAll(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_open = false;
+        const t_u64 now(TcpInitializer::Metrics::Now());
+        while (!this->_pending.empty()) {
+            this->_Complete(this->_pending.begin()->first, CallStatus::CLOSED, t_strw(), now, this->_ready);
+        }
+    }
+    this->_slot_cv.notify_all();
+    TcpInitializer::PipelineClient::_Deliver(this->_ready);
+};
+
+/**
+ * @brief Takes a request out of the pending table, the lock must be held.
+ *
+ * @param _id The correlation id.
+ * @param _status The outcome.
+ * @param _body The answer, copied.
+ * @param _now_ns The completion time.
+ * @param _done Receives the callback and result, to be delivered once the lock is released.
+ * @returns true if the request was pending, false otherwise.
+ */
+bool TcpInitializer::PipelineClient::_Complete(const t_u64 _id, const CallStatus _status, const t_strw _body, const t_u64 _now_ns, std::vector<completion> &_done) {
+    const std::unordered_map<t_u64, Pending>::iterator found(this->_pending.find(_id));
+    if (found == this->_pending.end())
+        return false;
+    CallResult result;
+    result.id = _id;
+    result.status = _status;
+    result.body.assign(_body.data(), _body.size());
+    result.latency_us = (_now_ns - found->second.started_ns) / 1000;
+    this->_deadlines.erase(found->second.deadline);
+    _done.emplace_back(std::move(found->second.on_reply), std::move(result));
+    this->_pending.erase(found);
+    return true;
+};
+
+/**
+ * @brief Runs completed callbacks, outside the lock so they may issue new requests.
+ *
+ * @param _done The completions, cleared afterwards.
+ */
+void TcpInitializer::PipelineClient::_Deliver(std::vector<completion> &_done) {
+    for (completion &done : _done) {
+        if (done.first)
+            done.first(std::move(done.second));
+    }
+    _done.clear();
+};
+
+#endif
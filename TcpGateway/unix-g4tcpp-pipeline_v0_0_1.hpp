@@ -0,0 +1,107 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_PIPELINE_V0_0_1_HPP
+#define UNIX_G4TCPP_PIPELINE_V0_0_1_HPP
+
+#include "unix-g4tcpp-framing_v0_0_1.hpp"
+
+#include <future>
+#include <map>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_PIPELINE_MAX_IN_FLIGHT 1024u
+#define DEFAULT_PIPELINE_TIMEOUT_MS    5000u
+#define DEFAULT_PIPELINE_TICK_MS       100u
+#define PIPELINE_ID_SIZE               8u
+
+enum class CallStatus
+{
+    OK,
+    TIMEOUT,
+    CLOSED
+};
+
+/**
+ * Multiplexing request/response client: many requests in flight on one connection.
+ *
+ * Every request goes out as one length-prefixed frame (LengthPrefixCodec, big-endian u32) whose
+ * payload starts with an 8-byte big-endian correlation id; the server answers with a frame that
+ * starts with the same id, in any order. EncodeFrame and ParseFrame implement that layout for the
+ * server side. A reader thread decodes the responses with a FrameDecoder, matches them to their
+ * requests and completes the callback or future; a request still unanswered at its deadline
+ * completes with TIMEOUT and a late answer to it is dropped. Callbacks run on the reader thread
+ * and must not block it.
+ *
+ * At most max_in_flight requests wait for an answer, further callers block until a slot frees
+ * or their own deadline passes. When the connection breaks, every waiting request completes with
+ * CLOSED. Call is thread-safe.
+ */
+class PipelineClient
+{
+  public:
+    typedef struct alignas(void *)
+    {
+        t_u64              id          {                                                    };
+        CallStatus         status      { CallStatus::CLOSED                                 };
+        t_str              body        {                                                    };
+        t_u64              latency_us  {                                                    };
+    } CallResult;
+
+    using reply_cb   = std::function<void(CallResult &&)>;
+
+  protected:
+    using completion = std::pair<reply_cb, CallResult>;
+
+    typedef struct alignas(void *)
+    {
+        reply_cb           on_reply    {                                                    };
+        t_u64              started_ns  {                                                    };
+        std::multimap<t_u64, t_u64>::iterator deadline {                                    };
+    } Pending;
+
+    TcpConnection                                         _connection;
+    std::unique_ptr<FrameDecoder>                         _decoder;
+    std::unordered_map<t_u64, Pending>                    _pending;
+    std::multimap<t_u64, t_u64>                           _deadlines;
+    std::vector<completion>                               _ready;
+    std::atomic<t_u64>                                    _next_id;
+    t_u32                                                 _max_in_flight;
+    bool                                                  _open;
+    t_u64                                                 _timeouts;
+    t_u64                                                 _late_replies;
+    std::thread                                           _reader;
+    mutable std::mutex                                    _mtx;
+    std::condition_variable                               _slot_cv;
+
+  public:
+    __attribute__((cold                                            ))  explicit                PipelineClient          (const t_u32 _max_in_flight = DEFAULT_PIPELINE_MAX_IN_FLIGHT);
+    PipelineClient(const PipelineClient &)            = delete;
+    PipelineClient &operator=(const PipelineClient &) = delete;
+    __attribute__((cold                                            ))                          ~PipelineClient         ();
+
+    __attribute__((cold                                            ))  inline               bool    Connect                 (const t_strw _address, const t_u16 _port);
+    __attribute__((hot                                             ))  inline               t_u64   Call                    (const t_strw _body, reply_cb _on_reply, const t_u32 _timeout_ms = DEFAULT_PIPELINE_TIMEOUT_MS);
+    __attribute__((hot, warn_unused_result                         ))  inline               std::future<CallResult> Call    (const t_strw _body, const t_u32 _timeout_ms = DEFAULT_PIPELINE_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               void    Close                   (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               bool    IsOpen                  (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetInFlight             (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetTimeoutCount         (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetLateReplyCount       (void) const noexcept;
+
+    __attribute__((hot                                             ))  inline static        void    EncodeFrame             (const t_u64 _id, const t_strw _body, t_str &_dest);
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool    ParseFrame              (const t_strw _payload, t_u64 &_id, t_strw &_body) noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               void    _Run                    (void);
+    __attribute__((hot                                             ))  inline               void    _OnFrames               (const t_strw *_frames, const std::size_t _count);
+    __attribute__((hot                                             ))  inline               void    _Expire                 (const t_u64 _now_ns);
+    __attribute__((cold                                            ))  inline               void    _FailAll                (void);
+    __attribute__((hot                                             ))  inline               bool    _Complete               (const t_u64 _id, const CallStatus _status, const t_strw _body, const t_u64 _now_ns, std::vector<completion> &_done);
+    __attribute__((hot                                             ))  inline static        void    _Deliver                (std::vector<completion> &_done);
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,405 @@
+#ifndef UNIX_G4TCPP_PROXY_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-upstream_v0_0_1.cpp"
+#include "unix-g4tcpp-proxy_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates a proxy forwarding every adopted client to one upstream.
+ *
+ * @param _loop The loop both sockets of every session are registered with.
+ * @param _upstream_address The upstream address, numeric IPv4 or IPv6.
+ * @param _upstream_port The upstream port.
+ * @param _pipe_size Requested capacity of each direction pipe.
+ * @throws std::runtime_error If the upstream address is invalid.
+ */
+TcpInitializer::TcpProxy::TcpProxy(EventLoop &_loop, const t_strw _upstream_address, const t_u16 _upstream_port, const t_u32 _pipe_size)
+    : _loop(&_loop), _upstream(), _upstream_size(0), _group(nullptr), _pipe_size(_pipe_size > 0 ? _pipe_size : DEFAULT_PROXY_PIPE_SIZE), _sessions(0), _bytes(0) {
+    TcpInitializer::IpAddress target;
+    if (_upstream_port == 0 || !TcpInitializer::AddressParser::ParseAddress(_upstream_address, target))
+        throw std::runtime_error("Proxy upstream Addr Eval failure");
+    target.port = _upstream_port;
+    if (!TcpInitializer::AddressParser::ToSockAddr(target, this->_upstream, this->_upstream_size))
+        throw std::runtime_error("Proxy upstream Addr Eval failure");
+};
+
+/**
+ * @brief Creates a proxy balancing every adopted client over the backends of a group.
+ *
+ * @param _loop The loop both sockets of every session are registered with.
+ * @param _group The backends, must outlive the proxy.
+ * @param _pipe_size Requested capacity of each direction pipe.
+ */
+TcpInitializer::TcpProxy::TcpProxy(EventLoop &_loop, UpstreamGroup &_group, const t_u32 _pipe_size) noexcept
+    : _loop(&_loop), _upstream(), _upstream_size(0), _group(&_group), _pipe_size(_pipe_size > 0 ? _pipe_size : DEFAULT_PROXY_PIPE_SIZE), _sessions(0), _bytes(0) {};
+
+/**
+ * @brief Proxies every connection accepted on a listening socket.
+ *
+ * @param _listen_sock The listening socket, registered with the proxy loop.
+ * @returns true if the listener was registered, false otherwise.
+ */
+bool TcpInitializer::TcpProxy::Serve(const t_sock _listen_sock) {
+    return this->_loop->AddListener(_listen_sock, [this](EventLoop &, ep_tcp &_client) -> void { this->Adopt(_client); });
+};
+
+/**
+ * @brief Starts a session for an accepted client, taking ownership of its socket.
+ *
+ * Also usable as the body of an accept callback of an existing loop or ShardedTcpServer shard,
+ * as long as the proxy was created on that same loop.
+ *
+ * @param _client The accepted client connection.
+ * @returns true if the session started, false if it could not be set up (the client is closed).
+ */
+bool TcpInitializer::TcpProxy::Adopt(const ep_tcp &_client) {
+    std::shared_ptr<Session> session(std::make_shared<Session>());
+    session->client = _client.sock;
+    const int nodelay(1);
+    if (!this->_OpenPipe(session->to_upstream) || !this->_OpenPipe(session->to_client)) {
+        TcpInitializer::Socket::Log("proxy pipe failure: ", strerror(errno), '\n');
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_upstream);
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_client);
+        close(_client.sock);
+        return false;
+    }
+    PeerAddress upstream_address(this->_upstream);
+    socklen_t upstream_size(this->_upstream_size);
+    if (this->_group != nullptr && !this->_group->Pick(TcpInitializer::TcpProxy::_AffinityOf(session->client), session->backend, upstream_address, upstream_size)) {
+        TcpInitializer::Socket::Log("proxy upstream pick failure: ", strerror(errno), '\n');
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_upstream);
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_client);
+        close(_client.sock);
+        return false;
+    }
+    session->dialed = std::chrono::steady_clock::now();
+    Metrics::connects.Add();
+    session->upstream = socket(upstream_address.addr.sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (session->upstream >= 0) {
+        setsockopt(session->upstream, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        if (connect(session->upstream, &upstream_address.addr, upstream_size) == 0)
+            session->connected = true;
+        else if (errno != EINPROGRESS) {
+            close(session->upstream);
+            session->upstream = -1;
+            session->failed = true;
+        }
+    }
+    if (session->upstream < 0) {
+        TcpInitializer::Socket::Log("proxy upstream connect failure: ", strerror(errno), '\n');
+        Metrics::connect_failures.Add();
+        if (this->_group != nullptr) {
+            if (session->failed)
+                this->_group->ReportFailure(session->backend);
+            this->_group->Release(session->backend);
+        }
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_upstream);
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_client);
+        close(_client.sock);
+        return false;
+    }
+    setsockopt(session->client, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+    EventLoop::IoHandlers client_handlers;
+    client_handlers.on_readable = [this, session](EventLoop &, ep_tcp &) -> void {
+        if (!session->connected || session->upstream_gone)
+            return;
+        if (!this->_Pump(*session, session->to_upstream, session->client, session->upstream))
+            return this->_Close(session);
+        this->_Settle(session);
+    };
+    client_handlers.on_writable = [this, session](EventLoop &, ep_tcp &) -> void {
+        if (!this->_Pump(*session, session->to_client, session->upstream, session->client))
+            return this->_Close(session);
+        this->_Settle(session);
+    };
+    client_handlers.on_close = [this, session](EventLoop &, ep_tcp &) -> void { this->_OnGone(session, true); };
+
+    EventLoop::IoHandlers upstream_handlers;
+    upstream_handlers.on_readable = [this, session](EventLoop &, ep_tcp &) -> void {
+        if (!session->connected || session->client_gone)
+            return;
+        if (!this->_Pump(*session, session->to_client, session->upstream, session->client))
+            return this->_Close(session);
+        this->_Settle(session);
+    };
+    upstream_handlers.on_writable = [this, session](EventLoop &, ep_tcp &) -> void {
+        if (!session->connected) {
+            int error(0);
+            socklen_t error_size(sizeof(error));
+            if (getsockopt(session->upstream, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0 || error != 0) {
+                session->failed = true;
+                return this->_Close(session);
+            }
+            return this->_OnConnected(session);
+        }
+        if (!this->_Pump(*session, session->to_upstream, session->client, session->upstream))
+            return this->_Close(session);
+        this->_Settle(session);
+    };
+    upstream_handlers.on_close = [this, session](EventLoop &, ep_tcp &) -> void { this->_OnGone(session, false); };
+
+    if (!this->_loop->AddConnection(ep_tcp{session->client, true}, std::move(client_handlers))) {
+        if (this->_group != nullptr)
+            this->_group->Release(session->backend);
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_upstream);
+        TcpInitializer::TcpProxy::_ClosePipe(session->to_client);
+        close(session->upstream);
+        close(session->client);
+        return false;
+    }
+    if (!this->_loop->AddConnection(ep_tcp{session->upstream, session->connected}, std::move(upstream_handlers))) {
+        close(session->upstream);
+        session->upstream_gone = true;
+        ++this->_sessions;
+        Metrics::sessions.Add();
+        this->_Close(session);
+        return false;
+    }
+    ++this->_sessions;
+    Metrics::sessions.Add();
+    if (session->connected)
+        this->_OnConnected(session);
+    else
+        this->_loop->WantWrite(session->upstream, true);
+    return true;
+};
+
+/**
+ * @brief Gets the number of live sessions.
+ *
+ * @returns The session count.
+ */
+t_u64 TcpInitializer::TcpProxy::GetSessionCount(void) const noexcept {
+    return this->_sessions;
+};
+
+/**
+ * @brief Gets the number of bytes delivered in either direction.
+ *
+ * @returns The forwarded byte count.
+ */
+t_u64 TcpInitializer::TcpProxy::GetBytesProxied(void) const noexcept {
+    return this->_bytes;
+};
+
+/**
+ * @brief Creates the pipe of one direction and sizes it.
+ *
+ * @param _direction The direction to prepare.
+ * @returns true if the pipe exists, false otherwise.
+ */
+bool TcpInitializer::TcpProxy::_OpenPipe(Direction &_direction) noexcept {
+    if (pipe2(_direction.pipe, O_NONBLOCK | O_CLOEXEC) < 0)
+        return false;
+    // the kernel may refuse a larger pipe, the default capacity still works
+    fcntl(_direction.pipe[1], F_SETPIPE_SZ, static_cast<int>(this->_pipe_size));
+    return true;
+};
+
+/**
+ * @brief Moves bytes of one direction: drains the pipe into the destination, then refills it from the source.
+ *
+ * A full destination enables its write interest and pauses reads on the source, a drained one
+ * undoes both. End of stream on the source is forwarded as a write shutdown once the pipe is empty.
+ *
+ * @param _session The session.
+ * @param _direction The direction to pump.
+ * @param _src The socket the direction reads from.
+ * @param _dst The socket the direction writes to.
+ * @returns true if the direction is healthy, false on a socket error.
+ */
+bool TcpInitializer::TcpProxy::_Pump(Session &_session, Direction &_direction, const t_sock _src, const t_sock _dst) noexcept {
+    if (_session.closing || _direction.pipe[0] < 0)
+        return true;
+    for (;;) {
+        while (_direction.buffered > 0) {
+            const ssize_t moved(splice(_direction.pipe[0], nullptr, _dst, nullptr, _direction.buffered, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+            if (moved > 0) {
+                _direction.buffered -= static_cast<t_u64>(moved);
+                this->_bytes += static_cast<t_u64>(moved);
+                Metrics::bytes_out.Add(static_cast<t_u64>(moved));
+                ConnectionTable::AccountOwner(_dst, 0, static_cast<t_u64>(moved));
+                continue;
+            }
+            if (moved < 0 && errno == EINTR)
+                continue;
+            if (moved < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!_direction.blocked) {
+                    _direction.blocked = true;
+                    this->_loop->WantWrite(_dst, true);
+                    if (!_direction.eof)
+                        this->_loop->WantRead(_src, false);
+                }
+                return true;
+            }
+            return false;
+        }
+        if (_direction.blocked) {
+            _direction.blocked = false;
+            this->_loop->WantWrite(_dst, false);
+            // re-arming read interest reports data that arrived while it was paused
+            if (!_direction.eof)
+                this->_loop->WantRead(_src, true);
+        }
+        if (_direction.eof) {
+            if (!_direction.shut) {
+                shutdown(_dst, SHUT_WR);
+                _direction.shut = true;
+            }
+            return true;
+        }
+        const ssize_t filled(splice(_src, nullptr, _direction.pipe[1], nullptr, this->_pipe_size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+        if (filled > 0) {
+            _direction.buffered += static_cast<t_u64>(filled);
+            Metrics::bytes_in.Add(static_cast<t_u64>(filled));
+            ConnectionTable::AccountOwner(_src, static_cast<t_u64>(filled), 0);
+            continue;
+        }
+        if (filled == 0) {
+            _direction.eof = true;
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+};
+
+/**
+ * @brief Starts forwarding once the upstream connect completed, picking up client data sent meanwhile.
+ *
+ * @param _session The session.
+ */
+void TcpInitializer::TcpProxy::_OnConnected(const std::shared_ptr<Session> &_session) noexcept {
+    _session->connected = true;
+    const t_u64 elapsed_ns(static_cast<t_u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _session->dialed).count()));
+    Metrics::connect_latency.Record(elapsed_ns);
+    if (this->_group != nullptr)
+        this->_group->ReportSuccess(_session->backend, elapsed_ns / 1000);
+    this->_loop->WantWrite(_session->upstream, false);
+    if (!this->_Pump(*_session, _session->to_upstream, _session->client, _session->upstream) ||
+        !this->_Pump(*_session, _session->to_client, _session->upstream, _session->client))
+        return this->_Close(_session);
+    this->_Settle(_session);
+};
+
+/**
+ * @brief Handles one socket being closed by the loop (hang-up or error).
+ *
+ * Bytes already read from the closed side are still delivered to the other side, bytes headed
+ * to the closed side are dropped.
+ *
+ * @param _session The session.
+ * @param _client true if the client socket closed, false for the upstream.
+ */
+void TcpInitializer::TcpProxy::_OnGone(const std::shared_ptr<Session> &_session, const bool _client) noexcept {
+    if (_session->closing)
+        return;
+    (_client ? _session->client_gone : _session->upstream_gone) = true;
+    // a refused or unreachable upstream shows up as a hang-up before the connect completed
+    if (!_client && !_session->connected)
+        _session->failed = true;
+    Direction &from_gone(_client ? _session->to_upstream : _session->to_client);
+    Direction &to_gone(_client ? _session->to_client : _session->to_upstream);
+    TcpInitializer::TcpProxy::_ClosePipe(to_gone);
+    from_gone.eof = true;
+    const bool other_alive(_client ? (!_session->upstream_gone && _session->connected) : !_session->client_gone);
+    if (!other_alive || from_gone.pipe[0] < 0)
+        return this->_Close(_session);
+    const t_sock src(_client ? _session->client : _session->upstream);
+    const t_sock dst(_client ? _session->upstream : _session->client);
+    if (!this->_Pump(*_session, from_gone, src, dst))
+        return this->_Close(_session);
+    this->_Settle(_session);
+};
+
+/**
+ * @brief Ends the session once both directions delivered their end of stream or were dropped.
+ *
+ * @param _session The session.
+ */
+void TcpInitializer::TcpProxy::_Settle(const std::shared_ptr<Session> &_session) noexcept {
+    const bool upstream_done(_session->to_upstream.shut || _session->to_upstream.pipe[0] < 0);
+    const bool client_done(_session->to_client.shut || _session->to_client.pipe[0] < 0);
+    if (upstream_done && client_done)
+        this->_Close(_session);
+};
+
+/**
+ * @brief Closes both sockets and both pipes of a session.
+ *
+ * @param _session The session.
+ */
+void TcpInitializer::TcpProxy::_Close(const std::shared_ptr<Session> &_session) noexcept {
+    if (_session->closing)
+        return;
+    _session->closing = true;
+    --this->_sessions;
+    Metrics::sessions.Sub();
+    if (_session->failed)
+        Metrics::connect_failures.Add();
+    if (this->_group != nullptr) {
+        if (_session->failed)
+            this->_group->ReportFailure(_session->backend);
+        this->_group->Release(_session->backend);
+    }
+    TcpInitializer::TcpProxy::_ClosePipe(_session->to_upstream);
+    TcpInitializer::TcpProxy::_ClosePipe(_session->to_client);
+    if (!_session->client_gone) {
+        _session->client_gone = true;
+        this->_loop->CloseConnection(_session->client);
+    }
+    if (!_session->upstream_gone) {
+        _session->upstream_gone = true;
+        this->_loop->CloseConnection(_session->upstream);
+    }
+};
+
+/**
+ * @brief Closes the pipe of one direction, dropping whatever it still buffers.
+ *
+ * @param _direction The direction.
+ */
+void TcpInitializer::TcpProxy::_ClosePipe(Direction &_direction) noexcept {
+    for (t_sock &end : _direction.pipe) {
+        if (end >= 0) {
+            close(end);
+            end = -1;
+        }
+    }
+    _direction.buffered = 0;
+};
+
+/**
+ * @brief Derives the balancing affinity of a client from its address.
+ *
+ * A v4-mapped peer of a dual-stack listener yields the same key as the plain IPv4 address, so a
+ * client keeps its backend whichever listener it came through.
+ *
+ * @param _client The client socket.
+ * @returns The IPv4 address of the peer, a fold of all 128 bits of an IPv6 peer, or 0 if unknown.
+ */
+t_u64 TcpInitializer::TcpProxy::_AffinityOf(const t_sock _client) noexcept {
+    PeerAddress peer;
+    socklen_t peer_size(sizeof(peer));
+    memset(&peer, 0, sizeof(peer));
+    if (getpeername(_client, &peer.addr, &peer_size) < 0)
+        return 0;
+    if (peer.addr.sa_family == AF_INET)
+        return ntohl(peer.v4.sin_addr.s_addr);
+    if (peer.addr.sa_family != AF_INET6)
+        return 0;
+    if (IN6_IS_ADDR_V4MAPPED(&peer.v6.sin6_addr)) {
+        t_u32 mapped;
+        memcpy(&mapped, &peer.v6.sin6_addr.s6_addr[12], sizeof(mapped));
+        return ntohl(mapped);
+    }
+    t_u64 halves[2];
+    memcpy(halves, &peer.v6.sin6_addr, sizeof(halves));
+    return (halves[0] * 0x9E3779B97F4A7C15ULL) ^ halves[1];
+};
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_PROXY_V0_0_1_HPP
+#define UNIX_G4TCPP_PROXY_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+#include "unix-g4tcpp-upstream_v0_0_1.hpp"
+
+#include <netinet/tcp.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_PROXY_PIPE_SIZE        65536u
+
+/**
+ * Gateway mode: every accepted client is paired with a fresh upstream connection and bytes are
+ * moved between the two sockets with splice() through one kernel pipe per direction, so payload
+ * never enters user space.
+ *
+ * Each direction drains its pipe into the destination before refilling it from the source. When
+ * the destination is full, reading from the source is paused until the destination is writable
+ * again, so a slow peer throttles a fast one instead of growing a buffer. End of stream on one
+ * side is forwarded as a write shutdown to the other (half-close), and the session ends once both
+ * directions finished or either socket fails. The upstream connect is non-blocking and runs on
+ * the loop like everything else.
+ *
+ * With an UpstreamGroup each session picks its backend (hashing the full client address,
+ * IPv4 or IPv6, under CONSISTENT_HASH), reports the connect outcome and latency back to the group and stays counted
+ * as outstanding on that backend until it closes.
+ */
+class TcpProxy
+{
+  public:
+    using ep_tcp     = ClientTcpConnection;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_sock             pipe[2]     { -1, -1                                             };
+        t_u64              buffered    {                                                    };
+        bool               eof         {                                                    };
+        bool               shut        {                                                    };
+        bool               blocked     {                                                    };
+    } Direction;
+
+    typedef struct alignas(void *)
+    {
+        t_sock             client      { -1                                                 };
+        t_sock             upstream    { -1                                                 };
+        t_u32              backend     {                                                    };
+        std::chrono::steady_clock::time_point dialed {                                      };
+        Direction          to_upstream {                                                    };
+        Direction          to_client   {                                                    };
+        bool               connected   {                                                    };
+        bool               closing     {                                                    };
+        bool               client_gone {                                                    };
+        bool               upstream_gone {                                                  };
+        bool               failed      {                                                    };
+    } Session;
+
+    EventLoop                                            *_loop;
+    PeerAddress                                           _upstream;
+    socklen_t                                             _upstream_size;
+    UpstreamGroup                                        *_group;
+    t_u32                                                 _pipe_size;
+    t_u64                                                 _sessions;
+    t_u64                                                 _bytes;
+
+  public:
+    __attribute__((cold                                            ))                          TcpProxy                (EventLoop &_loop, const t_strw _upstream_address, const t_u16 _upstream_port, const t_u32 _pipe_size = DEFAULT_PROXY_PIPE_SIZE);
+    __attribute__((cold                                            ))                          TcpProxy                (EventLoop &_loop, UpstreamGroup &_group, const t_u32 _pipe_size = DEFAULT_PROXY_PIPE_SIZE) noexcept;
+    TcpProxy(const TcpProxy &)            = delete;
+    TcpProxy &operator=(const TcpProxy &) = delete;
+
+    __attribute__((cold                                            ))  inline               bool    Serve                   (const t_sock _listen_sock);
+    __attribute__((hot                                             ))  inline               bool    Adopt                   (const ep_tcp &_client);
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetSessionCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetBytesProxied         (void) const noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               bool    _OpenPipe               (Direction &_direction) noexcept;
+    __attribute__((hot                                             ))  inline               bool    _Pump                   (Session &_session, Direction &_direction, const t_sock _src, const t_sock _dst) noexcept;
+    __attribute__((hot                                             ))  inline               void    _OnConnected            (const std::shared_ptr<Session> &_session) noexcept;
+    __attribute__((hot                                             ))  inline               void    _OnGone                 (const std::shared_ptr<Session> &_session, const bool _client) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Settle                 (const std::shared_ptr<Session> &_session) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Close                  (const std::shared_ptr<Session> &_session) noexcept;
+    __attribute__((hot                                             ))  inline static        void    _ClosePipe              (Direction &_direction) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        t_u64   _AffinityOf             (const t_sock _client) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
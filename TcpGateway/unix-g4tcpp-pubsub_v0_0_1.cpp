@@ -0,0 +1,317 @@
+#ifndef UNIX_G4TCPP_PUBSUB_V0_0_1_HPP
+
+#include "unix-g4tcpp-write-queue_v0_0_1.cpp"
+#include "unix-g4tcpp-pubsub_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates a broker without connections on a loop.
+ *
+ * @param _loop The loop the subscribers are registered with, every call runs on its thread.
+ * @param _policy What happens to a subscriber whose queue is full when a message is published.
+ * @param _max_queued Queued bytes at which a subscriber counts as slow, 0 never does.
+ */
+TcpInitializer::TopicBroker::TopicBroker(EventLoop &_loop, const SlowPolicy _policy, const t_u64 _max_queued)
+    : _loop(&_loop), _subscribers(), _topics(), _evicting(), _policy(_policy), _max_queued(_max_queued), _published(0), _delivered(0), _dropped(0), _evicted(0) {};
+
+/**
+ * @brief Adopts every connection accepted on a listening socket.
+ *
+ * @param _listen_sock The bound and listening socket.
+ * @param _handlers Handlers given to every adopted connection, see Adopt.
+ * @returns true if the listener was registered, false otherwise.
+ */
+bool TcpInitializer::TopicBroker::Serve(const t_sock _listen_sock, EventLoop::IoHandlers _handlers) {
+    return this->_loop->AddListener(_listen_sock, [this, _handlers](EventLoop &, ep_tcp &_client) -> void { this->Adopt(_client, _handlers); });
+};
+
+/**
+ * @brief Registers a connection with the loop and gives it an outbound queue, taking ownership of its socket.
+ *
+ * The connection starts without subscriptions, typically its on_readable handler parses requests
+ * and calls Subscribe. The broker flushes the queue on writability and forgets the connection when
+ * it closes, before the given on_writable and on_close handlers run.
+ *
+ * @param _client The connected client.
+ * @param _handlers The application handlers of the connection.
+ * @returns true if the connection was adopted, false if it is already known (errno EEXIST) or could not be registered (it is closed).
+ */
+bool TcpInitializer::TopicBroker::Adopt(const ep_tcp &_client, EventLoop::IoHandlers _handlers) {
+    const t_sock sock(_client.sock);
+    if (this->_subscribers.find(sock) != this->_subscribers.end()) {
+        errno = EEXIST;
+        return false;
+    }
+    std::unique_ptr<Subscriber> subscriber(std::make_unique<Subscriber>());
+    subscriber->sock = sock;
+    subscriber->queue = std::make_unique<OutboundQueue>(*this->_loop, sock);
+    this->_subscribers.emplace(sock, std::move(subscriber));
+
+    EventLoop::IoHandlers handlers;
+    handlers.on_readable = std::move(_handlers.on_readable);
+    handlers.on_writable = [this, on_writable = std::move(_handlers.on_writable)](EventLoop &_loop, ep_tcp &_conn) -> void {
+        OutboundQueue *queue(this->GetQueue(_conn.sock));
+        if (queue != nullptr && !queue->Flush()) {
+            _loop.CloseConnection(_conn.sock);
+            return;
+        }
+        if (on_writable)
+            on_writable(_loop, _conn);
+    };
+    handlers.on_close = [this, on_close = std::move(_handlers.on_close)](EventLoop &_loop, ep_tcp &_conn) -> void {
+        this->_Forget(_conn.sock);
+        if (on_close)
+            on_close(_loop, _conn);
+    };
+    if (!this->_loop->AddConnection(_client, std::move(handlers))) {
+        this->_subscribers.erase(sock);
+        close(sock);
+        return false;
+    }
+    return true;
+};
+
+/**
+ * @brief Subscribes an adopted connection to a topic.
+ *
+ * @param _sock The adopted connection.
+ * @param _topic The topic name.
+ * @returns true if the connection is subscribed (also when it already was), false if it is not adopted.
+ */
+bool TcpInitializer::TopicBroker::Subscribe(const t_sock _sock, const t_strw _topic) {
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>>::iterator subscriber(this->_subscribers.find(_sock));
+    if (subscriber == this->_subscribers.end())
+        return false;
+    std::vector<t_str> &topics(subscriber->second->topics);
+    if (std::find(topics.begin(), topics.end(), _topic) != topics.end())
+        return true;
+    this->_topics[t_str(_topic)].push_back(subscriber->second.get());
+    topics.emplace_back(_topic);
+    return true;
+};
+
+/**
+ * @brief Removes the subscription of a connection to a topic, messages already queued are still written.
+ *
+ * @param _sock The adopted connection.
+ * @param _topic The topic name.
+ * @returns true if the subscription was removed, false if there was none.
+ */
+bool TcpInitializer::TopicBroker::Unsubscribe(const t_sock _sock, const t_strw _topic) {
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>>::iterator subscriber(this->_subscribers.find(_sock));
+    if (subscriber == this->_subscribers.end())
+        return false;
+    std::vector<t_str> &topics(subscriber->second->topics);
+    std::vector<t_str>::iterator topic(std::find(topics.begin(), topics.end(), _topic));
+    if (topic == topics.end())
+        return false;
+    std::unordered_map<t_str, std::vector<Subscriber *>>::iterator members(this->_topics.find(*topic));
+    if (members != this->_topics.end() && TcpInitializer::TopicBroker::_Detach(members->second, subscriber->second.get()))
+        this->_topics.erase(members);
+    topics.erase(topic);
+    return true;
+};
+
+/**
+ * @brief Queues one shared message to every subscriber of a topic.
+ *
+ * Each subscriber gets a reference to the same buffer, the bytes leave with the queue flush at the
+ * end of the tick. Slow subscribers are handled by the slow policy; those to disconnect are closed
+ * before Publish returns, so their on_close handlers run from within it.
+ *
+ * @param _topic The topic name.
+ * @param _payload The message, must not be modified afterwards.
+ * @returns The number of subscribers the message was queued to.
+ */
+t_u64 TcpInitializer::TopicBroker::Publish(const t_strw _topic, shared_payload _payload) {
+    ++this->_published;
+    std::unordered_map<t_str, std::vector<Subscriber *>>::iterator members(this->_topics.find(t_str(_topic)));
+    if (members == this->_topics.end() || !_payload || _payload->empty())
+        return 0;
+    const t_u64 size(_payload->size());
+    t_u64 delivered(0);
+    for (Subscriber *subscriber : members->second) {
+        if (subscriber->evicted)
+            continue;
+        const t_u64 queued(subscriber->queue->GetQueued());
+        // an empty queue takes any message, so one larger than the limit still goes out
+        if (this->_max_queued > 0 && queued > 0 && queued + size > this->_max_queued) {
+            if (this->_policy == SlowPolicy::DISCONNECT) {
+                subscriber->evicted = true;
+                this->_evicting.push_back(subscriber->sock);
+            } else {
+                ++subscriber->dropped;
+                ++this->_dropped;
+            }
+            continue;
+        }
+        if (subscriber->queue->Push(_payload))
+            ++delivered;
+    }
+    this->_delivered += delivered;
+    if (!this->_evicting.empty())
+        this->_Evict();
+    return delivered;
+};
+
+/**
+ * @brief Wraps a message into a shared buffer and queues it to every subscriber of a topic.
+ *
+ * @param _topic The topic name.
+ * @param _message The message, moved into the shared buffer.
+ * @returns The number of subscribers the message was queued to.
+ */
+t_u64 TcpInitializer::TopicBroker::Publish(const t_strw _topic, t_str &&_message) {
+    return this->Publish(_topic, std::make_shared<const t_str>(std::move(_message)));
+};
+
+/**
+ * @brief Sets what happens to subscribers that do not keep up.
+ *
+ * @param _policy DROP skips the message for the subscriber, DISCONNECT closes it.
+ * @param _max_queued Queued bytes at which a subscriber counts as slow, 0 never does.
+ */
+void TcpInitializer::TopicBroker::SetSlowPolicy(const SlowPolicy _policy, const t_u64 _max_queued) noexcept {
+    this->_policy = _policy;
+    this->_max_queued = _max_queued;
+};
+
+/**
+ * @brief Gets the outbound queue of an adopted connection, e.g. to reply to a subscribe request in order.
+ *
+ * @param _sock The adopted connection.
+ * @returns The queue, nullptr if the connection is not adopted.
+ */
+TcpInitializer::OutboundQueue *TcpInitializer::TopicBroker::GetQueue(const t_sock _sock) noexcept {
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>>::iterator subscriber(this->_subscribers.find(_sock));
+    return subscriber == this->_subscribers.end() ? nullptr : subscriber->second->queue.get();
+};
+
+/**
+ * @brief Gets the number of connections subscribed to a topic.
+ *
+ * @param _topic The topic name.
+ * @returns The subscriber count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetSubscriberCount(const t_strw _topic) const {
+    std::unordered_map<t_str, std::vector<Subscriber *>>::const_iterator members(this->_topics.find(t_str(_topic)));
+    return members == this->_topics.end() ? 0 : members->second.size();
+};
+
+/**
+ * @brief Gets the number of adopted connections.
+ *
+ * @returns The connection count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetConnectionCount(void) const noexcept {
+    return this->_subscribers.size();
+};
+
+/**
+ * @brief Gets the number of topics with at least one subscriber.
+ *
+ * @returns The topic count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetTopicCount(void) const noexcept {
+    return this->_topics.size();
+};
+
+/**
+ * @brief Gets the number of messages a connection missed because it was slow.
+ *
+ * @param _sock The adopted connection.
+ * @returns The dropped message count, 0 if the connection is not adopted.
+ */
+t_u64 TcpInitializer::TopicBroker::GetDroppedCount(const t_sock _sock) const noexcept {
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>>::const_iterator subscriber(this->_subscribers.find(_sock));
+    return subscriber == this->_subscribers.end() ? 0 : subscriber->second->dropped;
+};
+
+/**
+ * @brief Gets the number of Publish calls.
+ *
+ * @returns The publish count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetPublishCount(void) const noexcept {
+    return this->_published;
+};
+
+/**
+ * @brief Gets the number of messages queued to subscribers, one per subscriber and publish.
+ *
+ * @returns The delivered message count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetDeliveredCount(void) const noexcept {
+    return this->_delivered;
+};
+
+/**
+ * @brief Gets the number of messages dropped for slow subscribers.
+ *
+ * @returns The dropped message count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetDroppedCount(void) const noexcept {
+    return this->_dropped;
+};
+
+/**
+ * @brief Gets the number of slow subscribers that were disconnected.
+ *
+ * @returns The evicted connection count.
+ */
+t_u64 TcpInitializer::TopicBroker::GetEvictedCount(void) const noexcept {
+    return this->_evicted;
+};
+
+/**
+ * @brief Drops a connection with its queue and subscriptions, bytes still queued are discarded.
+ *
+ * @param _sock The connection.
+ */
+void TcpInitializer::TopicBroker::_Forget(const t_sock _sock) noexcept {
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>>::iterator subscriber(this->_subscribers.find(_sock));
+    if (subscriber == this->_subscribers.end())
+        return;
+    for (const t_str &topic : subscriber->second->topics) {
+        std::unordered_map<t_str, std::vector<Subscriber *>>::iterator members(this->_topics.find(topic));
+        if (members != this->_topics.end() && TcpInitializer::TopicBroker::_Detach(members->second, subscriber->second.get()))
+            this->_topics.erase(members);
+    }
+    this->_subscribers.erase(subscriber);
+};
+
+/**
+ * @brief Closes the subscribers marked for disconnection by the last publish.
+ *
+ * The list is taken first: on_close handlers run from here and may publish again.
+ */
+void TcpInitializer::TopicBroker::_Evict(void) noexcept {
+    std::vector<t_sock> evicting;
+    evicting.swap(this->_evicting);
+    for (const t_sock sock : evicting) {
+        if (this->_subscribers.find(sock) == this->_subscribers.end())
+            continue;
+        ++this->_evicted;
+        this->_Forget(sock);
+        this->_loop->CloseConnection(sock);
+    }
+};
+
+/**
+ * @brief Removes a subscriber from the member list of a topic.
+ *
+ * @param _members The subscribers of the topic.
+ * @param _subscriber The subscriber to remove.
+ * @returns true if the topic has no subscriber left, false otherwise.
+ */
+bool TcpInitializer::TopicBroker::_Detach(std::vector<Subscriber *> &_members, const Subscriber *_subscriber) noexcept {
+    std::vector<Subscriber *>::iterator member(std::find(_members.begin(), _members.end(), _subscriber));
+    if (member != _members.end()) {
+        *member = _members.back();
+        _members.pop_back();
+    }
+    return _members.empty();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_PUBSUB_V0_0_1_HPP
+#define UNIX_G4TCPP_PUBSUB_V0_0_1_HPP
+
+#include "unix-g4tcpp-write-queue_v0_0_1.hpp"
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_PUBSUB_MAX_QUEUED      1048576u
+
+enum class SlowPolicy
+{
+    DROP,
+    DISCONNECT
+};
+
+/**
+ * Topic based fan-out of the same message to many connections of one EventLoop.
+ *
+ * Connections handed over with Adopt get an OutboundQueue and are registered with the loop; their
+ * on_writable and on_close handlers are wrapped so the broker flushes and forgets them on its own.
+ * Publish wraps the message once in an immutable ref-counted buffer and pushes a reference into the
+ * queue of every subscriber of the topic, so a publish costs one pointer push per subscriber and no
+ * copy; each queue writes everything published during a tick with one gathered sendmsg at its end.
+ *
+ * A subscriber whose queue already holds max_queued bytes is slow: under DROP it misses the message
+ * (counted per subscriber and in total), under DISCONNECT it is closed through the loop once the
+ * publish finished. Replies of the application to a subscriber go through GetQueue, so they keep
+ * their order with the published messages. Every member runs on the loop thread, publishers on
+ * other threads hand the message over with EventLoop::Post.
+ */
+class TopicBroker
+{
+  public:
+    using ep_tcp         = ClientTcpConnection;
+    using shared_payload = OutboundQueue::shared_payload;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_sock             sock        { -1                                                 };
+        std::unique_ptr<OutboundQueue> queue {                                              };
+        std::vector<t_str> topics      {                                                    };
+        t_u64              dropped     {                                                    };
+        bool               evicted     {                                                    };
+    } Subscriber;
+
+    EventLoop                                            *_loop;
+    std::unordered_map<t_sock, std::unique_ptr<Subscriber>> _subscribers;
+    std::unordered_map<t_str, std::vector<Subscriber *>>  _topics;
+    std::vector<t_sock>                                   _evicting;
+    SlowPolicy                                            _policy;
+    t_u64                                                 _max_queued;
+    t_u64                                                 _published;
+    t_u64                                                 _delivered;
+    t_u64                                                 _dropped;
+    t_u64                                                 _evicted;
+
+  public:
+    __attribute__((cold                                            ))                          TopicBroker             (EventLoop &_loop, const SlowPolicy _policy = SlowPolicy::DROP, const t_u64 _max_queued = DEFAULT_PUBSUB_MAX_QUEUED);
+    TopicBroker(const TopicBroker &)            = delete;
+    TopicBroker &operator=(const TopicBroker &) = delete;
+
+    __attribute__((cold                                            ))  inline               bool    Serve                   (const t_sock _listen_sock, EventLoop::IoHandlers _handlers = EventLoop::IoHandlers());
+    __attribute__((hot                                             ))  inline               bool    Adopt                   (const ep_tcp &_client, EventLoop::IoHandlers _handlers = EventLoop::IoHandlers());
+    __attribute__((hot                                             ))  inline               bool    Subscribe               (const t_sock _sock, const t_strw _topic);
+    __attribute__((hot                                             ))  inline               bool    Unsubscribe             (const t_sock _sock, const t_strw _topic);
+    __attribute__((hot                                             ))  inline               t_u64   Publish                 (const t_strw _topic, shared_payload _payload);
+    __attribute__((hot                                             ))  inline               t_u64   Publish                 (const t_strw _topic, t_str &&_message);
+    __attribute__((cold                                            ))  inline               void    SetSlowPolicy           (const SlowPolicy _policy, const t_u64 _max_queued) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               OutboundQueue* GetQueue         (const t_sock _sock) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetSubscriberCount      (const t_strw _topic) const;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetConnectionCount      (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetTopicCount           (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetDroppedCount         (const t_sock _sock) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetPublishCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetDeliveredCount       (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetDroppedCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetEvictedCount         (void) const noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               void    _Forget                 (const t_sock _sock) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Evict                  (void) noexcept;
+    __attribute__((hot                                             ))  inline static        bool    _Detach                 (std::vector<Subscriber *> &_members, const Subscriber *_subscriber) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,580 @@
+#ifndef UNIX_G4TCPP_REACTOR_V0_0_1_HPP
+
+#include "unix-g4tcpp-timers_v0_0_1.cpp"
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates the epoll instance and the wake-up eventfd used by Stop().
+ *
+ * @param _batch_size Maximum number of readiness events collected per epoll_wait call.
+ * @throws std::runtime_error If epoll or eventfd creation fails.
+ */
+TcpInitializer::EventLoop::EventLoop(const t_u32 _batch_size)
+    : _epoll_fd(epoll_create1(EPOLL_CLOEXEC)), _wake_fd(-1), _channels(), _retired(), _deferred(), _deferred_run(), _posted(), _timers(), _wake_pending(false), _events(_batch_size > 0 ? _batch_size : DEFAULT_EVENT_BATCH_SIZE), _running(false), _registered(0) {
+    if (this->_epoll_fd < 0) {
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("epoll create failure: "));
+    }
+    this->_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (this->_wake_fd < 0) {
+        close(this->_epoll_fd);
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("eventfd create failure: "));
+    }
+    struct epoll_event wake_event;
+    memset(&wake_event, 0, sizeof(wake_event));
+    wake_event.events = EPOLLIN | EPOLLET;
+    wake_event.data.u64 = static_cast<t_u64>(static_cast<t_u32>(this->_wake_fd));
+    if (epoll_ctl(this->_epoll_fd, EPOLL_CTL_ADD, this->_wake_fd, &wake_event) < 0) {
+        close(this->_wake_fd);
+        close(this->_epoll_fd);
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("epoll wake register failure: "));
+    }
+};
+
+/**
+ * @brief Releases the epoll instance; registered sockets are left open and owned by the caller.
+ */
+TcpInitializer::EventLoop::~EventLoop() {
+    for (const Channel &channel : this->_channels) {
+        if (channel.tcp_state == TcpState::CONNECTED)
+            TcpInitializer::Metrics::connections.Sub();
+    }
+    if (this->_wake_fd >= 0)
+        close(this->_wake_fd);
+    if (this->_epoll_fd >= 0)
+        close(this->_epoll_fd);
+};
+
+/**
+ * @brief Registers a listening socket, every accepted connection is passed to the accept callback.
+ *
+ * @param _sock The listening socket, e.g. the one returned by Socket::GetSocket() after CreateTcpServer.
+ * @param _on_accept Callback receiving each accepted connection, already in non-blocking mode.
+ * @returns true if the socket was registered, false otherwise.
+ */
+bool TcpInitializer::EventLoop::AddListener(const t_sock _sock, accept_cb _on_accept) {
+    if (_sock < 0 || !_on_accept || !TcpInitializer::EventLoop::SetNonBlocking(_sock))
+        return false;
+    if (!this->_Register(_sock, EPOLLIN | EPOLLET))
+        return false;
+    Channel &channel = this->_channels[_sock];
+    channel.connection = {_sock, true};
+    channel.callbacks = std::make_unique<Callbacks>(Callbacks{std::move(_on_accept), IoHandlers{}});
+    channel.listener = true;
+    channel.tcp_state = TcpState::LISTENING;
+    return true;
+};
+
+/**
+ * @brief Registers a connected socket with its readiness callbacks.
+ *
+ * @param _conn The connection to watch, as produced by an accept callback or Socket::Connect.
+ * @param _handlers Callbacks invoked on read readiness, write readiness and peer close/error.
+ * @returns true if the socket was registered, false otherwise.
+ */
+bool TcpInitializer::EventLoop::AddConnection(const ep_tcp &_conn, IoHandlers _handlers) {
+    if (_conn.sock < 0 || !TcpInitializer::EventLoop::SetNonBlocking(_conn.sock))
+        return false;
+    if (!this->_Register(_conn.sock, EPOLLIN | EPOLLRDHUP | EPOLLET))
+        return false;
+    Channel &channel = this->_channels[_conn.sock];
+    channel.connection = {_conn.sock, true};
+    channel.callbacks = std::make_unique<Callbacks>(Callbacks{nullptr, std::move(_handlers)});
+    channel.listener = false;
+    channel.tcp_state = TcpState::CONNECTED;
+    TcpInitializer::Metrics::connections.Add();
+    return true;
+};
+
+/**
+ * @brief Enables or disables write readiness notifications for a watched socket.
+ *
+ * @param _sock The watched socket.
+ * @param _enable true to receive on_writable callbacks, false to stop them.
+ * @returns true if the interest set was updated, false otherwise.
+ */
+bool TcpInitializer::EventLoop::WantWrite(const t_sock _sock, const bool _enable) noexcept {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr)
+        return false;
+    const t_u32 interest(_enable ? (channel->interest | EPOLLOUT) : (channel->interest & ~static_cast<t_u32>(EPOLLOUT)));
+    return interest == channel->interest || this->_Rearm(_sock, interest);
+};
+
+/**
+ * @brief Enables or disables read readiness notifications for a watched socket.
+ *
+ * @param _sock The watched socket.
+ * @param _enable true to receive on_readable callbacks, false to pause them.
+ * @returns true if the interest set was updated, false otherwise.
+ */
+bool TcpInitializer::EventLoop::WantRead(const t_sock _sock, const bool _enable) noexcept {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr)
+        return false;
+    const t_u32 interest(_enable ? (channel->interest | EPOLLIN) : (channel->interest & ~static_cast<t_u32>(EPOLLIN)));
+    return interest == channel->interest || this->_Rearm(_sock, interest);
+};
+
+/**
+ * @brief Stops watching a socket without closing it.
+ *
+ * @param _sock The socket to remove.
+ * @returns true if the socket was watched, false otherwise.
+ */
+bool TcpInitializer::EventLoop::Remove(const t_sock _sock) noexcept {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr)
+        return false;
+    epoll_ctl(this->_epoll_fd, EPOLL_CTL_DEL, _sock, nullptr);
+    if (channel->tcp_state == TcpState::CONNECTED)
+        TcpInitializer::Metrics::connections.Sub();
+    this->_timers.Cancel(channel->idle_timer);
+    this->_timers.Cancel(channel->deadline_timer);
+    channel->idle_timer = 0;
+    channel->deadline_timer = 0;
+    channel->idle_ms = 0;
+    // callbacks may be removing their own channel, keep them alive until the batch is dispatched
+    this->_retired.emplace_back(std::move(channel->callbacks));
+    channel->tcp_state = TcpState::NONE;
+    channel->connection.state = false;
+    channel->interest = 0;
+    ++channel->generation;
+    --this->_registered;
+    return true;
+};
+
+/**
+ * @brief Runs the close callback of a watched socket, removes it from the loop and closes it.
+ *
+ * @param _sock The socket to close.
+ */
+void TcpInitializer::EventLoop::CloseConnection(const t_sock _sock) noexcept {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr)
+        return;
+    ep_tcp connection(channel->connection);
+    this->Remove(_sock);
+    Callbacks *callbacks(this->_retired.back().get());
+    if (callbacks != nullptr && callbacks->handlers.on_close) {
+        callbacks->handlers.on_close(*this, connection);
+    }
+    close(_sock);
+};
+
+/**
+ * @brief Waits for readiness events once and dispatches them, then runs the timers that are due.
+ *
+ * @param _timeout_ms epoll_wait timeout in milliseconds, -1 blocks until an event arrives; the wait
+ *                    is shortened to the next timer.
+ * @returns The number of events dispatched.
+ */
+TcpInitializer::t_u32 TcpInitializer::EventLoop::RunOnce(const int _timeout_ms) {
+    // pending deferred work must not wait behind a blocking epoll_wait, nor must the next timer
+    int timeout_ms(this->_deferred.empty() ? _timeout_ms : 0);
+    const int timer_ms(this->_timers.NextTimeout());
+    if (timer_ms >= 0 && (timeout_ms < 0 || timer_ms < timeout_ms))
+        timeout_ms = timer_ms;
+    const int ready(epoll_wait(this->_epoll_fd, this->_events.data(), static_cast<int>(this->_events.size()), timeout_ms));
+    if (ready < 0) {
+        if (errno == EINTR)
+            return 0;
+        throw std::runtime_error(TcpInitializer::ErrorMsgCombine("epoll wait failure: "));
+    }
+    for (int i = 0; i < ready; ++i) {
+        this->_Dispatch(this->_events[i]);
+    }
+    this->_RunPosted();
+    this->_timers.Advance();
+    this->_RunDeferred();
+    this->_retired.clear();
+    return static_cast<t_u32>(ready);
+};
+
+/**
+ * @brief Queues a task to run on the loop thread at the end of the current tick.
+ *
+ * Tasks queued while deferred tasks run are picked up by the next tick, which then does not block.
+ *
+ * @param _task The task to run.
+ */
+void TcpInitializer::EventLoop::Defer(task_cb _task) {
+    if (_task)
+        this->_deferred.emplace_back(std::move(_task));
+};
+
+/**
+ * @brief Hands a task to the loop thread, safe to call from any thread.
+ *
+ * The task runs after the ready events of the next tick, e.g. to queue a reply computed by a
+ * worker on the connection the request came from. The loop is woken only if it was not already.
+ *
+ * @param _task The task to run.
+ */
+void TcpInitializer::EventLoop::Post(task_cb _task) {
+    if (!_task)
+        return;
+    this->_posted.Push(std::move(_task));
+    if (!this->_wake_pending.exchange(true, std::memory_order_seq_cst))
+        this->_Wake();
+};
+
+/**
+ * @brief Runs a task on the loop thread once a delay has elapsed.
+ *
+ * @param _delay_ms Delay in milliseconds.
+ * @param _task The task to run.
+ * @returns The timer id for CancelTimer and RestartTimer, 0 if the task is empty.
+ */
+TcpInitializer::t_u64 TcpInitializer::EventLoop::AddTimer(const t_u64 _delay_ms, task_cb _task) {
+    if (!_task)
+        return 0;
+    return this->_timers.Schedule(_delay_ms, [this, task = std::move(_task)]() { task(*this); });
+};
+
+/**
+ * @brief Disarms a timer.
+ *
+ * @param _timer The timer id returned by AddTimer.
+ * @returns true if the timer was pending, false if it already ran or was cancelled.
+ */
+bool TcpInitializer::EventLoop::CancelTimer(const t_u64 _timer) noexcept {
+    return this->_timers.Cancel(_timer);
+};
+
+/**
+ * @brief Pushes a pending timer back to a new delay from now.
+ *
+ * @param _timer The timer id returned by AddTimer.
+ * @param _delay_ms New delay in milliseconds.
+ * @returns true if the timer was re-armed, false if it already ran or was cancelled.
+ */
+bool TcpInitializer::EventLoop::RestartTimer(const t_u64 _timer, const t_u64 _delay_ms) noexcept {
+    return this->_timers.Restart(_timer, _delay_ms);
+};
+
+/**
+ * @brief Closes a connection that sees no readiness event for a while.
+ *
+ * Every event of the connection re-arms the timeout in O(1). On expiry the connection is closed
+ * through CloseConnection with errno set to ETIMEDOUT while on_close runs.
+ *
+ * @param _sock The watched connection.
+ * @param _timeout_ms Idle timeout in milliseconds, 0 disables it.
+ * @returns true if the timeout was updated, false if the socket is not a watched connection.
+ */
+bool TcpInitializer::EventLoop::SetIdleTimeout(const t_sock _sock, const t_u32 _timeout_ms) {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr || channel->listener)
+        return false;
+    channel->idle_ms = _timeout_ms;
+    if (_timeout_ms == 0) {
+        this->_timers.Cancel(channel->idle_timer);
+        channel->idle_timer = 0;
+    } else if (!this->_timers.Restart(channel->idle_timer, _timeout_ms)) {
+        const t_u32 generation(channel->generation);
+        channel->idle_timer = this->_timers.Schedule(_timeout_ms, [this, _sock, generation]() { this->_Expire(_sock, generation); });
+    }
+    return true;
+};
+
+/**
+ * @brief Closes a connection unless the deadline is cleared in time, regardless of its activity.
+ *
+ * Used for read and write deadlines (armed when a request is sent or a reply queued, cleared when
+ * it completes) and for connect timeouts on a connection still waiting for writability. On expiry
+ * the connection is closed through CloseConnection with errno set to ETIMEDOUT while on_close runs.
+ *
+ * @param _sock The watched connection.
+ * @param _timeout_ms Deadline in milliseconds from now, 0 clears it.
+ * @returns true if the deadline was updated, false if the socket is not a watched connection.
+ */
+bool TcpInitializer::EventLoop::SetDeadline(const t_sock _sock, const t_u32 _timeout_ms) {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr || channel->listener)
+        return false;
+    if (_timeout_ms == 0) {
+        this->_timers.Cancel(channel->deadline_timer);
+        channel->deadline_timer = 0;
+    } else if (!this->_timers.Restart(channel->deadline_timer, _timeout_ms)) {
+        const t_u32 generation(channel->generation);
+        channel->deadline_timer = this->_timers.Schedule(_timeout_ms, [this, _sock, generation]() { this->_Expire(_sock, generation); });
+    }
+    return true;
+};
+
+/**
+ * @brief Dispatches readiness events until Stop() is called.
+ */
+void TcpInitializer::EventLoop::Run(void) {
+    this->_running.store(true, std::memory_order_release);
+    while (this->_running.load(std::memory_order_acquire)) {
+        this->RunOnce(DEFAULT_LOOP_TIMEOUT_MS);
+    }
+};
+
+/**
+ * @brief Requests Run() to return, safe to call from any thread.
+ */
+void TcpInitializer::EventLoop::Stop(void) noexcept {
+    this->_running.store(false, std::memory_order_release);
+    this->_Wake();
+};
+
+/**
+ * @brief Checks whether Run() is currently dispatching events.
+ *
+ * @returns true if the loop is running, false otherwise.
+ */
+bool TcpInitializer::EventLoop::IsRunning(void) const noexcept {
+    return this->_running.load(std::memory_order_acquire);
+};
+
+/**
+ * @brief Gets the number of sockets currently watched by the loop.
+ *
+ * @returns The number of registered listeners and connections.
+ */
+TcpInitializer::t_u64 TcpInitializer::EventLoop::GetChannelCount(void) const noexcept {
+    return this->_registered;
+};
+
+/**
+ * @brief Gets the number of armed timers, including connection timeouts.
+ *
+ * @returns The timer count.
+ */
+TcpInitializer::t_u64 TcpInitializer::EventLoop::GetTimerCount(void) const noexcept {
+    return this->_timers.GetCount();
+};
+
+/**
+ * @brief Checks whether a socket is currently watched by the loop.
+ *
+ * @param _sock The socket to check.
+ * @returns true if the socket is registered, false otherwise.
+ */
+bool TcpInitializer::EventLoop::IsWatched(const t_sock _sock) const noexcept {
+    return _sock >= 0 && static_cast<std::size_t>(_sock) < this->_channels.size() && this->_channels[_sock].tcp_state != TcpState::NONE;
+};
+
+/**
+ * @brief Switches a socket to non-blocking mode.
+ *
+ * @param _sock The socket to update.
+ * @returns true if O_NONBLOCK is set, false otherwise.
+ */
+bool TcpInitializer::EventLoop::SetNonBlocking(const t_sock _sock) noexcept {
+    const int flags(fcntl(_sock, F_GETFL, 0));
+    if (flags < 0)
+        return false;
+    return (flags & O_NONBLOCK) != 0 || fcntl(_sock, F_SETFL, flags | O_NONBLOCK) == 0;
+};
+
+/**
+ * @brief Adds a socket to the epoll set, tagging the event with the channel generation.
+ *
+ * The generation sits in the upper half of epoll_data so events queued for a socket that was
+ * removed and reused inside the same batch are recognised as stale and dropped.
+ *
+ * @param _sock The socket to add.
+ * @param _interest The epoll event mask.
+ * @returns true if the socket was added, false otherwise.
+ */
+bool TcpInitializer::EventLoop::_Register(const t_sock _sock, const t_u32 _interest) {
+    if (static_cast<std::size_t>(_sock) >= this->_channels.size()) {
+        this->_channels.resize(std::max<std::size_t>(static_cast<std::size_t>(_sock) + 1, this->_channels.size() * 2));
+    }
+    Channel &channel = this->_channels[_sock];
+    if (channel.tcp_state != TcpState::NONE)
+        return false;
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = _interest;
+    event.data.u64 = (static_cast<t_u64>(channel.generation) << 32) | static_cast<t_u32>(_sock);
+    if (epoll_ctl(this->_epoll_fd, EPOLL_CTL_ADD, _sock, &event) < 0)
+        return false;
+    channel.interest = _interest;
+    channel.tcp_state = TcpState::OPEN;
+    ++this->_registered;
+    return true;
+};
+
+/**
+ * @brief Replaces the epoll interest set of a watched socket.
+ *
+ * @param _sock The watched socket.
+ * @param _interest The new epoll event mask.
+ * @returns true if the interest set was updated, false otherwise.
+ */
+bool TcpInitializer::EventLoop::_Rearm(const t_sock _sock, const t_u32 _interest) noexcept {
+    Channel &channel = this->_channels[_sock];
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = _interest;
+    event.data.u64 = (static_cast<t_u64>(channel.generation) << 32) | static_cast<t_u32>(_sock);
+    if (epoll_ctl(this->_epoll_fd, EPOLL_CTL_MOD, _sock, &event) < 0)
+        return false;
+    channel.interest = _interest;
+    return true;
+};
+
+/**
+ * @brief Accepts every pending connection on an edge-triggered listener.
+ *
+ * @param _sock The listening socket.
+ */
+void TcpInitializer::EventLoop::_DrainAccept(const t_sock _sock) {
+    const t_u32 generation(this->_channels[_sock].generation);
+    Callbacks *callbacks(this->_channels[_sock].callbacks.get());
+    for (;;) {
+        const t_sock sock_digest(accept4(_sock, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+        if (sock_digest < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                TcpInitializer::Socket::Log("accept failure: ", strerror(errno), '\n');
+            return;
+        }
+        TcpInitializer::Metrics::accepted.Add();
+        ep_tcp connection{sock_digest, true};
+        callbacks->on_accept(*this, connection);
+        // the callback may have removed the listener, stop draining a socket we no longer own
+        if (this->_channels[_sock].generation != generation)
+            return;
+    }
+};
+
+/**
+ * @brief Routes one readiness event to the callbacks of its channel.
+ *
+ * @param _event The event returned by epoll_wait.
+ */
+void TcpInitializer::EventLoop::_Dispatch(const struct epoll_event &_event) {
+    const t_sock sock(static_cast<t_sock>(_event.data.u64 & 0xFFFFFFFFu));
+    if (sock == this->_wake_fd) {
+        this->_DrainWake();
+        return;
+    }
+    const t_u32 generation(static_cast<t_u32>(_event.data.u64 >> 32));
+    Channel *channel(this->_ChannelOf(sock));
+    if (channel == nullptr || channel->generation != generation)
+        return;
+    if (channel->listener) {
+        this->_DrainAccept(sock);
+        return;
+    }
+    if (channel->idle_timer != 0)
+        this->_timers.Restart(channel->idle_timer, channel->idle_ms);
+    // channels live in a deque and callbacks are retired rather than destroyed, so neither moves
+    // while a callback is still running on the stack
+    Callbacks *callbacks(channel->callbacks.get());
+    if ((_event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && callbacks->handlers.on_readable) {
+        callbacks->handlers.on_readable(*this, channel->connection);
+        if (channel->generation != generation)
+            return;
+    }
+    if ((_event.events & (EPOLLOUT | EPOLLERR)) && callbacks->handlers.on_writable) {
+        callbacks->handlers.on_writable(*this, channel->connection);
+        if (channel->generation != generation)
+            return;
+    }
+    // a hung-up socket whose reads are paused may still hold unread data, its owner closes it;
+    // EPOLLERR without a pending socket error only reports the error queue (zero-copy completions)
+    if (((_event.events & EPOLLERR) && TcpInitializer::EventLoop::_SocketError(sock) != 0) || ((_event.events & EPOLLHUP) && (channel->interest & EPOLLIN))) {
+        this->CloseConnection(sock);
+    }
+};
+
+/**
+ * @brief Reads and clears the pending error of a socket.
+ *
+ * @param _sock The socket to query.
+ * @returns The pending errno value, 0 if none, or the getsockopt failure errno.
+ */
+int TcpInitializer::EventLoop::_SocketError(const t_sock _sock) noexcept {
+    int error(0);
+    socklen_t error_size(sizeof(error));
+    if (getsockopt(_sock, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0)
+        return errno;
+    return error;
+};
+
+/**
+ * @brief Resets the wake-up eventfd after Stop() signalled it.
+ */
+void TcpInitializer::EventLoop::_DrainWake(void) noexcept {
+    t_u64 signal(0);
+    while (read(this->_wake_fd, &signal, sizeof(signal)) > 0) {
+    }
+};
+
+/**
+ * @brief Runs the tasks deferred so far, tasks they defer wait for the next tick.
+ */
+void TcpInitializer::EventLoop::_RunDeferred(void) {
+    if (this->_deferred.empty())
+        return;
+    this->_deferred_run.swap(this->_deferred);
+    for (task_cb &task : this->_deferred_run) {
+        task(*this);
+    }
+    this->_deferred_run.clear();
+};
+
+/**
+ * @brief Runs tasks posted from other threads, at most DEFAULT_POST_BATCH_SIZE per tick.
+ */
+void TcpInitializer::EventLoop::_RunPosted(void) {
+    // cleared before looking at the queue: a Post whose element is not visible yet wakes us again
+    if (this->_wake_pending.load(std::memory_order_relaxed))
+        this->_wake_pending.exchange(false, std::memory_order_seq_cst);
+    if (this->_posted.IsEmpty())
+        return;
+    task_cb task;
+    for (t_u32 run = 0; run < DEFAULT_POST_BATCH_SIZE; ++run) {
+        if (!this->_posted.Pop(task))
+            return;
+        task(*this);
+    }
+    // producers outpace the loop, leave the rest to the next tick so ready events are not starved
+    if (!this->_posted.IsEmpty() && !this->_wake_pending.exchange(true, std::memory_order_acq_rel))
+        this->_Wake();
+};
+
+/**
+ * @brief Signals the wake-up eventfd so a blocking epoll_wait returns.
+ */
+void TcpInitializer::EventLoop::_Wake(void) noexcept {
+    const t_u64 signal(1);
+    [[maybe_unused]] const ssize_t w(write(this->_wake_fd, &signal, sizeof(signal)));
+};
+
+/**
+ * @brief Closes a connection whose idle timeout or deadline expired.
+ *
+ * @param _sock The connection.
+ * @param _generation The channel generation when the timer was armed.
+ */
+void TcpInitializer::EventLoop::_Expire(const t_sock _sock, const t_u32 _generation) noexcept {
+    Channel *channel(this->_ChannelOf(_sock));
+    if (channel == nullptr || channel->generation != _generation)
+        return;
+    errno = ETIMEDOUT;
+    this->CloseConnection(_sock);
+};
+
+/**
+ * @brief Gets the channel of a watched socket.
+ *
+ * @param _sock The socket to look up.
+ * @returns A pointer to the channel, or nullptr if the socket is not watched.
+ */
+TcpInitializer::EventLoop::Channel *TcpInitializer::EventLoop::_ChannelOf(const t_sock _sock) noexcept {
+    if (!this->IsWatched(_sock))
+        return nullptr;
+    return &this->_channels[_sock];
+};
+
+#endif
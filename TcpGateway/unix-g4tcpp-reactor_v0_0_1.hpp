@@ -0,0 +1,205 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_REACTOR_V0_0_1_HPP
+#define UNIX_G4TCPP_REACTOR_V0_0_1_HPP
+
+#include "unix-g4tcpp-timers_v0_0_1.hpp"
+
+#include <deque>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_EVENT_BATCH_SIZE       256u
+#define DEFAULT_LOOP_TIMEOUT_MS        -1
+#define DEFAULT_POST_BATCH_SIZE        1024u
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue (intrusive linked list after Vyukov).
+ *
+ * Push is a single atomic exchange and never blocks, whatever the number of producers; Pop may
+ * only be called by one consumer thread. A Pop racing with a Push still in progress may miss
+ * that element, callers signal the consumer after Push returns.
+ */
+template <typename T>
+class MpscQueue
+{
+  protected:
+    typedef struct Node
+    {
+        std::atomic<Node *> next      {                                                    };
+        T                  value      {                                                    };
+    } Node;
+
+    alignas(64) std::atomic<Node *>                       _head;
+    alignas(64) Node                                     *_tail;
+
+  public:
+    MpscQueue(void) : _head(new Node()), _tail(_head.load(std::memory_order_relaxed)) {};
+    MpscQueue(const MpscQueue &)            = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+    ~MpscQueue()
+    {
+        while (this->_tail != nullptr) {
+            Node *next(this->_tail->next.load(std::memory_order_relaxed));
+            delete this->_tail;
+            this->_tail = next;
+        }
+    };
+
+    /**
+     * @brief Appends an element, safe to call from any thread.
+     *
+     * @param _value The element.
+     */
+    void Push(T _value)
+    {
+        Node *node(new Node());
+        node->value = std::move(_value);
+        Node *previous(this->_head.exchange(node, std::memory_order_acq_rel));
+        previous->next.store(node, std::memory_order_release);
+    };
+
+    /**
+     * @brief Takes the oldest element, consumer thread only.
+     *
+     * @param _value Receives the element.
+     * @returns true if an element was taken, false if the queue is empty.
+     */
+    bool Pop(T &_value)
+    {
+        Node *next(this->_tail->next.load(std::memory_order_acquire));
+        if (next == nullptr)
+            return false;
+        _value = std::move(next->value);
+        // next becomes the new stub, its value was moved out
+        delete this->_tail;
+        this->_tail = next;
+        return true;
+    };
+
+    /**
+     * @brief Checks whether the queue holds an element, consumer thread only.
+     *
+     * @returns true if the queue is empty, false otherwise.
+     */
+    bool IsEmpty(void) const noexcept
+    {
+        return this->_tail->next.load(std::memory_order_acquire) == nullptr;
+    };
+};
+
+/**
+ * Edge-triggered epoll reactor.
+ *
+ * Every registered descriptor is switched to non-blocking mode and armed with EPOLLET, so each
+ * readiness callback is expected to drain its socket until EAGAIN. Listeners are drained by the
+ * loop itself (accept4 until EAGAIN) and every accepted connection is handed over as a
+ * ClientTcpConnection, the same type returned by Socket::Connect, so existing callers can move
+ * their sockets onto the loop one at a time. Work queued with Defer runs once at the end of the
+ * current tick, after every ready event was dispatched, e.g. to flush coalesced writes. Errors
+ * and hang-ups close the connection after its callbacks ran, except a hang-up on a socket whose
+ * reads are paused with WantRead, which may still hold unread data and is left to its owner.
+ * An EPOLLERR without a pending socket error only signals the error queue and is not fatal.
+ * Post is the only member safe to call from other threads: the task is handed over through a
+ * lock-free queue and runs on the loop thread after the ready events of the next tick.
+ *
+ * Timers run on a TimerWheel owned by the loop, epoll_wait sleeps no longer than the next timer.
+ * A connection can carry an idle timeout, re-armed by each of its readiness events, and a one-shot
+ * deadline (read, write or connect); either closes it through CloseConnection when it expires.
+ */
+class EventLoop
+{
+  public:
+    using ep_tcp     = ClientTcpConnection;
+    using accept_cb  = std::function<void(EventLoop &, ep_tcp &)>;
+    using io_cb      = std::function<void(EventLoop &, ep_tcp &)>;
+    using task_cb    = std::function<void(EventLoop &)>;
+
+    typedef struct alignas(void *)
+    {
+        io_cb              on_readable {                                                    };
+        io_cb              on_writable {                                                    };
+        io_cb              on_close    {                                                    };
+    } IoHandlers;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        accept_cb          on_accept   {                                                    };
+        IoHandlers         handlers    {                                                    };
+    } Callbacks;
+
+    typedef struct alignas(void *)
+    {
+        ep_tcp             connection  {                                                    };
+        std::unique_ptr<Callbacks> callbacks {                                              };
+        t_u32              interest    {                                                    };
+        t_u32              generation  {                                                    };
+        TcpState           tcp_state   { TcpState::NONE                                     };
+        bool               listener    {                                                    };
+        t_u32              idle_ms     {                                                    };
+        t_u64              idle_timer  {                                                    };
+        t_u64              deadline_timer {                                                 };
+    } Channel;
+
+    t_sock                                                _epoll_fd;
+    t_sock                                                _wake_fd;
+    std::deque<Channel>                                   _channels;
+    std::vector<std::unique_ptr<Callbacks>>               _retired;
+    std::vector<task_cb>                                  _deferred;
+    std::vector<task_cb>                                  _deferred_run;
+    MpscQueue<task_cb>                                    _posted;
+    TimerWheel                                            _timers;
+    std::atomic<bool>                                     _wake_pending;
+    std::vector<struct epoll_event>                       _events;
+    std::atomic<bool>                                     _running;
+    t_u64                                                 _registered;
+
+  public:
+    __attribute__((cold                                            ))  explicit                EventLoop               (const t_u32 _batch_size = DEFAULT_EVENT_BATCH_SIZE);
+    EventLoop(const EventLoop &)            = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+    __attribute__((cold                                            ))                          ~EventLoop              ();
+
+    __attribute__((cold                                            ))  inline               bool    AddListener             (const t_sock _sock, accept_cb _on_accept);
+    __attribute__((hot                                             ))  inline               bool    AddConnection           (const ep_tcp &_conn, IoHandlers _handlers);
+    __attribute__((hot                                             ))  inline               bool    WantWrite               (const t_sock _sock, const bool _enable) noexcept;
+    __attribute__((hot                                             ))  inline               bool    WantRead                (const t_sock _sock, const bool _enable) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Remove                  (const t_sock _sock) noexcept;
+    __attribute__((hot                                             ))  inline               void    CloseConnection         (const t_sock _sock) noexcept;
+    __attribute__((hot                                             ))  inline               void    Defer                   (task_cb _task);
+    __attribute__((hot                                             ))  inline               void    Post                    (task_cb _task);
+    __attribute__((hot                                             ))  inline               t_u64   AddTimer                (const t_u64 _delay_ms, task_cb _task);
+    __attribute__((hot                                             ))  inline               bool    CancelTimer             (const t_u64 _timer) noexcept;
+    __attribute__((hot                                             ))  inline               bool    RestartTimer            (const t_u64 _timer, const t_u64 _delay_ms) noexcept;
+    __attribute__((hot                                             ))  inline               bool    SetIdleTimeout          (const t_sock _sock, const t_u32 _timeout_ms);
+    __attribute__((hot                                             ))  inline               bool    SetDeadline             (const t_sock _sock, const t_u32 _timeout_ms);
+    __attribute__((hot                                             ))  inline               t_u32   RunOnce                 (const int _timeout_ms = DEFAULT_LOOP_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               void    Run                     (void);
+    __attribute__((cold                                            ))  inline               void    Stop                    (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               bool    IsRunning               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetChannelCount         (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetTimerCount           (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsWatched               (const t_sock _sock) const noexcept;
+    __attribute__((cold                                            ))  inline static        bool    SetNonBlocking          (const t_sock _sock) noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               bool    _Register               (const t_sock _sock, const t_u32 _interest);
+    __attribute__((hot                                             ))  inline               bool    _Rearm                  (const t_sock _sock, const t_u32 _interest) noexcept;
+    __attribute__((hot                                             ))  inline               void    _DrainAccept            (const t_sock _sock);
+    __attribute__((hot                                             ))  inline               void    _Dispatch               (const struct epoll_event &_event);
+    __attribute__((hot                                             ))  inline               void    _DrainWake              (void) noexcept;
+    __attribute__((hot                                             ))  inline               void    _RunDeferred            (void);
+    __attribute__((hot                                             ))  inline               void    _RunPosted              (void);
+    __attribute__((hot                                             ))  inline               void    _Wake                   (void) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Expire                 (const t_sock _sock, const t_u32 _generation) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               Channel* _ChannelOf             (const t_sock _sock) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        int     _SocketError            (const t_sock _sock) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
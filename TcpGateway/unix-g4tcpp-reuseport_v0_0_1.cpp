@@ -0,0 +1,233 @@
+#ifndef UNIX_G4TCPP_REUSEPORT_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-reuseport_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Prepares one listener and one event loop per shard.
+ *
+ * @param _shards Number of shards, 0 uses one per CPU the process may run on.
+ */
+TcpInitializer::ShardedTcpServer::ShardedTcpServer(const t_u32 _shards)
+    : _shard_count(_shards), _pin_cpu(true), _steering(false), _listeners(), _loops(), _workers(), _cpus(TcpInitializer::ShardedTcpServer::_AllowedCpus()) {
+    if (this->_shard_count == 0)
+        this->_shard_count = static_cast<t_u32>(this->_cpus.size());
+    for (t_u32 shard = 0; shard < this->_shard_count; ++shard) {
+        this->_listeners.emplace_back(std::make_unique<TcpListener>());
+        this->_loops.emplace_back(std::make_unique<EventLoop>());
+    }
+};
+
+/**
+ * @brief Stops and joins every worker, listeners are closed by their destructors.
+ */
+TcpInitializer::ShardedTcpServer::~ShardedTcpServer() {
+    this->Stop();
+    this->Join();
+};
+
+/**
+ * @brief Opens every shard listener on the default address and specified port.
+ *
+ * @param _port The port number to listen on.
+ * @returns true if every shard is listening, false otherwise.
+ */
+bool TcpInitializer::ShardedTcpServer::CreateTcpServer(const t_u16 _port) {
+    return this->CreateTcpServer(DEFAULT_IP_ADDRESS, _port);
+};
+
+/**
+ * @brief Opens every shard listener on the specified address and port with SO_REUSEPORT.
+ *
+ * Listeners join the reuseport group in shard order, which is the index the steering program returns.
+ *
+ * @param _address The local address to bind to.
+ * @param _port The port number to listen on.
+ * @returns true if every shard is listening, false otherwise.
+ * @throws std::runtime_error If address validation fails or socket creation fails.
+ */
+bool TcpInitializer::ShardedTcpServer::CreateTcpServer(const t_strw _address, const t_u16 _port) {
+    for (std::unique_ptr<TcpListener> &listener : this->_listeners) {
+        if (!listener->Listen(_address, _port))
+            return false;
+    }
+    if (this->_steering && !this->_AttachSteering()) {
+        TcpInitializer::Socket::Log("reuseport steering unavailable: ", strerror(errno), '\n');
+    }
+    return true;
+};
+
+/**
+ * @brief Starts one worker thread per shard, each draining its own listener on its own loop.
+ *
+ * @param _on_accept Callback invoked on the shard loop for every accepted connection.
+ */
+void TcpInitializer::ShardedTcpServer::Start(accept_cb _on_accept) {
+    for (t_u32 shard = 0; shard < this->_shard_count; ++shard) {
+        if (!this->_loops[shard]->AddListener(*this->_listeners[shard]->GetSocket(), _on_accept))
+            throw std::runtime_error(TcpInitializer::ErrorMsgCombine("shard listener register failure: "));
+    }
+    for (t_u32 shard = 0; shard < this->_shard_count; ++shard) {
+        EventLoop *loop(this->_loops[shard].get());
+        const bool pin(this->_pin_cpu);
+        const t_u32 cpu(this->_cpus[shard % this->_cpus.size()]);
+        // pinned from inside the thread, so the loop never runs a single iteration on another core
+        this->_workers.emplace_back([loop, pin, cpu, shard]() -> void {
+            if (pin && !TcpInitializer::ShardedTcpServer::_PinThread(cpu))
+                TcpInitializer::Socket::Log("shard ", shard, " cpu pin failure\n");
+            loop->Run();
+        });
+    }
+};
+
+/**
+ * @brief Asks every shard loop to return, safe to call from any thread.
+ */
+void TcpInitializer::ShardedTcpServer::Stop(void) noexcept {
+    for (std::unique_ptr<EventLoop> &loop : this->_loops) {
+        loop->Stop();
+    }
+};
+
+/**
+ * @brief Waits for every worker thread to exit.
+ */
+void TcpInitializer::ShardedTcpServer::Join(void) noexcept {
+    for (std::thread &worker : this->_workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    this->_workers.clear();
+};
+
+/**
+ * @brief Enables or disables pinning shard workers to CPUs, must be called before Start.
+ *
+ * @param _enable true to pin shard i to the allowed CPU i modulo the allowed CPU count.
+ */
+void TcpInitializer::ShardedTcpServer::SetCpuAffinity(const bool _enable) noexcept {
+    this->_pin_cpu = _enable;
+};
+
+/**
+ * @brief Enables or disables the CPU steering BPF program, must be called before CreateTcpServer.
+ *
+ * @param _enable true to route each connection to the listener of the receiving CPU.
+ */
+void TcpInitializer::ShardedTcpServer::SetSteering(const bool _enable) noexcept {
+    this->_steering = _enable;
+};
+
+/**
+ * @brief Sets the listen backlog of every shard listener, must be called before CreateTcpServer.
+ *
+ * @param max The maximum number of pending connections per shard.
+ */
+void TcpInitializer::ShardedTcpServer::SetMaxConnections(const t_u64 max) noexcept {
+    for (std::unique_ptr<TcpListener> &listener : this->_listeners) {
+        listener->SetMaxConnections(max);
+    }
+};
+
+/**
+ * @brief Gets the number of shards.
+ *
+ * @returns The shard count.
+ */
+t_u32 TcpInitializer::ShardedTcpServer::GetShardCount(void) const noexcept {
+    return this->_shard_count;
+};
+
+/**
+ * @brief Gets the listener of a shard.
+ *
+ * @param _shard The shard index, must be below GetShardCount().
+ * @returns A reference to the shard listener.
+ */
+TcpInitializer::TcpListener &TcpInitializer::ShardedTcpServer::GetListener(const t_u32 _shard) noexcept {
+    return *this->_listeners[_shard];
+};
+
+/**
+ * @brief Gets the event loop of a shard, e.g. to register upstream connections on the same core.
+ *
+ * @param _shard The shard index, must be below GetShardCount().
+ * @returns A reference to the shard event loop.
+ */
+TcpInitializer::EventLoop &TcpInitializer::ShardedTcpServer::GetLoop(const t_u32 _shard) noexcept {
+    return *this->_loops[_shard];
+};
+
+/**
+ * @brief Attaches a classic BPF program mapping the receiving CPU to its shard to the reuseport group.
+ *
+ * The program compares the CPU with every allowed CPU and returns the position of the match
+ * modulo the shard count, the same shard Start pins to that CPU. A CPU outside the allowed set
+ * (e.g. one reserved for interrupts) falls back to (cpu % shard count).
+ *
+ * @returns true if the program was attached, false otherwise (errno E2BIG if the CPU list does not fit a program).
+ */
+bool TcpInitializer::ShardedTcpServer::_AttachSteering(void) noexcept {
+    if (this->_cpus.size() * 2 + 3 > BPF_MAXINSNS) {
+        errno = E2BIG;
+        return false;
+    }
+    std::vector<struct sock_filter> code;
+    try {
+        code.reserve(this->_cpus.size() * 2 + 3);
+        code.push_back({BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<t_u32>(SKF_AD_OFF + SKF_AD_CPU)});
+        for (t_u32 position = 0; position < this->_cpus.size(); ++position) {
+            code.push_back({BPF_JMP | BPF_JEQ | BPF_K, 0, 1, this->_cpus[position]});
+            code.push_back({BPF_RET | BPF_K, 0, 0, position % this->_shard_count});
+        }
+        code.push_back({BPF_ALU | BPF_MOD | BPF_K, 0, 0, this->_shard_count});
+        code.push_back({BPF_RET | BPF_A, 0, 0, 0});
+    } catch (const t_except &) {
+        errno = ENOMEM;
+        return false;
+    }
+    struct sock_fprog program;
+    program.len = static_cast<unsigned short>(code.size());
+    program.filter = code.data();
+    // the program belongs to the whole group, attaching it through any member socket is enough
+    return setsockopt(*this->_listeners.front()->GetSocket(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0;
+};
+
+/**
+ * @brief Restricts the calling thread to a single CPU.
+ *
+ * @param _cpu The CPU index.
+ * @returns true if the affinity was applied, false otherwise.
+ */
+bool TcpInitializer::ShardedTcpServer::_PinThread(const t_u32 _cpu) noexcept {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(_cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+};
+
+/**
+ * @brief Lists the CPUs the calling thread may run on.
+ *
+ * @returns The allowed CPU indexes in ascending order, 0 to hardware_concurrency - 1 if the mask cannot be read.
+ */
+std::vector<t_u32> TcpInitializer::ShardedTcpServer::_AllowedCpus(void) {
+    std::vector<t_u32> cpus;
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        for (t_u32 cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpu_set))
+                cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        for (t_u32 cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+};
+
+#endif
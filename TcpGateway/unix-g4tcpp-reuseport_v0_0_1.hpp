@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_REUSEPORT_V0_0_1_HPP
+#define UNIX_G4TCPP_REUSEPORT_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace TcpInitializer
+{
+
+/**
+ * Per-core acceptor sharding on top of SO_REUSEPORT.
+ *
+ * CreateTcpServer opens one TcpListener per shard on the same address and port, and Start runs
+ * one EventLoop per shard on its own thread, pinned to a CPU. The kernel spreads incoming
+ * connections over the listeners, so no accept path is shared between threads. With steering
+ * enabled a classic BPF program is attached to the reuseport group that picks the listener of
+ * the CPU handling the incoming packet, keeping each connection on the core that received it.
+ *
+ * Pinning and steering both follow the CPUs the process may run on (sched_getaffinity at
+ * construction, in ascending order): shard i runs on the i-th allowed CPU, and a packet received
+ * there goes to shard i, so a restricted cpuset or a taskset never splits the two.
+ */
+class ShardedTcpServer
+{
+  public:
+    using accept_cb  = EventLoop::accept_cb;
+
+  protected:
+    t_u32                                                 _shard_count;
+    bool                                                  _pin_cpu;
+    bool                                                  _steering;
+    std::vector<std::unique_ptr<TcpListener>>             _listeners;
+    std::vector<std::unique_ptr<EventLoop>>               _loops;
+    std::vector<std::thread>                              _workers;
+    std::vector<t_u32>                                    _cpus;
+
+  public:
+    __attribute__((cold                                            ))  explicit                ShardedTcpServer        (const t_u32 _shards = 0);
+    ShardedTcpServer(const ShardedTcpServer &)            = delete;
+    ShardedTcpServer &operator=(const ShardedTcpServer &) = delete;
+    __attribute__((cold                                            ))                          ~ShardedTcpServer       ();
+
+    __attribute__((cold                                            ))  inline               bool    CreateTcpServer         (const t_u16 _port);
+    __attribute__((cold                                            ))  inline               bool    CreateTcpServer         (const t_strw _address, const t_u16 _port);
+    __attribute__((cold                                            ))  inline               void    Start                   (accept_cb _on_accept);
+    __attribute__((cold                                            ))  inline               void    Stop                    (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Join                    (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetCpuAffinity          (const bool _enable) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetSteering             (const bool _enable) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetMaxConnections       (const t_u64 max) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u32   GetShardCount           (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               TcpListener &GetListener        (const t_u32 _shard) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               EventLoop   &GetLoop            (const t_u32 _shard) noexcept;
+
+  protected:
+    __attribute__((cold                                            ))  inline               bool    _AttachSteering         (void) noexcept;
+    __attribute__((cold                                            ))  inline static        bool    _PinThread              (const t_u32 _cpu) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        std::vector<t_u32> _AllowedCpus (void);
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,342 @@
+#ifndef UNIX_G4TCPP_TIMERS_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-timers_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates an empty wheel, its clock starts at 0 ms.
+ */
+TcpInitializer::TimerWheel::TimerWheel(void)
+    : _timers(), _heads(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1, TIMER_WHEEL_NIL), _tails(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1, TIMER_WHEEL_NIL), _occupied(), _free(TIMER_WHEEL_NIL), _current(0), _count(0), _origin(std::chrono::steady_clock::now()) {};
+
+/**
+ * @brief Arms a one-shot timer.
+ *
+ * @param _delay_ms Delay in milliseconds, 0 fires on the next Advance.
+ * @param _callback Called from Advance once the delay has elapsed.
+ * @returns The timer id (never 0), valid until the timer fires or is cancelled.
+ */
+TcpInitializer::t_u64 TcpInitializer::TimerWheel::Schedule(const t_u64 _delay_ms, timer_cb _callback) {
+    t_u32 index(this->_free);
+    if (index != TIMER_WHEEL_NIL) {
+        this->_free = this->_timers[index].next;
+    } else {
+        index = static_cast<t_u32>(this->_timers.size());
+        this->_timers.emplace_back();
+    }
+    Timer &timer(this->_timers[index]);
+    timer.callback = std::move(_callback);
+    timer.expires = this->_DueIn(_delay_ms);
+    this->_Insert(index);
+    ++this->_count;
+    return (static_cast<t_u64>(timer.generation) << 32) | index;
+};
+
+/**
+ * @brief Disarms a timer.
+ *
+ * @param _id The timer id returned by Schedule.
+ * @returns true if the timer was pending, false if it already fired or was cancelled.
+ */
+bool TcpInitializer::TimerWheel::Cancel(const t_u64 _id) noexcept {
+    const t_u32 index(this->_IndexOf(_id));
+    if (index == TIMER_WHEEL_NIL)
+        return false;
+    this->_Unlink(index);
+    Timer &timer(this->_timers[index]);
+    timer.callback = nullptr;
+    timer.slot = TIMER_WHEEL_NIL;
+    timer.next = this->_free;
+    if (++timer.generation == 0)
+        timer.generation = 1;
+    this->_free = index;
+    --this->_count;
+    return true;
+};
+
+/**
+ * @brief Pushes a pending timer back to a new delay from now, e.g. an idle timeout on activity.
+ *
+ * @param _id The timer id returned by Schedule.
+ * @param _delay_ms New delay in milliseconds from now.
+ * @returns true if the timer was re-armed, false if it already fired or was cancelled.
+ */
+bool TcpInitializer::TimerWheel::Restart(const t_u64 _id, const t_u64 _delay_ms) noexcept {
+    const t_u32 index(this->_IndexOf(_id));
+    if (index == TIMER_WHEEL_NIL)
+        return false;
+    Timer &timer(this->_timers[index]);
+    const t_u64 expires(this->_DueIn(_delay_ms));
+    if (timer.slot == TcpInitializer::TimerWheel::_firing_slot || timer.expires != expires) {
+        this->_Unlink(index);
+        timer.expires = expires;
+        this->_Insert(index);
+    }
+    return true;
+};
+
+/**
+ * @brief Fires every timer whose delay has elapsed.
+ *
+ * Callbacks run tick by tick in due order and may schedule, restart or cancel timers, including
+ * ones due in the same call.
+ *
+ * @returns The number of timers fired.
+ */
+TcpInitializer::t_u32 TcpInitializer::TimerWheel::Advance(void) {
+    const t_u64 now(this->Now());
+    t_u32 fired(0);
+    while (this->_count > 0) {
+        const t_u64 tick(this->_current + this->_NextTicks());
+        if (tick > now)
+            break;
+        this->_current = tick;
+        // higher levels first, a timer cascaded from level 2 may land in the level 1 slot due now
+        for (t_u32 level = TIMER_WHEEL_LEVELS - 1; level > 0; --level) {
+            if ((tick & ((static_cast<t_u64>(1) << (level * TIMER_WHEEL_SLOT_BITS)) - 1)) == 0)
+                this->_Cascade(level);
+        }
+        fired += this->_Fire();
+    }
+    // nothing is due before the next occupied slot, skipping the empty ticks keeps slots valid
+    this->_current = std::max(this->_current, now);
+    return fired;
+};
+
+/**
+ * @brief Gets how long a poller may sleep before the wheel needs to advance.
+ *
+ * A timer parked on a higher level wakes the poller when its slot is cascaded, possibly before
+ * the timer is due.
+ *
+ * @returns The timeout in milliseconds, -1 if no timer is pending.
+ */
+int TcpInitializer::TimerWheel::NextTimeout(void) const noexcept {
+    if (this->_count == 0)
+        return -1;
+    const t_u64 due(this->_current + this->_NextTicks());
+    const t_u64 now(this->Now());
+    if (due <= now)
+        return 0;
+    return static_cast<int>(std::min<t_u64>(due - now, static_cast<t_u64>(std::numeric_limits<int>::max())));
+};
+
+/**
+ * @brief Checks whether a timer is still armed.
+ *
+ * @param _id The timer id returned by Schedule.
+ * @returns true if the timer has neither fired nor been cancelled, false otherwise.
+ */
+bool TcpInitializer::TimerWheel::IsPending(const t_u64 _id) const noexcept {
+    return this->_IndexOf(_id) != TIMER_WHEEL_NIL;
+};
+
+/**
+ * @brief Gets the number of armed timers.
+ *
+ * @returns The timer count.
+ */
+TcpInitializer::t_u64 TcpInitializer::TimerWheel::GetCount(void) const noexcept {
+    return this->_count;
+};
+
+/**
+ * @brief Gets the wheel clock.
+ *
+ * @returns Milliseconds since the wheel was created (steady clock).
+ */
+TcpInitializer::t_u64 TcpInitializer::TimerWheel::Now(void) const noexcept {
+    return static_cast<t_u64>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->_origin).count());
+};
+
+/**
+ * @brief Converts a delay into an absolute tick, never the current one (already fired).
+ *
+ * @param _delay_ms Delay in milliseconds, saturated at the end of the clock.
+ * @returns The due tick.
+ */
+TcpInitializer::t_u64 TcpInitializer::TimerWheel::_DueIn(const t_u64 _delay_ms) const noexcept {
+    const t_u64 now(this->Now());
+    const t_u64 due(_delay_ms > std::numeric_limits<t_u64>::max() - now ? std::numeric_limits<t_u64>::max() : now + _delay_ms);
+    return std::max(due, this->_current + 1);
+};
+
+/**
+ * @brief Hashes a timer into the lowest level whose range covers its expiry.
+ *
+ * @param _index The timer node.
+ */
+void TcpInitializer::TimerWheel::_Insert(const t_u32 _index) noexcept {
+    const t_u64 expires(this->_timers[_index].expires);
+    for (t_u32 level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        const t_u32 shift(level * TIMER_WHEEL_SLOT_BITS);
+        // compared by slot number rather than delay, so a timer never lands on the slot just cascaded
+        if ((expires >> shift) - (this->_current >> shift) < TIMER_WHEEL_SLOTS) {
+            this->_Link(_index, level * TIMER_WHEEL_SLOTS + static_cast<t_u32>((expires >> shift) & (TIMER_WHEEL_SLOTS - 1)));
+            return;
+        }
+    }
+    // beyond the wheel range: park in the furthest top slot, re-hashed when it is cascaded
+    const t_u32 shift((TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_SLOT_BITS);
+    this->_Link(_index, (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_SLOTS + static_cast<t_u32>(((this->_current >> shift) + TIMER_WHEEL_SLOTS - 1) & (TIMER_WHEEL_SLOTS - 1)));
+};
+
+/**
+ * @brief Appends a timer to a slot list, so timers hashed to one slot keep the order they were armed in.
+ *
+ * @param _index The timer node.
+ * @param _slot The slot list, level * TIMER_WHEEL_SLOTS + slot or the firing list.
+ */
+void TcpInitializer::TimerWheel::_Link(const t_u32 _index, const t_u32 _slot) noexcept {
+    Timer &timer(this->_timers[_index]);
+    timer.slot = _slot;
+    timer.prev = this->_tails[_slot];
+    timer.next = TIMER_WHEEL_NIL;
+    if (timer.prev != TIMER_WHEEL_NIL)
+        this->_timers[timer.prev].next = _index;
+    else
+        this->_heads[_slot] = _index;
+    this->_tails[_slot] = _index;
+    if (_slot < TcpInitializer::TimerWheel::_firing_slot)
+        this->_occupied[_slot / TIMER_WHEEL_SLOTS][(_slot % TIMER_WHEEL_SLOTS) / 64] |= static_cast<t_u64>(1) << (_slot % 64);
+};
+
+/**
+ * @brief Removes a timer from its slot list.
+ *
+ * @param _index The timer node.
+ */
+void TcpInitializer::TimerWheel::_Unlink(const t_u32 _index) noexcept {
+    Timer &timer(this->_timers[_index]);
+    if (timer.prev != TIMER_WHEEL_NIL)
+        this->_timers[timer.prev].next = timer.next;
+    else
+        this->_heads[timer.slot] = timer.next;
+    if (timer.next != TIMER_WHEEL_NIL)
+        this->_timers[timer.next].prev = timer.prev;
+    else
+        this->_tails[timer.slot] = timer.prev;
+    if (timer.slot < TcpInitializer::TimerWheel::_firing_slot && this->_heads[timer.slot] == TIMER_WHEEL_NIL)
+        this->_occupied[timer.slot / TIMER_WHEEL_SLOTS][(timer.slot % TIMER_WHEEL_SLOTS) / 64] &= ~(static_cast<t_u64>(1) << (timer.slot % 64));
+    timer.prev = TIMER_WHEEL_NIL;
+    timer.next = TIMER_WHEEL_NIL;
+};
+
+/**
+ * @brief Re-hashes the timers of the current slot of a level into the lower levels.
+ *
+ * @param _level The level whose slot came due.
+ */
+void TcpInitializer::TimerWheel::_Cascade(const t_u32 _level) noexcept {
+    const t_u32 slot(_level * TIMER_WHEEL_SLOTS + static_cast<t_u32>((this->_current >> (_level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1)));
+    t_u32 index(this->_heads[slot]);
+    this->_heads[slot] = TIMER_WHEEL_NIL;
+    this->_tails[slot] = TIMER_WHEEL_NIL;
+    this->_occupied[_level][(slot % TIMER_WHEEL_SLOTS) / 64] &= ~(static_cast<t_u64>(1) << (slot % 64));
+    while (index != TIMER_WHEEL_NIL) {
+        const t_u32 next(this->_timers[index].next);
+        this->_Insert(index);
+        index = next;
+    }
+};
+
+/**
+ * @brief Fires the timers of the current level 0 slot.
+ *
+ * The slot is moved to the firing list first, so a callback cancelling or restarting a timer due
+ * in the same tick unlinks it from a consistent list.
+ *
+ * @returns The number of timers fired.
+ */
+TcpInitializer::t_u32 TcpInitializer::TimerWheel::_Fire(void) {
+    const t_u32 slot(static_cast<t_u32>(this->_current & (TIMER_WHEEL_SLOTS - 1)));
+    t_u32 index(this->_heads[slot]);
+    if (index == TIMER_WHEEL_NIL)
+        return 0;
+    this->_heads[TcpInitializer::TimerWheel::_firing_slot] = index;
+    this->_tails[TcpInitializer::TimerWheel::_firing_slot] = this->_tails[slot];
+    this->_heads[slot] = TIMER_WHEEL_NIL;
+    this->_tails[slot] = TIMER_WHEEL_NIL;
+    this->_occupied[0][slot / 64] &= ~(static_cast<t_u64>(1) << (slot % 64));
+    for (; index != TIMER_WHEEL_NIL; index = this->_timers[index].next) {
+        this->_timers[index].slot = TcpInitializer::TimerWheel::_firing_slot;
+    }
+    t_u32 fired(0);
+    while ((index = this->_heads[TcpInitializer::TimerWheel::_firing_slot]) != TIMER_WHEEL_NIL) {
+        // moved out and released first: the callback may schedule (growing _timers) or re-use the node
+        timer_cb callback(std::move(this->_timers[index].callback));
+        this->Cancel((static_cast<t_u64>(this->_timers[index].generation) << 32) | index);
+        ++fired;
+        if (callback)
+            callback();
+    }
+    return fired;
+};
+
+/**
+ * @brief Gets the distance to the next tick that fires or cascades an occupied slot.
+ *
+ * @returns The number of ticks after the current one, at least 1, or 0 if the wheel is empty.
+ */
+TcpInitializer::t_u64 TcpInitializer::TimerWheel::_NextTicks(void) const noexcept {
+    t_u64 best(0);
+    for (t_u32 level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        const t_u32 shift(level * TIMER_WHEEL_SLOT_BITS);
+        const t_u64 base(this->_current >> shift);
+        const t_u32 current(static_cast<t_u32>(base & (TIMER_WHEEL_SLOTS - 1)));
+        // the current slot of a level is always empty (fired or cascaded), search the others in ring order
+        int found(TcpInitializer::TimerWheel::_FirstSet(this->_occupied[level], current + 1, TIMER_WHEEL_SLOTS));
+        if (found < 0)
+            found = TcpInitializer::TimerWheel::_FirstSet(this->_occupied[level], 0, current);
+        if (found < 0)
+            continue;
+        const t_u64 distance((static_cast<t_u32>(found) - current) & (TIMER_WHEEL_SLOTS - 1));
+        const t_u64 ticks(((base + distance) << shift) - this->_current);
+        if (best == 0 || ticks < best)
+            best = ticks;
+    }
+    return best;
+};
+
+/**
+ * @brief Validates a timer id against the generation of its node.
+ *
+ * @param _id The timer id.
+ * @returns The node index, TIMER_WHEEL_NIL if the id is stale or malformed.
+ */
+TcpInitializer::t_u32 TcpInitializer::TimerWheel::_IndexOf(const t_u64 _id) const noexcept {
+    const t_u32 index(static_cast<t_u32>(_id & 0xFFFFFFFFu));
+    if (index >= this->_timers.size())
+        return TIMER_WHEEL_NIL;
+    const Timer &timer(this->_timers[index]);
+    if (timer.generation != static_cast<t_u32>(_id >> 32) || timer.slot == TIMER_WHEEL_NIL)
+        return TIMER_WHEEL_NIL;
+    return index;
+};
+
+/**
+ * @brief Finds the first set bit of a 256-bit slot bitmap within a range.
+ *
+ * @param _bits The bitmap, TIMER_WHEEL_SLOTS / 64 words.
+ * @param _from First bit to consider.
+ * @param _to One past the last bit to consider.
+ * @returns The bit index, -1 if no bit is set in the range.
+ */
+int TcpInitializer::TimerWheel::_FirstSet(const t_u64 *_bits, const t_u32 _from, const t_u32 _to) noexcept {
+    if (_from >= _to)
+        return -1;
+    for (t_u32 word = _from / 64; word <= (_to - 1) / 64; ++word) {
+        t_u64 bits(_bits[word]);
+        if (word == _from / 64)
+            bits &= ~static_cast<t_u64>(0) << (_from % 64);
+        if (word == (_to - 1) / 64 && (_to % 64) != 0)
+            bits &= (static_cast<t_u64>(1) << (_to % 64)) - 1;
+        if (bits != 0)
+            return static_cast<int>(word * 64 + static_cast<t_u32>(__builtin_ctzll(bits)));
+    }
+    return -1;
+};
+
+#endif
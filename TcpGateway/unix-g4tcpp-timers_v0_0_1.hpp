@@ -0,0 +1,89 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_TIMERS_V0_0_1_HPP
+#define UNIX_G4TCPP_TIMERS_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+
+#include <limits>
+
+namespace TcpInitializer
+{
+
+#define TIMER_WHEEL_LEVELS             4u
+#define TIMER_WHEEL_SLOT_BITS          8u
+#define TIMER_WHEEL_SLOTS              (1u << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_NIL                0xFFFFFFFFu
+
+/**
+ * Hierarchical hashed timing wheel with a 1 ms tick.
+ *
+ * Four levels of 256 slots cover 2^32 ms (about 49 days), longer delays are parked in the last
+ * slot of the top level and re-hashed when it comes round. A timer is a node in a slot's
+ * intrusive list, so Schedule, Cancel and Restart are O(1) whatever the number of timers, and
+ * nodes are recycled through a free list rather than allocated. A timer due at a higher level is
+ * moved down (cascaded) once, when the lower level wraps onto its slot. Advance jumps straight
+ * to the next occupied slot using per-level occupancy bitmaps, so a loop sleeping for a long time
+ * does not walk every elapsed tick.
+ *
+ * Timer ids carry a generation, an id whose timer already fired or was cancelled is rejected. The
+ * wheel is not thread-safe, it belongs to the thread driving Advance (the loop thread).
+ */
+class TimerWheel
+{
+  public:
+    using timer_cb   = std::function<void(void)>;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        timer_cb           callback    {                                                    };
+        t_u64              expires     {                                                    };
+        t_u32              prev        { TIMER_WHEEL_NIL                                    };
+        t_u32              next        { TIMER_WHEEL_NIL                                    };
+        t_u32              slot        { TIMER_WHEEL_NIL                                    };
+        t_u32              generation  { 1                                                  };
+    } Timer;
+
+    // one list per slot of every level, plus the list of timers being fired
+    static constexpr t_u32 _firing_slot = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS;
+
+    std::vector<Timer>                                    _timers;
+    std::vector<t_u32>                                    _heads;
+    std::vector<t_u32>                                    _tails;
+    t_u64                                                 _occupied[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64];
+    t_u32                                                 _free;
+    t_u64                                                 _current;
+    t_u64                                                 _count;
+    std::chrono::steady_clock::time_point                 _origin;
+
+  public:
+    __attribute__((cold                                            ))                          TimerWheel              (void);
+    TimerWheel(const TimerWheel &)            = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+    __attribute__((cold                                            ))                          ~TimerWheel             () = default;
+
+    __attribute__((hot                                             ))  inline               t_u64   Schedule                (const t_u64 _delay_ms, timer_cb _callback);
+    __attribute__((hot                                             ))  inline               bool    Cancel                  (const t_u64 _id) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Restart                 (const t_u64 _id, const t_u64 _delay_ms) noexcept;
+    __attribute__((hot                                             ))  inline               t_u32   Advance                 (void);
+    __attribute__((hot, warn_unused_result                         ))  inline               int     NextTimeout             (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsPending               (const t_u64 _id) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetCount                (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   Now                     (void) const noexcept;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   _DueIn                  (const t_u64 _delay_ms) const noexcept;
+    __attribute__((hot                                             ))  inline               void    _Insert                 (const t_u32 _index) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Link                   (const t_u32 _index, const t_u32 _slot) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Unlink                 (const t_u32 _index) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Cascade                (const t_u32 _level) noexcept;
+    __attribute__((hot                                             ))  inline               t_u32   _Fire                   (void);
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   _NextTicks              (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u32   _IndexOf                (const t_u64 _id) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline static        int     _FirstSet               (const t_u64 *_bits, const t_u32 _from, const t_u32 _to) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
@@ -0,0 +1,448 @@
+#ifndef UNIX_G4TCPP_UPSTREAM_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-upstream_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates an empty group.
+ *
+ * @param _balance The backend selection policy.
+ * @param _max_fails Consecutive reported failures after which a backend is ejected.
+ * @param _eject_ms How long a passively ejected backend is skipped.
+ */
+TcpInitializer::UpstreamGroup::UpstreamGroup(const Balance _balance, const t_u32 _max_fails, const t_u32 _eject_ms) noexcept
+    : _balance(_balance), _max_fails(_max_fails > 0 ? _max_fails : DEFAULT_UPSTREAM_MAX_FAILS), _eject_ms(_eject_ms), _backends(), _ring(), _cursor(0), _rng(0), _mtx(), _prober(), _probing(false), _probe_cv() {
+    this->_rng = TcpInitializer::UpstreamGroup::_Mix(static_cast<t_u64>(std::chrono::steady_clock::now().time_since_epoch().count()) ^ reinterpret_cast<std::uintptr_t>(this));
+    if (this->_rng == 0)
+        this->_rng = 1;
+};
+
+/**
+ * @brief Stops the health prober.
+ */
+TcpInitializer::UpstreamGroup::~UpstreamGroup() {
+    this->StopProbing();
+};
+
+/**
+ * @brief Adds a backend to the group.
+ *
+ * @param _address The backend address, numeric IPv4 or IPv6.
+ * @param _port The backend port.
+ * @returns true if the backend was added, false if the address is invalid.
+ */
+bool TcpInitializer::UpstreamGroup::AddBackend(const t_strw _address, const t_u16 _port) {
+    Backend backend;
+    TcpInitializer::IpAddress target;
+    if (_port == 0 || !TcpInitializer::AddressParser::ParseAddress(_address, target))
+        return false;
+    target.port = _port;
+    if (!TcpInitializer::AddressParser::ToSockAddr(target, backend.address, backend.address_size))
+        return false;
+    backend.name = target.family == AF_INET6 ? '[' + t_str(_address) + ']' : t_str(_address);
+    backend.name += ':' + std::to_string(_port);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_backends.push_back(std::move(backend));
+    this->_RebuildRing();
+    return true;
+};
+
+/**
+ * @brief Chooses a backend for a new session and counts it as outstanding until Release.
+ *
+ * @param _affinity Key hashed by CONSISTENT_HASH (e.g. the client address), ignored otherwise.
+ * @param _index Set to the chosen backend, pass it to Release and the Report functions.
+ * @param _address Set to the address of the chosen backend.
+ * @param _address_size Set to the size of _address.
+ * @returns true if a backend was chosen, false if the group is empty (errno EHOSTUNREACH).
+ */
+bool TcpInitializer::UpstreamGroup::Pick(const t_u64 _affinity, t_u32 &_index, PeerAddress &_address, socklen_t &_address_size) noexcept {
+    return this->_Pick(_affinity, _index, _address, _address_size, nullptr);
+};
+
+/**
+ * @brief Ends a session started by Pick.
+ *
+ * @param _index The backend returned by Pick.
+ */
+void TcpInitializer::UpstreamGroup::Release(const t_u32 _index) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (_index < this->_backends.size() && this->_backends[_index].outstanding > 0)
+        --this->_backends[_index].outstanding;
+};
+
+/**
+ * @brief Records a successful connect to a backend, resetting its failure streak.
+ *
+ * @param _index The backend returned by Pick.
+ * @param _latency_us The measured connect latency, folded into the backend's moving average.
+ */
+void TcpInitializer::UpstreamGroup::ReportSuccess(const t_u32 _index, const t_u64 _latency_us) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (_index >= this->_backends.size())
+        return;
+    Backend &backend(this->_backends[_index]);
+    backend.fails = 0;
+    if (backend.latency_us == 0) {
+        backend.latency_us = std::max<t_u64>(_latency_us, 1);
+    } else {
+        const int64_t delta(static_cast<int64_t>(_latency_us) - static_cast<int64_t>(backend.latency_us));
+        backend.latency_us = static_cast<t_u64>(std::max<int64_t>(1, static_cast<int64_t>(backend.latency_us) + delta / (1 << UPSTREAM_LATENCY_EWMA_SHIFT)));
+    }
+};
+
+/**
+ * @brief Records a failed connect or request, ejecting the backend once its failure streak reaches the limit.
+ *
+ * @param _index The backend returned by Pick.
+ */
+void TcpInitializer::UpstreamGroup::ReportFailure(const t_u32 _index) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (_index >= this->_backends.size())
+        return;
+    Backend &backend(this->_backends[_index]);
+    ++backend.failures;
+    if (++backend.fails < this->_max_fails)
+        return;
+    backend.fails = 0;
+    ++backend.ejections;
+    backend.ejected_until = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->_eject_ms);
+    TcpInitializer::Socket::Log("upstream ", backend.name, " ejected for ", this->_eject_ms, " ms\n");
+};
+
+/**
+ * @brief Opens a blocking connection to a picked backend, trying other backends on failure.
+ *
+ * @param _affinity Key hashed by CONSISTENT_HASH, ignored otherwise.
+ * @param _index Set to the connected backend, pass it to Release once the connection is done.
+ * @param _timeout_ms Connect deadline per attempt, negative waits without limit.
+ * @returns The connected socket, or -1 if no backend accepted.
+ */
+t_sock TcpInitializer::UpstreamGroup::Dial(const t_u64 _affinity, t_u32 &_index, const int _timeout_ms) noexcept {
+    const t_u32 attempts(this->GetBackendCount());
+    std::vector<bool> tried(attempts, false);
+    for (t_u32 attempt = 0; attempt < attempts; ++attempt) {
+        PeerAddress address;
+        socklen_t address_size(0);
+        if (!this->_Pick(_affinity, _index, address, address_size, &tried))
+            return -1;
+        const t_sock sock(socket(address.addr.sa_family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP));
+        if (sock < 0) {
+            this->Release(_index);
+            return -1;
+        }
+        const std::chrono::steady_clock::time_point started(std::chrono::steady_clock::now());
+        if (TcpInitializer::Socket::ConnectWithin(sock, &address.addr, address_size, _timeout_ms)) {
+            const int nodelay(1);
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            this->ReportSuccess(_index, static_cast<t_u64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count()));
+            return sock;
+        }
+        close(sock);
+        tried[_index] = true;
+        this->ReportFailure(_index);
+        this->Release(_index);
+    }
+    errno = EHOSTUNREACH;
+    return -1;
+};
+
+/**
+ * @brief Runs one round of active health checks, connecting to every backend in parallel.
+ *
+ * A backend whose probe connect fails or misses the deadline is marked unhealthy until a later
+ * probe succeeds; successful probes also refresh the latency average.
+ *
+ * @param _timeout_ms Deadline for the whole round.
+ * @returns The number of healthy backends.
+ */
+t_u32 TcpInitializer::UpstreamGroup::Probe(const int _timeout_ms) noexcept {
+    std::vector<std::pair<PeerAddress, socklen_t>> addresses;
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        for (const Backend &backend : this->_backends) {
+            addresses.emplace_back(backend.address, backend.address_size);
+        }
+    }
+    const std::size_t count(addresses.size());
+    std::vector<struct pollfd> probes(count, pollfd{-1, POLLOUT, 0});
+    std::vector<bool> healthy(count, false);
+    std::vector<t_u64> latency_us(count, 0);
+    const std::chrono::steady_clock::time_point started(std::chrono::steady_clock::now());
+    const std::chrono::steady_clock::time_point deadline(started + std::chrono::milliseconds(std::max(0, _timeout_ms)));
+    std::size_t waiting(0);
+    for (std::size_t i = 0; i < count; ++i) {
+        const t_sock sock(socket(addresses[i].first.addr.sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP));
+        if (sock < 0)
+            continue;
+        if (connect(sock, &addresses[i].first.addr, addresses[i].second) == 0) {
+            healthy[i] = true;
+            close(sock);
+        } else if (errno == EINPROGRESS) {
+            probes[i].fd = sock;
+            ++waiting;
+        } else {
+            close(sock);
+        }
+    }
+    while (waiting > 0) {
+        const int64_t remaining(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+        if (remaining <= 0)
+            break;
+        const int ready(poll(probes.data(), probes.size(), static_cast<int>(remaining)));
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            break;
+        const t_u64 elapsed_us(static_cast<t_u64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count()));
+        for (std::size_t i = 0; i < count; ++i) {
+            if (probes[i].fd < 0 || probes[i].revents == 0)
+                continue;
+            int error(0);
+            socklen_t error_size(sizeof(error));
+            healthy[i] = getsockopt(probes[i].fd, SOL_SOCKET, SO_ERROR, &error, &error_size) == 0 && error == 0;
+            latency_us[i] = elapsed_us;
+            close(probes[i].fd);
+            probes[i].fd = -1;
+            --waiting;
+        }
+    }
+    for (struct pollfd &probe : probes) {
+        if (probe.fd >= 0)
+            close(probe.fd);
+    }
+
+    t_u32 healthy_count(0);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    for (std::size_t i = 0; i < count; ++i) {
+        Backend &backend(this->_backends[i]);
+        if (backend.healthy != healthy[i])
+            TcpInitializer::Socket::Log("upstream ", backend.name, healthy[i] ? " healthy\n" : " unhealthy\n");
+        backend.healthy = healthy[i];
+        if (!healthy[i])
+            continue;
+        ++healthy_count;
+        if (latency_us[i] > 0)
+            backend.latency_us = backend.latency_us == 0 ? latency_us[i] : backend.latency_us - (backend.latency_us >> UPSTREAM_LATENCY_EWMA_SHIFT) + (latency_us[i] >> UPSTREAM_LATENCY_EWMA_SHIFT);
+    }
+    return healthy_count;
+};
+
+/**
+ * @brief Starts a background thread running Probe at a fixed interval.
+ *
+ * @param _interval_ms Pause between two probe rounds.
+ * @param _timeout_ms Deadline of each probe round.
+ */
+void TcpInitializer::UpstreamGroup::StartProbing(const t_u32 _interval_ms, const int _timeout_ms) {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->_probing)
+            return;
+        this->_probing = true;
+    }
+    this->_prober = std::thread([this, _interval_ms, _timeout_ms]() -> void {
+        std::unique_lock<std::mutex> lock(this->_mtx);
+        while (this->_probing) {
+            lock.unlock();
+            this->Probe(_timeout_ms);
+            lock.lock();
+            this->_probe_cv.wait_for(lock, std::chrono::milliseconds(_interval_ms), [this]() -> bool { return !this->_probing; });
+        }
+    });
+};
+
+/**
+ * @brief Stops the background prober and waits for it to exit.
+ */
+void TcpInitializer::UpstreamGroup::StopProbing(void) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_probing = false;
+    }
+    this->_probe_cv.notify_all();
+    if (this->_prober.joinable())
+        this->_prober.join();
+};
+
+/**
+ * @brief Gets the number of backends.
+ *
+ * @returns The backend count.
+ */
+t_u32 TcpInitializer::UpstreamGroup::GetBackendCount(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return static_cast<t_u32>(this->_backends.size());
+};
+
+/**
+ * @brief Gets a snapshot of every backend, in the order they were added.
+ *
+ * @returns One entry per backend.
+ */
+std::vector<TcpInitializer::UpstreamGroup::BackendStats> TcpInitializer::UpstreamGroup::GetStats(void) const {
+    std::vector<BackendStats> stats;
+    const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    stats.reserve(this->_backends.size());
+    for (const Backend &backend : this->_backends) {
+        stats.push_back(BackendStats{backend.name, backend.healthy, now < backend.ejected_until, backend.outstanding, backend.latency_us, backend.picks, backend.failures, backend.ejections});
+    }
+    return stats;
+};
+
+/**
+ * @brief Chooses a backend and counts it as outstanding.
+ *
+ * @param _affinity Key hashed by CONSISTENT_HASH, ignored otherwise.
+ * @param _index Set to the chosen backend.
+ * @param _address Set to the address of the chosen backend.
+ * @param _address_size Set to the size of _address.
+ * @param _tried Backends to skip, one flag per backend, or nullptr.
+ * @returns true if a backend was chosen, false if the group is empty (errno EHOSTUNREACH).
+ */
+bool TcpInitializer::UpstreamGroup::_Pick(const t_u64 _affinity, t_u32 &_index, PeerAddress &_address, socklen_t &_address_size, const std::vector<bool> *_tried) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const t_u32 count(static_cast<t_u32>(this->_backends.size()));
+    if (count == 0) {
+        errno = EHOSTUNREACH;
+        return false;
+    }
+    const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+    const auto untried = [&](const t_u32 _candidate) -> bool { return _tried == nullptr || !(*_tried)[_candidate]; };
+    bool panic(true);
+    for (t_u32 candidate = 0; candidate < count && panic; ++candidate) {
+        panic = !(untried(candidate) && this->_IsEligible(this->_backends[candidate], now));
+    }
+    const auto eligible = [&](const t_u32 _candidate) -> bool { return untried(_candidate) && (panic || this->_IsEligible(this->_backends[_candidate], now)); };
+    const auto next_eligible = [&](const t_u32 _from) -> t_u32 {
+        for (t_u32 step = 0; step < count; ++step) {
+            if (eligible((_from + step) % count))
+                return (_from + step) % count;
+        }
+        return _from % count;
+    };
+
+    t_u32 chosen(0);
+    switch (this->_balance) {
+    case Balance::POWER_OF_TWO: {
+        const t_u32 first(next_eligible(static_cast<t_u32>(this->_NextRandom() % count)));
+        t_u32 second(next_eligible(static_cast<t_u32>(this->_NextRandom() % count)));
+        if (second == first)
+            second = next_eligible(first + 1);
+        chosen = this->_CostOf(this->_backends[second]) < this->_CostOf(this->_backends[first]) ? second : first;
+        break;
+    }
+    case Balance::CONSISTENT_HASH: {
+        const t_u64 point(TcpInitializer::UpstreamGroup::_Mix(_affinity));
+        std::vector<std::pair<t_u64, t_u32>>::const_iterator slot(std::lower_bound(this->_ring.begin(), this->_ring.end(), std::make_pair(point, static_cast<t_u32>(0))));
+        chosen = slot != this->_ring.end() ? slot->second : this->_ring.front().second;
+        // walk clockwise past ejected backends, their keys spread over the remaining ones
+        for (std::size_t step = 0; step < this->_ring.size() && !eligible(chosen); ++step) {
+            if (slot == this->_ring.end() || ++slot == this->_ring.end())
+                slot = this->_ring.begin();
+            chosen = slot->second;
+        }
+        break;
+    }
+    case Balance::LEAST_OUTSTANDING:
+    default: {
+        // the rotating start spreads ties instead of always favouring the first backend
+        t_u64 best(UINT64_MAX);
+        for (t_u32 step = 0; step < count; ++step) {
+            const t_u32 candidate((this->_cursor + step) % count);
+            if (!eligible(candidate))
+                continue;
+            const t_u64 cost(this->_CostOf(this->_backends[candidate]));
+            if (cost < best) {
+                best = cost;
+                chosen = candidate;
+            }
+        }
+        this->_cursor = (this->_cursor + 1) % count;
+        break;
+    }
+    }
+    Backend &backend(this->_backends[chosen]);
+    ++backend.outstanding;
+    ++backend.picks;
+    _index = chosen;
+    _address = backend.address;
+    _address_size = backend.address_size;
+    return true;
+};
+
+/**
+ * @brief Checks whether a backend may receive new sessions, the group lock must be held.
+ *
+ * @param _backend The backend.
+ * @param _now The current time.
+ * @returns true if it passed its last probe and is not ejected, false otherwise.
+ */
+bool TcpInitializer::UpstreamGroup::_IsEligible(const Backend &_backend, const std::chrono::steady_clock::time_point _now) const noexcept {
+    return _backend.healthy && _now >= _backend.ejected_until;
+};
+
+/**
+ * @brief Computes the load of a backend, the group lock must be held.
+ *
+ * @param _backend The backend.
+ * @returns (outstanding + 1) weighted by the latency average, lower is better.
+ */
+t_u64 TcpInitializer::UpstreamGroup::_CostOf(const Backend &_backend) const noexcept {
+    return (static_cast<t_u64>(_backend.outstanding) + 1) * std::max<t_u64>(_backend.latency_us, 1);
+};
+
+/**
+ * @brief Draws the next value of the group's xorshift generator, the group lock must be held.
+ *
+ * @returns A pseudo-random value.
+ */
+t_u64 TcpInitializer::UpstreamGroup::_NextRandom(void) noexcept {
+    this->_rng ^= this->_rng >> 12;
+    this->_rng ^= this->_rng << 25;
+    this->_rng ^= this->_rng >> 27;
+    return this->_rng * 0x2545F4914F6CDD1DULL;
+};
+
+/**
+ * @brief Recomputes the hash ring, the group lock must be held.
+ *
+ * Ring points derive from the backend address and port, not its position, so adding a backend
+ * only moves the keys that land on its own points.
+ */
+void TcpInitializer::UpstreamGroup::_RebuildRing(void) {
+    this->_ring.clear();
+    this->_ring.reserve(this->_backends.size() * UPSTREAM_HASH_REPLICAS);
+    for (t_u32 index = 0; index < this->_backends.size(); ++index) {
+        const PeerAddress &address(this->_backends[index].address);
+        t_u64 key((static_cast<t_u64>(ntohl(address.v4.sin_addr.s_addr)) << 16) | ntohs(address.v4.sin_port));
+        if (address.addr.sa_family == AF_INET6) {
+            // fold every byte of the address in, IPv6 backends often differ only in their low bits
+            t_u64 halves[2];
+            memcpy(halves, &address.v6.sin6_addr, sizeof(halves));
+            key = TcpInitializer::UpstreamGroup::_Mix(TcpInitializer::UpstreamGroup::_Mix(halves[0]) ^ halves[1]) ^ ntohs(address.v6.sin6_port);
+        }
+        for (t_u32 replica = 0; replica < UPSTREAM_HASH_REPLICAS; ++replica) {
+            this->_ring.emplace_back(TcpInitializer::UpstreamGroup::_Mix(key * UPSTREAM_HASH_REPLICAS + replica), index);
+        }
+    }
+    std::sort(this->_ring.begin(), this->_ring.end());
+};
+
+/**
+ * @brief Scrambles a key (splitmix64 finalizer).
+ *
+ * @param _value The key.
+ * @returns The hash of the key.
+ */
+t_u64 TcpInitializer::UpstreamGroup::_Mix(t_u64 _value) noexcept {
+    _value += 0x9E3779B97F4A7C15ULL;
+    _value = (_value ^ (_value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    _value = (_value ^ (_value >> 27)) * 0x94D049BB133111EBULL;
+    return _value ^ (_value >> 31);
+};
+
+#endif
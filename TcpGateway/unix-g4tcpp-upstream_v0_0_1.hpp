@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_UPSTREAM_V0_0_1_HPP
+#define UNIX_G4TCPP_UPSTREAM_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+
+#include <condition_variable>
+#include <netinet/tcp.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_UPSTREAM_MAX_FAILS          3u
+#define DEFAULT_UPSTREAM_EJECT_MS           10000u
+#define DEFAULT_UPSTREAM_PROBE_INTERVAL_MS  2000u
+#define DEFAULT_UPSTREAM_PROBE_TIMEOUT_MS   500
+#define UPSTREAM_HASH_REPLICAS              160u
+#define UPSTREAM_LATENCY_EWMA_SHIFT         3u
+
+enum class Balance
+{
+    LEAST_OUTSTANDING,
+    POWER_OF_TWO,
+    CONSISTENT_HASH
+};
+
+/**
+ * Group of interchangeable upstream backends with load balancing and health tracking.
+ *
+ * Pick chooses a backend for a new session and counts it as outstanding until Release. The
+ * cost of a backend is its outstanding count weighted by its smoothed connect latency, so a slow
+ * backend receives less traffic before it fails outright. LEAST_OUTSTANDING scans every backend
+ * for the lowest cost, POWER_OF_TWO compares two random backends (constant time, no herding on
+ * one momentarily idle backend), and CONSISTENT_HASH maps the affinity key (e.g. the client
+ * address) onto a hash ring so a client keeps its backend while the group changes.
+ *
+ * Backends are ejected passively after DEFAULT_UPSTREAM_MAX_FAILS consecutive reported failures,
+ * for DEFAULT_UPSTREAM_EJECT_MS, and actively while health probes (a connect within a deadline,
+ * all backends in parallel) fail. When every backend is out, Pick falls back to all of them
+ * rather than refusing traffic. The group is thread-safe and can be shared by several loops.
+ */
+class UpstreamGroup
+{
+  public:
+    typedef struct alignas(void *)
+    {
+        t_str              name        {                                                    };
+        bool               healthy     {                                                    };
+        bool               ejected     {                                                    };
+        t_u32              outstanding {                                                    };
+        t_u64              latency_us  {                                                    };
+        t_u64              picks       {                                                    };
+        t_u64              failures    {                                                    };
+        t_u64              ejections   {                                                    };
+    } BackendStats;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        PeerAddress        address     {                                                    };
+        socklen_t          address_size {                                                   };
+        t_str              name        {                                                    };
+        bool               healthy     { true                                               };
+        t_u32              outstanding {                                                    };
+        t_u32              fails       {                                                    };
+        std::chrono::steady_clock::time_point ejected_until {                               };
+        t_u64              latency_us  {                                                    };
+        t_u64              picks       {                                                    };
+        t_u64              failures    {                                                    };
+        t_u64              ejections   {                                                    };
+    } Backend;
+
+    Balance                                               _balance;
+    t_u32                                                 _max_fails;
+    t_u32                                                 _eject_ms;
+    std::vector<Backend>                                  _backends;
+    std::vector<std::pair<t_u64, t_u32>>                  _ring;
+    t_u32                                                 _cursor;
+    t_u64                                                 _rng;
+    mutable std::mutex                                    _mtx;
+    std::thread                                           _prober;
+    bool                                                  _probing;
+    std::condition_variable                               _probe_cv;
+
+  public:
+    __attribute__((cold                                            ))  explicit                UpstreamGroup           (const Balance _balance = Balance::LEAST_OUTSTANDING, const t_u32 _max_fails = DEFAULT_UPSTREAM_MAX_FAILS, const t_u32 _eject_ms = DEFAULT_UPSTREAM_EJECT_MS) noexcept;
+    UpstreamGroup(const UpstreamGroup &)            = delete;
+    UpstreamGroup &operator=(const UpstreamGroup &) = delete;
+    __attribute__((cold                                            ))                          ~UpstreamGroup          ();
+
+    __attribute__((cold                                            ))  inline               bool    AddBackend              (const t_strw _address, const t_u16 _port);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    Pick                    (const t_u64 _affinity, t_u32 &_index, PeerAddress &_address, socklen_t &_address_size) noexcept;
+    __attribute__((hot                                             ))  inline               void    Release                 (const t_u32 _index) noexcept;
+    __attribute__((hot                                             ))  inline               void    ReportSuccess           (const t_u32 _index, const t_u64 _latency_us) noexcept;
+    __attribute__((hot                                             ))  inline               void    ReportFailure           (const t_u32 _index) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Dial                    (const t_u64 _affinity, t_u32 &_index, const int _timeout_ms = DEFAULT_UPSTREAM_PROBE_TIMEOUT_MS) noexcept;
+    __attribute__((cold                                            ))  inline               t_u32   Probe                   (const int _timeout_ms = DEFAULT_UPSTREAM_PROBE_TIMEOUT_MS) noexcept;
+    __attribute__((cold                                            ))  inline               void    StartProbing            (const t_u32 _interval_ms = DEFAULT_UPSTREAM_PROBE_INTERVAL_MS, const int _timeout_ms = DEFAULT_UPSTREAM_PROBE_TIMEOUT_MS);
+    __attribute__((cold                                            ))  inline               void    StopProbing             (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u32   GetBackendCount         (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               std::vector<BackendStats> GetStats (void) const;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _Pick                   (const t_u64 _affinity, t_u32 &_index, PeerAddress &_address, socklen_t &_address_size, const std::vector<bool> *_tried) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _IsEligible             (const Backend &_backend, const std::chrono::steady_clock::time_point _now) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   _CostOf                 (const Backend &_backend) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   _NextRandom             (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    _RebuildRing            (void);
+    __attribute__((hot, const, warn_unused_result                  ))  inline static        t_u64   _Mix                    (t_u64 _value) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
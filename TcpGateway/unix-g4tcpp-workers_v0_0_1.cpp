@@ -0,0 +1,228 @@
+#ifndef UNIX_G4TCPP_WORKERS_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-workers_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * @param _threads Number of workers, 0 for one per hardware thread.
+ * @throws std::system_error If a thread cannot be started.
+ */
+TcpInitializer::WorkerPool::WorkerPool(const t_u32 _threads)
+    : _workers(), _threads(), _running(true), _pending(0), _sleeping(0), _cursor(0), _sleep_mtx(), _sleep_cv() {
+    t_u32 count(_threads > 0 ? _threads : std::thread::hardware_concurrency());
+    if (count == 0)
+        count = 1;
+    this->_workers.reserve(count);
+    for (t_u32 i = 0; i < count; ++i) {
+        this->_workers.emplace_back(std::make_unique<Worker>());
+    }
+    this->_threads.reserve(count);
+    try {
+        for (t_u32 i = 0; i < count; ++i) {
+            this->_threads.emplace_back(&TcpInitializer::WorkerPool::_Run, this, i);
+        }
+    } catch (...) {
+        this->Stop();
+        throw;
+    }
+};
+
+/**
+ * @brief Runs the queued jobs and joins the workers.
+ */
+TcpInitializer::WorkerPool::~WorkerPool() {
+    this->Stop();
+};
+
+/**
+ * @brief Queues a job, safe to call from any thread.
+ *
+ * @param _job The job to run on a worker.
+ * @returns true if the job was queued, false if it is empty or the pool is stopped.
+ */
+bool TcpInitializer::WorkerPool::Submit(job_cb _job) {
+    if (!_job)
+        return false;
+    const Current &current(TcpInitializer::WorkerPool::_Current());
+    // counted before the running check and before it is visible: a worker taking it at once must
+    // not see the count underflow, and once Stop ran the workers only exit when the count is back
+    // to 0, so a job that got past the check is run even if Stop wins the race to the push
+    this->_pending.fetch_add(1, std::memory_order_seq_cst);
+    // workers keep submitting while Stop drains, their follow-up jobs land on their own deque
+    if (current.pool != this && !this->_running.load(std::memory_order_seq_cst)) {
+        this->_pending.fetch_sub(1, std::memory_order_seq_cst);
+        return false;
+    }
+    const t_u32 index(current.pool == this ? current.index : this->_cursor.fetch_add(1, std::memory_order_relaxed) % static_cast<t_u32>(this->_workers.size()));
+    {
+        Worker &worker(*this->_workers[index]);
+        std::lock_guard<std::mutex> lock(worker.mtx);
+        worker.jobs.emplace_back(std::move(_job));
+    }
+    // pairs with the sleeping increment in _Run: either we see the sleeper or it sees the job
+    if (this->_sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(this->_sleep_mtx);
+        this->_sleep_cv.notify_one();
+    }
+    return true;
+};
+
+/**
+ * @brief Refuses new jobs from other threads, runs the queued ones (and what they submit) and joins the workers.
+ *
+ * Must not be called from a worker of this pool.
+ */
+void TcpInitializer::WorkerPool::Stop(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->_sleep_mtx);
+        this->_running.store(false, std::memory_order_seq_cst);
+    }
+    this->_sleep_cv.notify_all();
+    for (std::thread &thread : this->_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+    this->_threads.clear();
+};
+
+/**
+ * @brief Checks whether the calling thread is a worker of this pool.
+ *
+ * @returns true if called from one of the workers, false otherwise.
+ */
+bool TcpInitializer::WorkerPool::IsWorkerThread(void) const noexcept {
+    return TcpInitializer::WorkerPool::_Current().pool == this;
+};
+
+/**
+ * @brief Gets the number of workers.
+ *
+ * @returns The worker count.
+ */
+TcpInitializer::t_u32 TcpInitializer::WorkerPool::GetThreadCount(void) const noexcept {
+    return static_cast<t_u32>(this->_workers.size());
+};
+
+/**
+ * @brief Gets the number of queued jobs not yet taken by a worker.
+ *
+ * @returns The queued job count.
+ */
+TcpInitializer::t_u64 TcpInitializer::WorkerPool::GetPendingCount(void) const noexcept {
+    return this->_pending.load(std::memory_order_relaxed);
+};
+
+/**
+ * @brief Gets the counters of every worker.
+ *
+ * @returns One entry per worker, stolen counts the jobs it took from other workers.
+ */
+std::vector<TcpInitializer::WorkerPool::WorkerStats> TcpInitializer::WorkerPool::GetStats(void) const {
+    std::vector<WorkerStats> stats;
+    stats.reserve(this->_workers.size());
+    for (const std::unique_ptr<Worker> &worker : this->_workers) {
+        WorkerStats entry;
+        entry.executed = worker->executed.load(std::memory_order_relaxed);
+        entry.stolen = worker->stolen.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(worker->mtx);
+            entry.queued = static_cast<t_u32>(worker->jobs.size());
+        }
+        stats.push_back(entry);
+    }
+    return stats;
+};
+
+/**
+ * @brief Worker thread body: runs jobs until the pool is stopped and drained.
+ *
+ * @param _index The worker index.
+ */
+void TcpInitializer::WorkerPool::_Run(const t_u32 _index) {
+    Current &current(TcpInitializer::WorkerPool::_Current());
+    current.pool = this;
+    current.index = _index;
+    Worker &worker(*this->_workers[_index]);
+    job_cb job;
+    for (;;) {
+        if (this->_Take(_index, job)) {
+            try {
+                job();
+            } catch (const std::exception &e) {
+                TcpInitializer::Socket::Log("worker job failure: ", e.what(), '\n');
+            } catch (...) {
+                TcpInitializer::Socket::Log("worker job failure: unknown exception\n");
+            }
+            job = nullptr;
+            worker.executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->_sleep_mtx);
+        this->_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        this->_sleep_cv.wait(lock, [this]() {
+            return this->_pending.load(std::memory_order_seq_cst) > 0 || !this->_running.load(std::memory_order_seq_cst);
+        });
+        this->_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        if (!this->_running.load(std::memory_order_seq_cst) && this->_pending.load(std::memory_order_seq_cst) == 0)
+            break;
+    }
+    current.pool = nullptr;
+};
+
+/**
+ * @brief Takes the newest job of a worker, or steals the oldest job of another one.
+ *
+ * @param _index The worker index.
+ * @param _job Receives the job.
+ * @returns true if a job was taken, false if every deque looked empty.
+ */
+bool TcpInitializer::WorkerPool::_Take(const t_u32 _index, job_cb &_job) {
+    const t_u32 count(static_cast<t_u32>(this->_workers.size()));
+    Worker &own(*this->_workers[_index]);
+    {
+        std::lock_guard<std::mutex> lock(own.mtx);
+        if (!own.jobs.empty()) {
+            _job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            this->_pending.fetch_sub(1, std::memory_order_seq_cst);
+            return true;
+        }
+    }
+    // a victim whose lock is busy is retried once, its owner is most likely just popping
+    for (t_u32 attempt = 0; attempt < DEFAULT_WORKER_STEAL_ATTEMPTS; ++attempt) {
+        for (t_u32 offset = 1; offset < count; ++offset) {
+            Worker &victim(*this->_workers[(_index + offset) % count]);
+            std::unique_lock<std::mutex> lock(victim.mtx, std::defer_lock);
+            if (attempt + 1 < DEFAULT_WORKER_STEAL_ATTEMPTS) {
+                if (!lock.try_lock())
+                    continue;
+            } else {
+                lock.lock();
+            }
+            if (victim.jobs.empty())
+                continue;
+            _job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            this->_pending.fetch_sub(1, std::memory_order_seq_cst);
+            own.stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+};
+
+/**
+ * @brief Gets the pool and worker index of the calling thread.
+ *
+ * @returns The thread's entry, pool is nullptr outside of workers.
+ */
+TcpInitializer::WorkerPool::Current &TcpInitializer::WorkerPool::_Current(void) noexcept {
+    static thread_local Current current;
+    return current;
+};
+
+#endif
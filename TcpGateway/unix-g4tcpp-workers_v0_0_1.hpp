@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_WORKERS_V0_0_1_HPP
+#define UNIX_G4TCPP_WORKERS_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+#include <condition_variable>
+#include <type_traits>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_WORKER_STEAL_ATTEMPTS  2u
+
+/**
+ * Fixed pool of worker threads for handler work that must stay off the I/O threads.
+ *
+ * Every worker owns a deque of jobs. A job submitted from a worker (e.g. a handler splitting its
+ * work) is pushed onto that worker's own deque and popped back LIFO while it is still warm in
+ * cache; jobs submitted from other threads are spread round-robin. An idle worker steals the
+ * oldest job of another worker before going to sleep, so one long job does not hold back the
+ * jobs queued behind it. The deques are guarded by one uncontended mutex each; the reply path
+ * back to the loop is lock-free (EventLoop::Post).
+ *
+ * SubmitTo is the usual entry point from an I/O thread: the loop hands off a decoded message,
+ * a worker runs the handler, and the result is posted back to the loop that owns the connection,
+ * where it is queued for sending. Jobs and results must be copyable (std::function).
+ */
+class WorkerPool
+{
+  public:
+    using job_cb = std::function<void(void)>;
+
+    typedef struct alignas(void *)
+    {
+        t_u64              executed    {                                                    };
+        t_u64              stolen      {                                                    };
+        t_u32              queued      {                                                    };
+    } WorkerStats;
+
+  protected:
+    typedef struct alignas(64)
+    {
+        std::mutex         mtx         {                                                    };
+        std::deque<job_cb> jobs        {                                                    };
+        std::atomic<t_u64> executed    { 0                                                  };
+        std::atomic<t_u64> stolen      { 0                                                  };
+    } Worker;
+
+    typedef struct alignas(void *)
+    {
+        const WorkerPool  *pool        {                                                    };
+        t_u32              index       {                                                    };
+    } Current;
+
+    std::vector<std::unique_ptr<Worker>>                  _workers;
+    std::vector<std::thread>                              _threads;
+    std::atomic<bool>                                     _running;
+    alignas(64) std::atomic<t_u64>                        _pending;
+    alignas(64) std::atomic<t_u32>                        _sleeping;
+    std::atomic<t_u32>                                    _cursor;
+    std::mutex                                            _sleep_mtx;
+    std::condition_variable                               _sleep_cv;
+
+  public:
+    __attribute__((cold                                            ))  explicit                WorkerPool              (const t_u32 _threads = 0);
+    WorkerPool(const WorkerPool &)            = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    __attribute__((cold                                            ))                          ~WorkerPool             ();
+
+    __attribute__((hot                                             ))  inline               bool    Submit                  (job_cb _job);
+    template <typename Work, typename Done>
+    __attribute__((hot                                             ))  inline               bool    SubmitTo                (EventLoop &_loop, Work _work, Done _done);
+    __attribute__((cold                                            ))  inline               void    Stop                    (void);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsWorkerThread          (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u32   GetThreadCount          (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   GetPendingCount         (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               std::vector<WorkerStats> GetStats (void) const;
+
+  protected:
+    __attribute__((hot                                             ))  inline               void    _Run                    (const t_u32 _index);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _Take                   (const t_u32 _index, job_cb &_job);
+    __attribute__((hot                                             ))  inline static        Current &_Current               (void) noexcept;
+};
+
+/**
+ * @brief Runs a handler on a worker and its completion on the loop thread.
+ *
+ * @param _loop The loop owning the connection, _done runs on its thread.
+ * @param _work The handler, called on a worker; its result is passed to _done.
+ * @param _done Called on the loop thread with the result of _work (no argument if it is void).
+ * @returns true if the job was queued, false if the pool is stopped.
+ */
+template <typename Work, typename Done>
+bool TcpInitializer::WorkerPool::SubmitTo(EventLoop &_loop, Work _work, Done _done) {
+    EventLoop *loop(&_loop);
+    return this->Submit([loop, work = std::move(_work), done = std::move(_done)]() mutable {
+        if constexpr (std::is_void_v<std::invoke_result_t<Work &>>) {
+            work();
+            loop->Post([done](EventLoop &) mutable { done(); });
+        } else {
+            loop->Post([done, result = work()](EventLoop &) mutable { done(result); });
+        }
+    });
+};
+
+}; // namespace TcpInitializer
+
+#endif
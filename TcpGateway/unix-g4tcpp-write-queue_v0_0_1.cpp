@@ -0,0 +1,379 @@
+#ifndef UNIX_G4TCPP_WRITE_QUEUE_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.cpp"
+#include "unix-g4tcpp-write-queue_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates an empty queue for a socket watched by the loop.
+ *
+ * @param _loop The loop the socket is registered with, flushes run on its thread.
+ * @param _sock The connected socket.
+ */
+TcpInitializer::OutboundQueue::OutboundQueue(EventLoop &_loop, const t_sock _sock)
+    : _loop(&_loop), _sock(_sock), _segments(), _offset(0), _queued(0), _syscalls(0), _tail_open(false), _scheduled(false), _corked(false), _want_write(false), _failed(false),
+      _high_watermark(DEFAULT_WRITE_HIGH_WATERMARK), _low_watermark(DEFAULT_WRITE_LOW_WATERMARK), _sources(), _on_watermark(), _paused(false), _paused_since(), _paused_us(0), _pause_count(0), _peak_queued(0),
+      _token(std::make_shared<OutboundQueue *>(this)) {};
+
+/**
+ * @brief Returns the bytes still queued to the process wide gauge.
+ */
+TcpInitializer::OutboundQueue::~OutboundQueue() {
+    Metrics::queued_bytes.Sub(this->_queued);
+};
+
+/**
+ * @brief Queues a copy of a buffer, small buffers are coalesced into the open tail segment.
+ *
+ * @param _buffer The bytes to send.
+ * @returns true if the bytes were queued, false if the queue already failed.
+ */
+bool TcpInitializer::OutboundQueue::Push(const t_strw _buffer) {
+    if (this->_failed)
+        return false;
+    if (_buffer.empty())
+        return true;
+    if (_buffer.size() >= DEFAULT_COALESCE_THRESHOLD) {
+        this->_segments.push_back(Segment{t_str(_buffer), nullptr});
+        this->_tail_open = false;
+    } else {
+        if (!this->_tail_open || this->_segments.back().bytes.size() + _buffer.size() > DEFAULT_COALESCE_SEGMENT_SIZE) {
+            this->_segments.emplace_back();
+            this->_segments.back().bytes.reserve(DEFAULT_COALESCE_SEGMENT_SIZE);
+            this->_tail_open = true;
+        }
+        this->_segments.back().bytes.append(_buffer.data(), _buffer.size());
+    }
+    this->_queued += _buffer.size();
+    Metrics::queued_bytes.Add(_buffer.size());
+    this->_Pressure();
+    this->_Schedule();
+    return true;
+};
+
+/**
+ * @brief Queues a buffer, large buffers are moved in without copying.
+ *
+ * @param _buffer The bytes to send.
+ * @returns true if the bytes were queued, false if the queue already failed.
+ */
+bool TcpInitializer::OutboundQueue::Push(t_str &&_buffer) {
+    if (_buffer.size() < DEFAULT_COALESCE_THRESHOLD)
+        return this->Push(t_strw(_buffer));
+    if (this->_failed)
+        return false;
+    this->_queued += _buffer.size();
+    Metrics::queued_bytes.Add(_buffer.size());
+    this->_segments.push_back(Segment{std::move(_buffer), nullptr});
+    this->_tail_open = false;
+    this->_Pressure();
+    this->_Schedule();
+    return true;
+};
+
+/**
+ * @brief Queues a shared immutable payload by reference, it is written from its own buffer.
+ *
+ * The queue keeps the payload alive until it was written, so the same message can be pushed to
+ * any number of queues at the cost of one reference each.
+ *
+ * @param _payload The bytes to send, must not be modified while queued.
+ * @returns true if the bytes were queued, false if the queue already failed.
+ */
+bool TcpInitializer::OutboundQueue::Push(shared_payload _payload) {
+    if (this->_failed)
+        return false;
+    if (!_payload || _payload->empty())
+        return true;
+    const t_u64 size(_payload->size());
+    this->_queued += size;
+    Metrics::queued_bytes.Add(size);
+    this->_segments.push_back(Segment{t_str(), std::move(_payload)});
+    this->_tail_open = false;
+    this->_Pressure();
+    this->_Schedule();
+    return true;
+};
+
+/**
+ * @brief Writes as much of the queue as the socket accepts without blocking.
+ *
+ * Called from the deferred tick flush and from the connection on_writable handler. Write interest
+ * is enabled while bytes remain and disabled again once the queue is empty.
+ *
+ * @returns true if the socket is healthy, false on a write error.
+ */
+bool TcpInitializer::OutboundQueue::Flush(void) noexcept {
+    if (this->_failed)
+        return false;
+    struct iovec tcp_iov[DEFAULT_SEND_IOV_MAX];
+    while (!this->_segments.empty()) {
+        std::size_t count(0);
+        for (std::deque<Segment>::iterator segment = this->_segments.begin(); segment != this->_segments.end() && count < DEFAULT_SEND_IOV_MAX; ++segment, ++count) {
+            const t_str &bytes(TcpInitializer::OutboundQueue::_BytesOf(*segment));
+            const t_u64 skip(count == 0 ? this->_offset : 0);
+            tcp_iov[count].iov_base = const_cast<char *>(bytes.data()) + skip;
+            tcp_iov[count].iov_len = bytes.size() - skip;
+        }
+        struct msghdr tcp_msg;
+        memset(&tcp_msg, 0, sizeof(tcp_msg));
+        tcp_msg.msg_iov = tcp_iov;
+        tcp_msg.msg_iovlen = count;
+        // more segments than fit in one call: let the kernel hold the tail until the next one
+        const int flags(MSG_NOSIGNAL | MSG_DONTWAIT | (count < this->_segments.size() ? MSG_MORE : 0));
+        const t_u64 started(Metrics::Now());
+        const ssize_t tcp_sent(sendmsg(this->_sock, &tcp_msg, flags));
+        Metrics::send_latency.Record(Metrics::Now() - started);
+        ++this->_syscalls;
+        if (tcp_sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!this->_want_write)
+                    this->_want_write = this->_loop->WantWrite(this->_sock, true);
+                this->_Pressure();
+                return true;
+            }
+            this->_failed = true;
+            return false;
+        }
+        Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+        ConnectionTable::AccountOwner(this->_sock, 0, static_cast<t_u64>(tcp_sent));
+        this->_Advance(static_cast<t_u64>(tcp_sent));
+    }
+    this->_Pressure();
+    if (this->_want_write) {
+        this->_loop->WantWrite(this->_sock, false);
+        this->_want_write = false;
+    }
+    return true;
+};
+
+/**
+ * @brief Holds deferred flushes back until Uncork is called.
+ */
+void TcpInitializer::OutboundQueue::Cork(void) noexcept {
+    this->_corked = true;
+};
+
+/**
+ * @brief Releases the cork and writes everything queued meanwhile.
+ *
+ * @returns true if the socket is healthy, false on a write error.
+ */
+bool TcpInitializer::OutboundQueue::Uncork(void) noexcept {
+    this->_corked = false;
+    return this->Flush();
+};
+
+/**
+ * @brief Sets the queue sizes at which the sources are paused and resumed.
+ *
+ * @param _high Queued bytes at which reading from the sources pauses, 0 disables backpressure.
+ * @param _low Queued bytes at or below which reading resumes, clamped to the high watermark.
+ */
+void TcpInitializer::OutboundQueue::SetWatermarks(const t_u64 _high, const t_u64 _low) noexcept {
+    this->_high_watermark = _high;
+    this->_low_watermark = std::min(_low, _high);
+    this->_Pressure();
+};
+
+/**
+ * @brief Sets a callback run on every pause (true) and resume (false), e.g. to throttle sources outside the loop.
+ *
+ * @param _on_watermark The callback, must not throw.
+ */
+void TcpInitializer::OutboundQueue::SetWatermarkCallback(watermark_cb _on_watermark) {
+    this->_on_watermark = std::move(_on_watermark);
+};
+
+/**
+ * @brief Adds a connection of the same loop whose reading follows the queue pressure.
+ *
+ * @param _source The source socket, paused right away if the queue is above the high watermark.
+ */
+void TcpInitializer::OutboundQueue::AddSource(const t_sock _source) {
+    if (std::find(this->_sources.begin(), this->_sources.end(), _source) != this->_sources.end())
+        return;
+    this->_sources.push_back(_source);
+    if (this->_paused)
+        this->_loop->WantRead(_source, false);
+};
+
+/**
+ * @brief Removes a source, e.g. before it is closed, resuming its reading if it was paused.
+ *
+ * @param _source The source socket.
+ */
+void TcpInitializer::OutboundQueue::RemoveSource(const t_sock _source) noexcept {
+    std::vector<t_sock>::iterator source(std::find(this->_sources.begin(), this->_sources.end(), _source));
+    if (source == this->_sources.end())
+        return;
+    this->_sources.erase(source);
+    if (this->_paused)
+        this->_loop->WantRead(_source, true);
+};
+
+/**
+ * @brief Gets the number of bytes waiting to be written.
+ *
+ * @returns The queued byte count.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetQueued(void) const noexcept {
+    return this->_queued;
+};
+
+/**
+ * @brief Gets the number of queued segments.
+ *
+ * @returns The segment count.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetSegmentCount(void) const noexcept {
+    return this->_segments.size();
+};
+
+/**
+ * @brief Gets the number of sendmsg calls issued so far.
+ *
+ * @returns The syscall count.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetSyscallCount(void) const noexcept {
+    return this->_syscalls;
+};
+
+/**
+ * @brief Gets the socket the queue writes to.
+ *
+ * @returns The socket.
+ */
+t_sock TcpInitializer::OutboundQueue::GetSocket(void) const noexcept {
+    return this->_sock;
+};
+
+/**
+ * @brief Checks whether a write error was hit, the queue then rejects new data.
+ *
+ * @returns true if the queue failed, false otherwise.
+ */
+bool TcpInitializer::OutboundQueue::IsFailed(void) const noexcept {
+    return this->_failed;
+};
+
+/**
+ * @brief Checks whether the sources are paused because the queue is above the high watermark.
+ *
+ * @returns true if paused, false otherwise.
+ */
+bool TcpInitializer::OutboundQueue::IsPaused(void) const noexcept {
+    return this->_paused;
+};
+
+/**
+ * @brief Gets the total time the sources spent paused, including a pause still in progress.
+ *
+ * @returns The paused time in microseconds.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetPausedTime(void) const noexcept {
+    if (!this->_paused)
+        return this->_paused_us;
+    return this->_paused_us + static_cast<t_u64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->_paused_since).count());
+};
+
+/**
+ * @brief Gets the number of times the high watermark paused the sources.
+ *
+ * @returns The pause count.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetPauseCount(void) const noexcept {
+    return this->_pause_count;
+};
+
+/**
+ * @brief Gets the largest number of bytes queued at once.
+ *
+ * @returns The peak queued byte count.
+ */
+t_u64 TcpInitializer::OutboundQueue::GetPeakQueued(void) const noexcept {
+    return this->_peak_queued;
+};
+
+/**
+ * @brief Defers one flush to the end of the current loop tick, unless one is pending or the queue is corked.
+ *
+ * The deferred task holds a weak token, so a queue destroyed before the tick ends is skipped. A
+ * flush that fails closes the connection through the loop.
+ */
+void TcpInitializer::OutboundQueue::_Schedule(void) {
+    if (this->_scheduled || this->_corked)
+        return;
+    this->_scheduled = true;
+    std::weak_ptr<OutboundQueue *> token(this->_token);
+    this->_loop->Defer([token](EventLoop &loop) -> void {
+        std::shared_ptr<OutboundQueue *> alive(token.lock());
+        if (!alive)
+            return;
+        OutboundQueue *queue(*alive);
+        queue->_scheduled = false;
+        if (queue->_corked || queue->Flush())
+            return;
+        loop.CloseConnection(queue->_sock);
+    });
+};
+
+/**
+ * @brief Drops written bytes from the front of the queue.
+ *
+ * @param _bytes The number of bytes the kernel accepted.
+ */
+void TcpInitializer::OutboundQueue::_Advance(t_u64 _bytes) noexcept {
+    this->_queued -= _bytes;
+    Metrics::queued_bytes.Sub(_bytes);
+    while (_bytes > 0) {
+        const t_u64 left(TcpInitializer::OutboundQueue::_BytesOf(this->_segments.front()).size() - this->_offset);
+        if (_bytes < left) {
+            this->_offset += _bytes;
+            return;
+        }
+        _bytes -= left;
+        this->_offset = 0;
+        this->_segments.pop_front();
+    }
+    if (this->_segments.empty())
+        this->_tail_open = false;
+};
+
+/**
+ * @brief Pauses the sources when the queue reached the high watermark and resumes them once it drained to the low one.
+ */
+void TcpInitializer::OutboundQueue::_Pressure(void) noexcept {
+    this->_peak_queued = std::max(this->_peak_queued, this->_queued);
+    if (!this->_paused && this->_high_watermark > 0 && this->_queued >= this->_high_watermark) {
+        this->_paused = true;
+        this->_paused_since = std::chrono::steady_clock::now();
+        ++this->_pause_count;
+    } else if (this->_paused && (this->_high_watermark == 0 || this->_queued <= this->_low_watermark)) {
+        this->_paused = false;
+        this->_paused_us += static_cast<t_u64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->_paused_since).count());
+    } else {
+        return;
+    }
+    // re-arming read interest on resume reports data that arrived while it was paused
+    for (const t_sock source : this->_sources) {
+        this->_loop->WantRead(source, !this->_paused);
+    }
+    if (this->_on_watermark)
+        this->_on_watermark(*this, this->_paused);
+};
+
+/**
+ * @brief Gets the bytes of a segment, owned or shared.
+ *
+ * @param _segment The queued segment.
+ * @returns The segment bytes.
+ */
+const t_str &TcpInitializer::OutboundQueue::_BytesOf(const Segment &_segment) noexcept {
+    return _segment.shared ? *_segment.shared : _segment.bytes;
+};
+
+#endif
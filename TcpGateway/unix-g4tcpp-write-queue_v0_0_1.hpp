@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_WRITE_QUEUE_V0_0_1_HPP
+#define UNIX_G4TCPP_WRITE_QUEUE_V0_0_1_HPP
+
+#include "unix-g4tcpp-reactor_v0_0_1.hpp"
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_COALESCE_THRESHOLD     1024u
+#define DEFAULT_COALESCE_SEGMENT_SIZE  16384u
+#define DEFAULT_WRITE_HIGH_WATERMARK   4194304u
+#define DEFAULT_WRITE_LOW_WATERMARK    1048576u
+
+/**
+ * Per-connection outbound byte queue driven by an EventLoop.
+ *
+ * Push never writes: small messages are copied back to back into shared segments, large ones are
+ * kept as their own segment, and a flush is deferred to the end of the loop tick. The flush then
+ * writes every queued segment with gathered sendmsg calls, setting MSG_MORE while more data
+ * follows, so a burst of small replies produced by one tick leaves in one syscall. Whatever the
+ * socket does not accept stays queued and is written when the loop reports it writable, which the
+ * connection on_writable handler forwards to Flush. Cork holds the deferred flushes back until
+ * Uncork, e.g. while a multi-part response is assembled. A shared payload is queued by reference
+ * and written straight from its buffer, so one message sent to many queues is never copied.
+ *
+ * Backpressure: once the queued bytes reach the high watermark, reading is paused on every source
+ * connection added with AddSource (the connections whose input ends up in this queue) and the
+ * watermark callback runs; once a flush brings the queue down to the low watermark, reading
+ * resumes. A slow consumer therefore throttles its producers instead of growing the queue, and
+ * the gap between the two marks keeps the sources from flapping on every write.
+ */
+class OutboundQueue
+{
+  public:
+    using watermark_cb   = std::function<void(OutboundQueue &, const bool)>;
+    using shared_payload = std::shared_ptr<const t_str>;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_str              bytes       {                                                    };
+        shared_payload     shared      {                                                    };
+    } Segment;
+
+    EventLoop                                            *_loop;
+    t_sock                                                _sock;
+    std::deque<Segment>                                   _segments;
+    t_u64                                                 _offset;
+    t_u64                                                 _queued;
+    t_u64                                                 _syscalls;
+    bool                                                  _tail_open;
+    bool                                                  _scheduled;
+    bool                                                  _corked;
+    bool                                                  _want_write;
+    bool                                                  _failed;
+    t_u64                                                 _high_watermark;
+    t_u64                                                 _low_watermark;
+    std::vector<t_sock>                                   _sources;
+    watermark_cb                                          _on_watermark;
+    bool                                                  _paused;
+    std::chrono::steady_clock::time_point                 _paused_since;
+    t_u64                                                 _paused_us;
+    t_u64                                                 _pause_count;
+    t_u64                                                 _peak_queued;
+    std::shared_ptr<OutboundQueue *>                      _token;
+
+  public:
+    __attribute__((cold                                            ))                          OutboundQueue           (EventLoop &_loop, const t_sock _sock);
+    OutboundQueue(const OutboundQueue &)            = delete;
+    OutboundQueue &operator=(const OutboundQueue &) = delete;
+    __attribute__((cold                                            ))                          ~OutboundQueue          ();
+
+    __attribute__((hot                                             ))  inline               bool    Push                    (const t_strw _buffer);
+    __attribute__((hot                                             ))  inline               bool    Push                    (t_str &&_buffer);
+    __attribute__((hot                                             ))  inline               bool    Push                    (shared_payload _payload);
+    __attribute__((hot                                             ))  inline               bool    Flush                   (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Cork                    (void) noexcept;
+    __attribute__((cold                                            ))  inline               bool    Uncork                  (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetWatermarks           (const t_u64 _high, const t_u64 _low) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetWatermarkCallback    (watermark_cb _on_watermark);
+    __attribute__((cold                                            ))  inline               void    AddSource               (const t_sock _source);
+    __attribute__((cold                                            ))  inline               void    RemoveSource            (const t_sock _source) noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetQueued               (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetSegmentCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetSyscallCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_sock  GetSocket               (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               bool    IsFailed                (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               bool    IsPaused                (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetPausedTime           (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetPauseCount           (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetPeakQueued           (void) const noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               void    _Schedule               (void);
+    __attribute__((hot                                             ))  inline               void    _Advance                (t_u64 _bytes) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Pressure               (void) noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline static        const t_str &_BytesOf       (const Segment &_segment) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
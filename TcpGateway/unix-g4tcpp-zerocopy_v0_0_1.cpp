@@ -0,0 +1,234 @@
+#ifndef UNIX_G4TCPP_ZEROCOPY_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.cpp"
+#include "unix-g4tcpp-zerocopy_v0_0_1.hpp"
+
+using namespace TcpInitializer::_t; // types
+
+/**
+ * @brief Creates a sender for a connected socket and enables SO_ZEROCOPY on it.
+ *
+ * @param _sock The connected socket, blocking or not.
+ * @param _threshold Smallest buffer sent with MSG_ZEROCOPY, pinning smaller ones costs more than the copy.
+ */
+TcpInitializer::ZeroCopySender::ZeroCopySender(const t_sock _sock, const t_u64 _threshold) noexcept
+    : _sock(_sock), _threshold(_threshold), _enabled(false), _failed(false), _next_id(0), _acked(0), _pending(), _zerocopy_bytes(0), _copied_bytes(0) {
+    const int enable(1);
+    this->_enabled = setsockopt(this->_sock, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+};
+
+/**
+ * @brief Sends a buffer the sender takes ownership of until the kernel released it.
+ *
+ * @param _buffer The bytes to send, moved in.
+ * @param _on_done Optional callback run once the buffer was released, with true if the kernel copied it.
+ * @returns true if the buffer was written or queued, false on a socket error.
+ */
+bool TcpInitializer::ZeroCopySender::Send(t_str &&_buffer, done_cb _on_done) {
+    Pending pending;
+    pending.owned = std::move(_buffer);
+    pending.view = t_strw(pending.owned);
+    pending.on_done = std::move(_on_done);
+    return this->_Enqueue(std::move(pending));
+};
+
+/**
+ * @brief Sends a buffer owned by the caller, which must stay valid and unmodified until _on_done runs.
+ *
+ * @param _buffer The bytes to send.
+ * @param _on_done Callback run once the buffer was released, with true if the kernel copied it.
+ * @returns true if the buffer was written or queued, false on a socket error.
+ */
+bool TcpInitializer::ZeroCopySender::Send(const t_strw _buffer, done_cb _on_done) {
+    Pending pending;
+    pending.view = _buffer;
+    pending.on_done = std::move(_on_done);
+    return this->_Enqueue(std::move(pending));
+};
+
+/**
+ * @brief Writes the queued buffers in order until the socket is full.
+ *
+ * @returns true if the socket is healthy, false on a write error.
+ */
+bool TcpInitializer::ZeroCopySender::Flush(void) noexcept {
+    if (this->_failed)
+        return false;
+    for (Pending &pending : this->_pending) {
+        while (pending.offset < pending.view.size()) {
+            const int flags(MSG_NOSIGNAL | (pending.zerocopy ? MSG_ZEROCOPY : 0));
+            const t_u64 started(Metrics::Now());
+            const ssize_t tcp_sent(send(this->_sock, pending.view.data() + pending.offset, pending.view.size() - pending.offset, flags));
+            Metrics::send_latency.Record(Metrics::Now() - started);
+            if (tcp_sent > 0) {
+                Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+                ConnectionTable::AccountOwner(this->_sock, 0, static_cast<t_u64>(tcp_sent));
+                pending.offset += static_cast<t_u64>(tcp_sent);
+                if (pending.zerocopy) {
+                    // every successful MSG_ZEROCOPY call consumes one notification id
+                    pending.last_id = this->_next_id++;
+                    pending.pinned = true;
+                    this->_zerocopy_bytes += static_cast<t_u64>(tcp_sent);
+                } else {
+                    this->_copied_bytes += static_cast<t_u64>(tcp_sent);
+                }
+                continue;
+            }
+            if (tcp_sent < 0 && errno == EINTR)
+                continue;
+            if (tcp_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                this->_Retire();
+                return true;
+            }
+            if (tcp_sent < 0 && errno == ENOBUFS && pending.zerocopy) {
+                // out of optmem for pinned pages, send the rest of this buffer the ordinary way
+                pending.zerocopy = false;
+                continue;
+            }
+            this->_failed = true;
+            return false;
+        }
+    }
+    this->_Retire();
+    return true;
+};
+
+/**
+ * @brief Drains completion notifications from the socket error queue without blocking.
+ *
+ * Notifications are assumed to arrive in send order, which is what TCP sockets produce.
+ *
+ * @returns The number of zero-copy sends the kernel released.
+ */
+t_u64 TcpInitializer::ZeroCopySender::Reap(void) noexcept {
+    t_u64 released(0);
+    for (;;) {
+        char control[128];
+        struct msghdr tcp_msg;
+        memset(&tcp_msg, 0, sizeof(tcp_msg));
+        tcp_msg.msg_control = control;
+        tcp_msg.msg_controllen = sizeof(control);
+        if (recvmsg(this->_sock, &tcp_msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&tcp_msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&tcp_msg, cmsg)) {
+            if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+                continue;
+            struct sock_extended_err notification;
+            memcpy(&notification, CMSG_DATA(cmsg), sizeof(notification));
+            if (notification.ee_origin != SO_EE_ORIGIN_ZEROCOPY || notification.ee_errno != 0)
+                continue;
+            // ids are 32 bit on the wire, extend the acknowledged range onto the 64 bit counter
+            const t_u32 delta((notification.ee_data + 1) - static_cast<t_u32>(this->_acked));
+            if (delta == 0 || delta > 0x80000000u)
+                continue;
+            const t_u64 first(this->_acked + delta - (static_cast<t_u64>(notification.ee_data - notification.ee_info) + 1));
+            this->_acked += delta;
+            released += delta;
+            const bool copied((notification.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+            if (copied)
+                this->_enabled = false;
+            for (Pending &pending : this->_pending) {
+                if (pending.pinned && pending.last_id >= first && pending.last_id < this->_acked)
+                    pending.copied = pending.copied || copied;
+            }
+        }
+    }
+    this->_Retire();
+    return released;
+};
+
+/**
+ * @brief Writes everything queued and waits until the kernel released every buffer.
+ *
+ * @param _timeout_ms Maximum wait between two progress steps, -1 waits forever.
+ * @returns true once nothing is pending, false on a socket error or timeout.
+ */
+bool TcpInitializer::ZeroCopySender::Wait(const int _timeout_ms) noexcept {
+    while (!this->_pending.empty()) {
+        if (!this->Flush())
+            return false;
+        this->Reap();
+        if (this->_pending.empty())
+            break;
+        const bool unsent(this->_pending.back().offset < this->_pending.back().view.size());
+        // POLLERR is always reported and signals a waiting completion
+        struct pollfd tcp_poll = {this->_sock, static_cast<short>(unsent ? POLLOUT : 0), 0};
+        const int ready(poll(&tcp_poll, 1, _timeout_ms));
+        if (ready == 0 || (ready < 0 && errno != EINTR))
+            return false;
+    }
+    return true;
+};
+
+/**
+ * @brief Checks whether new large buffers are sent with MSG_ZEROCOPY.
+ *
+ * @returns true if zero-copy is in use, false if unsupported or disabled after a copied completion.
+ */
+bool TcpInitializer::ZeroCopySender::IsEnabled(void) const noexcept {
+    return this->_enabled;
+};
+
+/**
+ * @brief Gets the number of buffers not yet released.
+ *
+ * @returns The pending buffer count.
+ */
+t_u64 TcpInitializer::ZeroCopySender::GetPendingCount(void) const noexcept {
+    return this->_pending.size();
+};
+
+/**
+ * @brief Gets the number of bytes sent with MSG_ZEROCOPY.
+ *
+ * @returns The zero-copy byte count.
+ */
+t_u64 TcpInitializer::ZeroCopySender::GetZeroCopyBytes(void) const noexcept {
+    return this->_zerocopy_bytes;
+};
+
+/**
+ * @brief Gets the number of bytes sent through the ordinary copying path.
+ *
+ * @returns The copied byte count.
+ */
+t_u64 TcpInitializer::ZeroCopySender::GetCopiedBytes(void) const noexcept {
+    return this->_copied_bytes;
+};
+
+/**
+ * @brief Queues a buffer behind the pending ones and writes what the socket accepts.
+ *
+ * @param _pending The buffer to send.
+ * @returns true if the socket is healthy, false on a write error.
+ */
+bool TcpInitializer::ZeroCopySender::_Enqueue(Pending &&_pending) {
+    if (this->_failed)
+        return false;
+    _pending.zerocopy = this->_enabled && _pending.view.size() >= this->_threshold;
+    Pending &queued(this->_pending.emplace_back(std::move(_pending)));
+    // a moved short string changes address, deque elements do not once inserted
+    if (!queued.owned.empty())
+        queued.view = t_strw(queued.owned);
+    return this->Flush();
+};
+
+/**
+ * @brief Runs the done callbacks of fully sent and released buffers at the front of the queue.
+ */
+void TcpInitializer::ZeroCopySender::_Retire(void) noexcept {
+    while (!this->_pending.empty()) {
+        Pending &front(this->_pending.front());
+        if (front.offset < front.view.size() || (front.pinned && front.last_id >= this->_acked))
+            return;
+        Pending released(std::move(front));
+        this->_pending.pop_front();
+        if (released.on_done)
+            released.on_done(*this, !released.pinned || released.copied);
+    }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef UNIX_G4TCPP_ZEROCOPY_V0_0_1_HPP
+#define UNIX_G4TCPP_ZEROCOPY_V0_0_1_HPP
+
+#include "unix-g4tcpp_v0_0_1.hpp"
+
+#include <deque>
+#include <linux/errqueue.h>
+
+namespace TcpInitializer
+{
+
+#define DEFAULT_ZEROCOPY_THRESHOLD     65536u
+
+/**
+ * Large-buffer sender on top of SO_ZEROCOPY / MSG_ZEROCOPY.
+ *
+ * Buffers of at least DEFAULT_ZEROCOPY_THRESHOLD bytes are pinned and transmitted straight from
+ * user memory instead of being copied into the socket buffer; smaller ones are sent normally, in
+ * the same order. A pinned buffer must stay untouched until the kernel reports through the socket
+ * error queue that it is done with it, so the sender keeps each buffer (or the caller keeps it,
+ * for the view overload) until Reap sees its completion and runs its done callback. When the
+ * kernel reports that it had to copy anyway (loopback, a device without scatter-gather), later
+ * buffers skip MSG_ZEROCOPY since pinning them only adds cost.
+ *
+ * On a blocking socket Send writes the whole buffer, on a non-blocking one the rest is written by
+ * Flush once the socket is writable. Completion notifications raise EPOLLERR/POLLERR without a
+ * pending socket error; an EventLoop keeps such connections open and runs their callbacks, where
+ * Reap should be called.
+ */
+class ZeroCopySender
+{
+  public:
+    using done_cb    = std::function<void(ZeroCopySender &, const bool)>;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_str              owned       {                                                    };
+        t_strw             view        {                                                    };
+        t_u64              offset      {                                                    };
+        t_u64              last_id     {                                                    };
+        bool               zerocopy    {                                                    };
+        bool               pinned      {                                                    };
+        bool               copied      {                                                    };
+        done_cb            on_done     {                                                    };
+    } Pending;
+
+    t_sock                                                _sock;
+    t_u64                                                 _threshold;
+    bool                                                  _enabled;
+    bool                                                  _failed;
+    t_u64                                                 _next_id;
+    t_u64                                                 _acked;
+    std::deque<Pending>                                   _pending;
+    t_u64                                                 _zerocopy_bytes;
+    t_u64                                                 _copied_bytes;
+
+  public:
+    __attribute__((cold                                            ))  explicit                ZeroCopySender          (const t_sock _sock, const t_u64 _threshold = DEFAULT_ZEROCOPY_THRESHOLD) noexcept;
+    ZeroCopySender(const ZeroCopySender &)            = delete;
+    ZeroCopySender &operator=(const ZeroCopySender &) = delete;
+
+    __attribute__((hot                                             ))  inline               bool    Send                    (t_str &&_buffer, done_cb _on_done = nullptr);
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_strw _buffer, done_cb _on_done);
+    __attribute__((hot                                             ))  inline               bool    Flush                   (void) noexcept;
+    __attribute__((hot                                             ))  inline               t_u64   Reap                    (void) noexcept;
+    __attribute__((cold                                            ))  inline               bool    Wait                    (const int _timeout_ms = -1) noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               bool    IsEnabled               (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetPendingCount         (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetZeroCopyBytes        (void) const noexcept;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline               t_u64   GetCopiedBytes          (void) const noexcept;
+
+  protected:
+    __attribute__((hot                                             ))  inline               bool    _Enqueue                (Pending &&_pending);
+    __attribute__((hot                                             ))  inline               void    _Retire                 (void) noexcept;
+};
+
+}; // namespace TcpInitializer
+
+#endif
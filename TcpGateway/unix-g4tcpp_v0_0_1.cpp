@@ -12,10 +12,10 @@ const decltype(std::string::npos) __noindex = std::string::npos;
 /**
  * @brief Initializes the TCP socket channel, required for both client and server.
  * 
- * This function creates a socket using the TCP protocol.
+ * This function creates a socket using the TCP protocol on the default listener instance.
  */
 void TcpInitializer::Socket::Init(void) noexcept { 
-    *__self__::_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP); 
+    __self__::_listener.Open();
 };
 
 /**
@@ -27,27 +27,7 @@ void TcpInitializer::Socket::Init(void) noexcept {
  */
 void TcpInitializer::Socket::CreateTcpServer(const t_strw _address, const t_u16 _port) {
     try {
-        if (!__self__::_AddressValidate(_address, _port)) {
-            throw std::runtime_error(__self__::_ErrorMsgCombine("Arg Eval failure"));
-        }
-
-        __self__::_ip_address = _address;
-        __self__::_port = _port;
-
-        if (__self__::_socket.get() == nullptr || *__self__::_socket < 0) {
-            throw std::runtime_error(__self__::_ErrorMsgCombine("Socket failure"));
-        }
-        __self__::_tcp_state = TcpState::OPEN;
-
-        __self__::Log("Tcp Channel: ", __self__::_ip_address, ":", __self__::_port, '\n');
-
-        __self__::_AddressReuse();
-
-        if (__self__::_TcpBind()) {
-            if (__self__::_TcpListen()) {
-                __self__::_tcp_state = TcpState::LISTENING;
-            }
-        }
+        __self__::_listener.Listen(_address, _port);
     } catch (const t_except &e) {
         __self__::_ExceptionHandle(e.what());
     }
@@ -85,7 +65,16 @@ bool TcpInitializer::Socket::Connect(const t_strw _address, const t_u16 _port) {
  */
 const TcpInitializer::ClientTcpConnection TcpInitializer::Socket::Connect(const t_strw _address, const t_u16 _port, const bool _throw) {
     TcpInitializer::ClientTcpConnection tcp_new;
-    std::thread([&]() -> void { __self__::_Connect<TcpInitializer::ClientTcpConnection &>(_address, _port, tcp_new, _throw); }).join();
+    std::exception_ptr error;
+    std::thread([&]() -> void {
+        try {
+            __self__::_Connect<TcpInitializer::ClientTcpConnection &>(_address, _port, tcp_new, _throw);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }).join();
+    if (error)
+        std::rethrow_exception(error);
     return tcp_new;
 };
 
@@ -97,9 +86,9 @@ const TcpInitializer::ClientTcpConnection TcpInitializer::Socket::Connect(const
  * @throws std::invalid_argument If the socket is not connected.
  */
 t_sock TcpInitializer::Socket::AcceptTcpRequest(t_sock *__restrict__ _sock) {
-    if (!__self__::IsConnected())
+    if (!__self__::_IsActive())
         return -1;
-    t_sock sock_digest;
+    t_sock sock_digest(-1);
     std::thread(__self__::_Accept, _sock, &sock_digest).join();
     return sock_digest;
 };
@@ -111,11 +100,7 @@ t_sock TcpInitializer::Socket::AcceptTcpRequest(t_sock *__restrict__ _sock) {
  * @throws std::invalid_argument If the socket is not connected.
  */
 t_sock TcpInitializer::Socket::AcceptTcpRequest(void) {
-    if (!__self__::IsConnected())
-        return -1;
-    t_sock sock_digest;
-    std::thread(__self__::_Accept, __self__::_socket.get(), &sock_digest).join();
-    return sock_digest;
+    return __self__::AcceptTcpRequest(__self__::_listener.GetSocket());
 };
 
 /**
@@ -125,12 +110,14 @@ t_sock TcpInitializer::Socket::AcceptTcpRequest(void) {
  * @returns true if the buffer was sent successfully, false otherwise.
  */
 bool TcpInitializer::Socket::Send(const t_strw _buffer) noexcept { 
-    return __self__::Send(__self__::_socket.get(), _buffer); 
+    return __self__::Send(__self__::GetSocket(), _buffer);
 };
 
 /**
  * @brief Sends data over the specified TCP socket.
  * 
+ * Short writes are resumed until the whole buffer is written.
+ * 
  * @param _sock Pointer to the socket to send data over.
  * @param _buffer The buffer to send over the TCP connection.
  * @returns true if the buffer was sent successfully, false otherwise.
@@ -138,7 +125,167 @@ bool TcpInitializer::Socket::Send(const t_strw _buffer) noexcept {
 bool TcpInitializer::Socket::Send(const t_sock *__restrict__ _sock, const t_strw _buffer) noexcept {
     if (_sock == nullptr || *_sock <= 0)
         return false;
-    return send(*_sock, _buffer.data(), _buffer.length(), 0) > 0;
+    struct iovec tcp_iov;
+    tcp_iov.iov_base = const_cast<char *>(_buffer.data());
+    tcp_iov.iov_len = _buffer.length();
+    return __self__::_SendAll(*_sock, &tcp_iov, 1);
+};
+
+/**
+ * @brief Sends several buffers over the specified TCP socket with as few syscalls as possible.
+ * 
+ * The buffers are gathered into sendmsg calls of up to DEFAULT_SEND_IOV_MAX entries and written
+ * back to back, short writes are resumed until every byte is written.
+ * 
+ * @param _sock Pointer to the socket to send data over.
+ * @param _buffers The buffers to send, in order.
+ * @param _count The number of buffers.
+ * @returns true if every buffer was sent successfully, false otherwise.
+ */
+bool TcpInitializer::Socket::Send(const t_sock *__restrict__ _sock, const t_strw *_buffers, const std::size_t _count) noexcept {
+    if (_sock == nullptr || *_sock <= 0 || (_buffers == nullptr && _count > 0))
+        return false;
+    struct iovec tcp_iov[DEFAULT_SEND_IOV_MAX];
+    for (std::size_t sent = 0; sent < _count;) {
+        const std::size_t batch(std::min<std::size_t>(_count - sent, DEFAULT_SEND_IOV_MAX));
+        for (std::size_t i = 0; i < batch; ++i) {
+            tcp_iov[i].iov_base = const_cast<char *>(_buffers[sent + i].data());
+            tcp_iov[i].iov_len = _buffers[sent + i].length();
+        }
+        if (!__self__::_SendAll(*_sock, tcp_iov, batch))
+            return false;
+        sent += batch;
+    }
+    return true;
+};
+
+/**
+ * @brief Streams a region of a file over the specified TCP socket with sendfile().
+ * 
+ * The file pages go from the page cache to the socket inside the kernel, the payload is never
+ * read into user space. Partial transfers are resumed until the whole region is sent.
+ * 
+ * @param _sock Pointer to the socket to send data over.
+ * @param _file_fd The open file to read from, its file offset is left untouched.
+ * @param _offset The first byte of the region.
+ * @param _count The number of bytes to send.
+ * @returns true if the whole region was sent, false otherwise (including a file shorter than the region).
+ */
+bool TcpInitializer::Socket::SendFile(const t_sock *__restrict__ _sock, const int _file_fd, const off_t _offset, const std::size_t _count) noexcept {
+    if (_sock == nullptr || *_sock <= 0 || _file_fd < 0)
+        return false;
+    off_t file_offset(_offset);
+    std::size_t left(_count);
+    while (left > 0) {
+        const ssize_t tcp_sent(sendfile(*_sock, _file_fd, &file_offset, left));
+        if (tcp_sent > 0) {
+            TcpInitializer::Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+            TcpInitializer::ConnectionTable::AccountOwner(*_sock, 0, static_cast<t_u64>(tcp_sent));
+            left -= static_cast<std::size_t>(tcp_sent);
+            continue;
+        }
+        if (tcp_sent == 0)
+            return false;
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            // on a blocking socket EAGAIN means the SO_SNDTIMEO set by SetTimeouts expired
+            const int flags(fcntl(*_sock, F_GETFL, 0));
+            if (flags >= 0 && (flags & O_NONBLOCK) == 0) {
+                errno = EAGAIN;
+                return false;
+            }
+            struct pollfd tcp_poll = {*_sock, POLLOUT, 0};
+            if (poll(&tcp_poll, 1, -1) < 0 && errno != EINTR)
+                return false;
+            continue;
+        }
+        return false;
+    }
+    return true;
+};
+
+/**
+ * @brief Streams a whole file over the specified TCP socket with sendfile().
+ * 
+ * @param _sock Pointer to the socket to send data over.
+ * @param _path The path of the file to send.
+ * @returns true if the whole file was sent, false otherwise.
+ */
+bool TcpInitializer::Socket::SendFile(const t_sock *__restrict__ _sock, const t_strw _path) noexcept {
+    const t_str path(_path);
+    const int file_fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file_fd < 0)
+        return false;
+    struct stat file_stat;
+    const bool sent(fstat(file_fd, &file_stat) == 0 && __self__::SendFile(_sock, file_fd, 0, static_cast<std::size_t>(file_stat.st_size)));
+    close(file_fd);
+    return sent;
+};
+
+/**
+ * @brief Connects a socket with a deadline by running a non-blocking connect and waiting for it.
+ * 
+ * The socket keeps its original blocking mode afterwards.
+ * 
+ * @param _sock The unconnected socket.
+ * @param _address The remote address.
+ * @param _timeout_ms Deadline in milliseconds, a negative value waits without limit.
+ * @returns true if the connection was established in time, false otherwise (errno is ETIMEDOUT on timeout).
+ */
+bool TcpInitializer::Socket::ConnectWithin(const t_sock _sock, const struct sockaddr_in &_address, const int _timeout_ms) noexcept {
+    return __self__::ConnectWithin(_sock, reinterpret_cast<const struct sockaddr *>(&_address), sizeof(_address), _timeout_ms);
+};
+
+/**
+ * @brief Connects a socket of any family with a deadline by running a non-blocking connect and waiting for it.
+ * 
+ * The socket keeps its original blocking mode afterwards.
+ * 
+ * @param _sock The unconnected socket.
+ * @param _address The remote address, e.g. a sockaddr_in6.
+ * @param _size The size of the remote address.
+ * @param _timeout_ms Deadline in milliseconds, a negative value waits without limit.
+ * @returns true if the connection was established in time, false otherwise (errno is ETIMEDOUT on timeout).
+ */
+bool TcpInitializer::Socket::ConnectWithin(const t_sock _sock, const struct sockaddr *_address, const socklen_t _size, const int _timeout_ms) noexcept {
+    const int flags(fcntl(_sock, F_GETFL, 0));
+    if (flags < 0 || ((flags & O_NONBLOCK) == 0 && fcntl(_sock, F_SETFL, flags | O_NONBLOCK) < 0))
+        return false;
+    const t_u64 started(TcpInitializer::Metrics::Now());
+    TcpInitializer::Metrics::connects.Add();
+    bool connected(connect(_sock, _address, _size) == 0);
+    if (!connected && errno == EINPROGRESS) {
+        const std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(_timeout_ms));
+        for (;;) {
+            int wait_ms(-1);
+            if (_timeout_ms >= 0)
+                wait_ms = static_cast<int>(std::max<long long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count()));
+            struct pollfd tcp_poll = {_sock, POLLOUT, 0};
+            const int ready(poll(&tcp_poll, 1, wait_ms));
+            if (ready < 0 && errno == EINTR)
+                continue;
+            if (ready == 0)
+                errno = ETIMEDOUT;
+            if (ready > 0) {
+                int error(0);
+                socklen_t error_size(sizeof(error));
+                connected = getsockopt(_sock, SOL_SOCKET, SO_ERROR, &error, &error_size) == 0 && error == 0;
+                if (!connected && error != 0)
+                    errno = error;
+            }
+            break;
+        }
+    }
+    const int saved_errno(errno);
+    if (connected)
+        TcpInitializer::Metrics::connect_latency.Record(TcpInitializer::Metrics::Now() - started);
+    else
+        TcpInitializer::Metrics::connect_failures.Add();
+    if ((flags & O_NONBLOCK) == 0)
+        fcntl(_sock, F_SETFL, flags);
+    errno = saved_errno;
+    return connected;
 };
 
 /**
@@ -147,7 +294,7 @@ bool TcpInitializer::Socket::Send(const t_sock *__restrict__ _sock, const t_strw
  * @returns A TcpIntercept object containing the intercepted TCP request.
  */
 TcpInitializer::TcpIntercept TcpInitializer::Socket::Read(void) { 
-    return __self__::Read(__self__::_socket.get()); 
+    return __self__::Read(__self__::GetSocket());
 };
 
 /**
@@ -156,7 +303,7 @@ TcpInitializer::TcpIntercept TcpInitializer::Socket::Read(void) {
  * @param sink_frame Reference to the string used to store the result of the socket read operation.
  */
 void TcpInitializer::Socket::Read(t_str &sink_frame) {
-    TcpInitializer::TcpIntercept tcp_request(__self__::Read(__self__::_socket.get()));
+    TcpInitializer::TcpIntercept tcp_request(__self__::Read(__self__::GetSocket()));
     sink_frame = tcp_request.block_size > 0 ? tcp_request.raw_bytes : "";
 };
 
@@ -180,17 +327,9 @@ void TcpInitializer::Socket::Read(t_sock *__restrict__ _sock, t_str &sink_frame)
  */
 TcpInitializer::TcpIntercept TcpInitializer::Socket::Read(t_sock *__restrict__ _sock) {
     TcpInitializer::TcpIntercept tcp_request;
-    if (_sock == nullptr || *_sock <= 0 || !__self__::IsConnected())
+    if (_sock == nullptr || *_sock <= 0 || !__self__::_IsActive())
         throw std::invalid_argument("invalid socket state");
-    std::thread([&]() -> void {
-        int tcp_read(0);
-        char tcp_buffer[__self__::_buffer_max];
-        memset(&tcp_buffer, 0, sizeof(tcp_buffer));
-        if (__self__::IsConnected() && (tcp_read = read(*_sock, tcp_buffer, sizeof(tcp_buffer))) > 0) {
-            tcp_request.raw_bytes = tcp_buffer;
-            tcp_request.block_size = tcp_request.raw_bytes.length();
-        }
-    }).join();
+    std::thread([&]() -> void { __self__::_ReadFrom(*_sock, DEFAULT_BUFFER_MAX_SIZE, tcp_request); }).join();
 
     return tcp_request;
 };
@@ -205,13 +344,30 @@ void TcpInitializer::Socket::Read(t_sock *__restrict__ _sock, TcpInitializer::Tc
     dest_obj = __self__::Read(_sock); 
 };
 
+/**
+ * @brief Reads TCP data from the specified socket into a pooled buffer without copying it.
+ * 
+ * The read runs on the calling thread; once the thread pool is warm no heap allocation happens.
+ * 
+ * @param _sock Pointer to the socket to read data from.
+ * @param dest_view Reference to the view receiving the pooled block and the exact byte count.
+ * @returns true if at least one byte was read, false on end of stream or error.
+ * @throws std::invalid_argument If the socket is invalid or not connected.
+ */
+bool TcpInitializer::Socket::Read(t_sock *__restrict__ _sock, TcpInitializer::TcpInterceptView &dest_view) {
+    if (_sock == nullptr || *_sock <= 0 || !__self__::_IsActive())
+        throw std::invalid_argument("invalid socket state");
+    __self__::_ReadFrom(*_sock, DEFAULT_BUFFER_MAX_SIZE, dest_view);
+    return dest_view.block_size > 0;
+};
+
 /**
  * @brief Reads incoming TCP requests and returns the data as a string.
  * 
  * @returns A string containing the received socket data.
  */
 const t_str TcpInitializer::Socket::Read2Str(void) { 
-    return __self__::Read(__self__::_socket.get()).raw_bytes; 
+    return __self__::Read(__self__::GetSocket()).raw_bytes;
 };
 
 /**
@@ -227,32 +383,94 @@ const t_str TcpInitializer::Socket::Read2Str(t_sock *__restrict__ _sock) {
 /**
  * @brief Gets the pointer to the internal socket instance.
  * 
- * @returns A pointer to the internal socket instance.
+ * @returns The default connection socket once Connect was called, the default listener socket otherwise.
  */
 t_sock *TcpInitializer::Socket::GetSocket(void) noexcept {
-    __self__::_AccessGuard();
-    return __self__::_socket.get();
+    if (__self__::_connection.GetState() != TcpState::NONE)
+        return __self__::_connection.GetSocket();
+    return __self__::_listener.GetSocket();
 };
 
 /**
  * @brief Closes the specified socket connection.
  * 
+ * Closing the socket of a default instance also resets that instance state, closing a session
+ * accepted by the default listener frees its slot under the connection limit.
+ * 
  * @param _sock Pointer to the socket to close.
  */
 void TcpInitializer::Socket::Close(t_sock __restrict__ *_sock) noexcept {
-    if (_sock != nullptr)
-        close(*_sock);
+    if (_sock == nullptr)
+        return;
+    if (_sock == __self__::_listener.GetSocket())
+        __self__::_listener.Close();
+    else if (_sock == __self__::_connection.GetSocket())
+        __self__::_connection.Close();
+    else
+        __self__::_listener.CloseSession(*_sock);
 };
 
 /**
  * @brief Executes garbage collection for the socket.
  * 
- * This function cleans up resources and closes the socket.
+ * This function cleans up resources and closes the default listener and connection.
  */
 void TcpInitializer::Socket::GarbageCollectorExecute(void) noexcept {
-    __self__::_AccessGuard();
     __local_enc.free();
-    __self__::Close(__self__::_socket.get());
+    __local_enc.freed = true;
+    __self__::_connection.Close();
+    __self__::_listener.Close();
+};
+
+/**
+ * @brief Bounds the duration of later static Connect calls.
+ *
+ * @param _timeout_ms Connect deadline in milliseconds, a negative value restores the blocking connect without deadline.
+ */
+void TcpInitializer::Socket::SetConnectTimeout(const int _timeout_ms) noexcept {
+    __self__::_connection.SetConnectTimeout(_timeout_ms);
+};
+
+/**
+ * @brief Bounds blocking reads and sends on a socket, so a silent peer cannot hold a thread forever.
+ *
+ * A read that times out returns no data with errno EAGAIN, a send that times out fails.
+ *
+ * @param _sock The socket to update.
+ * @param _read_ms Read timeout in milliseconds, 0 waits without limit.
+ * @param _write_ms Send timeout in milliseconds, 0 waits without limit.
+ * @returns true if both timeouts were set, false otherwise.
+ */
+bool TcpInitializer::Socket::SetTimeouts(const t_sock _sock, const int _read_ms, const int _write_ms) noexcept {
+    struct timeval read_timeout = {_read_ms / 1000, (_read_ms % 1000) * 1000};
+    struct timeval write_timeout = {_write_ms / 1000, (_write_ms % 1000) * 1000};
+    return setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, &read_timeout, sizeof(read_timeout)) == 0 &&
+           setsockopt(_sock, SOL_SOCKET, SO_SNDTIMEO, &write_timeout, sizeof(write_timeout)) == 0;
+};
+
+/**
+ * @brief Enables TCP keepalive probes so half-dead peers are detected by the kernel.
+ *
+ * TCP_USER_TIMEOUT is set to the same probing window, so a connection with unacknowledged data
+ * is dropped as fast as an idle one instead of after the default retransmission timeout.
+ *
+ * @param _sock The socket to update.
+ * @param _idle_s Idle seconds before the first probe.
+ * @param _interval_s Seconds between probes.
+ * @param _count Unanswered probes before the connection is dropped.
+ * @returns true if every option was set, false otherwise.
+ */
+bool TcpInitializer::Socket::SetKeepAlive(const t_sock _sock, const t_u32 _idle_s, const t_u32 _interval_s, const t_u32 _count) noexcept {
+    const int enable(1);
+    const int idle(static_cast<int>(std::max<t_u32>(_idle_s, 1)));
+    const int interval(static_cast<int>(std::max<t_u32>(_interval_s, 1)));
+    const int count(static_cast<int>(std::max<t_u32>(_count, 1)));
+    const unsigned int user_timeout(static_cast<unsigned int>((idle + interval * count) * 1000));
+    return setsockopt(_sock, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable)) == 0 &&
+           setsockopt(_sock, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle)) == 0 &&
+           setsockopt(_sock, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval)) == 0 &&
+           setsockopt(_sock, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count)) == 0 &&
+           setsockopt(_sock, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout, sizeof(user_timeout)) == 0;
 };
 
 /**
@@ -261,9 +479,7 @@ void TcpInitializer::Socket::GarbageCollectorExecute(void) noexcept {
  * @param max The maximum number of connections.
  */
 void TcpInitializer::Socket::SetMaxConnections(const t_u64 max) noexcept {
-    if (max <= UINT64_MAX) {
-        __self__::_accept_max = max;
-    }
+    __self__::_listener.SetMaxConnections(max);
 };
 
 /**
@@ -272,26 +488,47 @@ void TcpInitializer::Socket::SetMaxConnections(const t_u64 max) noexcept {
  * @returns true if the socket can accept new connections, false otherwise.
  */
 bool TcpInitializer::Socket::CanAcceptTcp(void) noexcept { 
-    return __self__::_tcp_count < __self__::_accept_max && __self__::SocketState(__self__::_socket.get()); 
+    return __self__::_listener.CanAcceptTcp();
 };
 
 /**
- * @brief Gets the current session count.
+ * @brief Gets the number of live sessions of the default listener.
  * 
- * @returns A reference to the current session count.
+ * @returns The live session count.
  */
-const t_u64 &TcpInitializer::Socket::GetSessionCount(void) noexcept { 
-    return __self__::_tcp_count; 
+t_u64 TcpInitializer::Socket::GetSessionCount(void) noexcept { 
+    return __self__::_listener.GetSessionCount();
 };
 
 /**
  * @brief Checks if the socket is currently connected.
  * 
- * @returns true if the socket is connected, false otherwise.
+ * @returns true if the default listener is listening or the default connection is connected, false otherwise.
  */
 bool TcpInitializer::Socket::IsConnected(void) noexcept {
-    return __self__::_tcp_state == TcpState::CONNECTED && __self__::_tcp_state == TcpState::LISTENING && __self__::_socket.get() != nullptr && *__self__::_socket > 0 &&
-           __self__::SocketState(__self__::_socket.get());
+    if (__self__::_connection.IsConnected())
+        return __self__::SocketState(__self__::_connection.GetSocket());
+    if (__self__::_listener.IsListening())
+        return __self__::SocketState(__self__::_listener.GetSocket());
+    return false;
+};
+
+/**
+ * @brief Gets the default listener instance used by the static server API.
+ * 
+ * @returns A reference to the default listener.
+ */
+TcpInitializer::TcpListener &TcpInitializer::Socket::GetListener(void) noexcept {
+    return __self__::_listener;
+};
+
+/**
+ * @brief Gets the default connection instance used by the static client API.
+ * 
+ * @returns A reference to the default connection.
+ */
+TcpInitializer::TcpConnection &TcpInitializer::Socket::GetConnection(void) noexcept {
+    return __self__::_connection;
 };
 
 /**
@@ -312,7 +549,9 @@ bool TcpInitializer::Socket::SocketState(const t_sock *__restrict__ _sock) {
 };
 
 /**
- * @brief Connects to a server at the specified address and port.
+ * @brief Connects the default connection to a server at the specified address and port.
+ * 
+ * The socket opened by Init() is reused when the default listener was never bound.
  * 
  * @tparam rT The type of the result to return (e.g., ClientTcpConnection or bool).
  * @param _address The remote address to connect to.
@@ -323,35 +562,13 @@ bool TcpInitializer::Socket::SocketState(const t_sock *__restrict__ _sock) {
  */
 template <typename rT> 
 void TcpInitializer::Socket::_Connect(const t_strw _address, const t_u16 _port, rT _r, const bool _throw) {
-    __self__::_AccessGuard();
-    if (!__self__::_AddressValidate(_address, _port) && _throw) {
-        throw std::runtime_error(__self__::_ErrorMsgCombine("Conn Addr Eval failure"));
-    }
-
-    if (__self__::_socket == nullptr || *__self__::_socket <= 0) {
-        __self__::_socket = std::make_unique<t_sock>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
-    }
-    if (__self__::_socket.get() == nullptr && _throw) {
-        throw std::runtime_error(__self__::_ErrorMsgCombine("Sock open error"));
-    }
-    __self__::_tcp_state = TcpInitializer::TcpState::OPEN;
-    struct sockaddr_in srv_addr;
-    memset(&srv_addr, 0, sizeof(struct sockaddr_in));
-    srv_addr.sin_family = AF_INET;
-    srv_addr.sin_port = htons(_port);
-
-    if (inet_pton(AF_INET, _address.data(), &(srv_addr.sin_addr)) < 1 && _throw) {
-        throw std::runtime_error(__self__::_ErrorMsgCombine("address convert error"));
+    if (__self__::_listener.GetState() == TcpState::OPEN && __self__::_connection.GetState() == TcpState::NONE) {
+        __self__::_connection.Attach(__self__::_listener.Release());
     }
-    const bool status(connect(*__self__::_socket, (struct sockaddr *)&srv_addr, sizeof(srv_addr)) == 0);
     if constexpr (std::is_same_v<rT, TcpInitializer::ClientTcpConnection &>) {
-        _r.state = status;
-        _r.sock = *__self__::_socket;
+        _r = __self__::_connection.Connect(_address, _port, _throw);
     } else if constexpr (std::is_same_v<rT, bool &>) {
-        _r = status;
-    }
-    if (status) {
-        __self__::_tcp_state = TcpInitializer::TcpState::CONNECTED;
+        _r = __self__::_connection.Connect(_address, _port);
     }
     return;
 };
@@ -364,65 +581,155 @@ void TcpInitializer::Socket::_Connect(const t_strw _address, const t_u16 _port,
  * @returns true if a new connection was accepted, false otherwise.
  */
 bool TcpInitializer::Socket::_Accept(t_sock *__restrict__ _sock, t_sock *__restrict__ _sock_digest) {
-    if (__self__::IsConnected()) {
-        if (__self__::SocketState(_sock)) {
-            socklen_t addr_len(sizeof(*__self__::_sock_address));
-            if (__self__::_tcp_count <= __self__::_accept_max) {
-                ++__self__::_tcp_count;
-                *_sock_digest = accept(*_sock, (struct sockaddr *)&(*__self__::_sock_address), &addr_len);
-            }
-        }
-        return *_sock_digest > *_sock;
+    if (_sock == __self__::_listener.GetSocket()) {
+        *_sock_digest = __self__::_listener.Accept();
+    } else if (_sock != nullptr && *_sock >= 0) {
+        *_sock_digest = accept(*_sock, nullptr, nullptr);
     }
-    return false;
+    return *_sock_digest >= 0;
 };
 
 /**
- * @brief Binds the socket to the specified address and port.
+ * @brief Performs a single read from a socket into a TcpIntercept object.
  * 
- * @returns true if the binding was successful, false otherwise.
+ * The payload is read straight into the destination string, which is then trimmed to the exact
+ * byte count returned by read(), so binary data with embedded NUL bytes is kept intact.
+ * 
+ * @param _sock The socket to read from.
+ * @param _buffer_max The maximum number of bytes to read.
+ * @param _dest Reference to the TcpIntercept object receiving the payload, left empty on error.
  */
-bool TcpInitializer::Socket::_TcpBind(void) {
-    __self__::_AccessGuard();
-    if (__self__::SocketState(__self__::_socket.get())) {
-        memset(__self__::_sock_address.get(), 0, sizeof(struct sockaddr_in));
-        __self__::_sock_address->sin_port = htons(__self__::_port);
-        __self__::_sock_address->sin_family = AF_INET;
-        if (inet_pton(AF_INET, __self__::_ip_address.c_str(), &(__self__::_sock_address->sin_addr)) == 1) {
-            return bind(*__self__::_socket, (struct sockaddr *)&(*__self__::_sock_address), sizeof(*__self__::_sock_address)) == 0;
-        }
+void TcpInitializer::Socket::_ReadFrom(const t_sock _sock, const t_u64 _buffer_max, TcpInitializer::TcpIntercept &_dest) {
+    _dest.raw_bytes.resize(static_cast<std::size_t>(_buffer_max));
+    const t_u64 started(TcpInitializer::Metrics::Now());
+    const ssize_t tcp_read(read(_sock, _dest.raw_bytes.data(), _buffer_max));
+    TcpInitializer::Metrics::read_latency.Record(TcpInitializer::Metrics::Now() - started);
+    _dest.raw_bytes.resize(tcp_read > 0 ? static_cast<std::size_t>(tcp_read) : 0);
+    if (tcp_read > 0) {
+        TcpInitializer::Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+        TcpInitializer::ConnectionTable::AccountOwner(_sock, static_cast<t_u64>(tcp_read), 0);
+        _dest.block_size = static_cast<t_u64>(tcp_read);
     }
-    return false;
 };
 
 /**
- * @brief Listens for incoming TCP connections on the socket.
+ * @brief Performs a single read from a socket straight into a block of the calling thread pool.
  * 
- * @returns true if the socket is successfully set to listen, false otherwise.
+ * @param _sock The socket to read from.
+ * @param _buffer_max The maximum number of bytes to read, capped at the pool block size.
+ * @param _dest Reference to the view receiving the block and the exact byte count.
  */
-bool TcpInitializer::Socket::_TcpListen(void) {
-    __self__::_AccessGuard();
-    if (__self__::SocketState(__self__::_socket.get())) {
-        return listen(*__self__::_socket, __self__::_accept_max) == 0;
+void TcpInitializer::Socket::_ReadFrom(const t_sock _sock, const t_u64 _buffer_max, TcpInitializer::TcpInterceptView &_dest) {
+    _dest.buffer = BufferPool::Local().Acquire();
+    _dest.block_size = 0;
+    const t_u64 started(TcpInitializer::Metrics::Now());
+    const ssize_t tcp_read(read(_sock, _dest.buffer.Data(), std::min<t_u64>(_buffer_max, _dest.buffer.Capacity())));
+    TcpInitializer::Metrics::read_latency.Record(TcpInitializer::Metrics::Now() - started);
+    if (tcp_read > 0) {
+        TcpInitializer::Metrics::bytes_in.Add(static_cast<t_u64>(tcp_read));
+        TcpInitializer::ConnectionTable::AccountOwner(_sock, static_cast<t_u64>(tcp_read), 0);
+        _dest.block_size = static_cast<t_u64>(tcp_read);
     }
-    return false;
+};
+
+/**
+ * @brief Writes every byte described by an iovec array, resuming after short writes.
+ * 
+ * A non-blocking socket that fills up is waited on with poll() rather than failing half way.
+ * 
+ * @param _sock The socket to write to.
+ * @param _iov The buffers to write, updated in place as bytes are written.
+ * @param _count The number of entries in _iov, at most IOV_MAX.
+ * @returns true if everything was written, false on error.
+ */
+bool TcpInitializer::Socket::_SendAll(const t_sock _sock, struct iovec *_iov, std::size_t _count) noexcept {
+    while (_count > 0 && _iov->iov_len == 0) {
+        ++_iov;
+        --_count;
+    }
+    while (_count > 0) {
+        struct msghdr tcp_msg;
+        memset(&tcp_msg, 0, sizeof(tcp_msg));
+        tcp_msg.msg_iov = _iov;
+        tcp_msg.msg_iovlen = _count;
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        const ssize_t tcp_sent(sendmsg(_sock, &tcp_msg, MSG_NOSIGNAL));
+        TcpInitializer::Metrics::send_latency.Record(TcpInitializer::Metrics::Now() - started);
+        if (tcp_sent < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // on a blocking socket EAGAIN means the SO_SNDTIMEO set by SetTimeouts expired
+                const int flags(fcntl(_sock, F_GETFL, 0));
+                if (flags >= 0 && (flags & O_NONBLOCK) == 0) {
+                    errno = EAGAIN;
+                    return false;
+                }
+                struct pollfd tcp_poll = {_sock, POLLOUT, 0};
+                if (poll(&tcp_poll, 1, -1) < 0 && errno != EINTR)
+                    return false;
+                continue;
+            }
+            return false;
+        }
+        TcpInitializer::Metrics::bytes_out.Add(static_cast<t_u64>(tcp_sent));
+        TcpInitializer::ConnectionTable::AccountOwner(_sock, 0, static_cast<t_u64>(tcp_sent));
+        std::size_t written(static_cast<std::size_t>(tcp_sent));
+        while (_count > 0 && written >= _iov->iov_len) {
+            written -= _iov->iov_len;
+            ++_iov;
+            --_count;
+        }
+        if (_count > 0) {
+            _iov->iov_base = static_cast<char *>(_iov->iov_base) + written;
+            _iov->iov_len -= written;
+        }
+    }
+    return true;
 };
 
 /**
  * @brief Validates the specified address and port.
  * 
- * @param _address The address to validate.
+ * @param _address The address to validate, numeric IPv4 or IPv6, or a host name.
  * @param _port The port number to validate.
  * @returns true if the address and port are valid, false otherwise.
  */
-bool TcpInitializer::Socket::_AddressValidate(const t_strw _address, const t_u16 _port) {
-    if (_address.find(".") != ::__noindex) {
-        if (std::count(_address.begin(), _address.end(), '.') == 3) {
-            std::regex validator(TcpInitializer::IP_ADDRESS_REGX_ALLOW);
-            return std::regex_match(_address.data(), validator);
-        }
+bool TcpInitializer::Socket::_AddressValidate(const t_strw _address, [[maybe_unused]] const t_u16 _port) {
+    TcpInitializer::IpAddress address;
+    if (TcpInitializer::AddressParser::IsUnix(_address)) {
+        PeerAddress local;
+        socklen_t local_size(0);
+        int local_type(0);
+        return TcpInitializer::AddressParser::ParseUnix(_address, local, local_size, local_type);
     }
-    return false;
+    return TcpInitializer::AddressParser::ParseAddress(_address, address) || TcpInitializer::AddressParser::IsHostname(_address);
+};
+
+/**
+ * @brief Checks the tracked state of the default connection and listener, without a syscall.
+ *
+ * Used on the read and accept paths: a socket error surfaces through the return code of the
+ * read or accept itself, so querying SO_ERROR beforehand only costs a syscall per call.
+ *
+ * @returns true if the default connection is connected or the default listener is listening, false otherwise.
+ */
+bool TcpInitializer::Socket::_IsActive(void) noexcept {
+    return __self__::_connection.IsConnected() || __self__::_listener.IsListening();
+};
+
+/**
+ * @brief Gets the address family a socket was opened with.
+ *
+ * @param _sock The socket.
+ * @returns AF_INET, AF_INET6, ... or AF_UNSPEC if the socket cannot be queried.
+ */
+int TcpInitializer::Socket::_SocketFamily(const t_sock _sock) noexcept {
+    TcpInitializer::PeerAddress address;
+    socklen_t address_size(sizeof(address));
+    if (_sock < 0 || getsockname(_sock, &address.addr, &address_size) < 0)
+        return AF_UNSPEC;
+    return address.addr.sa_family;
 };
 
 /**
@@ -431,7 +738,7 @@ bool TcpInitializer::Socket::_AddressValidate(const t_strw _address, const t_u16
  * @param error The error message to log.
  */
 void TcpInitializer::Socket::_ExceptionHandle(const t_strw error) noexcept { 
-    std::cerr << "Error: " << error.data() << "\n"; 
+    TcpInitializer::Logger::Global().Write<TcpInitializer::LogLevel::ERROR>("Error: ", error); 
 };
 
 /**
@@ -441,7 +748,17 @@ void TcpInitializer::Socket::_ExceptionHandle(const t_strw error) noexcept {
  * @returns A string containing the combined error message.
  */
 const t_str TcpInitializer::Socket::_ErrorMsgCombine(const t_strw _token) noexcept { 
-    return t_str(_token.data(), _token.length()).append(strerror_l(errno, __local_enc.local_x)); 
+    return TcpInitializer::ErrorMsgCombine(_token); 
+};
+
+/**
+ * @brief Combines an error message with the last error string, shared by every module of the library.
+ * 
+ * @param _token The error token to combine.
+ * @returns A string containing the combined error message.
+ */
+const t_str TcpInitializer::ErrorMsgCombine(const t_strw _token) noexcept { 
+    return t_str(_token.data(), _token.length()).append(strerror_l(errno, TcpInitializer::__local_enc.local_x)); 
 };
 
 /**
@@ -454,7 +771,7 @@ void TcpInitializer::Socket::SetVerbose(const bool verbose) noexcept {
 };
 
 /**
- * @brief Logs messages if verbose logging is enabled.
+ * @brief Logs messages at INFO level through the global Logger if verbose logging is enabled.
  * 
  * @tparam MT The types of the messages to log.
  * @param msgs The messages to log.
@@ -462,41 +779,2481 @@ void TcpInitializer::Socket::SetVerbose(const bool verbose) noexcept {
 template <typename... MT> 
 void TcpInitializer::Socket::Log(MT... msgs) noexcept {
     if (TcpInitializer::Socket::verbose) {
-        (std::cout << ... << msgs);
+        TcpInitializer::Logger::Global().Write<TcpInitializer::LogLevel::INFO>(msgs...);
     }
 };
 
 /**
- * @brief Configures the socket to allow address reuse.
+ * @brief Destructor for the Socket class.
  * 
- * This function sets the SO_REUSEADDR and SO_REUSEPORT options on the socket.
- * @throws std::runtime_error If setting socket options fails.
+ * Cleans up resources and executes garbage collection.
  */
-void TcpInitializer::Socket::_AddressReuse(void) {
-    __self__::_AccessGuard();
-    if (__self__::_socket != nullptr && *__self__::_socket > 0) {
-        int opt_value(1);
-        socklen_t opt_len(sizeof(opt_value));
-        if (setsockopt(*__self__::_socket, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt_value, opt_len) < 0) {
-            throw std::runtime_error(__self__::_ErrorMsgCombine("Cannot set socket options!"));
+TcpInitializer::Socket::~Socket() { 
+    TcpInitializer::Socket::GarbageCollectorExecute(); 
+};
+
+/**
+ * @brief Constructs an unopened listener bound to the default address and port.
+ */
+TcpInitializer::TcpListener::TcpListener(void) noexcept
+    : _socket(-1), _sock_address(), _tcp_state(TcpState::NONE), _ip_address(DEFAULT_IP_ADDRESS), _port(DEFAULT_PORT_NUMBER), _accept_max(DEFAULT_ACCEPT_MAX), _reserved(0), _accepted(), _sessions(), _mtx() {};
+
+/**
+ * @brief Destructor for the TcpListener class, closes the listening socket.
+ */
+TcpInitializer::TcpListener::~TcpListener() {
+    this->Close();
+};
+
+/**
+ * @brief Opens the listening socket if not already open.
+ *
+ * @returns true if the listener owns an open socket, false otherwise.
+ */
+bool TcpInitializer::TcpListener::Open(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (this->_socket < 0) {
+        this->_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (this->_socket >= 0)
+            this->_tcp_state = TcpState::OPEN;
+    }
+    return this->_socket >= 0;
+};
+
+/**
+ * @brief Binds and listens on the default address and specified port.
+ *
+ * @param _port The port number to listen on.
+ * @returns true if the listener is listening, false otherwise.
+ */
+bool TcpInitializer::TcpListener::Listen(const t_u16 _port) {
+    return this->Listen(DEFAULT_IP_ADDRESS, _port);
+};
+
+/**
+ * @brief Binds and listens on the specified address and port, opening the socket if needed.
+ *
+ * @param _address The local address to bind to, IPv4 or IPv6 ("::" listens on both families) or a host name.
+ * @param _port The port number to listen on.
+ * @returns true if the listener is listening, false otherwise.
+ * @throws std::runtime_error If address validation fails or socket creation fails.
+ */
+bool TcpInitializer::TcpListener::Listen(const t_strw _address, const t_u16 _port) {
+    if (!__self__::_AddressValidate(_address, _port)) {
+        throw std::runtime_error(__self__::_ErrorMsgCombine("Arg Eval failure"));
+    }
+    if (!this->Open()) {
+        throw std::runtime_error(__self__::_ErrorMsgCombine("Socket failure"));
+    }
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_ip_address = _address;
+    this->_port = _port;
+
+    __self__::Log("Tcp Channel: ", this->_ip_address, ":", this->_port, '\n');
+
+    this->_AddressReuse();
+
+    if (this->_TcpBind()) {
+        if (this->_TcpListen()) {
+            this->_tcp_state = TcpState::LISTENING;
         }
     }
+    return this->_tcp_state == TcpState::LISTENING;
 };
 
 /**
- * @brief Acquires a lock for thread safety.
+ * @brief Takes over a socket that is already listening, e.g. one inherited from a previous process.
+ *
+ * @param _sock The listening socket, owned by the listener from now on.
+ * @param _address The address it was bound with, kept for GetAddress.
+ * @param _port The port it was bound with, kept for GetPort.
+ * @returns true if the socket is listening and was adopted, false otherwise (errno EINVAL, the socket is left alone).
  */
-void TcpInitializer::Socket::_AccessGuard(void) noexcept { 
-    std::unique_lock<decltype(__self__::_mtx)> Lock(__self__::_mtx); 
+bool TcpInitializer::TcpListener::Adopt(const t_sock _sock, const t_strw _address, const t_u16 _port) {
+    int accepting(0);
+    socklen_t accepting_size(sizeof(accepting));
+    if (_sock < 0 || getsockopt(_sock, SOL_SOCKET, SO_ACCEPTCONN, &accepting, &accepting_size) < 0 || accepting == 0) {
+        errno = EINVAL;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (this->_socket >= 0 && this->_socket != _sock)
+        close(this->_socket);
+    this->_socket = _sock;
+    this->_ip_address = _address;
+    this->_port = _port;
+    socklen_t address_size(sizeof(this->_sock_address));
+    if (getsockname(this->_socket, &this->_sock_address.addr, &address_size) < 0)
+        memset(&this->_sock_address, 0, sizeof(this->_sock_address));
+    this->_tcp_state = TcpState::LISTENING;
+    return true;
 };
 
 /**
- * @brief Destructor for the Socket class.
- * 
- * Cleans up resources and executes garbage collection.
+ * @brief Accepts a new TCP connection, honouring the configured connection limit.
+ *
+ * The session is tracked until CloseSession, so only live sessions count against the limit. A slot
+ * is reserved before accept() and held until the session is inserted, so concurrent callers can
+ * not overshoot the limit together.
+ *
+ * @returns The accepted socket, or -1 if the listener is not listening, the limit is reached (errno EMFILE) or accept failed.
  */
-TcpInitializer::Socket::~Socket() { 
-    TcpInitializer::Socket::GarbageCollectorExecute(); 
+t_sock TcpInitializer::TcpListener::Accept(void) {
+    t_sock listen_sock;
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->_tcp_state != TcpState::LISTENING)
+            return -1;
+        if (this->_sessions.GetCount() + this->_reserved.load(std::memory_order_relaxed) >= this->_accept_max) {
+            errno = EMFILE;
+            return -1;
+        }
+        this->_reserved.fetch_add(1, std::memory_order_relaxed);
+        listen_sock = this->_socket;
+    }
+    PeerAddress peer;
+    socklen_t peer_size(sizeof(peer));
+    const t_sock sock_digest(accept(listen_sock, &peer.addr, &peer_size));
+    if (sock_digest >= 0) {
+        try {
+            this->_sessions.Insert(sock_digest, &peer.addr, peer_size);
+        } catch (...) {
+            this->_reserved.fetch_sub(1, std::memory_order_relaxed);
+            close(sock_digest);
+            throw;
+        }
+        this->_accepted.Add();
+        TcpInitializer::Metrics::accepted.Add();
+    }
+    // the slot turns into a live session or is given back
+    this->_reserved.fetch_sub(1, std::memory_order_relaxed);
+    return sock_digest;
+};
+
+/**
+ * @brief Checks if the listener can accept new TCP connections.
+ *
+ * @returns true if the listener is healthy and below its connection limit, false otherwise.
+ */
+bool TcpInitializer::TcpListener::CanAcceptTcp(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_sessions.GetCount() + this->_reserved.load(std::memory_order_relaxed) < this->_accept_max && this->_tcp_state == TcpState::LISTENING && this->_socket >= 0;
+};
+
+/**
+ * @brief Checks if the listener is bound and listening.
+ *
+ * @returns true if the listener is listening, false otherwise.
+ */
+bool TcpInitializer::TcpListener::IsListening(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_tcp_state == TcpState::LISTENING && this->_socket >= 0;
+};
+
+/**
+ * @brief Gets the number of live sessions accepted by this listener and not closed yet.
+ *
+ * @returns The live session count.
+ */
+t_u64 TcpInitializer::TcpListener::GetSessionCount(void) const noexcept {
+    return this->_sessions.GetCount();
+};
+
+/**
+ * @brief Gets the number of sessions accepted by this listener since it was created.
+ *
+ * @returns The accepted session count.
+ */
+t_u64 TcpInitializer::TcpListener::GetAcceptedCount(void) const noexcept {
+    return this->_accepted.Get();
+};
+
+/**
+ * @brief Gets the table of live sessions, e.g. to look up a peer address or sweep idle sessions.
+ *
+ * @returns A reference to the session table.
+ */
+TcpInitializer::ConnectionTable &TcpInitializer::TcpListener::GetSessions(void) noexcept {
+    return this->_sessions;
+};
+
+/**
+ * @brief Closes an accepted session and releases its slot under the connection limit.
+ *
+ * @param _sock The session socket.
+ * @returns true if the socket was a tracked session, false otherwise (it is closed either way).
+ */
+bool TcpInitializer::TcpListener::CloseSession(const t_sock _sock) noexcept {
+    if (_sock < 0)
+        return false;
+    const bool tracked(this->_sessions.Remove(this->_sessions.IdOf(_sock)));
+    close(_sock);
+    return tracked;
+};
+
+/**
+ * @brief Gets the listener state.
+ *
+ * @returns The current TcpState.
+ */
+TcpInitializer::TcpState TcpInitializer::TcpListener::GetState(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_tcp_state;
+};
+
+/**
+ * @brief Gets the bound address.
+ *
+ * @returns A reference to the address string.
+ */
+const t_str &TcpInitializer::TcpListener::GetAddress(void) const noexcept {
+    return this->_ip_address;
+};
+
+/**
+ * @brief Gets the bound port.
+ *
+ * @returns The port number.
+ */
+t_u16 TcpInitializer::TcpListener::GetPort(void) const noexcept {
+    return this->_port;
+};
+
+/**
+ * @brief Gets the pointer to the listening socket.
+ *
+ * @returns A pointer to the listening socket.
+ */
+t_sock *TcpInitializer::TcpListener::GetSocket(void) noexcept {
+    return &this->_socket;
+};
+
+/**
+ * @brief Sets the maximum number of sessions and the listen backlog.
+ *
+ * @param max The maximum number of connections.
+ */
+void TcpInitializer::TcpListener::SetMaxConnections(const t_u64 max) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_accept_max = max;
+};
+
+/**
+ * @brief Detaches the socket from the listener without closing it.
+ *
+ * @returns The detached socket, or -1 if the listener had none.
+ */
+t_sock TcpInitializer::TcpListener::Release(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const t_sock sock(this->_socket);
+    this->_socket = -1;
+    this->_tcp_state = TcpState::NONE;
+    return sock;
+};
+
+/**
+ * @brief Closes the listening socket and resets the listener state.
+ */
+void TcpInitializer::TcpListener::Close(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (this->_tcp_state == TcpState::LISTENING && this->_sock_address.addr.sa_family == AF_UNIX && this->_sock_address.un.sun_path[0] != '\0')
+        unlink(this->_sock_address.un.sun_path);
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = -1;
+    this->_tcp_state = TcpState::NONE;
+};
+
+/**
+ * @brief Binds the socket to the configured address and port, reopening it if the address is of another family.
+ *
+ * @returns true if the binding was successful, false otherwise.
+ */
+bool TcpInitializer::TcpListener::_TcpBind(void) {
+    int unix_type(0);
+    socklen_t unix_size(0);
+    if (TcpInitializer::AddressParser::ParseUnix(this->_ip_address, this->_sock_address, unix_size, unix_type))
+        return this->_UnixBind(unix_type, unix_size);
+    TcpInitializer::IpAddress local;
+    if (!TcpInitializer::AddressParser::ParseAddress(this->_ip_address, local)) {
+        std::vector<TcpInitializer::IpAddress> resolved;
+        if (!TcpInitializer::Resolver::Global().Resolve(this->_ip_address, resolved))
+            return false;
+        local = resolved.front();
+    }
+    local.port = this->_port;
+    socklen_t address_size(0);
+    if (!__self__::SocketState(&this->_socket) || !TcpInitializer::AddressParser::ToSockAddr(local, this->_sock_address, address_size))
+        return false;
+    if (__self__::_SocketFamily(this->_socket) != local.family) {
+        // Open cannot know the family before the address, an IPv6 bind gets a fresh socket
+        const t_sock fresh(socket(local.family, SOCK_STREAM, IPPROTO_TCP));
+        if (fresh < 0)
+            return false;
+        close(this->_socket);
+        this->_socket = fresh;
+        this->_AddressReuse();
+    }
+    if (local.family == AF_INET6) {
+        // dual-stack: a listener on "::" also accepts IPv4 clients, as v4-mapped addresses
+        const int v6_only(0);
+        setsockopt(this->_socket, IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, sizeof(v6_only));
+    }
+    return bind(this->_socket, &this->_sock_address.addr, address_size) == 0;
+};
+
+/**
+ * @brief Listens for incoming TCP connections on the socket.
+ *
+ * @returns true if the socket is successfully set to listen, false otherwise.
+ */
+bool TcpInitializer::TcpListener::_TcpListen(void) {
+    if (__self__::SocketState(&this->_socket)) {
+        return listen(this->_socket, this->_accept_max) == 0;
+    }
+    return false;
+};
+
+/**
+ * @brief Configures the socket to allow address reuse.
+ *
+ * This function sets the SO_REUSEADDR and SO_REUSEPORT options on the socket. They are distinct
+ * option names, not flags, so each one needs its own setsockopt call.
+ * @throws std::runtime_error If setting socket options fails.
+ */
+void TcpInitializer::TcpListener::_AddressReuse(void) {
+    if (this->_socket > 0) {
+        int opt_value(1);
+        socklen_t opt_len(sizeof(opt_value));
+        if (setsockopt(this->_socket, SOL_SOCKET, SO_REUSEADDR, &opt_value, opt_len) < 0) {
+            throw std::runtime_error(__self__::_ErrorMsgCombine("Cannot set socket options!"));
+        }
+        if (setsockopt(this->_socket, SOL_SOCKET, SO_REUSEPORT, &opt_value, opt_len) < 0) {
+            throw std::runtime_error(__self__::_ErrorMsgCombine("Cannot set socket options!"));
+        }
+    }
+};
+
+/**
+ * @brief Binds a Unix domain socket of the requested type to the parsed _sock_address.
+ *
+ * A socket file left behind by a process that died without closing its listener is removed
+ * first, but only once a connect to it is refused, so a live server keeps its path (EADDRINUSE).
+ *
+ * @param _type SOCK_STREAM or SOCK_SEQPACKET.
+ * @param _size The size of the address in _sock_address.
+ * @returns true if the binding was successful, false otherwise.
+ */
+bool TcpInitializer::TcpListener::_UnixBind(const int _type, const socklen_t _size) {
+    const t_sock fresh(socket(AF_UNIX, _type, 0));
+    if (fresh < 0)
+        return false;
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = fresh;
+    struct stat stale;
+    if (this->_sock_address.un.sun_path[0] != '\0' && lstat(this->_sock_address.un.sun_path, &stale) == 0 && S_ISSOCK(stale.st_mode)) {
+        const t_sock probe(socket(AF_UNIX, _type, 0));
+        if (probe >= 0 && connect(probe, &this->_sock_address.addr, _size) < 0 && errno == ECONNREFUSED)
+            unlink(this->_sock_address.un.sun_path);
+        if (probe >= 0)
+            close(probe);
+    }
+    return bind(this->_socket, &this->_sock_address.addr, _size) == 0;
+};
+
+/**
+ * @brief Constructs an unconnected connection.
+ */
+TcpInitializer::TcpConnection::TcpConnection(void) noexcept
+    : _socket(-1), _sock_address(), _tcp_state(TcpState::NONE), _ip_address(), _port(0), _buffer_max(DEFAULT_BUFFER_MAX_SIZE), _bytes_sent(0), _bytes_received(0), _connect_timeout_ms(-1), _mtx() {};
+
+/**
+ * @brief Constructs a connection adopting an already connected socket, e.g. one returned by TcpListener::Accept.
+ *
+ * @param _sock The connected socket to take ownership of.
+ */
+TcpInitializer::TcpConnection::TcpConnection(const t_sock _sock) noexcept : TcpConnection() {
+    if (_sock >= 0) {
+        this->_socket = _sock;
+        this->_tcp_state = TcpState::CONNECTED;
+    }
+};
+
+/**
+ * @brief Destructor for the TcpConnection class, closes the socket.
+ */
+TcpInitializer::TcpConnection::~TcpConnection() {
+    this->Close();
+};
+
+/**
+ * @brief Connects to a server on the specified address and port.
+ *
+ * @param _address The remote address to connect to.
+ * @param _port The port number to connect to.
+ * @returns true if the connection was successful, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::Connect(const t_strw _address, const t_u16 _port) {
+    return this->Connect(_address, _port, false).state;
+};
+
+/**
+ * @brief Connects to a server on the specified address and port, with an option to throw exceptions.
+ *
+ * The connect timeout also bounds a cold name lookup, and the time the lookup took is taken off
+ * the deadline of the connect.
+ *
+ * @param _address The remote address to connect to, numeric IPv4 or IPv6, or a host name resolved through Resolver::Global.
+ * @param _port The port number to connect to.
+ * @param _throw If true, exceptions will be thrown on errors.
+ * @returns A ClientTcpConnection object representing the connection.
+ * @throws std::runtime_error If address validation or resolution fails or socket creation fails.
+ */
+const TcpInitializer::ClientTcpConnection TcpInitializer::TcpConnection::Connect(const t_strw _address, const t_u16 _port, const bool _throw) {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    TcpInitializer::ClientTcpConnection tcp_new{this->_socket, false};
+    int unix_type(0);
+    socklen_t unix_size(0);
+    if (TcpInitializer::AddressParser::IsUnix(_address)) {
+        if (!TcpInitializer::AddressParser::ParseUnix(_address, this->_sock_address, unix_size, unix_type)) {
+            if (_throw)
+                throw std::runtime_error(__self__::_ErrorMsgCombine("Conn Addr Eval failure"));
+            return tcp_new;
+        }
+        this->_ip_address = _address;
+        this->_port = _port;
+        tcp_new.state = this->_UnixConnect(unix_type, unix_size);
+        tcp_new.sock = this->_socket;
+        if (this->_socket < 0 && _throw)
+            throw std::runtime_error(__self__::_ErrorMsgCombine("Sock open error"));
+        return tcp_new;
+    }
+    // numeric addresses are parsed in place, names come from the resolver cache
+    TcpInitializer::IpAddress numeric;
+    std::vector<TcpInitializer::IpAddress> resolved;
+    const TcpInitializer::IpAddress *candidates(&numeric);
+    std::size_t candidate_count(1);
+    int connect_timeout_ms(this->_connect_timeout_ms);
+    if (!TcpInitializer::AddressParser::ParseAddress(_address, numeric)) {
+        if (!__self__::_AddressValidate(_address, _port)) {
+            if (_throw)
+                throw std::runtime_error(__self__::_ErrorMsgCombine("Conn Addr Eval failure"));
+            return tcp_new;
+        }
+        // a cold lookup is part of the connect deadline, what it used is gone for the connect
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        if (!TcpInitializer::Resolver::Global().Resolve(_address, resolved, this->_connect_timeout_ms)) {
+            if (_throw)
+                throw std::runtime_error(__self__::_ErrorMsgCombine("address resolve error"));
+            return tcp_new;
+        }
+        if (connect_timeout_ms >= 0)
+            connect_timeout_ms = static_cast<int>(std::max<int64_t>(0, connect_timeout_ms - static_cast<int64_t>((TcpInitializer::Metrics::Now() - started) / 1000000)));
+        candidates = resolved.data();
+        candidate_count = resolved.size();
+    }
+    this->_ip_address = _address;
+    this->_port = _port;
+    // a name may resolve to both families, its addresses are tried in order until one connects
+    for (std::size_t i = 0; i < candidate_count && !tcp_new.state; ++i) {
+        TcpInitializer::IpAddress target(candidates[i]);
+        target.port = _port;
+        if (this->_socket >= 0 && (this->_tcp_state == TcpState::FAILED || __self__::_SocketFamily(this->_socket) != target.family)) {
+            // a socket whose connect failed cannot be reused portably, start over with a fresh one
+            close(this->_socket);
+            this->_socket = -1;
+        }
+        if (this->_socket < 0) {
+            this->_socket = socket(target.family, SOCK_STREAM, IPPROTO_TCP);
+        }
+        if (this->_socket < 0) {
+            this->_tcp_state = TcpState::NONE;
+            if (_throw)
+                throw std::runtime_error(__self__::_ErrorMsgCombine("Sock open error"));
+            return tcp_new;
+        }
+        tcp_new.sock = this->_socket;
+        this->_tcp_state = TcpState::OPEN;
+        socklen_t address_size(0);
+        if (!TcpInitializer::AddressParser::ToSockAddr(target, this->_sock_address, address_size)) {
+            if (_throw)
+                throw std::runtime_error(__self__::_ErrorMsgCombine("address convert error"));
+            return tcp_new;
+        }
+        if (connect_timeout_ms >= 0) {
+            tcp_new.state = __self__::ConnectWithin(this->_socket, &this->_sock_address.addr, address_size, connect_timeout_ms);
+        } else {
+            const t_u64 started(TcpInitializer::Metrics::Now());
+            TcpInitializer::Metrics::connects.Add();
+            tcp_new.state = connect(this->_socket, &this->_sock_address.addr, address_size) == 0;
+            if (tcp_new.state)
+                TcpInitializer::Metrics::connect_latency.Record(TcpInitializer::Metrics::Now() - started);
+            else
+                TcpInitializer::Metrics::connect_failures.Add();
+        }
+        this->_tcp_state = tcp_new.state ? TcpState::CONNECTED : TcpState::FAILED;
+    }
+    return tcp_new;
+};
+
+/**
+ * @brief Sends data over the connection.
+ *
+ * @param _buffer The buffer to send over the TCP connection.
+ * @returns true if the buffer was sent successfully, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::Send(const t_strw _buffer) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!__self__::Send(&this->_socket, _buffer))
+        return false;
+    this->_bytes_sent += _buffer.length();
+    return true;
+};
+
+/**
+ * @brief Sends several buffers over the connection in gathered writes.
+ *
+ * @param _buffers The buffers to send, in order.
+ * @param _count The number of buffers.
+ * @returns true if every buffer was sent successfully, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::Send(const t_strw *_buffers, const std::size_t _count) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!__self__::Send(&this->_socket, _buffers, _count))
+        return false;
+    for (std::size_t i = 0; i < _count; ++i) {
+        this->_bytes_sent += _buffers[i].length();
+    }
+    return true;
+};
+
+/**
+ * @brief Streams a region of a file over the connection with sendfile().
+ *
+ * @param _file_fd The open file to read from, its file offset is left untouched.
+ * @param _offset The first byte of the region.
+ * @param _count The number of bytes to send.
+ * @returns true if the whole region was sent, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::SendFile(const int _file_fd, const off_t _offset, const std::size_t _count) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!__self__::SendFile(&this->_socket, _file_fd, _offset, _count))
+        return false;
+    this->_bytes_sent += _count;
+    return true;
+};
+
+/**
+ * @brief Reads one block of incoming data from the connection.
+ *
+ * @returns A TcpIntercept object containing the intercepted TCP request.
+ * @throws std::invalid_argument If the connection is not connected.
+ */
+TcpInitializer::TcpIntercept TcpInitializer::TcpConnection::Read(void) {
+    TcpInitializer::TcpIntercept tcp_request;
+    t_sock sock;
+    t_u64 buffer_max;
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->_tcp_state != TcpState::CONNECTED || this->_socket < 0)
+            throw std::invalid_argument("invalid socket state");
+        sock = this->_socket;
+        buffer_max = this->_buffer_max;
+    }
+    __self__::_ReadFrom(sock, buffer_max, tcp_request);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_bytes_received += tcp_request.block_size;
+    return tcp_request;
+};
+
+/**
+ * @brief Reads one block of incoming data and stores the payload in the provided string reference.
+ *
+ * @param sink_frame Reference to the string used to store the result of the socket read operation.
+ */
+void TcpInitializer::TcpConnection::Read(t_str &sink_frame) {
+    TcpInitializer::TcpIntercept tcp_request(this->Read());
+    sink_frame = tcp_request.block_size > 0 ? tcp_request.raw_bytes : "";
+};
+
+/**
+ * @brief Reads one block of incoming data into a pooled buffer without copying it.
+ *
+ * @param dest_view Reference to the view receiving the pooled block and the exact byte count.
+ * @returns true if at least one byte was read, false on end of stream or error.
+ * @throws std::invalid_argument If the connection is not connected.
+ */
+bool TcpInitializer::TcpConnection::Read(TcpInitializer::TcpInterceptView &dest_view) {
+    t_sock sock;
+    t_u64 buffer_max;
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->_tcp_state != TcpState::CONNECTED || this->_socket < 0)
+            throw std::invalid_argument("invalid socket state");
+        sock = this->_socket;
+        buffer_max = this->_buffer_max;
+    }
+    __self__::_ReadFrom(sock, buffer_max, dest_view);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_bytes_received += dest_view.block_size;
+    return dest_view.block_size > 0;
+};
+
+/**
+ * @brief Reads one block of incoming data and returns it as a string.
+ *
+ * @returns A string containing the received socket data.
+ */
+const t_str TcpInitializer::TcpConnection::Read2Str(void) {
+    return this->Read().raw_bytes;
+};
+
+/**
+ * @brief Checks if the connection is established.
+ *
+ * @returns true if the connection is connected, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::IsConnected(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_tcp_state == TcpState::CONNECTED && this->_socket >= 0;
+};
+
+/**
+ * @brief Gets the connection state.
+ *
+ * @returns The current TcpState.
+ */
+TcpInitializer::TcpState TcpInitializer::TcpConnection::GetState(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_tcp_state;
+};
+
+/**
+ * @brief Gets the number of bytes sent over this connection.
+ *
+ * @returns The byte count.
+ */
+t_u64 TcpInitializer::TcpConnection::GetBytesSent(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_bytes_sent;
+};
+
+/**
+ * @brief Gets the number of bytes received over this connection.
+ *
+ * @returns The byte count.
+ */
+t_u64 TcpInitializer::TcpConnection::GetBytesReceived(void) const noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_bytes_received;
+};
+
+/**
+ * @brief Gets the pointer to the connection socket.
+ *
+ * @returns A pointer to the connection socket.
+ */
+t_sock *TcpInitializer::TcpConnection::GetSocket(void) noexcept {
+    return &this->_socket;
+};
+
+/**
+ * @brief Sets the maximum number of bytes returned by a single Read.
+ *
+ * @param _size The read buffer size, zero is ignored.
+ */
+void TcpInitializer::TcpConnection::SetBufferSize(const t_u64 _size) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (_size > 0)
+        this->_buffer_max = _size;
+};
+
+/**
+ * @brief Bounds the duration of later Connect calls.
+ *
+ * @param _timeout_ms Connect deadline in milliseconds, a negative value restores the blocking connect without deadline.
+ */
+void TcpInitializer::TcpConnection::SetConnectTimeout(const int _timeout_ms) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_connect_timeout_ms = _timeout_ms;
+};
+
+/**
+ * @brief Takes ownership of an open socket, closing the one previously held.
+ *
+ * @param _sock The socket to attach, connected or not.
+ */
+void TcpInitializer::TcpConnection::Attach(const t_sock _sock) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (this->_socket >= 0 && this->_socket != _sock)
+        close(this->_socket);
+    this->_socket = _sock;
+    TcpInitializer::PeerAddress peer_address;
+    socklen_t addr_len(sizeof(peer_address));
+    if (_sock < 0)
+        this->_tcp_state = TcpState::NONE;
+    else if (getpeername(_sock, &peer_address.addr, &addr_len) == 0)
+        this->_tcp_state = TcpState::CONNECTED;
+    else
+        this->_tcp_state = TcpState::OPEN;
+};
+
+/**
+ * @brief Detaches the socket from the connection without closing it.
+ *
+ * @returns The detached socket, or -1 if the connection had none.
+ */
+t_sock TcpInitializer::TcpConnection::Release(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    const t_sock sock(this->_socket);
+    this->_socket = -1;
+    this->_tcp_state = TcpState::NONE;
+    return sock;
+};
+
+/**
+ * @brief Closes the connection socket and resets the connection state.
+ */
+void TcpInitializer::TcpConnection::Close(void) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = -1;
+    this->_tcp_state = TcpState::NONE;
+};
+
+/**
+ * @brief Connects a fresh Unix domain socket to the parsed _sock_address, the lock must be held.
+ *
+ * The previous socket is closed whatever its state: one opened for TCP cannot reach a local peer.
+ *
+ * @param _type SOCK_STREAM or SOCK_SEQPACKET.
+ * @param _size The size of the address in _sock_address.
+ * @returns true if connected, false otherwise.
+ */
+bool TcpInitializer::TcpConnection::_UnixConnect(const int _type, const socklen_t _size) {
+    if (this->_socket >= 0)
+        close(this->_socket);
+    this->_socket = socket(AF_UNIX, _type, 0);
+    if (this->_socket < 0) {
+        this->_tcp_state = TcpState::NONE;
+        return false;
+    }
+    this->_tcp_state = TcpState::OPEN;
+    bool connected(false);
+    if (this->_connect_timeout_ms >= 0) {
+        connected = __self__::ConnectWithin(this->_socket, &this->_sock_address.addr, _size, this->_connect_timeout_ms);
+    } else {
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        TcpInitializer::Metrics::connects.Add();
+        connected = connect(this->_socket, &this->_sock_address.addr, _size) == 0;
+        if (connected)
+            TcpInitializer::Metrics::connect_latency.Record(TcpInitializer::Metrics::Now() - started);
+        else
+            TcpInitializer::Metrics::connect_failures.Add();
+    }
+    this->_tcp_state = connected ? TcpState::CONNECTED : TcpState::FAILED;
+    return connected;
+};
+
+/**
+ * @brief Constructs an empty handle.
+ */
+TcpInitializer::PooledBuffer::PooledBuffer(void) noexcept : _block(nullptr) {};
+
+/**
+ * @brief Takes the first reference of a freshly acquired block.
+ *
+ * @param _block The block, its reference count must already account for this handle.
+ */
+TcpInitializer::PooledBuffer::PooledBuffer(BufferBlock *_block) noexcept : _block(_block) {};
+
+/**
+ * @brief Shares the block of another handle.
+ *
+ * @param _other The handle to share.
+ */
+TcpInitializer::PooledBuffer::PooledBuffer(const PooledBuffer &_other) noexcept : _block(_other._block) {
+    if (this->_block != nullptr)
+        this->_block->refs.fetch_add(1, std::memory_order_relaxed);
+};
+
+/**
+ * @brief Steals the block of another handle.
+ *
+ * @param _other The handle to steal from, left empty.
+ */
+TcpInitializer::PooledBuffer::PooledBuffer(PooledBuffer &&_other) noexcept : _block(_other._block) {
+    _other._block = nullptr;
+};
+
+/**
+ * @brief Shares the block of another handle, dropping the current one.
+ *
+ * @param _other The handle to share.
+ * @returns A reference to this handle.
+ */
+TcpInitializer::PooledBuffer &TcpInitializer::PooledBuffer::operator=(const PooledBuffer &_other) noexcept {
+    if (this->_block != _other._block) {
+        this->Reset();
+        this->_block = _other._block;
+        if (this->_block != nullptr)
+            this->_block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return *this;
+};
+
+/**
+ * @brief Steals the block of another handle, dropping the current one.
+ *
+ * @param _other The handle to steal from, left empty.
+ * @returns A reference to this handle.
+ */
+TcpInitializer::PooledBuffer &TcpInitializer::PooledBuffer::operator=(PooledBuffer &&_other) noexcept {
+    if (this != &_other) {
+        this->Reset();
+        this->_block = _other._block;
+        _other._block = nullptr;
+    }
+    return *this;
+};
+
+/**
+ * @brief Drops the reference, returning the block to its pool if it was the last one.
+ */
+TcpInitializer::PooledBuffer::~PooledBuffer() {
+    this->Reset();
+};
+
+/**
+ * @brief Gets the writable block memory.
+ *
+ * @returns A pointer to the block data, or nullptr for an empty handle.
+ */
+char *TcpInitializer::PooledBuffer::Data(void) noexcept {
+    return this->_block != nullptr ? this->_block->data() : nullptr;
+};
+
+/**
+ * @brief Gets the block memory.
+ *
+ * @returns A pointer to the block data, or nullptr for an empty handle.
+ */
+const char *TcpInitializer::PooledBuffer::Data(void) const noexcept {
+    return this->_block != nullptr ? this->_block->data() : nullptr;
+};
+
+/**
+ * @brief Gets the block capacity.
+ *
+ * @returns The number of usable bytes, 0 for an empty handle.
+ */
+t_u32 TcpInitializer::PooledBuffer::Capacity(void) const noexcept {
+    return this->_block != nullptr ? this->_block->capacity : 0;
+};
+
+/**
+ * @brief Checks whether the handle refers to a block.
+ *
+ * @returns true if the handle is empty, false otherwise.
+ */
+bool TcpInitializer::PooledBuffer::Empty(void) const noexcept {
+    return this->_block == nullptr;
+};
+
+/**
+ * @brief Gets the number of handles sharing the block.
+ *
+ * @returns The reference count, 0 for an empty handle.
+ */
+t_u32 TcpInitializer::PooledBuffer::UseCount(void) const noexcept {
+    return this->_block != nullptr ? this->_block->refs.load(std::memory_order_relaxed) : 0;
+};
+
+/**
+ * @brief Drops the reference held by this handle.
+ */
+void TcpInitializer::PooledBuffer::Reset(void) noexcept {
+    if (this->_block != nullptr && this->_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        this->_block->pool->_Release(this->_block);
+    this->_block = nullptr;
+};
+
+/**
+ * @brief Creates an empty pool owned by the calling thread, slabs are allocated on demand.
+ *
+ * @param _block_size Usable bytes per block.
+ * @param _slab_blocks Number of blocks carved from each slab.
+ */
+TcpInitializer::BufferPool::BufferPool(const t_u32 _block_size, const t_u32 _slab_blocks)
+    : _block_size(_block_size > 0 ? _block_size : DEFAULT_BUFFER_MAX_SIZE), _slab_blocks(_slab_blocks > 0 ? _slab_blocks : DEFAULT_POOL_SLAB_BLOCKS), _stride(0), _slabs(), _free(nullptr),
+      _remote_free(nullptr), _owner_refs(1), _owner(std::this_thread::get_id()) {
+    this->_stride = (sizeof(BufferBlock) + this->_block_size + alignof(BufferBlock) - 1) / alignof(BufferBlock) * alignof(BufferBlock);
+};
+
+/**
+ * @brief Frees every slab, outstanding handles must not outlive an explicitly created pool.
+ */
+TcpInitializer::BufferPool::~BufferPool() {
+    for (void *slab : this->_slabs)
+        std::free(slab);
+};
+
+/**
+ * @brief Takes a block from the pool, must be called from the owner thread.
+ *
+ * @returns A handle holding the only reference to the block.
+ * @throws std::bad_alloc If a new slab cannot be allocated.
+ */
+TcpInitializer::PooledBuffer TcpInitializer::BufferPool::Acquire(void) {
+    if (this->_free == nullptr)
+        this->_free = this->_remote_free.exchange(nullptr, std::memory_order_acquire);
+    if (this->_free == nullptr)
+        this->_Grow();
+    BufferBlock *block(this->_free);
+    this->_free = block->next;
+    block->next = nullptr;
+    block->refs.store(1, std::memory_order_relaxed);
+    this->_owner_refs.fetch_add(1, std::memory_order_relaxed);
+    return PooledBuffer(block);
+};
+
+/**
+ * @brief Gets the usable size of each block.
+ *
+ * @returns The block size in bytes.
+ */
+t_u32 TcpInitializer::BufferPool::GetBlockSize(void) const noexcept {
+    return this->_block_size;
+};
+
+/**
+ * @brief Gets the number of slabs allocated so far.
+ *
+ * @returns The slab count.
+ */
+t_u64 TcpInitializer::BufferPool::GetSlabCount(void) const noexcept {
+    return this->_slabs.size();
+};
+
+/**
+ * @brief Gets the pool of the calling thread, created on first use.
+ *
+ * The pool outlives its thread as long as buffers acquired from it are still referenced elsewhere.
+ *
+ * @returns A reference to the thread pool.
+ */
+TcpInitializer::BufferPool &TcpInitializer::BufferPool::Local(void) noexcept {
+    thread_local struct LocalPool
+    {
+        BufferPool *pool{new BufferPool()};
+        ~LocalPool()
+        {
+            pool->_Retire();
+        };
+    } local_pool;
+    return *local_pool.pool;
+};
+
+/**
+ * @brief Allocates one slab and threads its blocks onto the free list.
+ *
+ * @throws std::bad_alloc If the slab cannot be allocated.
+ */
+void TcpInitializer::BufferPool::_Grow(void) {
+    void *slab(std::aligned_alloc(alignof(BufferBlock), this->_stride * this->_slab_blocks));
+    if (slab == nullptr)
+        throw std::bad_alloc();
+    this->_slabs.push_back(slab);
+    char *cursor(static_cast<char *>(slab));
+    for (t_u32 i = 0; i < this->_slab_blocks; ++i, cursor += this->_stride) {
+        BufferBlock *block(new (cursor) BufferBlock());
+        block->capacity = this->_block_size;
+        block->pool = this;
+        block->next = this->_free;
+        this->_free = block;
+    }
+};
+
+/**
+ * @brief Returns a block whose last handle was dropped.
+ *
+ * @param _block The released block.
+ */
+void TcpInitializer::BufferPool::_Release(BufferBlock *_block) noexcept {
+    if (std::this_thread::get_id() == this->_owner) {
+        _block->next = this->_free;
+        this->_free = _block;
+    } else {
+        BufferBlock *head(this->_remote_free.load(std::memory_order_relaxed));
+        do {
+            _block->next = head;
+        } while (!this->_remote_free.compare_exchange_weak(head, _block, std::memory_order_release, std::memory_order_relaxed));
+    }
+    this->_Unref();
+};
+
+/**
+ * @brief Drops the owner reference of a thread pool when its thread exits.
+ */
+void TcpInitializer::BufferPool::_Retire(void) noexcept {
+    // blocks still referenced elsewhere keep the pool alive, the last one to come back deletes it
+    this->_Unref();
+};
+
+/**
+ * @brief Drops one reference held by the owner or an outstanding block, deleting a retired pool with the last one.
+ */
+void TcpInitializer::BufferPool::_Unref(void) noexcept {
+    if (this->_owner_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+};
+
+/**
+ * @brief Gets the metric slot of the calling thread, claimed on first use.
+ *
+ * @returns The slot, METRICS_MAX_THREADS for the shared overflow slot.
+ */
+t_u32 TcpInitializer::MetricSlot::Current(void) noexcept {
+    thread_local struct LocalSlot
+    {
+        t_u32 slot{MetricSlot::_Claim()};
+        ~LocalSlot()
+        {
+            MetricSlot::_Return(slot);
+        };
+    } local_slot;
+    return local_slot.slot;
+};
+
+/**
+ * @brief Claims a free slot for a new thread.
+ *
+ * @returns A slot no other live thread owns, or METRICS_MAX_THREADS if all are taken.
+ */
+t_u32 TcpInitializer::MetricSlot::_Claim(void) noexcept {
+    std::lock_guard<std::mutex> lock(MetricSlot::_mtx);
+    if (!MetricSlot::_free.empty()) {
+        const t_u32 slot(MetricSlot::_free.back());
+        MetricSlot::_free.pop_back();
+        return slot;
+    }
+    return MetricSlot::_next < METRICS_MAX_THREADS ? MetricSlot::_next++ : METRICS_MAX_THREADS;
+};
+
+/**
+ * @brief Hands the slot of an exiting thread to the next new thread, its shards keep their values.
+ *
+ * @param _slot The slot.
+ */
+void TcpInitializer::MetricSlot::_Return(const t_u32 _slot) noexcept {
+    if (_slot >= METRICS_MAX_THREADS)
+        return;
+    std::lock_guard<std::mutex> lock(MetricSlot::_mtx);
+    MetricSlot::_free.push_back(_slot);
+};
+
+/**
+ * @brief Creates a zero counter, shards are allocated by the threads that update it.
+ */
+TcpInitializer::MetricCounter::MetricCounter(void) noexcept : _cells(), _used(0), _shared() {
+    for (std::atomic<Cell *> &cell : this->_cells) {
+        cell.store(nullptr, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Frees the shards.
+ */
+TcpInitializer::MetricCounter::~MetricCounter() {
+    for (std::atomic<Cell *> &cell : this->_cells) {
+        delete cell.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Adds to the shard of the calling thread.
+ *
+ * @param _delta The amount to add.
+ */
+void TcpInitializer::MetricCounter::Add(const t_u64 _delta) noexcept {
+    bool exclusive(false);
+    Cell *cell(this->_Local(exclusive));
+    // a slot has one writer at a time, so a plain load and store replaces the locked add
+    if (exclusive)
+        cell->value.store(cell->value.load(std::memory_order_relaxed) + _delta, std::memory_order_relaxed);
+    else
+        cell->value.fetch_add(_delta, std::memory_order_relaxed);
+};
+
+/**
+ * @brief Subtracts from the shard of the calling thread, shards wrap and only their sum matters.
+ *
+ * @param _delta The amount to subtract.
+ */
+void TcpInitializer::MetricCounter::Sub(const t_u64 _delta) noexcept {
+    this->Add(static_cast<t_u64>(0) - _delta);
+};
+
+/**
+ * @brief Sums the shards.
+ *
+ * @returns The counter value.
+ */
+t_u64 TcpInitializer::MetricCounter::Get(void) const noexcept {
+    t_u64 total(this->_shared.value.load(std::memory_order_relaxed));
+    const t_u32 used(this->_used.load(std::memory_order_acquire));
+    for (t_u32 slot = 0; slot < used; ++slot) {
+        const Cell *cell(this->_cells[slot].load(std::memory_order_acquire));
+        if (cell != nullptr)
+            total += cell->value.load(std::memory_order_relaxed);
+    }
+    return total;
+};
+
+/**
+ * @brief Sums the shards of a gauge, which may be transiently negative while updates race the read.
+ *
+ * @returns The gauge value.
+ */
+int64_t TcpInitializer::MetricCounter::GetSigned(void) const noexcept {
+    return static_cast<int64_t>(this->Get());
+};
+
+/**
+ * @brief Gets the shard of the calling thread, allocating it on first use.
+ *
+ * @param _exclusive Set to true if the calling thread is the only writer of the shard.
+ * @returns The shard.
+ */
+TcpInitializer::MetricCounter::Cell *TcpInitializer::MetricCounter::_Local(bool &_exclusive) noexcept {
+    const t_u32 slot(MetricSlot::Current());
+    _exclusive = false;
+    if (slot >= METRICS_MAX_THREADS)
+        return &this->_shared;
+    Cell *cell(this->_cells[slot].load(std::memory_order_acquire));
+    if (cell == nullptr) {
+        cell = new (std::nothrow) Cell();
+        if (cell == nullptr)
+            return &this->_shared;
+        this->_cells[slot].store(cell, std::memory_order_release);
+        t_u32 used(this->_used.load(std::memory_order_relaxed));
+        while (used <= slot && !this->_used.compare_exchange_weak(used, slot + 1, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    _exclusive = true;
+    return cell;
+};
+
+/**
+ * @brief Creates an empty histogram, shards are allocated by the threads that record into it.
+ */
+TcpInitializer::LatencyHistogram::LatencyHistogram(void) noexcept : _shards(), _used(0), _shared() {
+    for (std::atomic<Shard *> &shard : this->_shards) {
+        shard.store(nullptr, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Frees the shards.
+ */
+TcpInitializer::LatencyHistogram::~LatencyHistogram() {
+    for (std::atomic<Shard *> &shard : this->_shards) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Records one sample into the shard of the calling thread.
+ *
+ * @param _value_ns The latency in nanoseconds.
+ */
+void TcpInitializer::LatencyHistogram::Record(const t_u64 _value_ns) noexcept {
+    bool exclusive(false);
+    Shard *shard(this->_Local(exclusive));
+    std::atomic<t_u64> &bucket(shard->buckets[LatencyHistogram::_BucketOf(_value_ns)]);
+    if (exclusive) {
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        shard->count.store(shard->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        shard->sum.store(shard->sum.load(std::memory_order_relaxed) + _value_ns, std::memory_order_relaxed);
+        if (_value_ns > shard->max.load(std::memory_order_relaxed))
+            shard->max.store(_value_ns, std::memory_order_relaxed);
+        return;
+    }
+    bucket.fetch_add(1, std::memory_order_relaxed);
+    shard->count.fetch_add(1, std::memory_order_relaxed);
+    shard->sum.fetch_add(_value_ns, std::memory_order_relaxed);
+    t_u64 max(shard->max.load(std::memory_order_relaxed));
+    while (_value_ns > max && !shard->max.compare_exchange_weak(max, _value_ns, std::memory_order_relaxed)) {
+    }
+};
+
+/**
+ * @brief Merges the shards into one snapshot.
+ *
+ * @returns The aggregated counts.
+ */
+TcpInitializer::HistogramSnapshot TcpInitializer::LatencyHistogram::GetSnapshot(void) const {
+    HistogramSnapshot snapshot;
+    snapshot.buckets.assign(HISTOGRAM_BUCKET_COUNT, 0);
+    const auto merge = [&snapshot](const Shard &_shard) -> void {
+        snapshot.count += _shard.count.load(std::memory_order_relaxed);
+        snapshot.sum += _shard.sum.load(std::memory_order_relaxed);
+        snapshot.max = std::max(snapshot.max, _shard.max.load(std::memory_order_relaxed));
+        for (t_u32 bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT; ++bucket) {
+            snapshot.buckets[bucket] += _shard.buckets[bucket].load(std::memory_order_relaxed);
+        }
+    };
+    merge(this->_shared);
+    const t_u32 used(this->_used.load(std::memory_order_acquire));
+    for (t_u32 slot = 0; slot < used; ++slot) {
+        const Shard *shard(this->_shards[slot].load(std::memory_order_acquire));
+        if (shard != nullptr)
+            merge(*shard);
+    }
+    return snapshot;
+};
+
+/**
+ * @brief Estimates a quantile from a snapshot.
+ *
+ * @param _snapshot The snapshot.
+ * @param _quantile The quantile in [0, 1], e.g. 0.99.
+ * @returns The upper bound of the bucket holding the quantile, capped at the largest sample, 0 if empty.
+ */
+t_u64 TcpInitializer::LatencyHistogram::ValueAt(const HistogramSnapshot &_snapshot, const double _quantile) noexcept {
+    if (_snapshot.count == 0 || _snapshot.buckets.empty())
+        return 0;
+    const double clamped(std::min(1.0, std::max(0.0, _quantile)));
+    const t_u64 rank(std::max<t_u64>(1, static_cast<t_u64>(clamped * static_cast<double>(_snapshot.count) + 0.5)));
+    t_u64 seen(0);
+    for (t_u32 bucket = 0; bucket < _snapshot.buckets.size(); ++bucket) {
+        seen += _snapshot.buckets[bucket];
+        if (seen >= rank)
+            return std::min(LatencyHistogram::_UpperBoundOf(bucket), _snapshot.max);
+    }
+    return _snapshot.max;
+};
+
+/**
+ * @brief Gets the shard of the calling thread, allocating it on first use.
+ *
+ * @param _exclusive Set to true if the calling thread is the only writer of the shard.
+ * @returns The shard.
+ */
+TcpInitializer::LatencyHistogram::Shard *TcpInitializer::LatencyHistogram::_Local(bool &_exclusive) noexcept {
+    const t_u32 slot(MetricSlot::Current());
+    _exclusive = false;
+    if (slot >= METRICS_MAX_THREADS)
+        return &this->_shared;
+    Shard *shard(this->_shards[slot].load(std::memory_order_acquire));
+    if (shard == nullptr) {
+        shard = new (std::nothrow) Shard();
+        if (shard == nullptr)
+            return &this->_shared;
+        this->_shards[slot].store(shard, std::memory_order_release);
+        t_u32 used(this->_used.load(std::memory_order_relaxed));
+        while (used <= slot && !this->_used.compare_exchange_weak(used, slot + 1, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    _exclusive = true;
+    return shard;
+};
+
+/**
+ * @brief Maps a value onto its bucket: values below 2^HISTOGRAM_SUB_BUCKET_BITS get one bucket each,
+ * every larger power of two is split into 2^HISTOGRAM_SUB_BUCKET_BITS equal buckets.
+ *
+ * @param _value The value, clamped below 2^(HISTOGRAM_MAX_EXPONENT + 1).
+ * @returns The bucket index.
+ */
+t_u32 TcpInitializer::LatencyHistogram::_BucketOf(t_u64 _value) noexcept {
+    constexpr t_u64 limit((static_cast<t_u64>(1) << (HISTOGRAM_MAX_EXPONENT + 1)) - 1);
+    if (_value > limit)
+        _value = limit;
+    if (_value < (static_cast<t_u64>(1) << HISTOGRAM_SUB_BUCKET_BITS))
+        return static_cast<t_u32>(_value);
+    const t_u32 exponent(63u - static_cast<t_u32>(__builtin_clzll(_value)));
+    const t_u32 sub_bucket(static_cast<t_u32>(_value >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & ((1u << HISTOGRAM_SUB_BUCKET_BITS) - 1));
+    return ((exponent - HISTOGRAM_SUB_BUCKET_BITS + 1) << HISTOGRAM_SUB_BUCKET_BITS) | sub_bucket;
+};
+
+/**
+ * @brief Gets the largest value a bucket holds.
+ *
+ * @param _bucket The bucket index.
+ * @returns The inclusive upper bound.
+ */
+t_u64 TcpInitializer::LatencyHistogram::_UpperBoundOf(const t_u32 _bucket) noexcept {
+    if (_bucket < (1u << HISTOGRAM_SUB_BUCKET_BITS))
+        return _bucket;
+    const t_u32 exponent((_bucket >> HISTOGRAM_SUB_BUCKET_BITS) + HISTOGRAM_SUB_BUCKET_BITS - 1);
+    const t_u64 sub_bucket(_bucket & ((1u << HISTOGRAM_SUB_BUCKET_BITS) - 1));
+    const t_u32 shift(exponent - HISTOGRAM_SUB_BUCKET_BITS);
+    return ((static_cast<t_u64>(1) << exponent) | (sub_bucket << shift)) + (static_cast<t_u64>(1) << shift) - 1;
+};
+
+/**
+ * @brief Reads the monotonic clock used for latency samples.
+ *
+ * @returns Nanoseconds since an arbitrary epoch.
+ */
+t_u64 TcpInitializer::Metrics::Now(void) noexcept {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<t_u64>(now.tv_sec) * 1000000000ull + static_cast<t_u64>(now.tv_nsec);
+};
+
+/**
+ * @brief Aggregates every metric.
+ *
+ * @returns The current values.
+ */
+TcpInitializer::MetricsSnapshot TcpInitializer::Metrics::Snapshot(void) {
+    MetricsSnapshot snapshot;
+    snapshot.accepted = Metrics::accepted.Get();
+    snapshot.connects = Metrics::connects.Get();
+    snapshot.connect_failures = Metrics::connect_failures.Get();
+    snapshot.bytes_in = Metrics::bytes_in.Get();
+    snapshot.bytes_out = Metrics::bytes_out.Get();
+    snapshot.connections = Metrics::connections.GetSigned();
+    snapshot.sessions = Metrics::sessions.GetSigned();
+    snapshot.queued_bytes = Metrics::queued_bytes.GetSigned();
+    snapshot.read_latency = Metrics::read_latency.GetSnapshot();
+    snapshot.send_latency = Metrics::send_latency.GetSnapshot();
+    snapshot.connect_latency = Metrics::connect_latency.GetSnapshot();
+    return snapshot;
+};
+
+/**
+ * @brief Renders every metric in the Prometheus text exposition format.
+ *
+ * @returns The exposition text.
+ */
+t_str TcpInitializer::Metrics::Dump(void) {
+    const MetricsSnapshot snapshot(Metrics::Snapshot());
+    t_str out;
+    out.reserve(2048);
+    const auto line = [&out](const t_strw _name, const t_strw _type, const t_str &_value) -> void {
+        out.append("# TYPE tcpgateway_").append(_name).append(" ").append(_type).append("\n");
+        out.append("tcpgateway_").append(_name).append(" ").append(_value).append("\n");
+    };
+    line("accepted_total", "counter", std::to_string(snapshot.accepted));
+    line("connects_total", "counter", std::to_string(snapshot.connects));
+    line("connect_failures_total", "counter", std::to_string(snapshot.connect_failures));
+    line("bytes_in_total", "counter", std::to_string(snapshot.bytes_in));
+    line("bytes_out_total", "counter", std::to_string(snapshot.bytes_out));
+    line("connections", "gauge", std::to_string(snapshot.connections));
+    line("sessions", "gauge", std::to_string(snapshot.sessions));
+    line("queued_bytes", "gauge", std::to_string(snapshot.queued_bytes));
+    Metrics::_DumpHistogram(out, "read_latency_ns", snapshot.read_latency);
+    Metrics::_DumpHistogram(out, "send_latency_ns", snapshot.send_latency);
+    Metrics::_DumpHistogram(out, "connect_latency_ns", snapshot.connect_latency);
+    return out;
+};
+
+/**
+ * @brief Renders one histogram as a summary with the usual quantiles.
+ *
+ * @param _out The text to append to.
+ * @param _name The metric name without prefix.
+ * @param _snapshot The histogram snapshot.
+ */
+void TcpInitializer::Metrics::_DumpHistogram(t_str &_out, const t_strw _name, const HistogramSnapshot &_snapshot) {
+    static constexpr const char *quantiles[] = {"0.5", "0.9", "0.99", "0.999"};
+    _out.append("# TYPE tcpgateway_").append(_name).append(" summary\n");
+    for (const char *quantile : quantiles) {
+        _out.append("tcpgateway_").append(_name).append("{quantile=\"").append(quantile).append("\"} ");
+        _out.append(std::to_string(LatencyHistogram::ValueAt(_snapshot, std::strtod(quantile, nullptr)))).append("\n");
+    }
+    _out.append("tcpgateway_").append(_name).append("_sum ").append(std::to_string(_snapshot.sum)).append("\n");
+    _out.append("tcpgateway_").append(_name).append("_count ").append(std::to_string(_snapshot.count)).append("\n");
+};
+
+
+/**
+ * @brief Creates an empty table, chunks are allocated as descriptors are inserted.
+ */
+TcpInitializer::ConnectionTable::ConnectionTable(void)
+    : _chunks(std::make_unique<std::atomic<Slot *>[]>(CONNECTION_TABLE_MAX_FDS / CONNECTION_TABLE_CHUNK)), _count(0), _mtx() {
+    for (t_u32 i = 0; i < CONNECTION_TABLE_MAX_FDS / CONNECTION_TABLE_CHUNK; ++i) {
+        this->_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Frees the chunks, the tracked sockets are left open.
+ */
+TcpInitializer::ConnectionTable::~ConnectionTable() {
+    for (t_u32 i = 0; i < CONNECTION_TABLE_MAX_FDS / CONNECTION_TABLE_CHUNK; ++i) {
+        Slot *slots(this->_chunks[i].load(std::memory_order_relaxed));
+        if (slots == nullptr)
+            continue;
+        for (t_u32 j = 0; j < CONNECTION_TABLE_CHUNK; ++j) {
+            owner_chunk *owner(slots[j].live.load(std::memory_order_relaxed) ? TcpInitializer::ConnectionTable::_OwnerOf(static_cast<t_sock>(i * CONNECTION_TABLE_CHUNK + j), false) : nullptr);
+            ConnectionTable *expected(this);
+            if (owner != nullptr)
+                owner->compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        }
+        delete[] slots;
+    }
+};
+
+/**
+ * @brief Starts tracking a connection.
+ *
+ * A descriptor still marked live was closed without Remove and reused by the kernel: its stale
+ * session is replaced (and its old id invalidated) without counting the descriptor twice.
+ *
+ * @param _sock The connected socket.
+ * @param _peer The peer address as returned by accept, nullptr if unknown.
+ * @param _peer_size The size of _peer.
+ * @returns The session id (never 0), or 0 if the descriptor is out of the table range.
+ */
+TcpInitializer::t_u64 TcpInitializer::ConnectionTable::Insert(const t_sock _sock, const struct sockaddr *_peer, const socklen_t _peer_size) {
+    if (_sock < 0 || static_cast<t_u32>(_sock) >= CONNECTION_TABLE_MAX_FDS)
+        return 0;
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    std::atomic<Slot *> &chunk(this->_chunks[static_cast<t_u32>(_sock) / CONNECTION_TABLE_CHUNK]);
+    if (chunk.load(std::memory_order_relaxed) == nullptr)
+        chunk.store(new Slot[CONNECTION_TABLE_CHUNK], std::memory_order_release);
+    Slot &slot(chunk.load(std::memory_order_relaxed)[static_cast<t_u32>(_sock) % CONNECTION_TABLE_CHUNK]);
+    if (slot.live.load(std::memory_order_relaxed)) {
+        slot.live.store(false, std::memory_order_release);
+        slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    } else {
+        this->_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (slot.generation.load(std::memory_order_relaxed) == 0)
+        slot.generation.store(1, std::memory_order_relaxed);
+    const t_u64 now(TcpInitializer::Metrics::Now());
+    slot.tcp_state = TcpState::CONNECTED;
+    memset(&slot.peer, 0, sizeof(slot.peer));
+    if (_peer != nullptr && _peer_size > 0)
+        memcpy(&slot.peer, _peer, std::min<std::size_t>(_peer_size, sizeof(slot.peer)));
+    slot.opened_ns.store(now, std::memory_order_relaxed);
+    slot.active_ns.store(now, std::memory_order_relaxed);
+    slot.bytes_in.store(0, std::memory_order_relaxed);
+    slot.bytes_out.store(0, std::memory_order_relaxed);
+    slot.buffer.clear();
+    slot.live.store(true, std::memory_order_release);
+    TcpInitializer::ConnectionTable::_OwnerOf(_sock, true)->store(this, std::memory_order_release);
+    return (static_cast<t_u64>(slot.generation.load(std::memory_order_relaxed)) << 32) | static_cast<t_u32>(_sock);
+};
+
+/**
+ * @brief Stops tracking a connection, the socket itself is not closed.
+ *
+ * @param _id The session id.
+ * @returns true if the session was live, false if the id is stale.
+ */
+bool TcpInitializer::ConnectionTable::Remove(const t_u64 _id) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!this->IsLive(_id))
+        return false;
+    Slot &slot(*this->_SlotOf(TcpInitializer::ConnectionTable::SocketOf(_id)));
+    slot.live.store(false, std::memory_order_release);
+    slot.tcp_state = TcpState::NONE;
+    t_str().swap(slot.buffer);
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    this->_count.fetch_sub(1, std::memory_order_relaxed);
+    // the descriptor may already be tracked by another table that accepted its reuse
+    owner_chunk *owner(TcpInitializer::ConnectionTable::_OwnerOf(TcpInitializer::ConnectionTable::SocketOf(_id), false));
+    ConnectionTable *expected(this);
+    if (owner != nullptr)
+        owner->compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    return true;
+};
+
+/**
+ * @brief Gets the id of the live session on a descriptor.
+ *
+ * @param _sock The socket.
+ * @returns The session id, 0 if the descriptor is not tracked.
+ */
+TcpInitializer::t_u64 TcpInitializer::ConnectionTable::IdOf(const t_sock _sock) const noexcept {
+    const Slot *slot(this->_SlotOf(_sock));
+    if (slot == nullptr || !slot->live.load(std::memory_order_acquire))
+        return 0;
+    return (static_cast<t_u64>(slot->generation.load(std::memory_order_acquire)) << 32) | static_cast<t_u32>(_sock);
+};
+
+/**
+ * @brief Checks whether an id still names a live session.
+ *
+ * @param _id The session id.
+ * @returns true if the session is live, false if it was removed (its descriptor may be reused).
+ */
+bool TcpInitializer::ConnectionTable::IsLive(const t_u64 _id) const noexcept {
+    const Slot *slot(this->_SlotOf(TcpInitializer::ConnectionTable::SocketOf(_id)));
+    return slot != nullptr && slot->live.load(std::memory_order_acquire) && slot->generation.load(std::memory_order_acquire) == static_cast<t_u32>(_id >> 32);
+};
+
+/**
+ * @brief Adds transferred bytes to a session and marks it active, a no-op for untracked sockets.
+ *
+ * @param _sock The socket the bytes went through.
+ * @param _bytes_in Bytes received.
+ * @param _bytes_out Bytes sent.
+ */
+void TcpInitializer::ConnectionTable::Account(const t_sock _sock, const t_u64 _bytes_in, const t_u64 _bytes_out) noexcept {
+    Slot *slot(this->_SlotOf(_sock));
+    if (slot == nullptr || !slot->live.load(std::memory_order_relaxed))
+        return;
+    if (_bytes_in > 0)
+        slot->bytes_in.fetch_add(_bytes_in, std::memory_order_relaxed);
+    if (_bytes_out > 0)
+        slot->bytes_out.fetch_add(_bytes_out, std::memory_order_relaxed);
+    slot->active_ns.store(TcpInitializer::Metrics::Now(), std::memory_order_relaxed);
+};
+
+/**
+ * @brief Copies the state of a session.
+ *
+ * @param _id The session id.
+ * @param _session Receives the session state.
+ * @returns true if the session is live, false otherwise.
+ */
+bool TcpInitializer::ConnectionTable::Lookup(const t_u64 _id, Session &_session) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!this->IsLive(_id))
+        return false;
+    const t_sock sock(TcpInitializer::ConnectionTable::SocketOf(_id));
+    this->_Fill(sock, *this->_SlotOf(sock), _session);
+    return true;
+};
+
+/**
+ * @brief Runs a callback on the carry-over buffer of a session, e.g. a partially received frame.
+ *
+ * @param _id The session id.
+ * @param _callback Called with the buffer, under the table lock.
+ * @returns true if the session is live and the callback ran, false otherwise.
+ */
+bool TcpInitializer::ConnectionTable::WithBuffer(const t_u64 _id, const buffer_cb &_callback) {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    if (!_callback || !this->IsLive(_id))
+        return false;
+    _callback(this->_SlotOf(TcpInitializer::ConnectionTable::SocketOf(_id))->buffer);
+    return true;
+};
+
+/**
+ * @brief Copies the state of every live session, e.g. to sweep idle ones.
+ *
+ * @returns The live sessions in descriptor order.
+ */
+std::vector<TcpInitializer::ConnectionTable::Session> TcpInitializer::ConnectionTable::Snapshot(void) const {
+    std::vector<Session> sessions;
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    sessions.reserve(this->_count.load(std::memory_order_relaxed));
+    for (t_u32 chunk = 0; chunk < CONNECTION_TABLE_MAX_FDS / CONNECTION_TABLE_CHUNK && sessions.size() < this->_count.load(std::memory_order_relaxed); ++chunk) {
+        const Slot *slots(this->_chunks[chunk].load(std::memory_order_acquire));
+        if (slots == nullptr)
+            continue;
+        for (t_u32 i = 0; i < CONNECTION_TABLE_CHUNK; ++i) {
+            if (!slots[i].live.load(std::memory_order_relaxed))
+                continue;
+            Session session;
+            this->_Fill(static_cast<t_sock>(chunk * CONNECTION_TABLE_CHUNK + i), slots[i], session);
+            sessions.push_back(session);
+        }
+    }
+    return sessions;
+};
+
+/**
+ * @brief Gets the number of live sessions.
+ *
+ * @returns The live session count.
+ */
+TcpInitializer::t_u64 TcpInitializer::ConnectionTable::GetCount(void) const noexcept {
+    return this->_count.load(std::memory_order_relaxed);
+};
+
+/**
+ * @brief Gets the descriptor named by a session id.
+ *
+ * @param _id The session id.
+ * @returns The socket.
+ */
+t_sock TcpInitializer::ConnectionTable::SocketOf(const t_u64 _id) noexcept {
+    return static_cast<t_sock>(_id & 0x7FFFFFFFu);
+};
+
+/**
+ * @brief Adds transferred bytes to the session of a socket in whichever table tracks it, a no-op for untracked sockets.
+ *
+ * @param _sock The socket the bytes went through.
+ * @param _bytes_in Bytes received.
+ * @param _bytes_out Bytes sent.
+ */
+void TcpInitializer::ConnectionTable::AccountOwner(const t_sock _sock, const t_u64 _bytes_in, const t_u64 _bytes_out) noexcept {
+    const owner_chunk *owner(TcpInitializer::ConnectionTable::_OwnerOf(_sock, false));
+    ConnectionTable *table(owner == nullptr ? nullptr : owner->load(std::memory_order_acquire));
+    if (table != nullptr)
+        table->Account(_sock, _bytes_in, _bytes_out);
+};
+
+/**
+ * @brief Gets the owner entry of a descriptor in the process-wide index.
+ *
+ * The index is chunked like the tables; chunks are installed with a compare-and-swap, since
+ * tables insert under their own locks, and live until the process exits.
+ *
+ * @param _sock The socket.
+ * @param _create true to allocate the chunk of the descriptor if it is missing.
+ * @returns The owner entry, nullptr if the descriptor is out of range or its chunk is missing and _create is false.
+ */
+TcpInitializer::ConnectionTable::owner_chunk *TcpInitializer::ConnectionTable::_OwnerOf(const t_sock _sock, const bool _create) {
+    static std::atomic<owner_chunk *> owners[CONNECTION_TABLE_MAX_FDS / CONNECTION_TABLE_CHUNK];
+    if (_sock < 0 || static_cast<t_u32>(_sock) >= CONNECTION_TABLE_MAX_FDS)
+        return nullptr;
+    std::atomic<owner_chunk *> &chunk(owners[static_cast<t_u32>(_sock) / CONNECTION_TABLE_CHUNK]);
+    owner_chunk *entries(chunk.load(std::memory_order_acquire));
+    if (entries == nullptr) {
+        if (!_create)
+            return nullptr;
+        owner_chunk *created(new owner_chunk[CONNECTION_TABLE_CHUNK]);
+        for (t_u32 i = 0; i < CONNECTION_TABLE_CHUNK; ++i)
+            created[i].store(nullptr, std::memory_order_relaxed);
+        if (chunk.compare_exchange_strong(entries, created, std::memory_order_acq_rel))
+            entries = created;
+        else
+            delete[] created;
+    }
+    return &entries[static_cast<t_u32>(_sock) % CONNECTION_TABLE_CHUNK];
+};
+
+/**
+ * @brief Gets the slot of a descriptor without allocating.
+ *
+ * @param _sock The socket.
+ * @returns The slot, nullptr if its chunk was never allocated or the descriptor is out of range.
+ */
+TcpInitializer::ConnectionTable::Slot *TcpInitializer::ConnectionTable::_SlotOf(const t_sock _sock) const noexcept {
+    if (_sock < 0 || static_cast<t_u32>(_sock) >= CONNECTION_TABLE_MAX_FDS)
+        return nullptr;
+    Slot *slots(this->_chunks[static_cast<t_u32>(_sock) / CONNECTION_TABLE_CHUNK].load(std::memory_order_acquire));
+    return slots == nullptr ? nullptr : &slots[static_cast<t_u32>(_sock) % CONNECTION_TABLE_CHUNK];
+};
+
+/**
+ * @brief Copies a slot into a session record, the table lock must be held.
+ *
+ * @param _sock The descriptor of the slot.
+ * @param _slot The slot.
+ * @param _session Receives the session state.
+ */
+void TcpInitializer::ConnectionTable::_Fill(const t_sock _sock, const Slot &_slot, Session &_session) const {
+    _session.id = (static_cast<t_u64>(_slot.generation.load(std::memory_order_relaxed)) << 32) | static_cast<t_u32>(_sock);
+    _session.sock = _sock;
+    _session.tcp_state = _slot.tcp_state;
+    _session.peer = _slot.peer;
+    _session.opened_ns = _slot.opened_ns.load(std::memory_order_relaxed);
+    _session.active_ns = _slot.active_ns.load(std::memory_order_relaxed);
+    _session.bytes_in = _slot.bytes_in.load(std::memory_order_relaxed);
+    _session.bytes_out = _slot.bytes_out.load(std::memory_order_relaxed);
+    _session.buffered = _slot.buffer.size();
+};
+
+/**
+ * @brief Converts an address into a socket address.
+ *
+ * @param _address The address, its port is used.
+ * @param _sock_address Set to the sockaddr_in or sockaddr_in6.
+ * @param _size Set to the size of the socket address.
+ * @returns true if the address has a known family, false otherwise.
+ */
+bool TcpInitializer::AddressParser::ToSockAddr(const IpAddress &_address, PeerAddress &_sock_address, socklen_t &_size) noexcept {
+    memset(&_sock_address, 0, sizeof(_sock_address));
+    if (_address.family == AF_INET) {
+        _sock_address.v4.sin_family = AF_INET;
+        _sock_address.v4.sin_port = htons(_address.port);
+        memcpy(&_sock_address.v4.sin_addr, _address.bytes, 4);
+        _size = sizeof(struct sockaddr_in);
+        return true;
+    }
+    if (_address.family == AF_INET6) {
+        _sock_address.v6.sin6_family = AF_INET6;
+        _sock_address.v6.sin6_port = htons(_address.port);
+        _sock_address.v6.sin6_scope_id = _address.scope_id;
+        memcpy(&_sock_address.v6.sin6_addr, _address.bytes, 16);
+        _size = sizeof(struct sockaddr_in6);
+        return true;
+    }
+    return false;
+};
+
+/**
+ * @brief Converts a socket address into an address.
+ *
+ * @param _sock_address The sockaddr_in or sockaddr_in6.
+ * @param _address Set to the address and port.
+ * @returns true if the socket address is IPv4 or IPv6, false otherwise.
+ */
+bool TcpInitializer::AddressParser::FromSockAddr(const struct sockaddr *_sock_address, IpAddress &_address) noexcept {
+    if (_sock_address == nullptr)
+        return false;
+    _address = IpAddress{};
+    if (_sock_address->sa_family == AF_INET) {
+        const struct sockaddr_in *v4(reinterpret_cast<const struct sockaddr_in *>(_sock_address));
+        _address.family = AF_INET;
+        _address.port = ntohs(v4->sin_port);
+        memcpy(_address.bytes, &v4->sin_addr, 4);
+        return true;
+    }
+    if (_sock_address->sa_family == AF_INET6) {
+        const struct sockaddr_in6 *v6(reinterpret_cast<const struct sockaddr_in6 *>(_sock_address));
+        _address.family = AF_INET6;
+        _address.port = ntohs(v6->sin6_port);
+        _address.scope_id = v6->sin6_scope_id;
+        memcpy(_address.bytes, &v6->sin6_addr, 16);
+        return true;
+    }
+    return false;
+};
+
+/**
+ * @brief Formats an address as text, without its port.
+ *
+ * @param _address The address.
+ * @returns The dotted or colon-hex text with "%scope" if set, empty for an unknown family.
+ */
+TcpInitializer::t_str TcpInitializer::AddressParser::ToString(const IpAddress &_address) {
+    char text[INET6_ADDRSTRLEN];
+    if ((_address.family != AF_INET && _address.family != AF_INET6) || inet_ntop(_address.family, _address.bytes, text, sizeof(text)) == nullptr)
+        return t_str();
+    t_str out(text);
+    if (_address.family == AF_INET6 && _address.scope_id != 0)
+        out.append("%").append(std::to_string(_address.scope_id));
+    return out;
+};
+
+/**
+ * @brief Parses a Unix domain socket address.
+ *
+ * @param _text "unix:PATH" for a stream socket or "unixpacket:PATH" for a seqpacket one; a PATH
+ * starting with '@' names an abstract socket, which has no file and vanishes with its last user.
+ * @param _sock_address Set to the sockaddr_un.
+ * @param _size Set to the length to pass to bind or connect.
+ * @param _type Set to SOCK_STREAM or SOCK_SEQPACKET.
+ * @returns true if the address is valid and its path fits sun_path, false otherwise.
+ */
+bool TcpInitializer::AddressParser::ParseUnix(const t_strw _text, PeerAddress &_sock_address, socklen_t &_size, int &_type) noexcept {
+    t_strw path;
+    int type(SOCK_STREAM);
+    if (_text.substr(0, sizeof(UNIX_PACKET_SCHEME) - 1) == UNIX_PACKET_SCHEME) {
+        path = _text.substr(sizeof(UNIX_PACKET_SCHEME) - 1);
+        type = SOCK_SEQPACKET;
+    } else if (_text.substr(0, sizeof(UNIX_STREAM_SCHEME) - 1) == UNIX_STREAM_SCHEME) {
+        path = _text.substr(sizeof(UNIX_STREAM_SCHEME) - 1);
+    } else {
+        return false;
+    }
+    const bool abstract(!path.empty() && path.front() == '@');
+    // a file path keeps its terminating NUL inside sun_path, an abstract name is sized by length
+    if (path.size() < (abstract ? 2u : 1u) || path.size() > sizeof(_sock_address.un.sun_path) - 1 || path.find('\0') != t_strw::npos)
+        return false;
+    memset(&_sock_address, 0, sizeof(_sock_address));
+    _sock_address.un.sun_family = AF_UNIX;
+    memcpy(_sock_address.un.sun_path, path.data(), path.size());
+    if (abstract)
+        _sock_address.un.sun_path[0] = '\0';
+    _size = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size() + (abstract ? 0 : 1));
+    _type = type;
+    return true;
+};
+
+/**
+ * @brief Starts the lookup threads.
+ *
+ * @param _threads Number of concurrent lookups, at least one.
+ * @throws std::system_error If a thread cannot be started.
+ */
+TcpInitializer::Resolver::Resolver(const t_u32 _threads)
+    : _cache(), _queue(), _threads(), _ttl_ms(DEFAULT_RESOLVER_TTL_MS), _fail_ttl_ms(DEFAULT_RESOLVER_FAIL_TTL_MS), _running(true), _mtx(), _queue_cv(), _done_cv() {
+    const t_u32 count(_threads > 0 ? _threads : 1);
+    this->_threads.reserve(count);
+    try {
+        for (t_u32 i = 0; i < count; ++i) {
+            this->_threads.emplace_back(&TcpInitializer::Resolver::_Run, this);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(this->_mtx);
+            this->_running = false;
+        }
+        this->_queue_cv.notify_all();
+        for (std::thread &thread : this->_threads) {
+            thread.join();
+        }
+        throw;
+    }
+};
+
+/**
+ * @brief Stops the lookup threads; queued lookups are dropped and their callers get no address.
+ */
+TcpInitializer::Resolver::~Resolver() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_running = false;
+    }
+    this->_queue_cv.notify_all();
+    for (std::thread &thread : this->_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+    this->_threads.clear();
+    std::vector<resolve_cb> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_queue.clear();
+        for (std::pair<const t_str, Entry> &item : this->_cache) {
+            if (!item.second.pending)
+                continue;
+            item.second.pending = false;
+            for (resolve_cb &callback : item.second.callbacks) {
+                callbacks.emplace_back(std::move(callback));
+            }
+            item.second.callbacks.clear();
+        }
+    }
+    this->_done_cv.notify_all();
+    const std::vector<IpAddress> none;
+    for (resolve_cb &callback : callbacks) {
+        callback(none);
+    }
+};
+
+/**
+ * @brief Resolves a host name, waiting only if the cache has never held an answer for it.
+ *
+ * @param _host The host name.
+ * @param _addresses Set to the addresses, in getaddrinfo preference order.
+ * @param _timeout_ms How long a cold lookup may be waited for, a negative value waits without limit.
+ * @returns true if at least one address is known, false otherwise (errno ETIMEDOUT or EHOSTUNREACH).
+ */
+bool TcpInitializer::Resolver::Resolve(const t_strw _host, std::vector<IpAddress> &_addresses, const int _timeout_ms) {
+    const t_str host(_host);
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    Entry &entry(this->_cache[host]);
+    if (!entry.resolved || TcpInitializer::Metrics::Now() >= entry.expires_ns)
+        this->_Request(host, entry);
+    if (!entry.resolved || (entry.addresses.empty() && entry.pending)) {
+        // the entry cannot be erased by Clear while a caller waits on it
+        ++entry.waiting;
+        const auto done([&entry]() -> bool { return !entry.pending; });
+        if (_timeout_ms < 0)
+            this->_done_cv.wait(lock, done);
+        else
+            this->_done_cv.wait_for(lock, std::chrono::milliseconds(_timeout_ms), done);
+        --entry.waiting;
+        if (entry.pending && entry.addresses.empty()) {
+            errno = ETIMEDOUT;
+            return false;
+        }
+    }
+    if (entry.addresses.empty()) {
+        errno = EHOSTUNREACH;
+        return false;
+    }
+    _addresses = entry.addresses;
+    return true;
+};
+
+/**
+ * @brief Resolves a host name without blocking.
+ *
+ * @param _host The host name.
+ * @param _callback Called with the addresses (empty on failure): inline if the cache answers, otherwise on a resolver thread.
+ * @returns true if the callback ran inline from the cache, false if it waits for a lookup.
+ */
+bool TcpInitializer::Resolver::ResolveAsync(const t_strw _host, resolve_cb _callback) {
+    const t_str host(_host);
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    Entry &entry(this->_cache[host]);
+    if (!entry.resolved || TcpInitializer::Metrics::Now() >= entry.expires_ns)
+        this->_Request(host, entry);
+    if (entry.resolved && (!entry.addresses.empty() || !entry.pending)) {
+        const std::vector<IpAddress> addresses(entry.addresses);
+        lock.unlock();
+        if (_callback)
+            _callback(addresses);
+        return true;
+    }
+    if (_callback)
+        entry.callbacks.emplace_back(std::move(_callback));
+    return false;
+};
+
+/**
+ * @brief Starts a lookup of a host name unless a fresh answer is cached, e.g. for upstreams known at startup.
+ *
+ * @param _host The host name.
+ */
+void TcpInitializer::Resolver::Prefetch(const t_strw _host) {
+    const t_str host(_host);
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    Entry &entry(this->_cache[host]);
+    if (!entry.resolved || TcpInitializer::Metrics::Now() >= entry.expires_ns)
+        this->_Request(host, entry);
+};
+
+/**
+ * @brief Sets how long answers are cached, for lookups completing from now on.
+ *
+ * @param _ttl_ms Lifetime of a successful answer in milliseconds.
+ * @param _fail_ttl_ms Lifetime of a failed lookup in milliseconds.
+ */
+void TcpInitializer::Resolver::SetTtl(const t_u64 _ttl_ms, const t_u64 _fail_ttl_ms) noexcept {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    this->_ttl_ms = _ttl_ms;
+    this->_fail_ttl_ms = _fail_ttl_ms;
+};
+
+/**
+ * @brief Drops every cached answer; names with a lookup in flight are kept until it completes.
+ */
+void TcpInitializer::Resolver::Clear(void) {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    for (std::unordered_map<t_str, Entry>::iterator it = this->_cache.begin(); it != this->_cache.end();) {
+        if (it->second.pending || it->second.waiting > 0)
+            ++it;
+        else
+            it = this->_cache.erase(it);
+    }
+};
+
+/**
+ * @brief Gets the number of cached names.
+ *
+ * @returns The cache size, including names whose first lookup is in flight.
+ */
+TcpInitializer::t_u64 TcpInitializer::Resolver::GetCount(void) const {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    return this->_cache.size();
+};
+
+/**
+ * @brief Gets the process-wide resolver used by Listen and Connect, started on first use.
+ *
+ * @returns The shared resolver.
+ */
+TcpInitializer::Resolver &TcpInitializer::Resolver::Global(void) {
+    static Resolver resolver;
+    return resolver;
+};
+
+/**
+ * @brief Lookup thread body: runs queued lookups until the resolver is destroyed.
+ */
+void TcpInitializer::Resolver::_Run(void) {
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    for (;;) {
+        this->_queue_cv.wait(lock, [this]() { return !this->_queue.empty() || !this->_running; });
+        if (!this->_running)
+            break;
+        const t_str host(std::move(this->_queue.front()));
+        this->_queue.pop_front();
+        lock.unlock();
+        std::vector<IpAddress> addresses;
+        const int error(TcpInitializer::Resolver::_Lookup(host, addresses));
+        lock.lock();
+        Entry &entry(this->_cache[host]);
+        const t_u64 now(TcpInitializer::Metrics::Now());
+        if (error == 0) {
+            entry.addresses = std::move(addresses);
+            entry.expires_ns = now + this->_ttl_ms * 1000000ull;
+        } else {
+            // a failed refresh keeps serving the previous answer, it is retried after the failure TTL
+            entry.expires_ns = now + this->_fail_ttl_ms * 1000000ull;
+        }
+        entry.error = error;
+        entry.resolved = true;
+        entry.pending = false;
+        std::vector<resolve_cb> callbacks(std::move(entry.callbacks));
+        entry.callbacks.clear();
+        const std::vector<IpAddress> answer(callbacks.empty() ? std::vector<IpAddress>() : entry.addresses);
+        lock.unlock();
+        this->_done_cv.notify_all();
+        for (resolve_cb &callback : callbacks) {
+            try {
+                callback(answer);
+            } catch (const std::exception &e) {
+                TcpInitializer::Socket::Log("resolver callback failure: ", e.what(), '\n');
+            } catch (...) {
+                TcpInitializer::Socket::Log("resolver callback failure: unknown exception\n");
+            }
+        }
+        lock.lock();
+    }
+};
+
+/**
+ * @brief Queues a lookup of a name unless one is already in flight, the lock must be held.
+ *
+ * @param _host The host name.
+ * @param _entry Its cache entry.
+ */
+void TcpInitializer::Resolver::_Request(const t_str &_host, Entry &_entry) {
+    if (_entry.pending)
+        return;
+    _entry.pending = true;
+    this->_queue.push_back(_host);
+    this->_queue_cv.notify_one();
+};
+
+/**
+ * @brief Runs getaddrinfo for a host name.
+ *
+ * @param _host The host name.
+ * @param _addresses Receives the stream addresses, duplicates removed.
+ * @returns 0 on success, the getaddrinfo error (EAI_NONAME if no usable address) otherwise.
+ */
+int TcpInitializer::Resolver::_Lookup(const t_str &_host, std::vector<IpAddress> &_addresses) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+    struct addrinfo *results(nullptr);
+    const int error(getaddrinfo(_host.c_str(), nullptr, &hints, &results));
+    if (error != 0)
+        return error;
+    for (const struct addrinfo *result = results; result != nullptr; result = result->ai_next) {
+        IpAddress address;
+        if (!TcpInitializer::AddressParser::FromSockAddr(result->ai_addr, address))
+            continue;
+        address.port = 0;
+        const bool seen(std::any_of(_addresses.begin(), _addresses.end(), [&address](const IpAddress &other) {
+            return other.family == address.family && other.scope_id == address.scope_id && memcmp(other.bytes, address.bytes, sizeof(address.bytes)) == 0;
+        }));
+        if (!seen)
+            _addresses.push_back(address);
+    }
+    freeaddrinfo(results);
+    return _addresses.empty() ? EAI_NONAME : 0;
+};
+
+/**
+ * @brief Starts the flusher thread, output goes to stderr until Open or SetOutput.
+ *
+ * @param _ring_size Bytes of each thread's ring, rounded up to a power of two (at least 4 KiB).
+ * @throws std::system_error If the thread cannot be started.
+ */
+TcpInitializer::Logger::Logger(const t_u32 _ring_size)
+    : _id(TcpInitializer::Logger::_instances.fetch_add(1, std::memory_order_relaxed) + 1), _ring_size(4096), _dropped_retired(0), _level(static_cast<t_u32>(LogLevel::INFO)),
+      _rate_burst(DEFAULT_LOG_RATE_BURST), _rate_window_ns(DEFAULT_LOG_RATE_WINDOW_MS * 1000000ull), _wake_requested(false), _rings(), _draining(), _next_index(0),
+      _fd(STDERR_FILENO), _owns_fd(false), _running(true), _mtx(), _drain_mtx(), _cv(), _thread(), _text(), _batch(), _lines() {
+    while (this->_ring_size < _ring_size) {
+        this->_ring_size <<= 1;
+    }
+    this->_thread = std::thread(&TcpInitializer::Logger::_Run, this);
+};
+
+/**
+ * @brief Writes what is left in the rings and stops the flusher thread.
+ */
+TcpInitializer::Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_running = false;
+    }
+    this->_cv.notify_all();
+    if (this->_thread.joinable())
+        this->_thread.join();
+    if (this->_owns_fd)
+        close(this->_fd);
+};
+
+/**
+ * @brief Appends the log to a file from now on, records already queued included.
+ *
+ * @param _path The file, created if missing.
+ * @returns true if the file was opened, false otherwise (the output is unchanged).
+ */
+bool TcpInitializer::Logger::Open(const t_strw _path) {
+    const t_str path(_path);
+    const int fd(open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644));
+    if (fd < 0)
+        return false;
+    std::lock_guard<std::mutex> lock(this->_drain_mtx);
+    if (this->_owns_fd)
+        close(this->_fd);
+    this->_fd = fd;
+    this->_owns_fd = true;
+    return true;
+};
+
+/**
+ * @brief Writes the log to a descriptor the caller keeps owning, e.g. STDERR_FILENO; -1 discards it.
+ *
+ * @param _fd The output descriptor.
+ */
+void TcpInitializer::Logger::SetOutput(const int _fd) {
+    std::lock_guard<std::mutex> lock(this->_drain_mtx);
+    if (this->_owns_fd)
+        close(this->_fd);
+    this->_fd = _fd;
+    this->_owns_fd = false;
+};
+
+/**
+ * @brief Sets the lowest level written, levels below UNIX_TCP_LOG_MIN_LEVEL stay compiled out.
+ *
+ * @param _level The level, LogLevel::OFF silences the logger.
+ */
+void TcpInitializer::Logger::SetLevel(const LogLevel _level) noexcept {
+    this->_level.store(static_cast<t_u32>(_level), std::memory_order_relaxed);
+};
+
+/**
+ * @brief Checks whether records of a level are currently written.
+ *
+ * @param _level The level.
+ * @returns true if the level passes both the compile-time and the runtime filter, false otherwise.
+ */
+bool TcpInitializer::Logger::IsEnabled(const LogLevel _level) const noexcept {
+    return _level != LogLevel::OFF && static_cast<t_u32>(_level) >= UNIX_TCP_LOG_MIN_LEVEL && static_cast<t_u32>(_level) >= this->_level.load(std::memory_order_relaxed);
+};
+
+/**
+ * @brief Sets how many WARN and ERROR lines with the same first argument a thread may write per window.
+ *
+ * @param _burst Lines let through per window, 0 disables rate limiting.
+ * @param _window_ms Window length in milliseconds.
+ */
+void TcpInitializer::Logger::SetRateLimit(const t_u32 _burst, const t_u32 _window_ms) noexcept {
+    this->_rate_burst.store(_burst, std::memory_order_relaxed);
+    this->_rate_window_ns.store(static_cast<t_u64>(_window_ms) * 1000000ull, std::memory_order_relaxed);
+};
+
+/**
+ * @brief Writes every record committed so far, without waiting for the flusher.
+ */
+void TcpInitializer::Logger::Flush(void) {
+    std::lock_guard<std::mutex> lock(this->_drain_mtx);
+    this->_Drain();
+};
+
+/**
+ * @brief Gets the number of records dropped because a ring was full.
+ *
+ * @returns The dropped record count, over every thread.
+ */
+TcpInitializer::t_u64 TcpInitializer::Logger::GetDropped(void) {
+    std::lock_guard<std::mutex> lock(this->_mtx);
+    t_u64 dropped(this->_dropped_retired);
+    for (const std::shared_ptr<Ring> &ring : this->_rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+};
+
+/**
+ * @brief Gets the process-wide logger behind Socket::Log, started on first use.
+ *
+ * It is never destroyed, so threads and static destructors can log until the process exits;
+ * what is queued at exit is written by an atexit handler.
+ *
+ * @returns The shared logger.
+ */
+TcpInitializer::Logger &TcpInitializer::Logger::Global(void) {
+    static Logger *logger([]() -> Logger * {
+        Logger *created(new Logger());
+        std::atexit([]() { TcpInitializer::Logger::Global().Flush(); });
+        return created;
+    }());
+    return *logger;
+};
+
+/**
+ * @brief Applies the calling thread's rate limit to a WARN or ERROR line.
+ *
+ * @param _level The line level.
+ * @param _key Hash of the line's first argument and level.
+ * @param _suppressed Set to the number of lines with this key suppressed in the window that just ended.
+ * @returns true if the line is written, false if it is suppressed.
+ */
+bool TcpInitializer::Logger::_Admit(const LogLevel _level, const t_u64 _key, t_u32 &_suppressed) noexcept {
+    const t_u32 burst(this->_rate_burst.load(std::memory_order_relaxed));
+    if (burst == 0 || _level < LogLevel::WARN)
+        return true;
+    RateSlot &slot(TcpInitializer::Logger::_Current().rates[_key % LOG_RATE_SLOTS]);
+    const t_u64 now(TcpInitializer::Metrics::Now());
+    if (slot.key != _key || now - slot.window_ns >= this->_rate_window_ns.load(std::memory_order_relaxed)) {
+        // a key evicted by another one sharing its slot loses its suppressed count
+        _suppressed = slot.key == _key ? slot.suppressed : 0;
+        slot.key = _key;
+        slot.window_ns = now;
+        slot.count = 1;
+        slot.suppressed = 0;
+        return true;
+    }
+    if (slot.count < burst) {
+        ++slot.count;
+        return true;
+    }
+    ++slot.suppressed;
+    return false;
+};
+
+/**
+ * @brief Gets the calling thread's ring, registering one with this logger on first use.
+ *
+ * A thread has one ring: writing to another Logger instance moves it to a new ring.
+ *
+ * @returns The ring.
+ * @throws std::bad_alloc If the ring cannot be allocated.
+ */
+TcpInitializer::Logger::Ring *TcpInitializer::Logger::_Ring(void) {
+    Local &local(TcpInitializer::Logger::_Current());
+    if (local.owner == this->_id)
+        return local.ring.get();
+    std::shared_ptr<Ring> ring(std::make_shared<Ring>());
+    ring->capacity = this->_ring_size;
+    ring->data.reset(new char[this->_ring_size]);
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        ring->index = this->_next_index++;
+        this->_rings.push_back(ring);
+    }
+    if (local.ring)
+        local.ring->closed.store(true, std::memory_order_release);
+    local.owner = this->_id;
+    local.ring = std::move(ring);
+    for (RateSlot &slot : local.rates) {
+        slot = RateSlot{};
+    }
+    return local.ring.get();
+};
+
+/**
+ * @brief Reserves contiguous space for a record, wrapping to the start of the ring if needed.
+ *
+ * @param _ring The calling thread's ring.
+ * @param _size The record size.
+ * @returns Where to write the record, nullptr if the ring is full (the record is counted as dropped).
+ */
+char *TcpInitializer::Logger::_Reserve(Ring &_ring, const std::size_t _size) noexcept {
+    const t_u64 need((_size + 7) & ~t_u64(7));
+    t_u64 head(_ring.head.load(std::memory_order_relaxed));
+    const t_u64 offset(head & (_ring.capacity - 1));
+    const t_u64 contiguous(_ring.capacity - offset);
+    const t_u64 total(contiguous < need ? contiguous + need : need);
+    if (need > _ring.capacity / 2 || head + total - _ring.tail_seen > _ring.capacity) {
+        _ring.tail_seen = _ring.tail.load(std::memory_order_acquire);
+        if (need > _ring.capacity / 2 || head + total - _ring.tail_seen > _ring.capacity) {
+            _ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+    if (contiguous < need) {
+        // a zero-size record (or a tail too short for a header) tells the reader to skip to the start
+        if (contiguous >= sizeof(Record)) {
+            const Record marker{};
+            memcpy(_ring.data.get() + offset, &marker, sizeof(Record));
+        }
+        head += contiguous;
+        _ring.head.store(head, std::memory_order_release);
+    }
+    return _ring.data.get() + (head & (_ring.capacity - 1));
+};
+
+/**
+ * @brief Publishes a written record, waking the flusher early if the ring is half full.
+ *
+ * @param _ring The calling thread's ring.
+ * @param _size The record size, a multiple of 8.
+ */
+void TcpInitializer::Logger::_Commit(Ring &_ring, const std::size_t _size) noexcept {
+    const t_u64 head(_ring.head.load(std::memory_order_relaxed) + _size);
+    _ring.head.store(head, std::memory_order_release);
+    if (head - _ring.tail_seen > _ring.capacity / 2) {
+        _ring.tail_seen = _ring.tail.load(std::memory_order_acquire);
+        // a lost notify only delays the flush to the next DEFAULT_LOG_FLUSH_MS tick
+        if (head - _ring.tail_seen > _ring.capacity / 2 && !this->_wake_requested.exchange(true, std::memory_order_relaxed))
+            this->_cv.notify_one();
+    }
+};
+
+/**
+ * @brief Flusher thread body: drains the rings every DEFAULT_LOG_FLUSH_MS or when woken, until the logger is destroyed.
+ */
+void TcpInitializer::Logger::_Run(void) {
+    std::unique_lock<std::mutex> lock(this->_mtx);
+    while (this->_running) {
+        this->_cv.wait_for(lock, std::chrono::milliseconds(DEFAULT_LOG_FLUSH_MS), [this]() {
+            return !this->_running || this->_wake_requested.load(std::memory_order_relaxed);
+        });
+        this->_wake_requested.store(false, std::memory_order_relaxed);
+        lock.unlock();
+        this->Flush();
+        lock.lock();
+    }
+    lock.unlock();
+    this->Flush();
+};
+
+/**
+ * @brief Formats every committed record in timestamp order and writes them in one batch, the drain lock must be held.
+ */
+void TcpInitializer::Logger::_Drain(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_draining.assign(this->_rings.begin(), this->_rings.end());
+    }
+    this->_text.clear();
+    this->_lines.clear();
+    bool retired(false);
+    for (const std::shared_ptr<Ring> &ring : this->_draining) {
+        // closed is read before head: a ring seen closed and then empty gets no more records
+        const bool closed(ring->closed.load(std::memory_order_acquire));
+        const t_u64 head(ring->head.load(std::memory_order_acquire));
+        t_u64 tail(ring->tail.load(std::memory_order_relaxed));
+        while (tail < head) {
+            const t_u64 offset(tail & (ring->capacity - 1));
+            const t_u64 contiguous(ring->capacity - offset);
+            Record record;
+            if (contiguous >= sizeof(Record))
+                memcpy(&record, ring->data.get() + offset, sizeof(Record));
+            if (contiguous < sizeof(Record) || record.size == 0) {
+                tail += contiguous;
+                continue;
+            }
+            this->_Format(*ring, record, ring->data.get() + offset + sizeof(Record));
+            tail += record.size;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        const t_u64 dropped(ring->dropped.load(std::memory_order_relaxed));
+        if (dropped != ring->reported) {
+            const t_u64 now(static_cast<t_u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()));
+            const std::size_t start(this->_text.size());
+            this->_Stamp(now, LogLevel::WARN, ring->index);
+            this->_text.append(std::to_string(dropped - ring->reported)).append(" log records dropped, ring full\n");
+            this->_lines.push_back(Line{now, static_cast<t_u32>(start), static_cast<t_u32>(this->_text.size() - start)});
+            ring->reported = dropped;
+        }
+        retired = retired || (closed && tail == head);
+    }
+    if (retired) {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_rings.erase(std::remove_if(this->_rings.begin(), this->_rings.end(), [this](const std::shared_ptr<Ring> &ring) {
+            const bool done(ring->closed.load(std::memory_order_acquire) && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire));
+            if (done)
+                this->_dropped_retired += ring->dropped.load(std::memory_order_relaxed);
+            return done;
+        }), this->_rings.end());
+    }
+    this->_draining.clear();
+    if (this->_lines.empty())
+        return;
+    std::stable_sort(this->_lines.begin(), this->_lines.end(), [](const Line &a, const Line &b) { return a.ts < b.ts; });
+    this->_batch.clear();
+    for (const Line &line : this->_lines) {
+        this->_batch.append(this->_text, line.offset, line.length);
+    }
+    this->_Emit(this->_batch);
+};
+
+/**
+ * @brief Formats one record as a line of the current batch.
+ *
+ * @param _ring The ring the record was read from.
+ * @param _record The record header.
+ * @param _args The encoded arguments following the header.
+ */
+void TcpInitializer::Logger::_Format(const Ring &_ring, const Record &_record, const char *_args) {
+    const std::size_t start(this->_text.size());
+    this->_Stamp(_record.time_ns, static_cast<LogLevel>(_record.level), _ring.index);
+    char number[32];
+    for (t_u32 i = 0; i < _record.args; ++i) {
+        const char tag(*_args++);
+        if (tag == _ARG_STR) {
+            t_u32 length;
+            memcpy(&length, _args, 4);
+            this->_text.append(_args + 4, length);
+            _args += 4 + length;
+        } else if (tag == _ARG_CHR) {
+            this->_text.push_back(*_args++);
+        } else if (tag == _ARG_I64 || tag == _ARG_U64 || tag == _ARG_PTR) {
+            t_u64 value;
+            memcpy(&value, _args, 8);
+            _args += 8;
+            std::to_chars_result written;
+            if (tag == _ARG_I64) {
+                written = std::to_chars(number, number + sizeof(number), static_cast<int64_t>(value));
+            } else if (tag == _ARG_U64) {
+                written = std::to_chars(number, number + sizeof(number), value);
+            } else {
+                this->_text.append("0x");
+                written = std::to_chars(number, number + sizeof(number), value, 16);
+            }
+            this->_text.append(number, written.ptr);
+        } else if (tag == _ARG_F64) {
+            double value;
+            memcpy(&value, _args, 8);
+            _args += 8;
+            const int length(snprintf(number, sizeof(number), "%g", value));
+            if (length > 0)
+                this->_text.append(number, std::min<std::size_t>(static_cast<std::size_t>(length), sizeof(number) - 1));
+        }
+    }
+    // messages written for the old Log end with '\n', every line gets exactly one
+    while (this->_text.size() > start && this->_text.back() == '\n') {
+        this->_text.pop_back();
+    }
+    this->_text.push_back('\n');
+    this->_lines.push_back(Line{_record.time_ns, static_cast<t_u32>(start), static_cast<t_u32>(this->_text.size() - start)});
+};
+
+/**
+ * @brief Appends the "time level [thread]" prefix of a line.
+ *
+ * @param _time_ns Wall-clock time in nanoseconds since the epoch.
+ * @param _level The line level.
+ * @param _index The ring (thread) index.
+ */
+void TcpInitializer::Logger::_Stamp(const t_u64 _time_ns, const LogLevel _level, const t_u32 _index) {
+    static constexpr const char *names[] = {"TRACE", "VERB ", "INFO ", "WARN ", "ERROR", "OFF  "};
+    const time_t seconds(static_cast<time_t>(_time_ns / 1000000000ull));
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char stamp[80];
+    const int length(snprintf(stamp, sizeof(stamp), "%04d-%02d-%02dT%02d:%02d:%02d.%06uZ %s [%u] ", utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                              static_cast<unsigned>((_time_ns % 1000000000ull) / 1000), names[std::min<t_u32>(static_cast<t_u32>(_level), 5)], _index));
+    if (length > 0)
+        this->_text.append(stamp, std::min<std::size_t>(static_cast<std::size_t>(length), sizeof(stamp) - 1));
+};
+
+/**
+ * @brief Writes a batch to the output, retrying partial writes.
+ *
+ * @param _output The formatted lines.
+ */
+void TcpInitializer::Logger::_Emit(const t_str &_output) noexcept {
+    std::size_t written(0);
+    while (this->_fd >= 0 && written < _output.size()) {
+        const ssize_t sent(write(this->_fd, _output.data() + written, _output.size() - written));
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            break;
+        written += static_cast<std::size_t>(sent);
+    }
+};
+
+/**
+ * @brief Gets the calling thread's ring and rate limiter state.
+ *
+ * @returns The thread's entry, its ring is released (closed) when the thread exits.
+ */
+TcpInitializer::Logger::Local &TcpInitializer::Logger::_Current(void) noexcept {
+    static thread_local Local local;
+    return local;
 };
 
 #endif
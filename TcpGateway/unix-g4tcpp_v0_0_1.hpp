@@ -12,6 +12,8 @@
 // library inclusion
 #include <algorithm>
 #include <cerrno>
+#include <charconv>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <err.h>
@@ -23,7 +25,8 @@
 #include <iostream>
 #include <locale.h>
 #include <memory>
-#include <regex>
+#include <new>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,18 +34,33 @@
 #include <mutex>
 #include <string_view>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unistd.h>
 #include <vector>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
 
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <fcntl.h>
 #include <inttypes.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+// lowest LogLevel compiled in, Logger calls below it are removed at compile time (0 keeps every level)
+#ifndef UNIX_TCP_LOG_MIN_LEVEL
+#define UNIX_TCP_LOG_MIN_LEVEL 0
+#endif
 
 // global version macro identifies library version
 #ifndef UNIX_TCP_INITIALIZER_VERSION
@@ -57,6 +75,7 @@ namespace _t
 
 using t_strw              = std::basic_string_view<char>;
 using t_str               = std::basic_string<char>;
+using t_u8                = std::uint8_t;
 using t_u16               = std::uint16_t;
 using t_u32               = std::uint32_t;
 using t_u64               = std::uint64_t;
@@ -68,12 +87,32 @@ using t_sock              = int;
 
 using namespace _t; // use internally
 
-#define IP_ADDRESS_REGX_ALLOW          t_str("^[0-9.]+$")
 #define DEFAULT_IP_ADDRESS             t_str("127.0.0.1")
 #define DEFAULT_PORT_NUMBER            3300u
 #define DEFAULT_ACCEPT_MAX             100u
 #define DEFAULT_BUFFER_MAX_SIZE        4096u
 #define EXIT_CODE                      "#exit"
+#define DEFAULT_POOL_SLAB_BLOCKS       64u
+#define DEFAULT_SEND_IOV_MAX           64u
+#define DEFAULT_KEEPALIVE_IDLE_S       60u
+#define DEFAULT_KEEPALIVE_INTERVAL_S   10u
+#define DEFAULT_KEEPALIVE_COUNT        6u
+#define CONNECTION_TABLE_CHUNK         1024u
+#define CONNECTION_TABLE_MAX_FDS       (1u << 24)
+#define DEFAULT_RESOLVER_TTL_MS        30000u
+#define DEFAULT_RESOLVER_FAIL_TTL_MS   1000u
+#define DEFAULT_RESOLVER_THREADS       2u
+#define UNIX_STREAM_SCHEME             "unix:"
+#define UNIX_PACKET_SCHEME             "unixpacket:"
+#define DEFAULT_LOG_RING_SIZE          (1u << 16)
+#define DEFAULT_LOG_FLUSH_MS           20u
+#define DEFAULT_LOG_RATE_BURST         20u
+#define DEFAULT_LOG_RATE_WINDOW_MS     1000u
+#define LOG_RATE_SLOTS                 64u
+#define METRICS_MAX_THREADS            256u
+#define HISTOGRAM_SUB_BUCKET_BITS      4u
+#define HISTOGRAM_MAX_EXPONENT         42u
+#define HISTOGRAM_BUCKET_COUNT         ((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BUCKET_BITS + 2u) << HISTOGRAM_SUB_BUCKET_BITS)
 
 
 enum class TcpState
@@ -85,6 +124,16 @@ enum class TcpState
     FAILED
 };
 
+enum class LogLevel : t_u32
+{
+    TRACE = 0,
+    VERBOSE,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
 enum class TcpConnectionType {
   PERSISTENT = 0,
   STATELESS
@@ -113,22 +162,1037 @@ typedef struct alignas(void *)
     bool               state      {                                                    };
 } ClientTcpConnection;
 
+class BufferPool;
+
+typedef struct alignas(64) BufferBlock
+{
+    std::atomic<t_u32> refs       {                                                    };
+    t_u32              capacity   {                                                    };
+    BufferPool        *pool       {                                                    };
+    BufferBlock       *next       {                                                    };
+    char *data() noexcept
+    {
+        return reinterpret_cast<char *>(this) + sizeof(BufferBlock);
+    };
+} BufferBlock;
+
+/**
+ * Ref-counted handle to one block of a BufferPool, the block returns to its pool with the last handle.
+ */
+class PooledBuffer
+{
+  protected:
+    BufferBlock                                          *_block;
+
+  public:
+    __attribute__((hot                                             ))                          PooledBuffer            (void) noexcept;
+    __attribute__((hot                                             ))  explicit                PooledBuffer            (BufferBlock *_block) noexcept;
+    __attribute__((hot                                             ))                          PooledBuffer            (const PooledBuffer &_other) noexcept;
+    __attribute__((hot                                             ))                          PooledBuffer            (PooledBuffer &&_other) noexcept;
+    __attribute__((hot                                             ))  inline               PooledBuffer &operator=         (const PooledBuffer &_other) noexcept;
+    __attribute__((hot                                             ))  inline               PooledBuffer &operator=         (PooledBuffer &&_other) noexcept;
+    __attribute__((hot                                             ))                          ~PooledBuffer           ();
+
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               char*   Data                    (void) noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline const         char*   Data                    (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               t_u32   Capacity                (void) const noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  inline               bool    Empty                   (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u32   UseCount                (void) const noexcept;
+    __attribute__((hot                                             ))  inline               void    Reset                   (void) noexcept;
+};
+
+/**
+ * Slab allocator of fixed-size receive blocks.
+ *
+ * Blocks are carved from slabs of DEFAULT_POOL_SLAB_BLOCKS and recycled through a free list, so
+ * once the pool is warm acquiring a block is a pointer pop. A pool is owned by one thread: only
+ * that thread may Acquire, any thread may drop the last PooledBuffer handle, blocks released
+ * elsewhere go through a lock-free return stack the owner drains when its free list is empty.
+ */
+class BufferPool
+{
+  friend class PooledBuffer;
+  protected:
+    t_u32                                                 _block_size;
+    t_u32                                                 _slab_blocks;
+    std::size_t                                           _stride;
+    std::vector<void *>                                   _slabs;
+    BufferBlock                                          *_free;
+    std::atomic<BufferBlock *>                            _remote_free;
+    std::atomic<t_u64>                                    _owner_refs;
+    std::thread::id                                       _owner;
+
+  public:
+    __attribute__((cold                                            ))  explicit                BufferPool              (const t_u32 _block_size = DEFAULT_BUFFER_MAX_SIZE, const t_u32 _slab_blocks = DEFAULT_POOL_SLAB_BLOCKS);
+    BufferPool(const BufferPool &)            = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+    __attribute__((cold                                            ))                          ~BufferPool             ();
+
+    __attribute__((hot, warn_unused_result                         ))  inline               PooledBuffer Acquire            (void);
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u32   GetBlockSize            (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetSlabCount            (void) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        BufferPool &Local               (void) noexcept;
+
+  protected:
+    __attribute__((cold                                            ))  inline               void    _Grow                   (void);
+    __attribute__((hot                                             ))  inline               void    _Release                (BufferBlock *_block) noexcept;
+    __attribute__((cold                                            ))  inline               void    _Retire                 (void) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Unref                  (void) noexcept;
+};
+
+typedef struct alignas(void *)
+{
+    PooledBuffer       buffer     {                                                    };
+    t_u64              block_size {                                                    };
+    t_strw view() const noexcept
+    {
+        return t_strw(buffer.Data(), block_size);
+    };
+} TcpInterceptView;
+
+/**
+ * Index of the calling thread into per-thread metric arrays.
+ *
+ * Each thread claims a free slot on its first metric update and hands it back when it exits, so
+ * short-lived threads do not exhaust the METRICS_MAX_THREADS slots. Threads beyond the limit share
+ * the overflow slot METRICS_MAX_THREADS, which is updated with atomic read-modify-writes.
+ */
+class MetricSlot
+{
+  protected:
+    static      std::mutex                                _mtx;
+    static      std::vector<t_u32>                        _free;
+    static      t_u32                                     _next;
+
+  public:
+    __attribute__((hot, warn_unused_result                         ))  inline static        t_u32   Current                 (void) noexcept;
+
+  protected:
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_u32   _Claim                  (void) noexcept;
+    __attribute__((cold                                            ))  inline static        void    _Return                 (const t_u32 _slot) noexcept;
+};
+
+/**
+ * Counter sharded per thread: every thread adds to its own cache line with a plain load and
+ * store, so updates never contend, and readers sum the shards. Used as a gauge with Sub, the
+ * shards hold deltas and only their sum is meaningful.
+ */
+class MetricCounter
+{
+  protected:
+    typedef struct alignas(64)
+    {
+        std::atomic<t_u64> value      {                                                    };
+    } Cell;
+
+    std::atomic<Cell *>                                   _cells[METRICS_MAX_THREADS];
+    std::atomic<t_u32>                                    _used;
+    Cell                                                  _shared;
+
+  public:
+    __attribute__((cold                                            ))                          MetricCounter           (void) noexcept;
+    MetricCounter(const MetricCounter &)            = delete;
+    MetricCounter &operator=(const MetricCounter &) = delete;
+    __attribute__((cold                                            ))                          ~MetricCounter          ();
+
+    __attribute__((hot                                             ))  inline               void    Add                     (const t_u64 _delta = 1) noexcept;
+    __attribute__((hot                                             ))  inline               void    Sub                     (const t_u64 _delta = 1) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   Get                     (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               int64_t GetSigned               (void) const noexcept;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               Cell*   _Local                  (bool &_exclusive) noexcept;
+};
+
+typedef struct alignas(void *)
+{
+    t_u64              count      {                                                    };
+    t_u64              sum        {                                                    };
+    t_u64              max        {                                                    };
+    std::vector<t_u64> buckets    {                                                    };
+} HistogramSnapshot;
+
+/**
+ * Log-linear (HDR-style) latency histogram in nanoseconds, sharded per thread like MetricCounter.
+ *
+ * Every power of two is split into 2^HISTOGRAM_SUB_BUCKET_BITS linear buckets, which bounds the
+ * relative error of any reported quantile to about 6% from 1 ns up to 2^HISTOGRAM_MAX_EXPONENT ns
+ * (larger values are clamped). Recording is a bucket lookup and three single-writer stores.
+ */
+class LatencyHistogram
+{
+  protected:
+    typedef struct alignas(64)
+    {
+        std::atomic<t_u64> count      {                                                    };
+        std::atomic<t_u64> sum        {                                                    };
+        std::atomic<t_u64> max        {                                                    };
+        std::atomic<t_u64> buckets[HISTOGRAM_BUCKET_COUNT] {                                };
+    } Shard;
+
+    std::atomic<Shard *>                                  _shards[METRICS_MAX_THREADS];
+    std::atomic<t_u32>                                    _used;
+    Shard                                                 _shared;
+
+  public:
+    __attribute__((cold                                            ))                          LatencyHistogram        (void) noexcept;
+    LatencyHistogram(const LatencyHistogram &)            = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+    __attribute__((cold                                            ))                          ~LatencyHistogram       ();
+
+    __attribute__((hot                                             ))  inline               void    Record                  (const t_u64 _value_ns) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               HistogramSnapshot GetSnapshot   (void) const;
+    __attribute__((cold, pure, warn_unused_result                  ))  inline static        t_u64   ValueAt                 (const HistogramSnapshot &_snapshot, const double _quantile) noexcept;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               Shard*  _Local                  (bool &_exclusive) noexcept;
+    __attribute__((hot, const, warn_unused_result                  ))  inline static        t_u32   _BucketOf               (t_u64 _value) noexcept;
+    __attribute__((cold, const, warn_unused_result                 ))  inline static        t_u64   _UpperBoundOf           (const t_u32 _bucket) noexcept;
+};
+
+typedef struct alignas(void *)
+{
+    t_u64              accepted         {                                              };
+    t_u64              connects         {                                              };
+    t_u64              connect_failures {                                              };
+    t_u64              bytes_in         {                                              };
+    t_u64              bytes_out        {                                              };
+    int64_t            connections      {                                              };
+    int64_t            sessions         {                                              };
+    int64_t            queued_bytes     {                                              };
+    HistogramSnapshot  read_latency     {                                              };
+    HistogramSnapshot  send_latency     {                                              };
+    HistogramSnapshot  connect_latency  {                                              };
+} MetricsSnapshot;
+
+/**
+ * Process-wide metrics updated on the I/O paths of every module.
+ *
+ * Counters: accepted connections, connect attempts and failures, bytes read and written.
+ * Gauges: connections registered with event loops, live proxy sessions, bytes waiting in
+ * outbound queues. Histograms: read and send syscall latency, connect latency. Updates are
+ * per-thread and cheap enough to stay on at full load; Snapshot aggregates on demand and Dump
+ * renders the Prometheus text exposition format.
+ */
+class Metrics
+{
+  public:
+    static      MetricCounter                             accepted;
+    static      MetricCounter                             connects;
+    static      MetricCounter                             connect_failures;
+    static      MetricCounter                             bytes_in;
+    static      MetricCounter                             bytes_out;
+    static      MetricCounter                             connections;
+    static      MetricCounter                             sessions;
+    static      MetricCounter                             queued_bytes;
+    static      LatencyHistogram                          read_latency;
+    static      LatencyHistogram                          send_latency;
+    static      LatencyHistogram                          connect_latency;
+
+    __attribute__((hot, warn_unused_result                         ))  inline static        t_u64   Now                     (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        MetricsSnapshot Snapshot        (void);
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_str   Dump                    (void);
+
+  protected:
+    __attribute__((cold                                            ))  inline static        void    _DumpHistogram          (t_str &_out, const t_strw _name, const HistogramSnapshot &_snapshot);
+};
+
 local_encoding __local_enc;
 
+__attribute__((cold, warn_unused_result                        ))  inline const t_str ErrorMsgCombine(const t_strw _token) noexcept;
+
+typedef union
+{
+    struct sockaddr        addr;
+    struct sockaddr_in     v4;
+    struct sockaddr_in6    v6;
+    struct sockaddr_un     un;
+} PeerAddress;
+
+typedef struct alignas(void *)
+{
+    t_u8               bytes[16]  {                                                    };
+    t_u32              scope_id   {                                                    };
+    t_u16              port       {                                                    };
+    t_u16              family     {                                                    };
+} IpAddress;
+
+typedef struct alignas(void *)
+{
+    IpAddress          address    {                                                    };
+    t_strw             host       {                                                    };
+} Endpoint;
+
+/**
+ * Hand-written parser of numeric addresses and endpoints.
+ *
+ * Accepts dotted IPv4 (no leading zeros, as inet_pton), IPv6 in RFC 4291 text form with "::"
+ * compression, an embedded IPv4 tail and a numeric "%scope", and endpoints written "1.2.3.4:80",
+ * "[::1]:80" or "host.name:80". Parsing only reads the input view and writes the result, it never
+ * allocates, and every parse function is constexpr, so addresses fixed at build time are checked
+ * by the compiler. An IpAddress holds the address in network byte order; its port is host order.
+ * Local peers are written "unix:/run/gw.sock" (stream) or "unixpacket:/run/gw.sock" (seqpacket),
+ * a leading '@' naming a Linux abstract socket; Listen and Connect take them in place of an IP.
+ */
+class AddressParser
+{
+  public:
+    AddressParser() = delete;
+
+    __attribute__((hot, warn_unused_result                         ))  constexpr static     bool    ParseIPv4               (const t_strw _text, IpAddress &_address) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  constexpr static     bool    ParseIPv6               (t_strw _text, IpAddress &_address) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  constexpr static     bool    ParseAddress            (const t_strw _text, IpAddress &_address) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  constexpr static     bool    ParsePort               (const t_strw _text, t_u16 &_port) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  constexpr static     bool    ParseEndpoint           (const t_strw _text, Endpoint &_endpoint) noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  constexpr static     bool    IsHostname              (const t_strw _text) noexcept;
+    __attribute__((hot, pure, warn_unused_result                   ))  constexpr static     bool    IsUnix                  (const t_strw _text) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        bool    ParseUnix               (const t_strw _text, PeerAddress &_sock_address, socklen_t &_size, int &_type) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool    ToSockAddr              (const IpAddress &_address, PeerAddress &_sock_address, socklen_t &_size) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool    FromSockAddr            (const struct sockaddr *_sock_address, IpAddress &_address) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_str   ToString                (const IpAddress &_address);
+
+  protected:
+    __attribute__((hot, const, warn_unused_result                  ))  constexpr static     bool    _IsDigit                (const char _c) noexcept;
+    __attribute__((hot, const, warn_unused_result                  ))  constexpr static     int     _HexValue               (const char _c) noexcept;
+};
+
+/**
+ * @brief Parses a dotted IPv4 address.
+ *
+ * @param _text The address text, e.g. "10.0.0.1".
+ * @param _address Set to the parsed address (family AF_INET, port 0).
+ * @returns true if the text is a complete IPv4 address, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::ParseIPv4(const t_strw _text, IpAddress &_address) noexcept {
+    t_u8 bytes[4]{};
+    std::size_t pos(0);
+    for (t_u32 part = 0; part < 4; ++part) {
+        if (part > 0) {
+            if (pos >= _text.size() || _text[pos] != '.')
+                return false;
+            ++pos;
+        }
+        const std::size_t start(pos);
+        t_u32 value(0);
+        while (pos < _text.size() && pos - start < 3 && _IsDigit(_text[pos])) {
+            value = value * 10 + static_cast<t_u32>(_text[pos] - '0');
+            ++pos;
+        }
+        if (pos == start || value > 255 || (pos - start > 1 && _text[start] == '0'))
+            return false;
+        bytes[part] = static_cast<t_u8>(value);
+    }
+    if (pos != _text.size())
+        return false;
+    _address = IpAddress{};
+    _address.family = AF_INET;
+    for (t_u32 i = 0; i < 4; ++i) {
+        _address.bytes[i] = bytes[i];
+    }
+    return true;
+};
+
+/**
+ * @brief Parses an IPv6 address, with an optional numeric zone ("fe80::1%2").
+ *
+ * @param _text The address text, without brackets.
+ * @param _address Set to the parsed address (family AF_INET6, port 0).
+ * @returns true if the text is a complete IPv6 address, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::ParseIPv6(t_strw _text, IpAddress &_address) noexcept {
+    t_u32 scope_id(0);
+    const std::size_t zone(_text.find('%'));
+    if (zone != t_strw::npos) {
+        const t_strw digits(_text.substr(zone + 1));
+        if (digits.empty() || digits.size() > 10)
+            return false;
+        t_u64 value(0);
+        for (const char c : digits) {
+            if (!_IsDigit(c))
+                return false;
+            value = value * 10 + static_cast<t_u64>(c - '0');
+        }
+        if (value > 0xFFFFFFFFull)
+            return false;
+        scope_id = static_cast<t_u32>(value);
+        _text = _text.substr(0, zone);
+    }
+    t_u8 bytes[16]{};
+    std::size_t filled(0), pos(0);
+    int gap(-1); // byte offset of "::"
+    if (!_text.empty() && _text[0] == ':') {
+        if (_text.size() < 2 || _text[1] != ':')
+            return false;
+        gap = 0;
+        pos = 2;
+    }
+    while (pos < _text.size()) {
+        if (filled >= 16)
+            return false;
+        const std::size_t start(pos);
+        t_u32 value(0);
+        while (pos < _text.size() && pos - start < 4 && _HexValue(_text[pos]) >= 0) {
+            value = (value << 4) | static_cast<t_u32>(_HexValue(_text[pos]));
+            ++pos;
+        }
+        if (pos == start)
+            return false;
+        if (pos < _text.size() && _text[pos] == '.') {
+            // dotted tail ("::ffff:10.0.0.1") takes the last 32 bits
+            IpAddress tail;
+            if (filled > 12 || !ParseIPv4(_text.substr(start), tail))
+                return false;
+            for (t_u32 i = 0; i < 4; ++i) {
+                bytes[filled++] = tail.bytes[i];
+            }
+            break;
+        }
+        bytes[filled++] = static_cast<t_u8>(value >> 8);
+        bytes[filled++] = static_cast<t_u8>(value & 0xFF);
+        if (pos == _text.size())
+            break;
+        if (_text[pos] != ':')
+            return false;
+        if (++pos == _text.size())
+            return false;
+        if (_text[pos] == ':') {
+            if (gap >= 0)
+                return false;
+            gap = static_cast<int>(filled);
+            ++pos;
+        }
+    }
+    if (gap < 0 ? filled != 16 : filled == 16)
+        return false;
+    _address = IpAddress{};
+    _address.family = AF_INET6;
+    _address.scope_id = scope_id;
+    // the groups after "::" are right-aligned, the gap between stays zero
+    const std::size_t head(gap < 0 ? 16 : static_cast<std::size_t>(gap));
+    for (std::size_t i = 0; i < filled; ++i) {
+        _address.bytes[i < head ? i : i + 16 - filled] = bytes[i];
+    }
+    return true;
+};
+
+/**
+ * @brief Parses an IPv4 or IPv6 address.
+ *
+ * @param _text The address text.
+ * @param _address Set to the parsed address.
+ * @returns true if the text is a numeric address of either family, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::ParseAddress(const t_strw _text, IpAddress &_address) noexcept {
+    if (_text.find(':') != t_strw::npos)
+        return ParseIPv6(_text, _address);
+    return ParseIPv4(_text, _address);
+};
+
+/**
+ * @brief Parses a decimal port number.
+ *
+ * @param _text The port text, 1 to 5 digits.
+ * @param _port Set to the parsed port.
+ * @returns true if the text is a port in [0, 65535], false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::ParsePort(const t_strw _text, t_u16 &_port) noexcept {
+    if (_text.empty() || _text.size() > 5)
+        return false;
+    t_u32 value(0);
+    for (const char c : _text) {
+        if (!_IsDigit(c))
+            return false;
+        value = value * 10 + static_cast<t_u32>(c - '0');
+    }
+    if (value > 0xFFFF)
+        return false;
+    _port = static_cast<t_u16>(value);
+    return true;
+};
+
+/**
+ * @brief Parses "address:port", "[ipv6]:port" or "host:port"; the port is optional.
+ *
+ * A bare IPv6 address (more than one colon, no brackets) is read as an address without port.
+ *
+ * @param _text The endpoint text.
+ * @param _endpoint Set to the parsed endpoint: a numeric address, or host viewing into _text with family AF_UNSPEC.
+ * @returns true if the text is a valid endpoint, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::ParseEndpoint(const t_strw _text, Endpoint &_endpoint) noexcept {
+    t_strw host(_text);
+    t_u16 port(0);
+    if (!_text.empty() && _text[0] == '[') {
+        const std::size_t close(_text.find(']'));
+        if (close == t_strw::npos)
+            return false;
+        const t_strw rest(_text.substr(close + 1));
+        if (!rest.empty() && (rest[0] != ':' || !ParsePort(rest.substr(1), port)))
+            return false;
+        if (!ParseIPv6(_text.substr(1, close - 1), _endpoint.address))
+            return false;
+        _endpoint.address.port = port;
+        _endpoint.host = t_strw();
+        return true;
+    }
+    const std::size_t colon(_text.rfind(':'));
+    if (colon != t_strw::npos && _text.find(':') == colon) {
+        if (!ParsePort(_text.substr(colon + 1), port))
+            return false;
+        host = _text.substr(0, colon);
+    }
+    if (ParseAddress(host, _endpoint.address)) {
+        _endpoint.host = t_strw();
+    } else if (IsHostname(host)) {
+        _endpoint.address = IpAddress{};
+        _endpoint.host = host;
+    } else {
+        return false;
+    }
+    _endpoint.address.port = port;
+    return true;
+};
+
+/**
+ * @brief Checks a DNS host name: labels of letters, digits, '-' and '_', the last one not all digits.
+ *
+ * @param _text The name, optionally ending with the root '.'.
+ * @returns true if the text can be handed to the resolver, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::IsHostname(const t_strw _text) noexcept {
+    const t_strw name(!_text.empty() && _text.back() == '.' ? _text.substr(0, _text.size() - 1) : _text);
+    if (name.empty() || name.size() > 253)
+        return false;
+    std::size_t label(0);
+    bool numeric(true);
+    for (std::size_t i = 0; i < name.size(); ++i) {
+        const char c(name[i]);
+        if (c == '.') {
+            if (label == 0 || name[i - 1] == '-')
+                return false;
+            label = 0;
+            numeric = true;
+            continue;
+        }
+        const bool alpha((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_');
+        if (!alpha && !_IsDigit(c) && (c != '-' || label == 0))
+            return false;
+        if (++label > 63)
+            return false;
+        numeric = numeric && _IsDigit(c);
+    }
+    // an all-numeric last label would be taken by getaddrinfo as a legacy inet_aton address
+    return label > 0 && name.back() != '-' && !numeric;
+};
+
+/**
+ * @brief Checks whether an address names a Unix domain socket.
+ *
+ * @param _text The address.
+ * @returns true if the text starts with UNIX_STREAM_SCHEME or UNIX_PACKET_SCHEME, false otherwise.
+ */
+constexpr bool TcpInitializer::AddressParser::IsUnix(const t_strw _text) noexcept {
+    return _text.substr(0, t_strw(UNIX_STREAM_SCHEME).size()) == UNIX_STREAM_SCHEME || _text.substr(0, t_strw(UNIX_PACKET_SCHEME).size()) == UNIX_PACKET_SCHEME;
+};
+
+constexpr bool TcpInitializer::AddressParser::_IsDigit(const char _c) noexcept {
+    return _c >= '0' && _c <= '9';
+};
+
+constexpr int TcpInitializer::AddressParser::_HexValue(const char _c) noexcept {
+    if (_c >= '0' && _c <= '9')
+        return _c - '0';
+    if (_c >= 'a' && _c <= 'f')
+        return _c - 'a' + 10;
+    if (_c >= 'A' && _c <= 'F')
+        return _c - 'A' + 10;
+    return -1;
+};
+
+/**
+ * Asynchronous host name resolver with a TTL'd cache of getaddrinfo results.
+ *
+ * Lookups run on DEFAULT_RESOLVER_THREADS background threads, one lookup per name at a time
+ * however many callers ask for it. A cached answer is served for DEFAULT_RESOLVER_TTL_MS
+ * (getaddrinfo does not report record TTLs), failures for DEFAULT_RESOLVER_FAIL_TTL_MS. An
+ * expired answer is still served while it is refreshed in the background, and kept if the
+ * refresh fails, so once a name is warm Connect never waits on DNS. Resolve blocks only on a
+ * cold miss; ResolveAsync never blocks, its callback runs on a resolver thread.
+ */
+class Resolver
+{
+  public:
+    using resolve_cb = std::function<void(const std::vector<IpAddress> &)>;
+
+  protected:
+    typedef struct alignas(void *)
+    {
+        std::vector<IpAddress>  addresses {                                                 };
+        std::vector<resolve_cb> callbacks {                                                 };
+        t_u64              expires_ns  {                                                    };
+        t_u32              waiting     {                                                    };
+        int                error       {                                                    };
+        bool               resolved    {                                                    };
+        bool               pending     {                                                    };
+    } Entry;
+
+    std::unordered_map<t_str, Entry>                      _cache;
+    std::deque<t_str>                                     _queue;
+    std::vector<std::thread>                              _threads;
+    t_u64                                                 _ttl_ms;
+    t_u64                                                 _fail_ttl_ms;
+    bool                                                  _running;
+    mutable std::mutex                                    _mtx;
+    std::condition_variable                               _queue_cv;
+    std::condition_variable                               _done_cv;
+
+  public:
+    __attribute__((cold                                            ))  explicit                Resolver                (const t_u32 _threads = DEFAULT_RESOLVER_THREADS);
+    Resolver(const Resolver &)            = delete;
+    Resolver &operator=(const Resolver &) = delete;
+    __attribute__((cold                                            ))                          ~Resolver               ();
+
+    __attribute__((hot                                             ))  inline               bool    Resolve                 (const t_strw _host, std::vector<IpAddress> &_addresses, const int _timeout_ms = -1);
+    __attribute__((hot                                             ))  inline               bool    ResolveAsync            (const t_strw _host, resolve_cb _callback);
+    __attribute__((cold                                            ))  inline               void    Prefetch                (const t_strw _host);
+    __attribute__((cold                                            ))  inline               void    SetTtl                  (const t_u64 _ttl_ms, const t_u64 _fail_ttl_ms) noexcept;
+    __attribute__((cold                                            ))  inline               void    Clear                   (void);
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetCount                (void) const;
+    __attribute__((hot, warn_unused_result                         ))  inline static        Resolver &Global                (void);
+
+  protected:
+    __attribute__((cold                                            ))  inline               void    _Run                    (void);
+    __attribute__((hot                                             ))  inline               void    _Request                (const t_str &_host, Entry &_entry);
+    __attribute__((cold                                            ))  inline static        int     _Lookup                 (const t_str &_host, std::vector<IpAddress> &_addresses);
+};
+
+/**
+ * Dense table of live connections indexed by descriptor.
+ *
+ * Slots live in chunks of CONNECTION_TABLE_CHUNK that are allocated on first use and never move,
+ * so looking up a descriptor is two loads without a lock. A connection is named by an id holding
+ * its descriptor and the generation of its slot; the generation changes on every Remove, so an
+ * id kept past the close of its connection never matches the connection that reuses the
+ * descriptor. Insert and Remove are serialised by one mutex and keep the live count exact, which
+ * is what admission limits are checked against. Byte counters and the activity timestamp are
+ * updated lock-free from the I/O paths; the carry-over buffer is accessed under the lock.
+ *
+ * Every table that inserts a descriptor registers itself as its owner in one process-wide index,
+ * so the I/O paths (Socket, EventLoop back-ends, OutboundQueue, TcpProxy, ...) account their bytes
+ * with AccountOwner into whichever table tracks the socket, whatever listener accepted it. A table
+ * must outlive the I/O on the descriptors it tracks.
+ */
+class ConnectionTable
+{
+  public:
+    typedef struct alignas(void *)
+    {
+        t_u64              id          {                                                    };
+        t_sock             sock        { -1                                                 };
+        TcpState           tcp_state   { TcpState::NONE                                     };
+        PeerAddress        peer        {                                                    };
+        t_u64              opened_ns   {                                                    };
+        t_u64              active_ns   {                                                    };
+        t_u64              bytes_in    {                                                    };
+        t_u64              bytes_out   {                                                    };
+        t_u64              buffered    {                                                    };
+    } Session;
+
+    using buffer_cb  = std::function<void(t_str &)>;
+
+  protected:
+    typedef struct alignas(64)
+    {
+        std::atomic<t_u32> generation  { 1                                                  };
+        std::atomic<bool>  live        { false                                              };
+        TcpState           tcp_state   { TcpState::NONE                                     };
+        PeerAddress        peer        {                                                    };
+        std::atomic<t_u64> opened_ns   { 0                                                  };
+        std::atomic<t_u64> active_ns   { 0                                                  };
+        std::atomic<t_u64> bytes_in    { 0                                                  };
+        std::atomic<t_u64> bytes_out   { 0                                                  };
+        t_str              buffer      {                                                    };
+    } Slot;
+
+    using owner_chunk = std::atomic<ConnectionTable *>;
+
+    std::unique_ptr<std::atomic<Slot *>[]>                _chunks;
+    std::atomic<t_u64>                                    _count;
+    mutable std::mutex                                    _mtx;
+
+  public:
+    __attribute__((cold                                            ))                          ConnectionTable         (void);
+    ConnectionTable(const ConnectionTable &)            = delete;
+    ConnectionTable &operator=(const ConnectionTable &) = delete;
+    __attribute__((cold                                            ))                          ~ConnectionTable        ();
+
+    __attribute__((hot                                             ))  inline               t_u64   Insert                  (const t_sock _sock, const struct sockaddr *_peer = nullptr, const socklen_t _peer_size = 0);
+    __attribute__((hot                                             ))  inline               bool    Remove                  (const t_u64 _id) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   IdOf                    (const t_sock _sock) const noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsLive                  (const t_u64 _id) const noexcept;
+    __attribute__((hot                                             ))  inline               void    Account                 (const t_sock _sock, const t_u64 _bytes_in, const t_u64 _bytes_out) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               bool    Lookup                  (const t_u64 _id, Session &_session) const;
+    __attribute__((hot                                             ))  inline               bool    WithBuffer              (const t_u64 _id, const buffer_cb &_callback);
+    __attribute__((cold, warn_unused_result                        ))  inline               std::vector<Session> Snapshot   (void) const;
+    __attribute__((hot, warn_unused_result                         ))  inline               t_u64   GetCount                (void) const noexcept;
+    __attribute__((hot, const, warn_unused_result                  ))  inline static        t_sock  SocketOf                (const t_u64 _id) noexcept;
+    __attribute__((hot                                             ))  inline static        void    AccountOwner            (const t_sock _sock, const t_u64 _bytes_in, const t_u64 _bytes_out) noexcept;
+
+  protected:
+    __attribute__((hot, warn_unused_result                         ))  inline               Slot*   _SlotOf                 (const t_sock _sock) const noexcept;
+    __attribute__((cold                                            ))  inline               void    _Fill                   (const t_sock _sock, const Slot &_slot, Session &_session) const;
+    __attribute__((hot, warn_unused_result                         ))  inline static        owner_chunk* _OwnerOf           (const t_sock _sock, const bool _create);
+};
+
+/**
+ * Asynchronous logger: the calling thread only copies its arguments, a background thread formats and writes them.
+ *
+ * Every thread writes binary records (a header and the tagged arguments, strings copied) into its
+ * own single-producer single-consumer ring, so logging takes no lock and never makes a syscall;
+ * when a ring is full the record is dropped and counted. The flusher thread drains the rings every
+ * DEFAULT_LOG_FLUSH_MS, or sooner when a ring is half full, formats the records in timestamp order
+ * and writes the batch to the output (stderr or a file) in one call. Levels below
+ * UNIX_TCP_LOG_MIN_LEVEL are compiled out, the others are filtered at runtime with SetLevel.
+ * WARN and ERROR lines are rate limited per thread and message (keyed by the first argument):
+ * beyond DEFAULT_LOG_RATE_BURST lines per DEFAULT_LOG_RATE_WINDOW_MS the repeats are counted, and
+ * the count is logged with the next line let through.
+ */
+class Logger
+{
+  protected:
+    typedef struct alignas(void *)
+    {
+        t_u32              size        {                                                    };
+        t_u16              level       {                                                    };
+        t_u16              args        {                                                    };
+        t_u64              time_ns     {                                                    };
+    } Record;
+
+    typedef struct alignas(64)
+    {
+        std::atomic<t_u64>      head      { 0                                               };
+        t_u64                   tail_seen { 0                                               };
+        alignas(64) std::atomic<t_u64> tail { 0                                             };
+        std::atomic<t_u64>      dropped   { 0                                               };
+        std::atomic<bool>       closed    { false                                           };
+        t_u64                   reported  { 0                                               };
+        t_u32                   index     {                                                 };
+        t_u64                   capacity  {                                                 };
+        std::unique_ptr<char[]> data      {                                                 };
+    } Ring;
+
+    typedef struct alignas(void *)
+    {
+        t_u64              key         {                                                    };
+        t_u64              window_ns   {                                                    };
+        t_u32              count       {                                                    };
+        t_u32              suppressed  {                                                    };
+    } RateSlot;
+
+    typedef struct alignas(void *)
+    {
+        t_u64              ts          {                                                    };
+        t_u32              offset      {                                                    };
+        t_u32              length      {                                                    };
+    } Line;
+
+    struct Local
+    {
+        t_u64                   owner     {                                                 };
+        std::shared_ptr<Ring>   ring      {                                                 };
+        RateSlot                rates[LOG_RATE_SLOTS] {                                     };
+        ~Local()
+        {
+            if (ring)
+                ring->closed.store(true, std::memory_order_release);
+        };
+    };
+
+    enum : char
+    {
+        _ARG_STR = 1,
+        _ARG_I64,
+        _ARG_U64,
+        _ARG_F64,
+        _ARG_CHR,
+        _ARG_PTR
+    };
+
+    static      std::atomic<t_u64>                        _instances;
+    const t_u64                                           _id;
+    t_u64                                                 _ring_size;
+    t_u64                                                 _dropped_retired;
+    std::atomic<t_u32>                                    _level;
+    std::atomic<t_u32>                                    _rate_burst;
+    std::atomic<t_u64>                                    _rate_window_ns;
+    std::atomic<bool>                                     _wake_requested;
+    std::vector<std::shared_ptr<Ring>>                    _rings;
+    std::vector<std::shared_ptr<Ring>>                    _draining;
+    t_u32                                                 _next_index;
+    int                                                   _fd;
+    bool                                                  _owns_fd;
+    bool                                                  _running;
+    std::mutex                                            _mtx;
+    std::mutex                                            _drain_mtx;
+    std::condition_variable                               _cv;
+    std::thread                                           _thread;
+    t_str                                                 _text;
+    t_str                                                 _batch;
+    std::vector<Line>                                     _lines;
+
+  public:
+    __attribute__((cold                                            ))  explicit                Logger                  (const t_u32 _ring_size = DEFAULT_LOG_RING_SIZE);
+    Logger(const Logger &)            = delete;
+    Logger &operator=(const Logger &) = delete;
+    __attribute__((cold                                            ))                          ~Logger                 ();
+
+    template <LogLevel Level, typename... MT>
+    __attribute__((hot                                             ))  inline               void    Write                   (const MT &..._msgs) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline static        void    Trace                   (const MT &..._msgs) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline static        void    Verbose                 (const MT &..._msgs) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline static        void    Info                    (const MT &..._msgs) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline static        void    Warn                    (const MT &..._msgs) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline static        void    Error                   (const MT &..._msgs) noexcept;
+    __attribute__((cold                                            ))  inline               bool    Open                    (const t_strw _path);
+    __attribute__((cold                                            ))  inline               void    SetOutput               (const int _fd);
+    __attribute__((cold                                            ))  inline               void    SetLevel                (const LogLevel _level) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    IsEnabled               (const LogLevel _level) const noexcept;
+    __attribute__((cold                                            ))  inline               void    SetRateLimit            (const t_u32 _burst, const t_u32 _window_ms) noexcept;
+    __attribute__((cold                                            ))  inline               void    Flush                   (void);
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetDropped              (void);
+    __attribute__((hot, warn_unused_result                         ))  inline static        Logger &Global                  (void);
+
+  protected:
+    template <typename T>
+    __attribute__((hot, warn_unused_result                         ))  inline static        decltype(auto) _Lower           (const T &_msg);
+    template <typename T>
+    __attribute__((hot, warn_unused_result                         ))  inline static        std::size_t _SizeOf             (const T &_msg) noexcept;
+    template <typename T>
+    __attribute__((hot                                             ))  inline static        void    _Encode                 (char *&_out, const T &_msg) noexcept;
+    template <typename T>
+    __attribute__((hot, warn_unused_result                         ))  inline static        t_u64   _KeyOf                  (const T &_msg) noexcept;
+    template <typename... MT>
+    __attribute__((hot                                             ))  inline               void    _Append                 (const LogLevel _level, const MT &..._msgs);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    _Admit                  (const LogLevel _level, const t_u64 _key, t_u32 &_suppressed) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               Ring*   _Ring                   (void);
+    __attribute__((hot, warn_unused_result                         ))  inline               char*   _Reserve                (Ring &_ring, const std::size_t _size) noexcept;
+    __attribute__((hot                                             ))  inline               void    _Commit                 (Ring &_ring, const std::size_t _size) noexcept;
+    __attribute__((cold                                            ))  inline               void    _Run                    (void);
+    __attribute__((cold                                            ))  inline               void    _Drain                  (void);
+    __attribute__((cold                                            ))  inline               void    _Format                 (const Ring &_ring, const Record &_record, const char *_args);
+    __attribute__((cold                                            ))  inline               void    _Stamp                  (const t_u64 _time_ns, const LogLevel _level, const t_u32 _index);
+    __attribute__((cold                                            ))  inline               void    _Emit                   (const t_str &_output) noexcept;
+    __attribute__((hot                                             ))  inline static        Local  &_Current                (void) noexcept;
+};
+
+/**
+ * @brief Logs a record at a compile-time level, copying the arguments into the calling thread's ring.
+ *
+ * @tparam Level The level, calls below UNIX_TCP_LOG_MIN_LEVEL compile to nothing.
+ * @param _msgs The message parts: strings, characters, numbers, pointers; other types are formatted with operator<< first.
+ */
+template <TcpInitializer::LogLevel Level, typename... MT>
+void TcpInitializer::Logger::Write(const MT &..._msgs) noexcept {
+    if constexpr (static_cast<t_u32>(Level) < UNIX_TCP_LOG_MIN_LEVEL || Level == LogLevel::OFF) {
+        return;
+    } else {
+        if (!this->IsEnabled(Level))
+            return;
+        try {
+            if constexpr (Level >= LogLevel::WARN && sizeof...(MT) > 0) {
+                const auto &first(std::get<0>(std::forward_as_tuple(_msgs...)));
+                t_u32 suppressed(0);
+                if (!this->_Admit(Level, TcpInitializer::Logger::_KeyOf(first) ^ static_cast<t_u64>(Level), suppressed))
+                    return;
+                if (suppressed > 0)
+                    this->_Append(Level, "(", suppressed, " similar lines suppressed) ", TcpInitializer::Logger::_Lower(first));
+            }
+            this->_Append(Level, TcpInitializer::Logger::_Lower(_msgs)...);
+        } catch (...) {
+            // only a thread's first record (its ring) or a streamed argument allocates
+        }
+    }
+};
+
+template <typename... MT>
+void TcpInitializer::Logger::Trace(const MT &..._msgs) noexcept {
+    TcpInitializer::Logger::Global().Write<LogLevel::TRACE>(_msgs...);
+};
+
+template <typename... MT>
+void TcpInitializer::Logger::Verbose(const MT &..._msgs) noexcept {
+    TcpInitializer::Logger::Global().Write<LogLevel::VERBOSE>(_msgs...);
+};
+
+template <typename... MT>
+void TcpInitializer::Logger::Info(const MT &..._msgs) noexcept {
+    TcpInitializer::Logger::Global().Write<LogLevel::INFO>(_msgs...);
+};
+
+template <typename... MT>
+void TcpInitializer::Logger::Warn(const MT &..._msgs) noexcept {
+    TcpInitializer::Logger::Global().Write<LogLevel::WARN>(_msgs...);
+};
+
+template <typename... MT>
+void TcpInitializer::Logger::Error(const MT &..._msgs) noexcept {
+    TcpInitializer::Logger::Global().Write<LogLevel::ERROR>(_msgs...);
+};
+
+/**
+ * @brief Passes through the argument types a record can hold, formats any other type with operator<<.
+ *
+ * @param _msg The argument.
+ * @returns The argument itself, or its text.
+ */
+template <typename T>
+decltype(auto) TcpInitializer::Logger::_Lower(const T &_msg) {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_arithmetic_v<D> || std::is_enum_v<D> || std::is_pointer_v<D> || std::is_convertible_v<const T &, t_strw>) {
+        return (_msg);
+    } else {
+        std::ostringstream text;
+        text << _msg;
+        return text.str();
+    }
+};
+
+/**
+ * @brief Gets the encoded size of an argument.
+ *
+ * @param _msg The argument.
+ * @returns Its tag and payload size in bytes.
+ */
+template <typename T>
+std::size_t TcpInitializer::Logger::_SizeOf(const T &_msg) noexcept {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, char> || std::is_same_v<D, bool>) {
+        return 2;
+    } else if constexpr (std::is_pointer_v<T> && (std::is_same_v<D, const char *> || std::is_same_v<D, char *>)) {
+        return 5 + (_msg == nullptr ? 6 : strlen(_msg));
+    } else if constexpr (std::is_arithmetic_v<D> || std::is_enum_v<D> || (std::is_pointer_v<D> && !std::is_same_v<D, const char *> && !std::is_same_v<D, char *>)) {
+        return 9;
+    } else {
+        return 5 + t_strw(_msg).size();
+    }
+};
+
+/**
+ * @brief Writes an argument's tag and payload.
+ *
+ * @param _out Write position, advanced past the argument.
+ * @param _msg The argument.
+ */
+template <typename T>
+void TcpInitializer::Logger::_Encode(char *&_out, const T &_msg) noexcept {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, char> || std::is_same_v<D, bool>) {
+        *_out++ = _ARG_CHR;
+        *_out++ = std::is_same_v<D, bool> ? (_msg ? '1' : '0') : static_cast<char>(_msg);
+    } else if constexpr (std::is_floating_point_v<D>) {
+        const double value(static_cast<double>(_msg));
+        *_out++ = _ARG_F64;
+        memcpy(_out, &value, 8);
+        _out += 8;
+    } else if constexpr (std::is_integral_v<D> || std::is_enum_v<D>) {
+        using U = std::conditional_t<std::is_enum_v<D>, std::underlying_type<D>, std::common_type<D>>;
+        using V = typename U::type;
+        if constexpr (std::is_signed_v<V>) {
+            const int64_t value(static_cast<int64_t>(_msg));
+            *_out++ = _ARG_I64;
+            memcpy(_out, &value, 8);
+        } else {
+            const t_u64 value(static_cast<t_u64>(_msg));
+            *_out++ = _ARG_U64;
+            memcpy(_out, &value, 8);
+        }
+        _out += 8;
+    } else if constexpr (std::is_pointer_v<D> && !std::is_same_v<D, const char *> && !std::is_same_v<D, char *>) {
+        const t_u64 value(reinterpret_cast<std::uintptr_t>(_msg));
+        *_out++ = _ARG_PTR;
+        memcpy(_out, &value, 8);
+        _out += 8;
+    } else {
+        t_strw text;
+        // only a real pointer can be null, a char array argument is a reference to its storage
+        if constexpr (std::is_pointer_v<T> && (std::is_same_v<D, const char *> || std::is_same_v<D, char *>))
+            text = _msg == nullptr ? t_strw("(null)") : t_strw(_msg);
+        else
+            text = t_strw(_msg);
+        const t_u32 length(static_cast<t_u32>(text.size()));
+        *_out++ = _ARG_STR;
+        memcpy(_out, &length, 4);
+        memcpy(_out + 4, text.data(), length);
+        _out += 4 + length;
+    }
+};
+
+/**
+ * @brief Hashes the text of a message's first argument, the rate limiter's notion of "the same line".
+ *
+ * @param _msg The first argument.
+ * @returns The FNV-1a hash of its text, 0 for non-text arguments.
+ */
+template <typename T>
+TcpInitializer::t_u64 TcpInitializer::Logger::_KeyOf(const T &_msg) noexcept {
+    using D = std::decay_t<T>;
+    if constexpr (std::is_convertible_v<const T &, t_strw> && !std::is_pointer_v<T>) {
+        t_u64 hash(14695981039346656037ull);
+        for (const char c : t_strw(_msg)) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return hash;
+    } else if constexpr (std::is_pointer_v<T> && (std::is_same_v<D, char *> || std::is_same_v<D, const char *>)) {
+        return _msg == nullptr ? 0 : TcpInitializer::Logger::_KeyOf(t_strw(_msg));
+    } else {
+        return 0;
+    }
+};
+
+/**
+ * @brief Encodes a record into the calling thread's ring.
+ *
+ * @param _level The record level.
+ * @param _msgs The lowered message parts.
+ */
+template <typename... MT>
+void TcpInitializer::Logger::_Append(const LogLevel _level, const MT &..._msgs) {
+    Ring *ring(this->_Ring());
+    if (ring == nullptr)
+        return;
+    const std::size_t size(sizeof(Record) + (std::size_t(0) + ... + TcpInitializer::Logger::_SizeOf(_msgs)));
+    char *out(this->_Reserve(*ring, size));
+    if (out == nullptr)
+        return;
+    Record record;
+    record.size = static_cast<t_u32>((size + 7) & ~std::size_t(7));
+    record.level = static_cast<t_u16>(_level);
+    record.args = static_cast<t_u16>(sizeof...(MT));
+    record.time_ns = static_cast<t_u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    memcpy(out, &record, sizeof(Record));
+    out += sizeof(Record);
+    (TcpInitializer::Logger::_Encode(out, _msgs), ...);
+    this->_Commit(*ring, record.size);
+};
+
+class TcpListener;
+class TcpConnection;
+
 class Socket
 {
   using ep_tcp   = ClientTcpConnection;
   using tcp_int  = TcpIntercept; 
+  friend class TcpListener;
+  friend class TcpConnection;
   protected: 
-    static      std::unique_ptr<t_sock>                   _socket;
-    static      std::unique_ptr<struct sockaddr_in>       _sock_address;
-    static      TcpState                                  _tcp_state;
-    static      t_str                                     _ip_address;
-    static      t_u16                                     _port;
-    static      t_u64                                     _accept_max;
-    static      t_u64                                     _tcp_count;
-    static      t_u64                                     _buffer_max;
-    static      std::mutex                                _mtx;
+    // default instances backing the static API, dedicated listeners and connections own their state
+    static      TcpListener                               _listener;
+    static      TcpConnection                             _connection;
 
 
   public: // public member variables
@@ -147,6 +1211,14 @@ class Socket
     __attribute__((hot                                             ))  inline static        t_sock  AcceptTcpRequest        (void);
     __attribute__((hot                                             ))  inline static        bool    Send                    (const t_strw _buffer) noexcept;
     __attribute__((hot, access(read_only, 1)                       ))  inline static        bool    Send                    (const t_sock *__restrict__ _sock, const t_strw _buffer) noexcept;
+    __attribute__((hot, access(read_only, 1)                       ))  inline static        bool    Send                    (const t_sock *__restrict__ _sock, const t_strw *_buffers, const std::size_t _count) noexcept;
+    __attribute__((hot, access(read_only, 1)                       ))  inline static        bool    SendFile                (const t_sock *__restrict__ _sock, const int _file_fd, const off_t _offset, const std::size_t _count) noexcept;
+    __attribute__((cold, access(read_only, 1)                      ))  inline static        bool    SendFile                (const t_sock *__restrict__ _sock, const t_strw _path) noexcept;
+    __attribute__((cold                                            ))  inline static        bool    ConnectWithin           (const t_sock _sock, const struct sockaddr_in &_address, const int _timeout_ms) noexcept;
+    __attribute__((cold                                            ))  inline static        bool    ConnectWithin           (const t_sock _sock, const struct sockaddr *_address, const socklen_t _size, const int _timeout_ms) noexcept;
+    __attribute__((cold                                            ))  inline static        void    SetConnectTimeout       (const int _timeout_ms) noexcept;
+    __attribute__((cold                                            ))  inline static        bool    SetTimeouts             (const t_sock _sock, const int _read_ms, const int _write_ms) noexcept;
+    __attribute__((cold                                            ))  inline static        bool    SetKeepAlive            (const t_sock _sock, const t_u32 _idle_s = DEFAULT_KEEPALIVE_IDLE_S, const t_u32 _interval_s = DEFAULT_KEEPALIVE_INTERVAL_S, const t_u32 _count = DEFAULT_KEEPALIVE_COUNT) noexcept;
     __attribute__((hot, warn_unused_result                         ))  inline static        tcp_int Read                    (void);
     __attribute__((hot, warn_unused_result                         ))  inline static const  t_str   Read2Str                (void);
     __attribute__((hot, warn_unused_result                         ))  inline static const  t_str   Read2Str                (t_sock *__restrict__ _sock);
@@ -154,7 +1226,8 @@ class Socket
     __attribute__((hot, access(read_only, 1)                       ))  inline static        void    Read                    (t_sock *__restrict__ _sock, t_str& sink_frame);
     __attribute__((hot, warn_unused_result, access(read_only, 1)   ))  inline static        tcp_int Read                    (t_sock *__restrict__ _sock);
     __attribute__((hot, access(read_only, 1)                       ))  inline static        void    Read                    (t_sock *__restrict__ _sock, TcpIntercept &dest_obj);
-    __attribute__((const, warn_unused_result                       ))  inline static        t_sock* GetSocket               (void) noexcept;
+    __attribute__((hot, access(read_only, 1)                       ))  inline static        bool    Read                    (t_sock *__restrict__ _sock, TcpInterceptView &dest_view);
+    __attribute__((pure, warn_unused_result                        ))  inline static        t_sock* GetSocket               (void) noexcept;
     __attribute__((cold                                            ))  inline static        void    Close                   (t_sock __restrict__ *_sock) noexcept;
     __attribute__((cold, zero_call_used_regs("all")                ))  inline static        void    GarbageCollectorExecute (void) noexcept;
     __attribute__((cold                                            ))  inline static        void    SetVerbose              (const bool verbose) noexcept;
@@ -162,9 +1235,11 @@ class Socket
     template <typename... MT> 
     __attribute__((hot                                             ))  inline static        void    Log                     (MT... msgs) noexcept;
     __attribute__((hot                                             ))  inline static        bool    CanAcceptTcp            (void) noexcept;
-    __attribute__((cold, const, warn_unused_result                 ))  inline static const  t_u64&  GetSessionCount         (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        t_u64   GetSessionCount         (void) noexcept;
     __attribute__((cold, warn_unused_result                        ))  inline static        bool    IsConnected             (void) noexcept;
     __attribute__((cold, warn_unused_result, access(read_only, 1)  ))  inline static        bool    SocketState             (const t_sock *__restrict__ _sock);
+    __attribute__((cold, warn_unused_result                        ))  inline static        TcpListener   &GetListener      (void) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline static        TcpConnection &GetConnection    (void) noexcept;
 
     ~Socket();
 
@@ -173,13 +1248,123 @@ class Socket
     template <typename rT> 
     __attribute__((cold                                            ))  inline static        void     _Connect               (const t_strw _address, const t_u16 _port, rT _r, const bool _throw = false);
     __attribute__((hot, access(read_only, 1)                       ))  inline static        bool     _Accept                (t_sock *__restrict__ _sock, t_sock *__restrict__ _sock_digest);
+    __attribute__((hot                                             ))  inline static        void     _ReadFrom              (const t_sock _sock, const t_u64 _buffer_max, tcp_int &_dest);
+    __attribute__((hot                                             ))  inline static        void     _ReadFrom              (const t_sock _sock, const t_u64 _buffer_max, TcpInterceptView &_dest);
+    __attribute__((hot                                             ))  inline static        bool     _SendAll               (const t_sock _sock, struct iovec *_iov, std::size_t _count) noexcept;
     __attribute__((cold, warn_unused_result, pure, nothrow         ))         static        bool     _AddressValidate       (const t_strw _address, const t_u16 _port);
+    __attribute__((cold, warn_unused_result                        ))  inline static        int      _SocketFamily          (const t_sock _sock) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline static        bool     _IsActive              (void) noexcept;
     __attribute__((cold, nothrow                                   ))         static        void     _ExceptionHandle       (const t_strw error) noexcept;
     __attribute__((hot, const, warn_unused_result                  ))         static const  t_str    _ErrorMsgCombine       (const t_strw _token) noexcept;
-    __attribute__((cold                                            ))  inline static        bool     _TcpBind               (void);
-    __attribute__((cold                                            ))  inline static        bool     _TcpListen             (void);
-    __attribute__((cold                                            ))  inline static        void     _AddressReuse          (void);
-    __attribute__((hot                                             ))  inline static        void     _AccessGuard           (void) noexcept;
+};
+
+/**
+ * Listening endpoint with its own socket, bind address, admission counters and lock.
+ *
+ * Any number of listeners can live in one process, e.g. one per served port, without sharing
+ * state; the static Socket server API is a wrapper around a default instance. Accepted sessions
+ * are tracked in a ConnectionTable until closed with CloseSession (or Socket::Close), and the
+ * live count, not the number ever accepted, is held against the connection limit.
+ */
+class TcpListener
+{
+  using __self__ = TcpInitializer::Socket;
+  protected:
+    t_sock                                                _socket;
+    PeerAddress                                           _sock_address;
+    TcpState                                              _tcp_state;
+    t_str                                                 _ip_address;
+    t_u16                                                 _port;
+    t_u64                                                 _accept_max;
+    std::atomic<t_u64>                                    _reserved;
+    MetricCounter                                         _accepted;
+    ConnectionTable                                       _sessions;
+    mutable std::mutex                                    _mtx;
+
+  public:
+    __attribute__((cold                                            ))                          TcpListener             (void) noexcept;
+    TcpListener(const TcpListener &)            = delete;
+    TcpListener &operator=(const TcpListener &) = delete;
+    __attribute__((cold                                            ))                          ~TcpListener            ();
+
+    __attribute__((cold                                            ))  inline               bool    Open                    (void) noexcept;
+    __attribute__((cold                                            ))  inline               bool    Listen                  (const t_u16 _port);
+    __attribute__((cold                                            ))  inline               bool    Listen                  (const t_strw _address, const t_u16 _port);
+    __attribute__((cold                                            ))  inline               bool    Adopt                   (const t_sock _sock, const t_strw _address, const t_u16 _port);
+    __attribute__((hot                                             ))  inline               t_sock  Accept                  (void);
+    __attribute__((hot, warn_unused_result                         ))  inline               bool    CanAcceptTcp            (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               bool    IsListening             (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetSessionCount         (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetAcceptedCount        (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               ConnectionTable &GetSessions    (void) noexcept;
+    __attribute__((hot                                             ))  inline               bool    CloseSession            (const t_sock _sock) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               TcpState GetState               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline const         t_str&  GetAddress              (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u16   GetPort                 (void) const noexcept;
+    __attribute__((pure, warn_unused_result                        ))  inline               t_sock* GetSocket               (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetMaxConnections       (const t_u64 max) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Release                 (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Close                   (void) noexcept;
+
+  protected:
+    __attribute__((cold                                            ))  inline               bool    _TcpBind                (void);
+    __attribute__((cold                                            ))  inline               bool    _TcpListen              (void);
+    __attribute__((cold                                            ))  inline               void    _AddressReuse           (void);
+    __attribute__((cold                                            ))  inline               bool    _UnixBind               (const int _type, const socklen_t _size);
+};
+
+/**
+ * Outbound (or adopted accepted) connection with its own socket, peer address, byte counters and lock.
+ *
+ * Each instance holds one connection, so a process can keep as many upstream connections as it
+ * needs; the static Socket client API is a wrapper around a default instance.
+ */
+class TcpConnection
+{
+  using __self__ = TcpInitializer::Socket;
+  using ep_tcp   = ClientTcpConnection;
+  using tcp_int  = TcpIntercept;
+  protected:
+    t_sock                                                _socket;
+    PeerAddress                                           _sock_address;
+    TcpState                                              _tcp_state;
+    t_str                                                 _ip_address;
+    t_u16                                                 _port;
+    t_u64                                                 _buffer_max;
+    t_u64                                                 _bytes_sent;
+    t_u64                                                 _bytes_received;
+    int                                                   _connect_timeout_ms;
+    mutable std::mutex                                    _mtx;
+
+  public:
+    __attribute__((cold                                            ))                          TcpConnection           (void) noexcept;
+    __attribute__((cold                                            ))  explicit                TcpConnection           (const t_sock _sock) noexcept;
+    TcpConnection(const TcpConnection &)            = delete;
+    TcpConnection &operator=(const TcpConnection &) = delete;
+    __attribute__((cold                                            ))                          ~TcpConnection          ();
+
+    __attribute__((cold                                            ))  inline               bool    Connect                 (const t_strw _address, const t_u16 _port);
+    __attribute__((cold                                            ))  inline const         ep_tcp  Connect                 (const t_strw _address, const t_u16 _port, const bool _throw);
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_strw _buffer) noexcept;
+    __attribute__((hot                                             ))  inline               bool    Send                    (const t_strw *_buffers, const std::size_t _count) noexcept;
+    __attribute__((hot                                             ))  inline               bool    SendFile                (const int _file_fd, const off_t _offset, const std::size_t _count) noexcept;
+    __attribute__((hot, warn_unused_result                         ))  inline               tcp_int Read                    (void);
+    __attribute__((hot                                             ))  inline               void    Read                    (t_str &sink_frame);
+    __attribute__((hot                                             ))  inline               bool    Read                    (TcpInterceptView &dest_view);
+    __attribute__((hot, warn_unused_result                         ))  inline const         t_str   Read2Str                (void);
+    __attribute__((cold, warn_unused_result                        ))  inline               bool    IsConnected             (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               TcpState GetState               (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetBytesSent            (void) const noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_u64   GetBytesReceived        (void) const noexcept;
+    __attribute__((pure, warn_unused_result                        ))  inline               t_sock* GetSocket               (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetBufferSize           (const t_u64 _size) noexcept;
+    __attribute__((cold                                            ))  inline               void    SetConnectTimeout       (const int _timeout_ms) noexcept;
+    __attribute__((cold                                            ))  inline               void    Attach                  (const t_sock _sock) noexcept;
+    __attribute__((cold, warn_unused_result                        ))  inline               t_sock  Release                 (void) noexcept;
+    __attribute__((cold                                            ))  inline               void    Close                   (void) noexcept;
+
+  protected:
+    __attribute__((cold                                            ))  inline               bool    _UnixConnect            (const int _type, const socklen_t _size);
 };
 }; // namespace TcpInitializer
 
@@ -189,15 +1374,23 @@ class Socket
 
 #endif
 
-std::unique_ptr<TcpInitializer::t_sock>  TcpInitializer::Socket::_socket            = std::make_unique<TcpInitializer::t_sock>(-1);
-std::unique_ptr<struct sockaddr_in>      TcpInitializer::Socket::_sock_address      = std::make_unique<struct sockaddr_in>();
-TcpInitializer::t_str                    TcpInitializer::Socket::_ip_address        = TcpInitializer::t_str(DEFAULT_IP_ADDRESS);
-TcpInitializer::t_u16                    TcpInitializer::Socket::_port              = DEFAULT_PORT_NUMBER;
+TcpInitializer::TcpListener              TcpInitializer::Socket::_listener;
+TcpInitializer::TcpConnection            TcpInitializer::Socket::_connection;
 bool                                     TcpInitializer::Socket::verbose            = false;
-TcpInitializer::t_u64                    TcpInitializer::Socket::_accept_max        = DEFAULT_ACCEPT_MAX;
-TcpInitializer::t_u64                    TcpInitializer::Socket::_tcp_count         = 0;
-TcpInitializer::t_u64                    TcpInitializer::Socket::_buffer_max        = DEFAULT_BUFFER_MAX_SIZE;
-TcpInitializer::TcpState                 TcpInitializer::Socket::_tcp_state         = TcpInitializer::TcpState::NONE;
-std::mutex                               TcpInitializer::Socket::_mtx               = std::mutex();
+std::mutex                               TcpInitializer::MetricSlot::_mtx;
+std::vector<TcpInitializer::_t::t_u32>   TcpInitializer::MetricSlot::_free;
+TcpInitializer::_t::t_u32                TcpInitializer::MetricSlot::_next          = 0;
+std::atomic<TcpInitializer::_t::t_u64>   TcpInitializer::Logger::_instances         {0};
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::accepted;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::connects;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::connect_failures;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::bytes_in;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::bytes_out;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::connections;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::sessions;
+TcpInitializer::MetricCounter            TcpInitializer::Metrics::queued_bytes;
+TcpInitializer::LatencyHistogram         TcpInitializer::Metrics::read_latency;
+TcpInitializer::LatencyHistogram         TcpInitializer::Metrics::send_latency;
+TcpInitializer::LatencyHistogram         TcpInitializer::Metrics::connect_latency;
 
 #endif
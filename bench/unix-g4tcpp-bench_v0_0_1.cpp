@@ -0,0 +1,625 @@
+/**
+ * Loopback benchmark suite.
+ *
+ * Every case starts an echo server on 127.0.0.1 with one of the server implementations below and
+ * drives it from plain blocking client sockets, so the client side costs the same for every mode:
+ *
+ *   legacy  thread per connection and a thread per Read, the original Socket API
+ *   epoll   EpollIoBackend on one EventLoop thread
+ *   uring   UringIoBackend on one thread, skipped where io_uring is unavailable
+ *   coro    a coroutine per connection on a Scheduler, when built as C++20
+ *
+ * Cases:
+ *
+ *   echo      throughput of N connections echoing 1 B, 64 B, 1 KiB and 64 KiB messages
+ *   pingpong  round trip latency percentiles of a single connection
+ *   churn     connect, one byte round trip and close per second
+ *   idle      user and kernel memory held per idle connection
+ *
+ * Usage: tcpgateway_bench [--mode legacy,epoll,uring,coro] [--case echo,pingpong,churn,idle]
+ *                         [--seconds N] [--connections N] [--idle N] [--size N]
+ *
+ * Each result is printed as one line of key=value pairs, so runs can be diffed and compared.
+ */
+
+#include "TcpGateway/unix-g4tcpp-iobackend_v0_0_1.cpp"
+#if defined(__cpp_impl_coroutine) && __cplusplus >= 202002L
+#include "TcpGateway/unix-g4tcpp-coro_v0_0_1.cpp"
+#define TCPGATEWAY_BENCH_CORO 1
+#endif
+
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <unordered_set>
+
+using namespace TcpInitializer::_t; // types
+
+namespace TcpGatewayBench
+{
+
+typedef struct alignas(void *)
+{
+    std::vector<t_str> modes      { "legacy", "epoll", "uring", "coro"                  };
+    std::vector<t_str> cases      { "echo", "pingpong", "churn", "idle"                 };
+    t_u32              seconds    { 2                                                   };
+    t_u32              connections{ 8                                                   };
+    t_u32              idle       { 1000                                                };
+    t_u32              size       { 64                                                  };
+} Options;
+
+/**
+ * @brief Disables Nagle on a socket, so echoed tails are not held back waiting for a delayed ack.
+ */
+void SetNoDelay(const t_sock _sock) noexcept {
+    const int nodelay(1);
+    setsockopt(_sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+};
+
+/**
+ * Echo server under test, bound to an ephemeral loopback port.
+ */
+class Server
+{
+  public:
+    virtual ~Server() = default;
+
+    virtual                 bool    Start                   (void) = 0;
+    virtual                 void    Stop                    (void) noexcept = 0;
+
+    t_u16 GetPort(void) const noexcept { return this->_port; };
+
+  protected:
+    t_u16                                                 _port { 0 };
+
+    /**
+     * @brief Reads the port the kernel assigned to a listening socket.
+     *
+     * @param _sock The listening socket.
+     * @returns true if the port was read, false otherwise.
+     */
+    bool _ResolvePort(const t_sock _sock) noexcept {
+        struct sockaddr_in address;
+        socklen_t address_size(sizeof(address));
+        if (getsockname(_sock, reinterpret_cast<struct sockaddr *>(&address), &address_size) != 0)
+            return false;
+        this->_port = ntohs(address.sin_port);
+        return true;
+    };
+};
+
+/**
+ * The original model: the static Socket server, a thread per accepted connection and
+ * Socket::Read, which runs every read on a thread of its own.
+ */
+class LegacyServer final : public Server
+{
+  protected:
+    std::thread                                           _acceptor;
+    std::atomic<bool>                                     _stopping { false };
+    std::atomic<t_u64>                                    _live     { 0 };
+
+  public:
+    bool Start(void) override {
+        TcpInitializer::Socket::SetMaxConnections(1u << 20);
+        TcpInitializer::Socket::CreateTcpServer("127.0.0.1", 0);
+        if (!TcpInitializer::Socket::GetListener().IsListening() || !this->_ResolvePort(*TcpInitializer::Socket::GetListener().GetSocket()))
+            return false;
+        this->_stopping = false;
+        this->_acceptor = std::thread([this]() -> void {
+            while (!this->_stopping.load(std::memory_order_acquire)) {
+                t_sock sock(TcpInitializer::Socket::AcceptTcpRequest());
+                if (sock < 0)
+                    continue;
+                if (this->_stopping.load(std::memory_order_acquire)) {
+                    close(sock);
+                    break;
+                }
+                SetNoDelay(sock);
+                ++this->_live;
+                std::thread([this, sock]() mutable -> void {
+                    try {
+                        for (;;) {
+                            const TcpInitializer::TcpIntercept request(TcpInitializer::Socket::Read(&sock));
+                            if (request.block_size == 0 || !TcpInitializer::Socket::Send(&sock, request.raw_bytes))
+                                break;
+                        }
+                    } catch (const t_except &) {
+                    }
+                    close(sock);
+                    --this->_live;
+                }).detach();
+            }
+        });
+        return true;
+    };
+
+    void Stop(void) noexcept override {
+        this->_stopping.store(true, std::memory_order_release);
+        // wake the blocking accept with a throwaway connection
+        const t_sock wake(socket(AF_INET, SOCK_STREAM, 0));
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(this->_port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (wake >= 0) {
+            [[maybe_unused]] const int connected(connect(wake, reinterpret_cast<const struct sockaddr *>(&address), sizeof(address)));
+            close(wake);
+        }
+        if (this->_acceptor.joinable())
+            this->_acceptor.join();
+        for (int waited = 0; this->_live.load() > 0 && waited < 5000; ++waited)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        TcpInitializer::Socket::GetListener().Close();
+    };
+};
+
+/**
+ * Echo server on an IoBackend driven by one thread.
+ */
+class BackendServer final : public Server
+{
+  protected:
+    TcpInitializer::IoBackendType                         _type;
+    std::unique_ptr<TcpInitializer::IoBackend>            _backend;
+    TcpInitializer::TcpListener                           _listener;
+    std::unordered_set<t_sock>                            _open;
+    std::thread                                           _worker;
+
+  public:
+    explicit BackendServer(const TcpInitializer::IoBackendType _type) noexcept : _type(_type) {};
+
+    bool Start(void) override {
+        try {
+            if (this->_type == TcpInitializer::IoBackendType::IO_URING)
+                this->_backend = std::make_unique<TcpInitializer::UringIoBackend>();
+            else
+                this->_backend = std::make_unique<TcpInitializer::EpollIoBackend>();
+        } catch (const t_except &e) {
+            std::cerr << "backend unavailable: " << e.what() << '\n';
+            return false;
+        }
+        this->_listener.SetMaxConnections(1u << 20);
+        try {
+            if (!this->_listener.Listen("127.0.0.1", 0) || !this->_ResolvePort(*this->_listener.GetSocket()))
+                return false;
+        } catch (const t_except &e) {
+            std::cerr << e.what() << '\n';
+            return false;
+        }
+        const bool accepting(this->_backend->Accept(*this->_listener.GetSocket(), [this](TcpInitializer::IoBackend &_backend, const t_sock _sock) -> void {
+            SetNoDelay(_sock);
+            this->_open.insert(_sock);
+            _backend.Read(_sock, [this](TcpInitializer::IoBackend &_backend, const t_sock _sock, const t_strw _bytes) -> void {
+                if (_bytes.empty()) {
+                    this->_open.erase(_sock);
+                    return _backend.Close(_sock);
+                }
+                _backend.Send(_sock, _bytes);
+            });
+        }));
+        if (!accepting)
+            return false;
+        this->_worker = std::thread([this]() -> void { this->_backend->Run(); });
+        return true;
+    };
+
+    void Stop(void) noexcept override {
+        if (!this->_backend)
+            return;
+        this->_backend->Stop();
+        if (this->_worker.joinable())
+            this->_worker.join();
+        for (const t_sock sock : this->_open)
+            this->_backend->Close(sock);
+        this->_open.clear();
+        this->_backend.reset();
+        this->_listener.Close();
+    };
+};
+
+#ifdef TCPGATEWAY_BENCH_CORO
+/**
+ * Echo server written as coroutines: one accept loop and one straight-line session per connection.
+ */
+class CoroServer final : public Server
+{
+  protected:
+    TcpInitializer::TcpListener                           _listener;
+    std::unique_ptr<TcpInitializer::EventLoop>            _loop;
+    std::unique_ptr<TcpInitializer::Scheduler>            _scheduler;
+    std::thread                                           _worker;
+
+    static TcpInitializer::Task<void> _Session(TcpInitializer::AsyncSocket _client) {
+        char buffer[DEFAULT_BUFFER_MAX_SIZE];
+        for (;;) {
+            const ssize_t received(co_await _client.Read(buffer, sizeof(buffer)));
+            if (received <= 0 || !co_await _client.Send(t_strw(buffer, static_cast<std::size_t>(received))))
+                break;
+        }
+    };
+
+    static TcpInitializer::Task<void> _Serve(TcpInitializer::Scheduler &_scheduler, const t_sock _listen_sock) {
+        for (;;) {
+            TcpInitializer::AsyncSocket client(co_await _scheduler.Accept(_listen_sock));
+            if (!client.IsValid())
+                break;
+            SetNoDelay(client.GetSocket());
+            _scheduler.Spawn(_Session(std::move(client)));
+        }
+    };
+
+  public:
+    bool Start(void) override {
+        this->_listener.SetMaxConnections(1u << 20);
+        try {
+            if (!this->_listener.Listen("127.0.0.1", 0) || !this->_ResolvePort(*this->_listener.GetSocket()))
+                return false;
+            this->_loop = std::make_unique<TcpInitializer::EventLoop>();
+            this->_scheduler = std::make_unique<TcpInitializer::Scheduler>(*this->_loop);
+        } catch (const t_except &e) {
+            std::cerr << e.what() << '\n';
+            return false;
+        }
+        this->_scheduler->Spawn(_Serve(*this->_scheduler, *this->_listener.GetSocket()));
+        this->_worker = std::thread([this]() -> void { this->_scheduler->Run(); });
+        return true;
+    };
+
+    void Stop(void) noexcept override {
+        if (!this->_scheduler)
+            return;
+        this->_scheduler->Stop();
+        if (this->_worker.joinable())
+            this->_worker.join();
+        this->_scheduler.reset();
+        this->_loop.reset();
+        this->_listener.Close();
+    };
+};
+#endif
+
+/**
+ * @brief Opens a blocking client connection to the loopback server.
+ *
+ * @param _port The server port.
+ * @returns The connected socket, or -1 on failure.
+ */
+t_sock Dial(const t_u16 _port) noexcept {
+    const t_sock sock(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (sock < 0)
+        return -1;
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(_port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    SetNoDelay(sock);
+    if (connect(sock, reinterpret_cast<const struct sockaddr *>(&address), sizeof(address)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+};
+
+/**
+ * @brief Writes a whole buffer to a blocking socket.
+ *
+ * @returns true if every byte was written, false otherwise.
+ */
+bool WriteAll(const t_sock _sock, const char *_data, std::size_t _size) noexcept {
+    while (_size > 0) {
+        const ssize_t sent(send(_sock, _data, _size, MSG_NOSIGNAL));
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        _data += sent;
+        _size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+};
+
+/**
+ * @brief Reads exactly _size bytes from a blocking socket.
+ *
+ * @returns true if every byte was read, false on end of stream or error.
+ */
+bool ReadAll(const t_sock _sock, char *_data, std::size_t _size) noexcept {
+    while (_size > 0) {
+        const ssize_t received(recv(_sock, _data, _size, 0));
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        _data += received;
+        _size -= static_cast<std::size_t>(received);
+    }
+    return true;
+};
+
+/**
+ * @brief Closes a client socket with a reset, so loopback churn does not pile up TIME_WAIT sockets.
+ */
+void Abort(const t_sock _sock) noexcept {
+    const struct linger reset{1, 0};
+    setsockopt(_sock, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+    close(_sock);
+};
+
+/**
+ * @brief Echo throughput: every connection sends one message and reads it back, in a loop.
+ */
+void Echo(Server &_server, const t_strw _mode, const Options &_options) {
+    for (const t_u32 size : {1u, 64u, 1024u, 65536u}) {
+        std::atomic<t_u64> messages(0);
+        std::atomic<bool> failed(false);
+        std::vector<std::thread> clients;
+        const auto started(std::chrono::steady_clock::now());
+        const auto deadline(started + std::chrono::seconds(_options.seconds));
+        for (t_u32 i = 0; i < _options.connections; ++i) {
+            clients.emplace_back([&]() -> void {
+                const t_sock sock(Dial(_server.GetPort()));
+                if (sock < 0) {
+                    failed = true;
+                    return;
+                }
+                std::vector<char> out(size, 'e'), in(size);
+                t_u64 local(0);
+                while (std::chrono::steady_clock::now() < deadline) {
+                    if (!WriteAll(sock, out.data(), size) || !ReadAll(sock, in.data(), size)) {
+                        failed = true;
+                        break;
+                    }
+                    ++local;
+                }
+                messages += local;
+                close(sock);
+            });
+        }
+        for (std::thread &client : clients)
+            client.join();
+        const double elapsed(std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+        std::printf("mode=%.*s case=echo size=%u connections=%u msgs_per_sec=%.0f mib_per_sec=%.2f%s\n", static_cast<int>(_mode.size()), _mode.data(), size, _options.connections,
+                    static_cast<double>(messages.load()) / elapsed, static_cast<double>(messages.load()) * size * 2 / elapsed / (1 << 20), failed ? " errors=yes" : "");
+    }
+};
+
+/**
+ * @brief Ping-pong latency: one connection, one message in flight, every round trip recorded.
+ */
+void PingPong(Server &_server, const t_strw _mode, const Options &_options) {
+    const t_sock sock(Dial(_server.GetPort()));
+    if (sock < 0) {
+        std::printf("mode=%.*s case=pingpong error=connect\n", static_cast<int>(_mode.size()), _mode.data());
+        return;
+    }
+    TcpInitializer::LatencyHistogram histogram;
+    std::vector<char> out(_options.size, 'p'), in(_options.size);
+    const auto deadline(std::chrono::steady_clock::now() + std::chrono::seconds(_options.seconds));
+    while (std::chrono::steady_clock::now() < deadline) {
+        const t_u64 started(TcpInitializer::Metrics::Now());
+        if (!WriteAll(sock, out.data(), out.size()) || !ReadAll(sock, in.data(), in.size()))
+            break;
+        histogram.Record(TcpInitializer::Metrics::Now() - started);
+    }
+    close(sock);
+    const TcpInitializer::HistogramSnapshot snapshot(histogram.GetSnapshot());
+    std::printf("mode=%.*s case=pingpong size=%u round_trips=%" PRIu64 " p50_us=%.1f p90_us=%.1f p99_us=%.1f p999_us=%.1f max_us=%.1f\n", static_cast<int>(_mode.size()), _mode.data(), _options.size,
+                snapshot.count, TcpInitializer::LatencyHistogram::ValueAt(snapshot, 0.5) / 1e3, TcpInitializer::LatencyHistogram::ValueAt(snapshot, 0.9) / 1e3,
+                TcpInitializer::LatencyHistogram::ValueAt(snapshot, 0.99) / 1e3, TcpInitializer::LatencyHistogram::ValueAt(snapshot, 0.999) / 1e3, snapshot.max / 1e3);
+};
+
+/**
+ * @brief Connection churn: connect, exchange one byte so the server has accepted and served the
+ * connection, close; as many times per second as the connections allow.
+ */
+void Churn(Server &_server, const t_strw _mode, const Options &_options) {
+    std::atomic<t_u64> cycles(0), failures(0);
+    std::vector<std::thread> clients;
+    const auto started(std::chrono::steady_clock::now());
+    const auto deadline(started + std::chrono::seconds(_options.seconds));
+    for (t_u32 i = 0; i < _options.connections; ++i) {
+        clients.emplace_back([&]() -> void {
+            t_u64 local(0), failed(0);
+            char byte('c');
+            while (std::chrono::steady_clock::now() < deadline) {
+                const t_sock sock(Dial(_server.GetPort()));
+                if (sock < 0) {
+                    ++failed;
+                    continue;
+                }
+                if (WriteAll(sock, &byte, 1) && ReadAll(sock, &byte, 1))
+                    ++local;
+                else
+                    ++failed;
+                Abort(sock);
+            }
+            cycles += local;
+            failures += failed;
+        });
+    }
+    for (std::thread &client : clients)
+        client.join();
+    const double elapsed(std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    std::printf("mode=%.*s case=churn connections=%u conns_per_sec=%.0f failures=%" PRIu64 "\n", static_cast<int>(_mode.size()), _mode.data(), _options.connections,
+                static_cast<double>(cycles.load()) / elapsed, failures.load());
+};
+
+/**
+ * @brief Resident set size of the process in bytes.
+ */
+t_u64 ResidentBytes(void) noexcept {
+    std::ifstream statm("/proc/self/statm");
+    t_u64 size(0), resident(0);
+    statm >> size >> resident;
+    return resident * static_cast<t_u64>(sysconf(_SC_PAGESIZE));
+};
+
+/**
+ * @brief Kernel memory charged to TCP sockets system wide, in bytes (the "mem" pages of /proc/net/sockstat).
+ */
+t_u64 KernelSocketBytes(void) noexcept {
+    std::ifstream sockstat("/proc/net/sockstat");
+    t_str token;
+    while (sockstat >> token) {
+        if (token != "TCP:")
+            continue;
+        while (sockstat >> token) {
+            if (token == "mem") {
+                t_u64 pages(0);
+                sockstat >> pages;
+                return pages * static_cast<t_u64>(sysconf(_SC_PAGESIZE));
+            }
+        }
+    }
+    return 0;
+};
+
+/**
+ * @brief Number of threads of the process.
+ */
+t_u64 ThreadCount(void) noexcept {
+    std::ifstream status("/proc/self/status");
+    t_str line;
+    while (std::getline(status, line)) {
+        if (line.rfind("Threads:", 0) == 0)
+            return std::strtoull(line.c_str() + 8, nullptr, 10);
+    }
+    return 0;
+};
+
+/**
+ * @brief Idle footprint: open many connections, make sure each one was served once, and report
+ * the memory and threads held while they sit idle. Both ends live in this process, so the kernel
+ * figure covers client and server sockets.
+ */
+void Idle(Server &_server, const t_strw _mode, const Options &_options) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const t_u64 resident_before(ResidentBytes()), kernel_before(KernelSocketBytes()), threads_before(ThreadCount());
+    std::vector<t_sock> socks;
+    socks.reserve(_options.idle);
+    char byte('i');
+    for (t_u32 i = 0; i < _options.idle; ++i) {
+        const t_sock sock(Dial(_server.GetPort()));
+        if (sock < 0)
+            break;
+        socks.push_back(sock);
+        if (!WriteAll(sock, &byte, 1) || !ReadAll(sock, &byte, 1))
+            break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const t_u64 resident_after(ResidentBytes()), kernel_after(KernelSocketBytes()), threads_after(ThreadCount());
+    const double count(static_cast<double>(std::max<std::size_t>(socks.size(), 1)));
+    std::printf("mode=%.*s case=idle connections=%zu user_bytes_per_conn=%.0f kernel_bytes_per_conn=%.0f threads_added=%" PRId64 "\n", static_cast<int>(_mode.size()), _mode.data(), socks.size(),
+                (static_cast<double>(resident_after) - static_cast<double>(resident_before)) / count, (static_cast<double>(kernel_after) - static_cast<double>(kernel_before)) / count,
+                static_cast<int64_t>(threads_after) - static_cast<int64_t>(threads_before));
+    for (const t_sock sock : socks)
+        Abort(sock);
+};
+
+/**
+ * @brief Splits a comma separated list.
+ */
+std::vector<t_str> SplitList(const t_strw _list) {
+    std::vector<t_str> items;
+    std::size_t begin(0);
+    while (begin <= _list.size()) {
+        const std::size_t end(std::min(_list.find(',', begin), _list.size()));
+        if (end > begin)
+            items.emplace_back(_list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return items;
+};
+
+/**
+ * @brief Raises the descriptor limit to its hard maximum for the idle case.
+ *
+ * @returns The number of descriptors the process may open.
+ */
+t_u64 RaiseDescriptorLimit(void) noexcept {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return 1024;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return static_cast<t_u64>(limit.rlim_cur);
+};
+
+}; // namespace TcpGatewayBench
+
+int main(int argc, char **argv) {
+    using namespace TcpGatewayBench;
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const t_strw flag(argv[i]);
+        if (flag == "--help" || flag == "-h" || i + 1 >= argc) {
+            std::printf("usage: %s [--mode legacy,epoll,uring,coro] [--case echo,pingpong,churn,idle] [--seconds N] [--connections N] [--idle N] [--size N]\n", argv[0]);
+            return flag == "--help" || flag == "-h" ? 0 : 1;
+        }
+        const t_strw value(argv[++i]);
+        if (flag == "--mode")
+            options.modes = SplitList(value);
+        else if (flag == "--case")
+            options.cases = SplitList(value);
+        else if (flag == "--seconds")
+            options.seconds = static_cast<t_u32>(std::max(1ul, std::strtoul(value.data(), nullptr, 10)));
+        else if (flag == "--connections")
+            options.connections = static_cast<t_u32>(std::max(1ul, std::strtoul(value.data(), nullptr, 10)));
+        else if (flag == "--idle")
+            options.idle = static_cast<t_u32>(std::strtoul(value.data(), nullptr, 10));
+        else if (flag == "--size")
+            options.size = static_cast<t_u32>(std::max(1ul, std::strtoul(value.data(), nullptr, 10)));
+        else {
+            std::fprintf(stderr, "unknown option %s\n", argv[i - 1]);
+            return 1;
+        }
+    }
+    // every idle connection holds a client and a server descriptor
+    const t_u64 descriptors(RaiseDescriptorLimit());
+    options.idle = static_cast<t_u32>(std::min<t_u64>(options.idle, descriptors > 128 ? (descriptors - 128) / 2 : 0));
+
+    for (const t_str &mode : options.modes) {
+        std::unique_ptr<Server> server;
+        if (mode == "legacy")
+            server = std::make_unique<LegacyServer>();
+        else if (mode == "epoll")
+            server = std::make_unique<BackendServer>(TcpInitializer::IoBackendType::EPOLL);
+        else if (mode == "uring")
+            server = std::make_unique<BackendServer>(TcpInitializer::IoBackendType::IO_URING);
+#ifdef TCPGATEWAY_BENCH_CORO
+        else if (mode == "coro")
+            server = std::make_unique<CoroServer>();
+#else
+        else if (mode == "coro") {
+            std::printf("mode=coro skipped=requires_cxx20\n");
+            continue;
+        }
+#endif
+        else {
+            std::fprintf(stderr, "unknown mode %s\n", mode.c_str());
+            return 1;
+        }
+        if (!server->Start()) {
+            std::printf("mode=%s skipped=unavailable\n", mode.c_str());
+            server->Stop();
+            continue;
+        }
+        for (const t_str &name : options.cases) {
+            if (name == "echo")
+                Echo(*server, mode, options);
+            else if (name == "pingpong")
+                PingPong(*server, mode, options);
+            else if (name == "churn")
+                Churn(*server, mode, options);
+            else if (name == "idle")
+                Idle(*server, mode, options);
+            else
+                std::fprintf(stderr, "unknown case %s\n", name.c_str());
+        }
+        server->Stop();
+    }
+    return 0;
+}
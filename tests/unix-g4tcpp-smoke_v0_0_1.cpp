@@ -0,0 +1,263 @@
+/**
+ * Smoke tests, one case per invocation so ctest reports them one by one.
+ *
+ * Cases:
+ *
+ *   framing   length-prefixed (u32 and varint) and delimited frames survive a byte-by-byte feed
+ *   timers    a timer beyond the first wheel level cascades down and fires once, in order
+ *   pubsub    a subscriber that stops reading is dropped from, then evicted, under each SlowPolicy
+ *   pipeline  replies sent back in reverse order still complete the request they answer
+ *   fdpass    a descriptor and its payload cross an FdChannel over a socketpair
+ *
+ * Usage: tcpgateway_smoke <case>
+ *
+ * A case prints "ok" and exits with 0, or prints the failed check and exits with 1.
+ */
+
+#include "TcpGateway/unix-g4tcpp-pubsub_v0_0_1.cpp"
+#include "TcpGateway/unix-g4tcpp-pipeline_v0_0_1.cpp"
+#include "TcpGateway/unix-g4tcpp-fdpass_v0_0_1.cpp"
+
+using namespace TcpInitializer::_t; // types
+
+namespace TcpGatewaySmoke
+{
+
+/**
+ * @brief Fails the running case when a check does not hold.
+ *
+ * @param _condition The checked condition.
+ * @param _what What was checked, reported on failure.
+ */
+void Expect(const bool _condition, const char *_what) {
+    if (!_condition)
+        throw std::runtime_error(_what);
+};
+
+/**
+ * @brief Reads everything a socket has buffered without blocking.
+ *
+ * @param _sock The socket.
+ * @param _dest Appended with the bytes read.
+ * @returns false once the peer closed, true otherwise.
+ */
+bool Drain(const t_sock _sock, t_str &_dest) {
+    char buffer[65536];
+    for (;;) {
+        const ssize_t count(recv(_sock, buffer, sizeof(buffer), MSG_DONTWAIT));
+        if (count == 0)
+            return false;
+        if (count < 0)
+            return true;
+        _dest.append(buffer, static_cast<std::size_t>(count));
+    }
+};
+
+/**
+ * @brief Encodes frames of several sizes and feeds them back one byte at a time.
+ */
+void Framing(void) {
+    const std::vector<t_str> payloads{ "", "a", t_str(127, 'b'), t_str(128, 'c'), t_str(300, 'd'), t_str(4096, 'e') };
+    const auto round_trip([](std::unique_ptr<TcpInitializer::FrameCodec> _codec, const std::vector<t_str> &_payloads) -> void {
+        t_str wire;
+        for (const t_str &payload : _payloads)
+            _codec->Encode(payload, wire);
+        std::vector<t_str> decoded;
+        TcpInitializer::FrameDecoder decoder(std::move(_codec), [&](TcpInitializer::FrameDecoder &, const t_strw *_frames, const std::size_t _count) -> void {
+            for (std::size_t i = 0; i < _count; ++i)
+                decoded.emplace_back(_frames[i]);
+        });
+        for (const char byte : wire)
+            Expect(decoder.Feed(t_strw(&byte, 1)), "feed accepted");
+        Expect(!decoder.IsMalformed() && decoder.GetBuffered() == 0, "stream fully decoded");
+        Expect(decoded == _payloads, "payloads round-trip");
+    });
+    round_trip(std::make_unique<TcpInitializer::LengthPrefixCodec>(TcpInitializer::LengthPrefix::U32_BE), payloads);
+    round_trip(std::make_unique<TcpInitializer::LengthPrefixCodec>(TcpInitializer::LengthPrefix::VARINT), payloads);
+    round_trip(std::make_unique<TcpInitializer::DelimiterCodec>("\r\n"), payloads);
+};
+
+/**
+ * @brief Arms timers on the first and second wheel level and checks each fires once, not early.
+ */
+void Timers(void) {
+    TcpInitializer::TimerWheel wheel;
+    std::vector<std::pair<t_u64, t_u64>> fired;
+    const auto arm([&](const t_u64 _delay_ms) -> t_u64 {
+        return wheel.Schedule(_delay_ms, [&fired, &wheel, _delay_ms]() -> void { fired.emplace_back(_delay_ms, wheel.Now()); });
+    });
+    arm(5);
+    const t_u64 cascading(arm(300));
+    const t_u64 cancelled(arm(400));
+    arm(600);
+    Expect(wheel.GetCount() == 4 && wheel.IsPending(cascading), "timers armed");
+    Expect(wheel.Cancel(cancelled) && !wheel.IsPending(cancelled), "timer cancelled");
+    while (wheel.GetCount() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::max(1, wheel.NextTimeout())));
+        wheel.Advance();
+    }
+    Expect(fired.size() == 3, "every armed timer fired once");
+    Expect(fired[0].first == 5 && fired[1].first == 300 && fired[2].first == 600, "timers fired in order");
+    for (const auto &[delay, at] : fired)
+        Expect(at >= delay, "no timer fired early");
+    Expect(!wheel.IsPending(cascading) && !wheel.Cancel(cascading), "fired timer is gone");
+};
+
+/**
+ * @brief Publishes to a reading and a stalled subscriber, first under DROP, then under DISCONNECT.
+ */
+void PubSub(void) {
+    constexpr t_u64 max_queued(16 * 1024);
+    TcpInitializer::EventLoop loop;
+    TcpInitializer::TopicBroker broker(loop, TcpInitializer::SlowPolicy::DROP, max_queued);
+    int fast[2], slow[2];
+    Expect(socketpair(AF_UNIX, SOCK_STREAM, 0, fast) == 0 && socketpair(AF_UNIX, SOCK_STREAM, 0, slow) == 0, "socketpairs");
+    const int small(4096);
+    setsockopt(slow[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+    setsockopt(slow[1], SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+    Expect(broker.Adopt({ fast[0], true }) && broker.Adopt({ slow[0], true }), "subscribers adopted");
+    Expect(broker.Subscribe(fast[0], "topic") && broker.Subscribe(slow[0], "topic"), "subscribed");
+    Expect(broker.GetSubscriberCount("topic") == 2, "two subscribers");
+
+    const t_str message(4096, 'm');
+    t_str received;
+    t_u64 published(0);
+    while (broker.GetDroppedCount(slow[0]) == 0 && published < 100000) {
+        Expect(broker.Publish("topic", t_str(message)) >= 1, "published to the fast subscriber");
+        ++published;
+        loop.RunOnce(0);
+        Drain(fast[1], received);
+    }
+    Expect(broker.GetDroppedCount(slow[0]) > 0 && broker.GetDroppedCount(fast[0]) == 0, "only the stalled subscriber drops");
+    Expect(broker.GetEvictedCount() == 0 && broker.GetQueue(slow[0]) != nullptr, "DROP keeps the subscriber");
+    for (int i = 0; i < 100 && received.size() < published * message.size(); ++i) {
+        loop.RunOnce(1);
+        Drain(fast[1], received);
+    }
+    Expect(received.size() == published * message.size(), "the fast subscriber got every message");
+
+    broker.SetSlowPolicy(TcpInitializer::SlowPolicy::DISCONNECT, max_queued);
+    Expect(broker.Publish("topic", t_str(message)) >= 1, "published under DISCONNECT");
+    Expect(broker.GetEvictedCount() == 1 && broker.GetQueue(slow[0]) == nullptr, "DISCONNECT evicts the subscriber");
+    Expect(broker.GetSubscriberCount("topic") == 1 && broker.GetQueue(fast[0]) != nullptr, "the fast subscriber stays");
+    bool open(true);
+    for (int i = 0; i < 1000 && open; ++i) {
+        t_str discarded;
+        loop.RunOnce(1);
+        open = Drain(slow[1], discarded);
+    }
+    Expect(!open, "the evicted subscriber sees the connection close");
+    close(slow[1]);
+    close(fast[1]);
+    for (int i = 0; i < 1000 && broker.GetConnectionCount() > 0; ++i)
+        loop.RunOnce(1);
+    Expect(broker.GetConnectionCount() == 0 && broker.GetTopicCount() == 0, "closed subscribers are forgotten");
+};
+
+/**
+ * @brief Issues a batch of calls to a server that answers them in reverse order.
+ */
+void Pipeline(void) {
+    constexpr std::size_t calls(16);
+    TcpInitializer::TcpListener listener;
+    Expect(listener.Listen("127.0.0.1", 0), "listening");
+    struct sockaddr_in address;
+    socklen_t address_size(sizeof(address));
+    Expect(getsockname(*listener.GetSocket(), reinterpret_cast<struct sockaddr *>(&address), &address_size) == 0, "listener port");
+
+    std::thread server([&listener]() -> void {
+        t_sock sock(listener.Accept());
+        if (sock < 0)
+            return;
+        std::vector<std::pair<t_u64, t_str>> batch;
+        TcpInitializer::FrameDecoder decoder(std::make_unique<TcpInitializer::LengthPrefixCodec>(), [&batch](TcpInitializer::FrameDecoder &, const t_strw *_frames, const std::size_t _count) -> void {
+            for (std::size_t i = 0; i < _count; ++i) {
+                t_u64 id;
+                t_strw body;
+                if (TcpInitializer::PipelineClient::ParseFrame(_frames[i], id, body))
+                    batch.emplace_back(id, t_str(body));
+            }
+        });
+        bool open(true);
+        while (open) {
+            struct pollfd readable{ sock, POLLIN, 0 };
+            poll(&readable, 1, -1);
+            open = decoder.Feed(sock);
+            if (batch.size() < calls && open)
+                continue;
+            t_str replies;
+            for (auto reply(batch.rbegin()); reply != batch.rend(); ++reply)
+                TcpInitializer::PipelineClient::EncodeFrame(reply->first, "re:" + reply->second, replies);
+            batch.clear();
+            if (!replies.empty())
+                TcpInitializer::Socket::Send(&sock, replies);
+        }
+        close(sock);
+    });
+
+    TcpInitializer::PipelineClient client(calls);
+    Expect(client.Connect("127.0.0.1", ntohs(address.sin_port)), "connected");
+    std::vector<std::pair<t_str, std::future<TcpInitializer::PipelineClient::CallResult>>> pending;
+    for (std::size_t i = 0; i < calls; ++i) {
+        t_str body("call-" + std::to_string(i));
+        auto reply(client.Call(body, 10000));
+        pending.emplace_back(std::move(body), std::move(reply));
+    }
+    for (auto &[body, reply] : pending) {
+        const TcpInitializer::PipelineClient::CallResult result(reply.get());
+        Expect(result.status == TcpInitializer::CallStatus::OK, "call answered");
+        Expect(result.body == "re:" + body, "reply matched to its request");
+    }
+    Expect(client.GetInFlight() == 0 && client.GetTimeoutCount() == 0, "nothing left in flight");
+    client.Close();
+    server.join();
+};
+
+/**
+ * @brief Transfers one end of a socketpair with a payload and talks through the received copy.
+ */
+void FdPass(void) {
+    TcpInitializer::FdChannel sender, receiver;
+    Expect(TcpInitializer::FdChannel::Pair(sender, receiver), "channel pair");
+    int pair[2];
+    Expect(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0, "socketpair");
+    t_sock transferred(pair[0]);
+    Expect(sender.Transfer(transferred, "hello"), "descriptor transferred");
+    Expect(transferred == -1 && sender.GetSentCount() == 1, "local copy closed");
+
+    t_str payload;
+    const t_sock received(receiver.Receive(&payload));
+    Expect(received >= 0 && payload == "hello" && receiver.GetReceivedCount() == 1, "descriptor and payload received");
+    Expect(write(received, "ping", 4) == 4, "write through the received descriptor");
+    char buffer[4];
+    Expect(read(pair[1], buffer, sizeof(buffer)) == 4 && t_strw(buffer, 4) == "ping", "bytes reach the other end");
+    close(received);
+    close(pair[1]);
+};
+
+}; // namespace TcpGatewaySmoke
+
+int main(int argc, char **argv) {
+    using namespace TcpGatewaySmoke;
+    const std::vector<std::pair<t_strw, void (*)(void)>> cases{
+        { "framing", Framing }, { "timers", Timers }, { "pubsub", PubSub }, { "pipeline", Pipeline }, { "fdpass", FdPass }
+    };
+    if (argc != 2) {
+        std::printf("usage: %s framing|timers|pubsub|pipeline|fdpass\n", argv[0]);
+        return 1;
+    }
+    for (const auto &[name, run] : cases) {
+        if (name != argv[1])
+            continue;
+        try {
+            run();
+        } catch (const t_except &e) {
+            std::printf("%s failed: %s\n", argv[1], e.what());
+            return 1;
+        }
+        std::printf("%s ok\n", argv[1]);
+        return 0;
+    }
+    std::fprintf(stderr, "unknown case %s\n", argv[1]);
+    return 1;
+};